@@ -8,7 +8,15 @@
  * requested.
  *
  * Usage:
- *   ./06-client-server-interaction-image-commands-server
+ *   ./06-client-server-interaction-image-commands-server [--simulated | --replay <path> |
+ *                                                         --replay-fast <path>]
+ *
+ * With `--simulated`, the server acquires from a simulated camera instead of the physical one, so
+ * that the full server path can be exercised (and load-tested) on any machine.
+ *
+ * With `--replay <path>`, the server serves the frames of a recording, or of a directory of
+ * recordings (see examples/07-recording-frames), at their original pace. With
+ * `--replay-fast <path>`, the recorded frames are served as fast as they are requested.
  *
  * The server runs until the user presses 'q' in the terminal, at which point it shuts down
  * gracefully. All logging is written to logs/camera-server.log.
@@ -16,11 +24,13 @@
 
 #include "irsol/irsol.hpp"
 
+#include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 int
-main()
+main(int argc, char** argv)
 {
 
   irsol::initLogging("logs/camera-server.log");
@@ -30,7 +40,24 @@ main()
 
   in_port_t port = 15099;  // port used by existing clients
 
-  irsol::server::App app(port);
+  const std::string mode = argc > 1 ? argv[1] : "";
+
+  std::vector<std::unique_ptr<irsol::server::Device>> devices;
+  if(mode == "--simulated") {
+    IRSOL_LOG_INFO("Using a simulated camera");
+    devices.push_back(irsol::server::Device::simulated(
+      "default", std::make_unique<irsol::camera::SimulatedCamera>()));
+  } else if((mode == "--replay" || mode == "--replay-fast") && argc > 2) {
+    using Pacing      = irsol::camera::ReplayCamera::Pacing;
+    const auto pacing = mode == "--replay" ? Pacing::ORIGINAL : Pacing::AS_FAST_AS_POSSIBLE;
+    IRSOL_LOG_INFO("Replaying the recorded frames of '{}'", argv[2]);
+    devices.push_back(irsol::server::Device::replay(
+      "default", std::make_unique<irsol::camera::ReplayCamera>(argv[2], pacing)));
+  } else {
+    devices.push_back(irsol::server::Device::connect("default"));
+  }
+
+  irsol::server::App app(port, std::move(devices));
   if(!app.start()) {
     IRSOL_LOG_FATAL("Failed to start server.");
     return 1;
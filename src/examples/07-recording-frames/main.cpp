@@ -0,0 +1,123 @@
+/// @file examples/07-recording-frames/main.cpp
+/// @brief Records frames captured from the camera into a recording file.
+///
+/// The recording can then be replayed by the server instead of the camera (see
+/// `irsol::camera::ReplayCamera`), e.g. to reproduce a production load on realistic pixel data.
+///
+/// Build system integration is expected to define `PROGRAM_NAME` for logging.
+
+#include "irsol/irsol.hpp"
+
+#include <chrono>
+#include <string>
+
+/// @brief Returns the program name, typically used for logging.
+/// If `PROGRAM_NAME` is not defined at compile time, returns `"recording-frames-demo"`.
+const std::string
+getProgramName()
+{
+#ifndef PROGRAM_NAME
+#define PROGRAM_NAME "recording-frames-demo"
+#endif
+  return PROGRAM_NAME;
+}
+
+/// @brief Command-line parameters for the program.
+struct Params
+{
+  /// Logging verbosity level (default: info)
+  spdlog::level::level_enum logLevel{spdlog::level::info};
+
+  /// Number of frames to record (default: 100)
+  uint64_t numFrames{100};
+
+  /// Path of the recording file (default: recording.irsolrec)
+  std::string output{"recording.irsolrec"};
+};
+
+/// @brief Parses command-line arguments using `args` library.
+///
+/// Supported arguments:
+/// - `--log-level`, `-l`: Set logging level (trace, debug, info, warn, error)
+/// - `--frames-count`, `-n`: Set number of frames to record
+/// - `--output`, `-o`: Set the path of the recording file
+/// - `--help`, `-h`: Show help message and exit
+///
+/// @param argc Argument count
+/// @param argv Argument vector
+/// @return Filled `Params` struct
+Params
+getParams(int argc, char** argv)
+{
+  args::ArgumentParser parser(getProgramName());
+  args::HelpFlag       help(parser, "help", "Display this help menu", {'h', "help"});
+
+  args::MapFlag<std::string, spdlog::level::level_enum> logLevelArg(
+    parser, "level", "Log level", {'l', "log-level"}, irsol::levelNameToLevelMap);
+
+  args::ValueFlag<uint64_t> numFramesArg(
+    parser, "#frames", "Number of frames to record", {'n', "frames-count"});
+
+  args::ValueFlag<std::string> outputArg(
+    parser, "output", "Path of the recording file", {'o', "output"});
+
+  try {
+    parser.ParseCLI(argc, argv);
+  } catch(args::Help) {
+    std::cerr << parser.Help() << std::endl;
+    std::exit(0);
+  } catch(args::ParseError e) {
+    std::cerr << "Error parsing command-line arguments:\n" << e.what() << "\n\n" << parser.Help();
+    std::exit(1);
+  }
+
+  Params params{};
+  if(logLevelArg) {
+    params.logLevel = args::get(logLevelArg);
+  }
+  if(numFramesArg) {
+    params.numFrames = args::get(numFramesArg);
+  }
+  if(outputArg) {
+    params.output = args::get(outputArg);
+  }
+  return params;
+}
+
+/// @brief Program entrypoint.
+///
+/// - Initializes logging and assertions
+/// - Connects to the camera, at half resolution
+/// - Records a user-defined number of frames
+int
+main(int argc, char** argv)
+{
+  auto params = getParams(argc, argv);
+
+  std::string logPath = "logs/" + getProgramName() + ".log";
+  irsol::initLogging(logPath.c_str(), params.logLevel);
+  irsol::initAssertHandler();
+
+  auto cam = irsol::camera::Interface::HalfResolution();
+  IRSOL_ASSERT_FATAL(cam.isConnected(), "Camera is not connected");
+  IRSOL_LOG_INFO("\n{}", cam.cameraStatusAsString());
+
+  irsol::camera::RecordingWriter writer(params.output, {cam.serialNumber(), cam.getExposure()});
+  for(size_t i = 0; i < params.numFrames; ++i) {
+    auto image = cam.captureImage();
+    if(image.IsEmpty()) {
+      IRSOL_LOG_WARN("Image is empty, skipping it.");
+      continue;
+    }
+    writer.write(
+      image.GetImageID(),
+      cam.imageTimestamp(image),
+      image.GetWidth(),
+      image.GetHeight(),
+      reinterpret_cast<const irsol::types::byte_t*>(image.GetImageData()),
+      image.GetSize());
+  }
+  IRSOL_LOG_INFO("Recorded {} frames into '{}'", writer.numFrames(), params.output);
+
+  return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file irsol/buffer_pool.hpp
+ * @brief Pool of re-usable, large byte buffers.
+ *
+ * Declares the @ref irsol::utils::BufferPool class, used on the frame path (camera acquisition,
+ * image serialization) to avoid allocating and page-faulting multi-megabyte buffers for every
+ * frame.
+ */
+#pragma once
+
+#include "irsol/types.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace irsol {
+namespace utils {
+
+/**
+ * @brief Thread-safe pool of re-usable byte buffers, organized in size classes.
+ *
+ * Buffers are handed out as `std::shared_ptr<std::vector<byte_t>>`, sized exactly to the
+ * requested number of bytes, so they can be used directly as the storage of the protocol binary
+ * data types (see @ref irsol::protocol::internal::BinaryData). A buffer goes back to the pool
+ * automatically, as soon as the last consumer releases its reference: no explicit release call is
+ * needed.
+ *
+ * Requests are rounded up to a size class (a power of two, at least @ref MIN_CLASS_SIZE bytes),
+ * and each class keeps its own list of buffers. Newly allocated buffers are pre-faulted (all their
+ * pages are touched once), and may optionally be backed by transparent huge pages, so that the
+ * first frame written into a buffer does not pay for page faults.
+ *
+ * In steady state (i.e. once enough buffers of each used class have been allocated), acquiring a
+ * buffer does not allocate memory. The number of buffer allocations performed by the pool is
+ * exposed via @ref numAllocations(), so that this can be verified.
+ *
+ * @note The pool keeps a reference on each of its buffers: the content of a handed-out buffer is
+ * only written by the consumer that acquired it, and copy-on-write helpers relying on
+ * `use_count()` (e.g. @ref irsol::protocol::internal::BinaryData::mutableData()) never modify a
+ * pooled buffer in place.
+ *
+ * ```cpp
+ * irsol::utils::BufferPool pool;
+ * pool.reserve(1080 * 1440 * 2, 4);  // pre-allocate 4 frame buffers
+ *
+ * {
+ *   auto buffer = pool.acquire(1080 * 1440 * 2);
+ *   // ... fill the buffer ...
+ * }  // the buffer is available again
+ * ```
+ */
+class BufferPool
+{
+public:
+  /// Shared buffer handed out by the pool.
+  using buffer_t = std::shared_ptr<std::vector<irsol::types::byte_t>>;
+
+  /// Smallest size class of the pool, in bytes.
+  static constexpr size_t MIN_CLASS_SIZE = 4096;
+
+  /// Size of the huge pages used when @ref useHugePages() is enabled, in bytes.
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  /**
+   * @brief Constructs an empty pool.
+   *
+   * @param useHugePages Whether newly allocated buffers should be backed by huge pages, when
+   *                     supported by the platform.
+   */
+  explicit BufferPool(bool useHugePages = false);
+
+  // Buffers keep no reference to the pool, but a pool is not meant to be copied or moved.
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+
+  /**
+   * @brief Returns a buffer of exactly @p numBytes bytes.
+   *
+   * A free buffer of the matching size class is re-used if available, otherwise a new one is
+   * allocated. The content of a re-used buffer is unspecified.
+   *
+   * @param numBytes Size of the requested buffer.
+   * @return Shared pointer to the buffer. The buffer is available again once all its copies are
+   *         destroyed.
+   */
+  buffer_t acquire(size_t numBytes);
+
+  /**
+   * @brief Makes sure that at least @p count buffers of the class of @p numBytes exist.
+   *
+   * Missing buffers are allocated and pre-faulted immediately, so that later calls to
+   * @ref acquire() for at most @p count concurrent buffers of this size don't allocate memory.
+   */
+  void reserve(size_t numBytes, size_t count);
+
+  /**
+   * @brief Enables or disables huge pages for the buffers allocated from now on.
+   */
+  void useHugePages(bool enabled);
+
+  /// Number of buffers allocated by the pool since its construction.
+  uint64_t numAllocations() const;
+
+  /// Number of buffers owned by the pool (either in use or available).
+  size_t numBuffers() const;
+
+  /// Number of buffers owned by the pool that are currently not in use.
+  size_t numAvailable() const;
+
+  /**
+   * @brief Returns the size class used for a request of @p numBytes bytes.
+   */
+  static size_t classSize(size_t numBytes);
+
+  /**
+   * @brief Process-wide pool, used by default on the frame path.
+   */
+  static BufferPool& global();
+
+private:
+  /// Index in @ref m_classes of the size class used for a request of @p numBytes bytes.
+  static size_t classIndex(size_t numBytes);
+
+  /// Allocates and pre-faults a new buffer of the given size class (not thread-safe).
+  buffer_t allocateNonThreadSafe(size_t classSize);
+
+  /// Checks whether a buffer is only referenced by the pool.
+  static bool isAvailable(const buffer_t& buffer);
+
+  mutable std::mutex                 m_mutex;              ///< Protects the size classes.
+  std::vector<std::vector<buffer_t>> m_classes;            ///< Buffers of each size class.
+  std::atomic<bool>                  m_useHugePages;       ///< Whether huge pages are requested.
+  std::atomic<uint64_t>              m_numAllocations{0};  ///< Number of allocated buffers.
+};
+
+}  // namespace utils
+}  // namespace irsol
@@ -1,6 +1,12 @@
 #pragma once
 
+#include "irsol/camera/backend.hpp"
 #include "irsol/camera/discovery.hpp"
 #include "irsol/camera/interface.hpp"
 #include "irsol/camera/monitor.hpp"
-#include "irsol/camera/pixel_format.hpp"
\ No newline at end of file
+#include "irsol/camera/pixel_format.hpp"
+#include "irsol/camera/recording.hpp"
+#include "irsol/camera/replay_camera.hpp"
+#include "irsol/camera/simulated_camera.hpp"
+#include "irsol/camera/trigger_timing.hpp"
+#include "irsol/camera/user_buffers.hpp"
\ No newline at end of file
@@ -0,0 +1,74 @@
+/**
+ * @file irsol/camera/backend.hpp
+ * @brief Abstract camera backend, as used by the server.
+ *
+ * The @ref irsol::camera::Backend declares the camera parameters accessed by the server (exposure
+ * and integer features such as the region of interest), independently of the device implementing
+ * them: the NeoAPI camera (@ref irsol::camera::Interface), or the simulated camera
+ * (@ref irsol::camera::SimulatedCamera) used to exercise the server without hardware.
+ */
+
+#pragma once
+
+#include "irsol/types.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace irsol {
+namespace camera {
+
+/**
+ * @brief Abstract camera, whose parameters are accessed by name.
+ *
+ * The acquisition itself is exposed to the server by the frame source matching the backend (see
+ * @ref irsol::server::frame_collector::FrameSource).
+ *
+ * Implementations are thread-safe.
+ */
+class Backend
+{
+public:
+  virtual ~Backend() = default;
+
+  /// Serial number of the camera.
+  virtual std::string serialNumber() const = 0;
+
+  /// Human-readable description of the current state of the camera.
+  virtual std::string cameraStatusAsString() const = 0;
+
+  /// Current exposure time of the camera.
+  virtual irsol::types::duration_t getExposure() const = 0;
+
+  /**
+   * @brief Sets the exposure time of the camera.
+   *
+   * @param exposure New exposure duration.
+   * @return The actual exposure set on the camera (may differ slightly).
+   */
+  virtual irsol::types::duration_t setExposure(irsol::types::duration_t exposure) = 0;
+
+  /// Exposure time last set on the camera, without querying the camera.
+  virtual irsol::types::duration_t cachedExposure() const = 0;
+
+  /**
+   * @brief Reads an integer parameter of the camera.
+   *
+   * @param param Name of the parameter, e.g. `Width`.
+   * @return The value of the parameter, or 0 if it can't be read.
+   */
+  virtual int64_t getIntParam(const std::string& param) const = 0;
+
+  /**
+   * @brief Writes an integer parameter of the camera.
+   *
+   * @param param Name of the parameter, e.g. `Width`.
+   * @param value Value to set.
+   * @return The value of the parameter read back after the write (e.g. rounded to the increment of
+   *         the parameter, or unchanged if the write failed).
+   */
+  virtual int64_t setIntParam(const std::string& param, int64_t value) = 0;
+};
+
+}  // namespace camera
+}  // namespace irsol
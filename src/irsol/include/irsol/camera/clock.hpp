@@ -0,0 +1,119 @@
+/**
+ * @file irsol/camera/clock.hpp
+ * @brief Mapping of the camera clock onto the host clock.
+ *
+ * Cameras stamp each image with the value of their internal timestamp counter, latched at the
+ * start of the exposure. This header declares @ref irsol::camera::DeviceClock, which converts
+ * such device timestamps into host time points, so that frames can be correlated with other
+ * instruments independently of the transfer and processing delays of the host.
+ */
+
+#pragma once
+
+#include "irsol/types.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace irsol {
+namespace camera {
+
+/**
+ * @brief Drift-corrected mapping of a device timestamp counter onto the host clock.
+ *
+ * The mapping is a linear function `host = offset + rate * device`, fitted on a sliding window of
+ * synchronization samples. Each sample pairs a value of the device counter with the host interval
+ * during which it was read (e.g. the duration of a `TimestampLatch` command): the middle of the
+ * interval is used as the host time of the sample, and samples are weighted by the inverse square
+ * of the interval length, so that samples disturbed by a slow round-trip barely affect the fit.
+ *
+ * Fitting the rate (instead of assuming the device and host clocks run at the same speed)
+ * compensates for the drift between the two oscillators. The fitted rate is bounded to
+ * @ref MAX_DRIFT around the nominal rate, so that a few close samples cannot produce a wild
+ * extrapolation.
+ *
+ * A device counter going backwards (e.g. after a camera reset) discards all the previous samples.
+ *
+ * Thread-safe.
+ */
+class DeviceClock
+{
+public:
+  /// Default number of synchronization samples the mapping is fitted on.
+  static constexpr size_t DEFAULT_WINDOW_SIZE = 32;
+
+  /// Maximum relative difference between the rates of the device and of the host clocks.
+  static constexpr double MAX_DRIFT = 1e-3;
+
+  /**
+   * @param ticksPerSecond Frequency of the device timestamp counter.
+   * @param windowSize     Number of synchronization samples the mapping is fitted on.
+   */
+  explicit DeviceClock(double ticksPerSecond = 1e9, size_t windowSize = DEFAULT_WINDOW_SIZE);
+
+  /**
+   * @brief Adds a synchronization sample.
+   *
+   * @param deviceTicks Value of the device counter.
+   * @param hostBefore  Host time right before the device counter was read.
+   * @param hostAfter   Host time right after the device counter was read.
+   */
+  void addSample(
+    uint64_t                  deviceTicks,
+    irsol::types::timepoint_t hostBefore,
+    irsol::types::timepoint_t hostAfter);
+
+  /**
+   * @brief Converts a device timestamp to host time.
+   *
+   * @param deviceTicks Value of the device counter.
+   * @return The corresponding host time point, or `std::nullopt` if no sample is available.
+   */
+  std::optional<irsol::types::timepoint_t> toHost(uint64_t deviceTicks) const;
+
+  /**
+   * @brief Returns the fitted drift of the device clock relative to the host clock.
+   *
+   * A positive drift means that the device clock runs faster than the host clock (e.g. `1e-5`
+   * for 10 ppm).
+   */
+  double drift() const;
+
+  /// Number of synchronization samples the current mapping is fitted on.
+  size_t numSamples() const;
+
+  /// Host time of the last synchronization sample, `std::nullopt` if none.
+  std::optional<irsol::types::timepoint_t> lastSampleTime() const;
+
+  /// Discards all the synchronization samples, e.g. when the device is reconnected.
+  void reset();
+
+private:
+  /// A synchronization sample.
+  struct Sample
+  {
+    uint64_t                  deviceTicks;  ///< Value of the device counter.
+    irsol::types::timepoint_t hostTime;     ///< Host time at which the counter was read.
+    double                    weight;       ///< Weight of the sample in the fit.
+  };
+
+  /// Fits the mapping on the current samples (not thread-safe).
+  void fitNonThreadSafe();
+
+  const double       m_ticksPerSecond;  ///< Frequency of the device timestamp counter.
+  const size_t       m_windowSize;      ///< Number of samples the mapping is fitted on.
+  mutable std::mutex m_mutex;           ///< Protects the samples and the mapping.
+  std::deque<Sample> m_samples;         ///< Samples the mapping is fitted on.
+
+  // The mapping is `host = m_refHost + m_rate * (device seconds since m_refTicks - m_refSeconds)`,
+  // so that it's computed on small, and thus precise, differences.
+  uint64_t                  m_refTicks{0};    ///< Device counter the mapping is relative to.
+  double                    m_refSeconds{0};  ///< Device seconds of the fit's center of mass.
+  irsol::types::timepoint_t m_refHost{};      ///< Host time of the fit's center of mass.
+  double                    m_rate{1.0};      ///< Host seconds elapsed per device second.
+};
+
+}  // namespace camera
+}  // namespace irsol
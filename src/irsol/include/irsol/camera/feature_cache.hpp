@@ -0,0 +1,200 @@
+/**
+ * @file irsol/camera/feature_cache.hpp
+ * @brief Interned camera feature names, and cache of the resolved feature handles.
+ *
+ * Looking up a feature of the camera by name (`NeoAPI::Cam::GetFeature()`) builds a
+ * `NeoAPI::NeoString` and walks the feature tree of the device. The
+ * @ref irsol::camera::FeatureCache resolves each feature only once, and serves the following
+ * accesses with an index lookup, given the interned name of the feature
+ * (@ref irsol::camera::FeatureId).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <neoapi/neoapi.hpp>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace irsol {
+namespace camera {
+
+/**
+ * @brief Interned name of a camera feature.
+ *
+ * All the identifiers built from the same name share the same index, which is used by
+ * @ref irsol::camera::FeatureCache to find the resolved feature without comparing strings. The
+ * identifiers of the features accessed on every frame are meant to be built once, e.g. as
+ * constants.
+ *
+ * Thread-safe.
+ */
+class FeatureId
+{
+public:
+  /**
+   * @brief Interns the name of a feature.
+   * @param name Name of the feature, e.g. `ExposureTime`.
+   */
+  explicit FeatureId(const std::string& name);
+
+  /// Index of the interned name, dense from 0.
+  size_t index() const
+  {
+    return m_index;
+  }
+
+  /// Name of the feature.
+  const std::string& name() const
+  {
+    return *m_name;
+  }
+
+  /// Number of distinct names interned so far.
+  static size_t numInterned();
+
+private:
+  size_t             m_index;  ///< Index of the interned name.
+  const std::string* m_name;   ///< Interned name, never released.
+};
+
+/**
+ * @brief Cache of the features of a feature tree, indexed by @ref irsol::camera::FeatureId.
+ *
+ * A feature is resolved through the tree on its first access, and a copy of its handle is kept
+ * until @ref invalidate() is called, which must happen whenever the features of the tree are
+ * rebuilt (e.g. when the camera reconnects). Features that can't be resolved are not cached.
+ *
+ * The handles are copied, as the tree doesn't document how long the reference it returns stays
+ * valid: it may be a scratch object, re-used by the next lookup.
+ *
+ * Not thread-safe: the accesses must be serialized by the owner of the tree.
+ *
+ * @tparam Tree Feature tree, providing `Feature& GetFeature(const NeoAPI::NeoString&) const`
+ *              (e.g. `NeoAPI::Cam`), where `Feature` is a copyable handle on the feature.
+ */
+template<typename Tree>
+class FeatureCache
+{
+public:
+  /// Type of the features of the tree.
+  using feature_t = std::remove_reference_t<decltype(std::declval<const Tree&>().GetFeature(
+    std::declval<const NeoAPI::NeoString&>()))>;
+
+  /**
+   * @brief Returns the feature, resolving it through @p tree on the first access.
+   *
+   * @param tree    Feature tree owning the feature.
+   * @param feature Identifier of the feature.
+   * @return The cached handle of the feature, valid until @ref invalidate() is called.
+   * @throws Any exception thrown by the tree when the feature can't be resolved.
+   */
+  feature_t& get(const Tree& tree, const FeatureId& feature)
+  {
+    const auto index = feature.index();
+    if(index < m_features.size() && m_features[index].has_value()) {
+      return *m_features[index];
+    }
+    feature_t resolved = tree.GetFeature(NeoAPI::NeoString(feature.name().c_str()));
+    if(index >= m_features.size()) {
+      // Growing a deque at its end keeps the handles returned so far valid.
+      m_features.resize(index + 1);
+    }
+    m_features[index].emplace(std::move(resolved));
+    ++m_numResolved;
+    return *m_features[index];
+  }
+
+  /// Forgets all the resolved features: they are resolved again on their next access.
+  void invalidate()
+  {
+    for(auto& resolved : m_features) {
+      resolved.reset();
+    }
+  }
+
+  /// Number of lookups performed on the tree so far.
+  uint64_t numResolved() const
+  {
+    return m_numResolved;
+  }
+
+private:
+  /// Resolved features, indexed by feature ID.
+  std::deque<std::optional<feature_t>> m_features;
+  /// Number of lookups performed on the tree.
+  uint64_t m_numResolved{0};
+};
+
+/**
+ * @brief Stand-in for the feature tree of a camera, for testing and benchmarking purposes.
+ *
+ * Features are looked up by name in an ordered map, as in the node map of a GenICam device. As
+ * for a `NeoAPI::Cam`, a lookup returns a handle on the feature: the copies of the handle access
+ * the same feature. The reference returned by a lookup is only valid until the next lookup, as it
+ * is a scratch handle re-used by all the lookups.
+ */
+class SimulatedFeatureTree
+{
+private:
+  /// State of a feature of the simulated tree.
+  struct Node
+  {
+    std::string name;   ///< Name of the feature.
+    int64_t     value;  ///< Current value of the feature.
+  };
+
+public:
+  /// Handle on a feature of the simulated tree.
+  class Feature
+  {
+  public:
+    /// Name of the feature.
+    const std::string& GetName() const;
+
+    /// Current value of the feature.
+    int64_t GetInt() const;
+
+    /// Writes the value of the feature.
+    void SetInt(int64_t value);
+
+  private:
+    friend class SimulatedFeatureTree;
+
+    std::shared_ptr<Node> m_node;  ///< Feature accessed by the handle.
+  };
+
+  /**
+   * @brief Adds a feature to the tree.
+   * @param name  Name of the feature.
+   * @param value Initial value of the feature.
+   */
+  void addFeature(const std::string& name, int64_t value = 0);
+
+  /**
+   * @brief Looks up a feature by name.
+   * @return A handle on the feature, only valid until the next lookup: it must be copied to be
+   *         kept.
+   * @throws std::out_of_range if the tree has no such feature.
+   */
+  Feature& GetFeature(const NeoAPI::NeoString& name) const;
+
+  /// Number of lookups performed so far.
+  uint64_t numLookups() const;
+
+private:
+  /// Features, by name.
+  std::map<std::string, std::shared_ptr<Node>> m_features;
+  /// Handle returned by the last lookup.
+  mutable Feature m_scratch;
+  /// Number of lookups.
+  mutable uint64_t m_numLookups{0};
+};
+
+}  // namespace camera
+}  // namespace irsol
@@ -12,10 +12,18 @@
 #pragma once
 
 #include "irsol/assert.hpp"
+#include "irsol/camera/backend.hpp"
+#include "irsol/camera/clock.hpp"
+#include "irsol/camera/feature_cache.hpp"
+#include "irsol/camera/parameter_shadow.hpp"
+#include "irsol/camera/trigger_timing.hpp"
+#include "irsol/camera/user_buffers.hpp"
 #include "irsol/types.hpp"
 #include "irsol/utils.hpp"
 
 #include <chrono>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <neoapi/neoapi.hpp>
 #include <optional>
@@ -23,6 +31,7 @@
 #include <type_traits>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 namespace irsol {
 
@@ -54,21 +63,53 @@ namespace camera {
  * via NeoAPI. It abstracts common camera operations such as setting exposure, retrieving and
  * setting camera parameters, capturing images, and managing sensor state.
  *
+ * The features of the camera are resolved once, and their handles are cached until the camera
+ * reconnects (see @ref reconnect()). The accessors taking a @ref irsol::camera::FeatureId skip
+ * the lookup of the feature name altogether, and are meant for the features accessed on every
+ * frame.
+ *
+ * The values read from the camera are kept in a @ref irsol::camera::ParameterShadow, which serves
+ * the following reads without accessing the camera (nor waiting for an acquisition in progress).
+ * The shadow is invalidated by every write to the camera, and the values of the volatile features
+ * (see @ref VOLATILE_FEATURES) expire after @ref VOLATILE_REFRESH_PERIOD.
+ *
+ * The `Interface` is the NeoAPI implementation of the @ref irsol::camera::Backend used by the
+ * server.
+ *
  * @note The underlying NeoAPI camera must be usable with a pixel format Mono12. Failure to run in
  * this modality will lead to the Interface constructor to raise a fatal assertion.
  */
-class Interface
+class Interface : public Backend
 {
 public:
   /// Alias for the image type returned by the NeoAPI.
   using image_t = NeoAPI::Image;
 
+  /// Callback receiving the images of a triggered acquisition.
+  using image_callback_t = std::function<void(const image_t&)>;
+
   /// Union of all supported types for camera parameters.
   using camera_param_t = std::variant<bool, int, int64_t, double, std::string, const char*>;
 
   /// Default exposure time (2 milliseconds) used to initialize the camera.
   static constexpr irsol::types::duration_t DEFAULT_EXPOSURE_TIME = std::chrono::milliseconds(2);
 
+  /// Maximum age of the last synchronization of the device clock, see @ref imageTimestamp().
+  static constexpr irsol::types::duration_t CLOCK_SYNC_PERIOD = std::chrono::seconds(1);
+
+  /// Delay before synchronizing the device clock again after a failure, see @ref synchronizeClock()
+  static constexpr irsol::types::duration_t CLOCK_SYNC_RETRY_PERIOD = std::chrono::seconds(10);
+
+  /// Default number of user buffers acquired into, see @ref enableUserBuffers().
+  static constexpr size_t DEFAULT_USER_BUFFER_COUNT = 8;
+
+  /// Default maximum age of the shadowed values of the volatile features.
+  static constexpr irsol::types::duration_t VOLATILE_REFRESH_PERIOD = std::chrono::seconds(1);
+
+  /// Features whose value changes without being written to, see @ref setRefreshPeriod().
+  static constexpr const char* VOLATILE_FEATURES[] = {
+    "DeviceTemperature", "DeviceTemperatureStatus", "FrameCounter"};
+
   /**
    * @brief Constructs the Interface by loading the default camera.
    *
@@ -81,7 +122,12 @@ public:
    */
   Interface(NeoAPI::Cam cam = irsol::utils::loadDefaultCamera());
 
-  /// Move constructor.
+  /**
+   * @brief Move constructor.
+   *
+   * @note User buffers are not transferred to the new instance: enable them (see @ref
+   * enableUserBuffers()) once the interface reached its final location.
+   */
   Interface(Interface&& other);
 
   /// Move assignment operator.
@@ -89,18 +135,25 @@ public:
 
   /**
    * @brief Factory method to create a camera interface using full sensor resolution.
+   * @param cam Camera handle. Defaults to the result of @ref irsol::utils::loadDefaultCamera().
    * @return Interface instance initialized at full resolution.
    */
-  static Interface FullResolution();
+  static Interface FullResolution(NeoAPI::Cam cam = irsol::utils::loadDefaultCamera());
 
   /**
    * @brief Factory method to create a camera interface using half sensor resolution.
    *
    * Uses hardware binning to reduce resolution by averaging pixels.
    *
+   * @param cam Camera handle. Defaults to the result of @ref irsol::utils::loadDefaultCamera().
    * @return Interface instance initialized at half resolution.
    */
-  static Interface HalfResolution();
+  static Interface HalfResolution(NeoAPI::Cam cam = irsol::utils::loadDefaultCamera());
+
+  /**
+   * @brief Get the serial number of the camera.
+   */
+  std::string serialNumber() const override;
 
   /**
    * @brief Get human-readable camera information.
@@ -117,9 +170,12 @@ public:
    * Reads camera state such as resolution, exposure, and other operational flags
    * and returns a descriptive tabular string.
    *
+   * The values are served by the shadow copy of the features: only the expired volatile features
+   * (e.g. the device temperature) are read from the camera.
+   *
    * @return Formatted string describing current state of the camera.
    */
-  std::string cameraStatusAsString() const;
+  std::string cameraStatusAsString() const override;
 
   /**
    * @brief Access the underlying NeoAPI camera instance.
@@ -139,6 +195,31 @@ public:
     return m_cam.IsConnected();
   }
 
+  /**
+   * @brief Reconnect to the camera, e.g. after it was unplugged.
+   *
+   * The cached feature handles are invalidated, and resolved again on their next access.
+   *
+   * @throws NeoAPI::NeoException if the camera can't be connected.
+   */
+  void reconnect();
+
+  /**
+   * @brief Set the maximum age of the shadowed value of a feature.
+   *
+   * @param param  Name of the feature.
+   * @param period Maximum age of the value, `std::nullopt` if the feature only changes when
+   *               written to (the default for non-volatile features).
+   */
+  void setRefreshPeriod(
+    const std::string&                      param,
+    std::optional<irsol::types::duration_t> period);
+
+  /**
+   * @brief Shadow copy of the feature values, e.g. to inspect its hit rate.
+   */
+  const ParameterShadow& parameterShadow() const;
+
   /**
    * @brief Reset the sensor area to the full sensor dimensions.
    *
@@ -151,7 +232,7 @@ public:
    *
    * @return Current exposure duration.
    */
-  irsol::types::duration_t getExposure() const;
+  irsol::types::duration_t getExposure() const override;
 
   /**
    * @brief Set the exposure time of the camera.
@@ -159,12 +240,30 @@ public:
    * @param exposure New exposure duration.
    * @return The actual exposure set on the camera (may differ slightly).
    */
-  irsol::types::duration_t setExposure(irsol::types::duration_t exposure);
+  irsol::types::duration_t setExposure(irsol::types::duration_t exposure) override;
+
+  /**
+   * @brief Get the exposure time last set on the camera, without querying the camera.
+   *
+   * @return Cached exposure duration.
+   */
+  irsol::types::duration_t cachedExposure() const override;
+
+  /**
+   * @brief Read an integer camera parameter, see @ref getParam(const std::string&) const.
+   */
+  int64_t getIntParam(const std::string& param) const override;
+
+  /**
+   * @brief Write an integer camera parameter, see @ref setParam(const std::string&, T).
+   */
+  int64_t setIntParam(const std::string& param, int64_t value) override;
 
   /**
    * @brief Retrieve a camera parameter of arbitrary type T.
    *
-   * Uses the NeoAPI API to retrieve the value and cast to T. Supported types:
+   * Uses the NeoAPI API to retrieve the value and cast to T, unless it's shadowed already.
+   * Supported types:
    * - std::string
    * - bool
    * - integral types (e.g., int, int64_t)
@@ -183,6 +282,18 @@ public:
       int> = 0>
   T getParam(const std::string& param) const;
 
+  /**
+   * @brief Retrieve a camera parameter of arbitrary type T, identified by its interned name.
+   *
+   * Same as @ref getParam(const std::string&) const, without looking up the feature name.
+   */
+  template<
+    typename T,
+    std::enable_if_t<
+      std::is_integral_v<T> || std::is_floating_point_v<T> || std::is_same_v<std::string, T>,
+      int> = 0>
+  T getParam(const FeatureId& feature) const;
+
   /**
    * @brief Retrieve a camera parameter and convert it to string.
    *
@@ -193,9 +304,19 @@ public:
    */
   std::string getParam(const std::string& param) const;
 
+  /**
+   * @brief Retrieve a camera parameter, identified by its interned name, and convert it to string.
+   *
+   * Same as @ref getParam(const std::string&) const, without looking up the feature name.
+   */
+  std::string getParam(const FeatureId& feature) const;
+
   /**
    * @brief Set a camera parameter of arbitrary type T.
    *
+   * The parameter is written and read back under a single lock. A value already in place
+   * according to the shadow copy of the features is not written again.
+   *
    * Thread-safe. Supported types:
    * - std::string
    * - const char*
@@ -217,6 +338,19 @@ public:
       int> = 0>
   T setParam(const std::string& param, T value);
 
+  /**
+   * @brief Set a camera parameter of arbitrary type T, identified by its interned name.
+   *
+   * Same as @ref setParam(const std::string&, T), without looking up the feature name.
+   */
+  template<
+    typename T,
+    std::enable_if_t<
+      std::is_integral_v<std::decay_t<T>> || std::is_floating_point_v<std::decay_t<T>> ||
+        std::is_same_v<std::decay_t<T>, std::string>,
+      int> = 0>
+  T setParam(const FeatureId& feature, T value);
+
   /**
    * @brief Specialization for setting const char* values as strings.
    *
@@ -229,23 +363,52 @@ public:
   std::string setParam(const std::string& param, T value);
 
   /**
-   * @brief Set multiple parameters in one call.
+   * @brief Set multiple parameters as a single transaction.
    *
-   * Iterates through a map of key-value pairs and sets each camera parameter
-   * accordingly. Internally dispatches based on type.
+   * The parameters are applied under a single lock, so no other access to the camera (e.g. an
+   * acquisition) observes a partially applied configuration. They are written in the order of
+   * their dependencies (see @ref dependencyOrder()), so that e.g. the binning is applied before
+   * the region of interest it constrains. Within a region of interest, the offset and the size of
+   * each axis are written in the order keeping the region within the sensor at all times.
+   *
+   * The parameters whose value is already in place are not written, and only the written ones are
+   * read back (into the shadow copy of the features). A parameter that can't be written doesn't
+   * prevent the others from being applied.
    *
    * @param params Map of parameter names and values.
+   * @return true if all the parameters were applied, false otherwise.
    * @see Interface::setParam()
    */
-  void setMultiParam(const std::unordered_map<std::string, camera_param_t>& params);
+  bool setMultiParam(const std::unordered_map<std::string, camera_param_t>& params);
+
+  /**
+   * @brief Sorts features in the order they must be written to the camera.
+   *
+   * Features constraining others come first: trigger and acquisition configuration, pixel format,
+   * binning and decimation, region of interest (offset before size), exposure, and finally the
+   * frame rate, whose range depends on all of them. Other features follow, sorted by name.
+   *
+   * @param features Names of the features.
+   * @return The names of the features, in order.
+   */
+  static std::vector<std::string> dependencyOrder(std::vector<std::string> features);
 
   /**
    * @brief Trigger a camera feature (e.g., software trigger).
    *
    * @param param Name of the triggerable feature.
+   * @note Not thread-safe: meant to be called while holding the lock of the camera, e.g. within
+   * an acquisition.
    */
   void trigger(const std::string& param);
 
+  /**
+   * @brief Trigger a camera feature, identified by its interned name.
+   *
+   * Same as @ref trigger(const std::string&), without looking up the feature name.
+   */
+  void trigger(const FeatureId& feature);
+
   /**
    * @brief Capture a single image from the camera.
    *
@@ -258,6 +421,166 @@ public:
    */
   image_t captureImage(std::optional<irsol::types::duration_t> timeout = std::nullopt);
 
+  /**
+   * @brief Start an asynchronous, software-triggered acquisition.
+   *
+   * The camera stays armed between the triggers (see @ref submitTrigger()), and each acquired
+   * image is handed to @p callback as soon as it is received, on a thread of the driver. Unlike
+   * @ref captureImage(), no thread waits for the images, and the camera doesn't stop between two
+   * frames.
+   *
+   * The callback must not call back into this interface, apart from @ref imageTimestamp() and
+   * @ref shareImageData().
+   *
+   * @param callback Receives the images, in acquisition order.
+   * @note While the triggered acquisition is active, @ref
+   * irsol::camera::Interface::captureImage() must not be used.
+   */
+  void startTriggeredAcquisition(image_callback_t callback);
+
+  /**
+   * @brief Trigger the capture of an image in the triggered acquisition, without waiting for it.
+   *
+   * Thread-safe. Up to @ref maxPendingTriggers() triggers can be outstanding: the camera ignores
+   * any further trigger until an image is read out.
+   */
+  void submitTrigger();
+
+  /**
+   * @brief Stop the triggered acquisition, and restore the single-frame acquisition mode.
+   *
+   * The images of the outstanding triggers are discarded. Once this method returns, the callback
+   * is no longer called.
+   */
+  void stopTriggeredAcquisition();
+
+  /**
+   * @brief Maximum number of outstanding triggers of a triggered acquisition.
+   *
+   * A camera accepts a trigger during the readout of the previous frame only if its
+   * `TriggerOverlap` feature allows it. Otherwise, a single trigger can be outstanding.
+   */
+  size_t maxPendingTriggers() const;
+
+  /**
+   * @brief Enable (or disable) overlapped triggering.
+   *
+   * With overlapped triggering (`TriggerOverlap` set to `ReadOut`), the exposure of a frame runs
+   * during the readout of the previous one, see @ref irsol::camera::TriggerTiming.
+   *
+   * @param enable Whether the triggers may overlap the readout of the previous frame.
+   * @return true if overlapped triggering is enabled once the feature is written.
+   */
+  bool setTriggerOverlap(bool enable);
+
+  /**
+   * @brief Timing of the triggered captures with the current parameters.
+   *
+   * Based on the cached exposure, and on the `ReadOutTime` and `TriggerOverlap` features.
+   */
+  TriggerTiming triggerTiming() const;
+
+  /**
+   * @brief Switch the camera to free-running (continuous) acquisition and start it.
+   *
+   * The software trigger is disabled and the camera produces frames on its own at the requested
+   * frame rate, until @ref irsol::camera::Interface::stopContinuousAcquisition() is called.
+   * Frames are retrieved with @ref irsol::camera::Interface::grabContinuousImage().
+   *
+   * @param fps Frame rate at which the camera should produce frames. If `fps <= 0`, the camera
+   *            runs at the highest rate allowed by its current configuration.
+   * @note While the continuous acquisition is active, @ref
+   * irsol::camera::Interface::captureImage() must not be used.
+   */
+  void startContinuousAcquisition(double fps);
+
+  /**
+   * @brief Retrieve the next frame produced by a continuous acquisition.
+   *
+   * Thread-safe.
+   *
+   * @param timeout Optional duration to wait for a frame. Defaults to the cached exposure time
+   *                with a small buffer added. The camera stays locked while waiting.
+   * @return Captured image, which is empty in case of timeout. A timeout isn't reported as a
+   *         failure: the camera may be idle for up to its frame period, which the caller knows.
+   */
+  image_t grabContinuousImage(std::optional<irsol::types::duration_t> timeout = std::nullopt);
+
+  /**
+   * @brief Stop a continuous acquisition and restore the software-triggered acquisition mode.
+   */
+  void stopContinuousAcquisition();
+
+  /**
+   * @brief Let the camera acquire images directly into a ring of application-owned buffers.
+   *
+   * The buffers are sized after the current `PayloadSize` of the camera. Images acquired in user
+   * buffers can be exposed without copy via @ref shareImageData(). Calling this method again
+   * replaces the ring. The ring is re-allocated after any write changing the frame size (sensor
+   * area, binning, pixel format) through @ref setParam() or @ref setMultiParam(), which must thus
+   * happen while the camera is not acquiring.
+   *
+   * @param numBuffers Number of buffers in the ring. The camera drops frames when all the buffers
+   *                   are held by the application.
+   * @throws NeoAPI::NeoException if the camera does not support user buffers.
+   */
+  void enableUserBuffers(size_t numBuffers = DEFAULT_USER_BUFFER_COUNT);
+
+  /**
+   * @brief Let the camera acquire images into its internally allocated buffers again.
+   */
+  void disableUserBuffers();
+
+  /**
+   * @brief Whether the camera acquires images into user buffers.
+   */
+  bool usesUserBuffers() const;
+
+  /**
+   * @brief Expose the bytes of an image acquired in a user buffer, without copying them.
+   *
+   * The returned storage keeps a copy of @p image alive, so that the camera re-uses the buffer
+   * only once the storage (and all its copies) are released.
+   *
+   * @param image Image acquired by this interface.
+   * @return The shared storage of the image bytes, or `nullptr` if the image was not acquired in
+   *         a user buffer of the current ring (in which case the bytes must be copied).
+   */
+  UserBufferRing::storage_t shareImageData(const image_t& image) const;
+
+  /**
+   * @brief Returns the host time at which the exposure of an image started.
+   *
+   * The device timestamp of the image is mapped onto the host clock (see @ref deviceClock()),
+   * which is synchronized first if its last synchronization is older than
+   * @ref CLOCK_SYNC_PERIOD. Unlike the time at which the image is received, this timestamp does
+   * not depend on the transfer, nor on the processing delays on the host.
+   *
+   * @param image Image acquired by this interface.
+   * @return The host time of the exposure start, or the current time if the image carries no
+   *         device timestamp, or if the device clock can't be synchronized.
+   */
+  irsol::types::timepoint_t imageTimestamp(const image_t& image);
+
+  /**
+   * @brief Adds a synchronization sample to the mapping of the device clock.
+   *
+   * The device timestamp counter is latched (via the `TimestampLatch` command), and paired with
+   * the host time at which the latch was performed.
+   *
+   * After a failure (e.g. the camera doesn't support timestamp latches), the synchronization is
+   * skipped until @ref CLOCK_SYNC_RETRY_PERIOD has elapsed, and only the first of consecutive
+   * failures is logged as a warning.
+   *
+   * @return true if the sample was added, false if it failed or was skipped.
+   */
+  bool synchronizeClock();
+
+  /**
+   * @brief Mapping of the device timestamp counter onto the host clock.
+   */
+  const DeviceClock& deviceClock() const;
+
 private:
   /// Mutex to protect access to camera parameters and image acquisition.
   mutable std::mutex m_camMutex;
@@ -269,12 +592,106 @@ private:
   /// irsol::camera::Interface::captureImage().
   irsol::types::duration_t m_CachedExposureTime;
 
+  /// Mapping of the device timestamps onto the host clock.
+  DeviceClock m_deviceClock;
+
+  /// Time before which the device clock is not synchronized again, set after a failure.
+  /// Protected by @ref m_camMutex.
+  std::optional<irsol::types::timepoint_t> m_nextClockSyncRetry;
+
+  /// Whether the last synchronization of the device clock failed. Protected by @ref m_camMutex.
+  bool m_clockSyncFailed{false};
+
+  /// Driver-side user buffer operations on @ref m_cam, set while user buffers are enabled.
+  std::unique_ptr<UserBufferDriver> m_userBufferDriver;
+
+  /// Ring of user buffers the camera acquires into, set while user buffers are enabled.
+  std::unique_ptr<UserBufferRing> m_userBuffers;
+
+  /// Driver-side callback of the triggered acquisition, set while it is active.
+  std::unique_ptr<NeoAPI::NeoImageCallback> m_imageCallback;
+
+  /// Handles of the features of @ref m_cam resolved so far, protected by @ref m_camMutex.
+  mutable FeatureCache<NeoAPI::Cam> m_features;
+
+  /// Last values read from the camera. Updated while holding @ref m_camMutex.
+  mutable ParameterShadow m_shadow{volatileFeatures()};
+
+  /// Refresh periods of @ref VOLATILE_FEATURES.
+  static std::vector<ParameterShadow::refresh_t> volatileFeatures();
+
+  /**
+   * @brief Internal, non-thread-safe accessor to the (cached) handle of a feature.
+   *
+   * @param feature Identifier of the feature.
+   * @return The handle of the feature.
+   * @throws NeoAPI::NeoException if the camera has no such feature.
+   */
+  NeoAPI::Feature& featureNonThreadSafe(const FeatureId& feature) const;
+
+  /**
+   * @brief Internal, non-thread-safe parameter getter, served by the shadow if possible.
+   *
+   * @tparam T Representation of the value.
+   * @param feature Identifier of the parameter.
+   * @return The value of the parameter, stored in the shadow.
+   * @throws NeoAPI::NeoException if the parameter can't be read.
+   */
+  template<typename T>
+  T readParamNonThreadSafe(const FeatureId& feature) const;
+
+  /**
+   * @brief Internal, non-thread-safe version of @ref getParam(const FeatureId&) const.
+   *
+   * @return The value of the parameter, or a default on read error.
+   */
+  template<typename T>
+  T getParamNonThreadSafe(const FeatureId& feature) const;
+
+  /**
+   * @brief Internal, non-thread-safe invalidation of the features affected by a write.
+   *
+   * Only the shadowed values of the features preceding @p feature in @ref dependencyOrder() are
+   * kept.
+   *
+   * @param feature Identifier of the written feature.
+   */
+  void invalidateDependentsNonThreadSafe(const FeatureId& feature) const;
+
+  /**
+   * @brief Internal, non-thread-safe re-allocation of the user buffers after a write changing the
+   * frame size.
+   *
+   * Nothing is done if user buffers are disabled, or if their size matches the `PayloadSize` of
+   * the camera.
+   */
+  void refitUserBuffersNonThreadSafe();
+
   /**
    * @brief Internal, non-thread-safe parameter setter used by `setParam`.
    *
    * @tparam T Parameter value type.
    * @param param Name of the parameter.
    * @param value Value to assign.
+   * @return true if the value was written, false otherwise.
+   */
+  template<
+    typename T,
+    std::enable_if_t<
+      std::is_integral_v<std::decay_t<T>> || std::is_floating_point_v<std::decay_t<T>> ||
+        std::is_same_v<std::decay_t<T>, std::string> ||
+        std::is_same_v<std::decay_t<T>, const char*>,
+      int> = 0>
+  bool setParamNonThreadSafe(const std::string& param, T value);
+
+  /**
+   * @brief Internal, non-thread-safe parameter setter, for a feature identified by its interned
+   * name.
+   *
+   * @tparam T Parameter value type.
+   * @param feature Identifier of the parameter.
+   * @param value Value to assign.
+   * @return true if the value was written, false otherwise.
    */
   template<
     typename T,
@@ -283,7 +700,7 @@ private:
         std::is_same_v<std::decay_t<T>, std::string> ||
         std::is_same_v<std::decay_t<T>, const char*>,
       int> = 0>
-  void setParamNonThreadSafe(const std::string& param, T value);
+  bool setParamNonThreadSafe(const FeatureId& feature, T value);
 };
 
 }  // namespace camera
@@ -16,28 +16,61 @@ template<
     int>>
 T
 Interface::getParam(const std::string& param) const
+{
+  return getParam<T>(FeatureId(param));
+}
+
+template<
+  typename T,
+  std::enable_if_t<
+    std::is_integral_v<T> || std::is_floating_point_v<T> || std::is_same_v<std::string, T>,
+    int>>
+T
+Interface::getParam(const FeatureId& feature) const
+{
+  if(auto shadowed = m_shadow.get<std::decay_t<T>>(feature)) {
+    return *shadowed;
+  }
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+  return getParamNonThreadSafe<T>(feature);
+}
+
+template<typename T>
+T
+Interface::readParamNonThreadSafe(const FeatureId& featureId) const
 {
   using U = std::decay_t<T>;
-  IRSOL_LOG_DEBUG("Getting parameter '{}'", param);
-  try {
-    std::scoped_lock<std::mutex> lock(m_camMutex);
-    NeoAPI::NeoString            neoParam(param.c_str());
-    auto                         feature = m_cam.GetFeature(neoParam);
+  if(auto shadowed = m_shadow.get<U>(featureId)) {
+    return *shadowed;
+  }
+  IRSOL_LOG_DEBUG("Getting parameter '{}'", featureId.name());
+  auto& feature = featureNonThreadSafe(featureId);
 
-    if constexpr(std::is_same_v<U, std::string>) {
-      return std::string(feature.GetString());
-    } else if constexpr(std::is_same_v<U, bool>) {
-      return feature.GetBool();
-    } else if constexpr(std::is_integral_v<U>) {
-      return static_cast<T>(feature.GetInt());
-    } else if constexpr(std::is_floating_point_v<U>) {
-      return static_cast<T>(feature.GetDouble());
-    } else {
-      IRSOL_MISSING_TEMPLATE_SPECIALIZATION(T, "Interface::getParam()");
-    }
+  U value;
+  if constexpr(std::is_same_v<U, std::string>) {
+    value = std::string(feature.GetString());
+  } else if constexpr(std::is_same_v<U, bool>) {
+    value = feature.GetBool();
+  } else if constexpr(std::is_integral_v<U>) {
+    value = static_cast<U>(feature.GetInt());
+  } else if constexpr(std::is_floating_point_v<U>) {
+    value = static_cast<U>(feature.GetDouble());
+  } else {
+    IRSOL_MISSING_TEMPLATE_SPECIALIZATION(T, "Interface::readParamNonThreadSafe()");
+  }
+  m_shadow.store(featureId, value);
+  return value;
+}
+
+template<typename T>
+T
+Interface::getParamNonThreadSafe(const FeatureId& feature) const
+{
+  try {
+    return readParamNonThreadSafe<T>(feature);
   } catch(const std::exception& e) {
-    IRSOL_LOG_ERROR("Failed to get parameter '{}': {}", param, e.what());
-    if constexpr(std::is_same_v<U, std::string>) {
+    IRSOL_LOG_ERROR("Failed to get parameter '{}': {}", feature.name(), e.what());
+    if constexpr(std::is_same_v<std::decay_t<T>, std::string>) {
       return "Unknown";
     } else {
       return T{};
@@ -54,12 +87,29 @@ template<
 T
 Interface::setParam(const std::string& param, T value)
 {
-  IRSOL_LOG_DEBUG("Setting parameter '{}' to value '{}'", param, value);
-  {
-    std::scoped_lock<std::mutex> lock(m_camMutex);
-    setParamNonThreadSafe(param, value);
+  return setParam<T>(FeatureId(param), value);
+}
+
+template<
+  typename T,
+  std::enable_if_t<
+    std::is_integral_v<std::decay_t<T>> || std::is_floating_point_v<std::decay_t<T>> ||
+      std::is_same_v<std::decay_t<T>, std::string>,
+    int>>
+T
+Interface::setParam(const FeatureId& feature, T value)
+{
+  using U = std::decay_t<T>;
+  IRSOL_LOG_DEBUG("Setting parameter '{}' to value '{}'", feature.name(), value);
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+  if(auto shadowed = m_shadow.get<U>(feature); shadowed && *shadowed == value) {
+    IRSOL_LOG_TRACE("Parameter '{}' is already set to '{}'", feature.name(), value);
+    return *shadowed;
   }
-  return getParam<std::decay_t<T>>(param);
+  if(setParamNonThreadSafe(feature, value) && affectsPayloadSize(feature.name())) {
+    refitUserBuffersNonThreadSafe();
+  }
+  return getParamNonThreadSafe<U>(feature);
 }
 
 template<typename T, std::enable_if_t<std::is_same_v<std::decay_t<T>, const char*>, int> = 0>
@@ -75,13 +125,25 @@ template<
     std::is_integral_v<std::decay_t<T>> || std::is_floating_point_v<std::decay_t<T>> ||
       std::is_same_v<std::decay_t<T>, std::string> || std::is_same_v<std::decay_t<T>, const char*>,
     int> = 0>
-void
+bool
 Interface::setParamNonThreadSafe(const std::string& param, T value)
 {
-  using U = std::decay_t<T>;
+  return setParamNonThreadSafe(FeatureId(param), value);
+}
+
+template<
+  typename T,
+  std::enable_if_t<
+    std::is_integral_v<std::decay_t<T>> || std::is_floating_point_v<std::decay_t<T>> ||
+      std::is_same_v<std::decay_t<T>, std::string> || std::is_same_v<std::decay_t<T>, const char*>,
+    int>>
+bool
+Interface::setParamNonThreadSafe(const FeatureId& featureId, T value)
+{
+  using U           = std::decay_t<T>;
+  const auto& param = featureId.name();
   try {
-    NeoAPI::NeoString neoParam(param.c_str());
-    auto              feature = m_cam.GetFeature(neoParam);
+    auto& feature = featureNonThreadSafe(featureId);
 
     // Make sure the feature is writable
     if(!feature.IsWritable()) {
@@ -102,9 +164,12 @@ Interface::setParamNonThreadSafe(const std::string& param, T value)
     } else {
       IRSOL_MISSING_TEMPLATE_SPECIALIZATION(T, "Interface::setParamNonThreadSafe()");
     }
-
+    // Writing a feature may change others (e.g. the binning changes the width).
+    invalidateDependentsNonThreadSafe(featureId);
+    return true;
   } catch(const std::exception& e) {
     IRSOL_LOG_ERROR("Failed to set parameter '{}': {}", param, e.what());
+    return false;
   }
 }
 
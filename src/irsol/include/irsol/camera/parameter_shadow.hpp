@@ -0,0 +1,175 @@
+/**
+ * @file irsol/camera/parameter_shadow.hpp
+ * @brief Shadow copy of the values of the camera features.
+ *
+ * Reading a feature of the camera is a round-trip over the transport layer (e.g. USB), which also
+ * competes with the acquisition for the camera. The @ref irsol::camera::ParameterShadow keeps
+ * the last value read from (or written to) each feature, so that repeated reads, e.g. by polling
+ * clients or by the @ref irsol::camera::StatusMonitor, are served from memory.
+ */
+
+#pragma once
+
+#include "irsol/camera/feature_cache.hpp"
+#include "irsol/types.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace irsol {
+namespace camera {
+
+/**
+ * @brief Read-through shadow copy of the values of the camera features.
+ *
+ * Values are stored per feature, in each of the representations they were read as (boolean,
+ * integer, floating point or string). A value stays valid until the shadow is invalidated, which
+ * the owner does whenever it writes to the camera, as a write may affect other features (e.g. the
+ * binning changes the width), see @ref invalidateAllBut(). Volatile features (e.g. the device
+ * temperature) are given a refresh period instead: their values expire once older than the
+ * period, and are then read from the camera again.
+ *
+ * Thread-safe. Lookups only hold an internal lock for the time of a copy of the value.
+ */
+class ParameterShadow
+{
+public:
+  /// Refresh period of a volatile feature.
+  using refresh_t = std::pair<FeatureId, irsol::types::duration_t>;
+
+  /**
+   * @brief Constructs an empty shadow.
+   * @param volatileFeatures Volatile features, and their refresh period.
+   */
+  explicit ParameterShadow(const std::vector<refresh_t>& volatileFeatures = {});
+
+  /**
+   * @brief Returns the shadowed value of a feature, in the representation @p T.
+   *
+   * @param feature Identifier of the feature.
+   * @param now     Current time, to check the refresh period of volatile features.
+   * @return The value, or `std::nullopt` if the feature must be read from the camera.
+   */
+  template<typename T>
+  std::optional<T> get(
+    const FeatureId&          feature,
+    irsol::types::timepoint_t now = irsol::types::clock_t::now()) const
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    const auto*                  entry = validEntry(feature, now);
+    std::optional<T>             result;
+    if(entry) {
+      if constexpr(std::is_same_v<T, std::string>) {
+        result = entry->text;
+      } else if constexpr(std::is_same_v<T, bool>) {
+        result = entry->boolean;
+      } else if constexpr(std::is_integral_v<T>) {
+        if(entry->integer) {
+          result = static_cast<T>(*entry->integer);
+        }
+      } else if constexpr(std::is_floating_point_v<T>) {
+        if(entry->real) {
+          result = static_cast<T>(*entry->real);
+        }
+      }
+    }
+    ++(result ? m_numHits : m_numMisses);
+    return result;
+  }
+
+  /**
+   * @brief Stores the value of a feature, as read from the camera.
+   *
+   * @param feature Identifier of the feature.
+   * @param value   Value of the feature, in the representation @p T.
+   * @param now     Time at which the value was read.
+   */
+  template<typename T>
+  void store(
+    const FeatureId&          feature,
+    const T&                  value,
+    irsol::types::timepoint_t now = irsol::types::clock_t::now())
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    auto&                        entry = freshEntry(feature, now);
+    if constexpr(std::is_same_v<T, std::string>) {
+      entry.text = value;
+    } else if constexpr(std::is_same_v<T, bool>) {
+      entry.boolean = value;
+    } else if constexpr(std::is_integral_v<T>) {
+      entry.integer = static_cast<int64_t>(value);
+    } else if constexpr(std::is_floating_point_v<T>) {
+      entry.real = static_cast<double>(value);
+    }
+  }
+
+  /// Forgets the values of all the features.
+  void invalidate();
+
+  /**
+   * @brief Forgets the values of all the features, except the given ones.
+   * @param kept Features whose values are kept.
+   */
+  void invalidateAllBut(const std::vector<FeatureId>& kept);
+
+  /**
+   * @brief Sets the refresh period of a feature.
+   *
+   * @param feature Identifier of the feature.
+   * @param period  Maximum age of the value of the feature, `std::nullopt` if the feature only
+   *                changes when written to.
+   */
+  void setRefreshPeriod(
+    const FeatureId&                        feature,
+    std::optional<irsol::types::duration_t> period);
+
+  /// Number of lookups served by the shadow.
+  uint64_t numHits() const;
+
+  /// Number of lookups that had to be read from the camera.
+  uint64_t numMisses() const;
+
+private:
+  /// Shadowed values of a feature.
+  struct Entry
+  {
+    std::optional<bool>        boolean;  ///< Value as a boolean, if read as such.
+    std::optional<int64_t>     integer;  ///< Value as an integer, if read as such.
+    std::optional<double>      real;     ///< Value as a floating point number, if read as such.
+    std::optional<std::string> text;     ///< Value as a string, if read as such.
+    irsol::types::timepoint_t  fetched;  ///< Time at which the values were read.
+
+    /// Refresh period of the feature, `std::nullopt` if it's not volatile.
+    std::optional<irsol::types::duration_t> refreshPeriod;
+
+    /// Whether the entry holds any value.
+    bool empty() const;
+
+    /// Forgets the values of the entry, keeping its refresh period.
+    void clear();
+  };
+
+  /// Returns the entry of a feature, if it holds values not older than its refresh period.
+  const Entry* validEntry(const FeatureId& feature, irsol::types::timepoint_t now) const;
+
+  /// Returns the entry of a feature, after discarding its values if they expired.
+  Entry& freshEntry(const FeatureId& feature, irsol::types::timepoint_t now);
+
+  /// Returns the entry of a feature, allocating it if needed.
+  Entry& entryOf(const FeatureId& feature);
+
+  mutable std::mutex m_mutex;    ///< Protects the entries.
+  std::vector<Entry> m_entries;  ///< Shadowed values, indexed by feature ID.
+
+  mutable std::atomic<uint64_t> m_numHits{0};    ///< Number of lookups served by the shadow.
+  mutable std::atomic<uint64_t> m_numMisses{0};  ///< Number of lookups not served by the shadow.
+};
+
+}  // namespace camera
+}  // namespace irsol
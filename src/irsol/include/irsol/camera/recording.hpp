@@ -0,0 +1,137 @@
+/**
+ * @file irsol/camera/recording.hpp
+ * @brief Files of recorded camera frames.
+ *
+ * A recording holds a sequence of Mono12 frames, together with their frame IDs and timestamps, as
+ * captured from a camera. It is written by the @ref irsol::camera::RecordingWriter, and read back
+ * by the @ref irsol::camera::RecordingReader, e.g. to replay the frames to the clients of the
+ * server (see @ref irsol::camera::ReplayCamera).
+ *
+ * File layout (all the integers are stored in the native byte order of the host):
+ * - header: the magic string `IRSOLREC`, the format version (`uint32_t`), the exposure time of the
+ *   frames in microseconds (`int64_t`), the length of the serial number of the camera
+ *   (`uint32_t`) followed by its characters;
+ * - one record per frame: the frame ID (`uint64_t`), the timestamp in nanoseconds of the
+ *   @ref irsol::types::clock_t (`int64_t`), the width and height (`uint64_t`), the size of the
+ *   image in bytes (`uint64_t`) followed by the image bytes.
+ */
+
+#pragma once
+
+#include "irsol/buffer_pool.hpp"
+#include "irsol/types.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+
+namespace irsol {
+namespace camera {
+
+/// Description of the camera a recording was captured with.
+struct RecordingHeader
+{
+  std::string              serialNumber;  ///< Serial number of the camera.
+  irsol::types::duration_t exposure;      ///< Exposure time of the frames.
+};
+
+/// A frame read from a recording.
+struct RecordedFrame
+{
+  uint64_t                           frameId;    ///< Frame ID, as assigned by the camera.
+  irsol::types::timepoint_t          timestamp;  ///< Time at which the frame was captured.
+  uint64_t                           width;      ///< Width of the image, in pixels.
+  uint64_t                           height;     ///< Height of the image, in pixels.
+  irsol::utils::BufferPool::buffer_t data;       ///< Bytes of the image.
+};
+
+/**
+ * @brief Writes frames into a recording file.
+ *
+ * Not thread-safe.
+ */
+class RecordingWriter
+{
+public:
+  /**
+   * @brief Creates (or truncates) a recording file, and writes its header.
+   *
+   * @param path   Path of the file.
+   * @param header Description of the camera the frames are captured with.
+   * @throws std::runtime_error if the file can't be written.
+   */
+  RecordingWriter(const std::string& path, const RecordingHeader& header);
+
+  /**
+   * @brief Appends a frame to the recording.
+   *
+   * @param frameId   Frame ID, as assigned by the camera.
+   * @param timestamp Time at which the frame was captured.
+   * @param width     Width of the image, in pixels.
+   * @param height    Height of the image, in pixels.
+   * @param data      Bytes of the image.
+   * @param numBytes  Size of the image, in bytes.
+   * @throws std::runtime_error if the frame can't be written.
+   */
+  void write(
+    uint64_t                    frameId,
+    irsol::types::timepoint_t   timestamp,
+    uint64_t                    width,
+    uint64_t                    height,
+    const irsol::types::byte_t* data,
+    size_t                      numBytes);
+
+  /// Number of frames written so far.
+  uint64_t numFrames() const;
+
+private:
+  std::ofstream m_file;          ///< Recording file.
+  std::string   m_path;          ///< Path of the recording file.
+  uint64_t      m_numFrames{0};  ///< Number of frames written so far.
+};
+
+/**
+ * @brief Reads the frames of a recording file, in order.
+ *
+ * Not thread-safe.
+ */
+class RecordingReader
+{
+public:
+  /// Version of the file format written by the @ref irsol::camera::RecordingWriter.
+  static constexpr uint32_t FORMAT_VERSION = 1;
+
+  /**
+   * @brief Opens a recording file, and reads its header.
+   *
+   * @param path Path of the file.
+   * @throws std::runtime_error if the file can't be read, or is not a recording.
+   */
+  explicit RecordingReader(const std::string& path);
+
+  /// Description of the camera the frames were captured with.
+  const RecordingHeader& header() const;
+
+  /**
+   * @brief Reads the next frame of the recording.
+   *
+   * @param pool Pool providing the buffer of the image.
+   * @return The frame, or `std::nullopt` at the end of the recording.
+   * @throws std::runtime_error if the recording is truncated or corrupted.
+   */
+  std::optional<RecordedFrame> next(
+    irsol::utils::BufferPool& pool = irsol::utils::BufferPool::global());
+
+  /// Goes back to the first frame of the recording.
+  void rewind();
+
+private:
+  std::ifstream   m_file;        ///< Recording file.
+  std::string     m_path;        ///< Path of the recording file.
+  RecordingHeader m_header;      ///< Header of the recording.
+  std::streampos  m_firstFrame;  ///< Position of the first frame record.
+};
+
+}  // namespace camera
+}  // namespace irsol
@@ -0,0 +1,165 @@
+/**
+ * @file irsol/camera/replay_camera.hpp
+ * @brief Camera backend replaying recorded frames.
+ *
+ * The @ref irsol::camera::ReplayCamera streams the frames of recordings (see
+ * @ref irsol/camera/recording.hpp), e.g. real solar images captured in production, so that the
+ * server, its serialization and any processing stage can be exercised deterministically on
+ * realistic pixel data, without hardware.
+ */
+
+#pragma once
+
+#include "irsol/buffer_pool.hpp"
+#include "irsol/camera/backend.hpp"
+#include "irsol/camera/recording.hpp"
+#include "irsol/types.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace irsol {
+namespace camera {
+
+/**
+ * @brief Camera backend replaying the frames of recordings, in order.
+ *
+ * The recordings are read from a single file, or from all the files of a directory, in the order
+ * of their names. Once all the frames were replayed, the replay starts over from the first one.
+ *
+ * The frame IDs of the recorded frames are preserved: on later passes over the recordings, they
+ * are shifted so that the first frame of a pass follows the last frame of the previous pass. The
+ * intervals between the timestamps of the frames of a recording are preserved as well, while the
+ * timestamps themselves are moved onto the timeline of the replay (the clock of the recording host
+ * is unrelated to the clock of the replaying host). The first frame of a recording follows the
+ * last frame of the previous one by the mean frame interval of the latter.
+ *
+ * The parameters of the recorded frames can't be changed: the writes are rejected, and the reads
+ * describe the last replayed frame (`Width`, `Height`, `ExposureTime`, `FrameCounter`).
+ *
+ * The parameters are thread-safe. The acquisition methods must be called from a single thread
+ * (e.g. the acquisition thread of a frame collector).
+ */
+class ReplayCamera : public Backend
+{
+public:
+  /// Pace at which the recorded frames are replayed.
+  enum class Pacing
+  {
+    /// Each frame is produced at its recorded time, relative to the first frame.
+    ORIGINAL,
+    /// Each frame is produced as soon as it's requested, and timestamped with the current time.
+    AS_FAST_AS_POSSIBLE
+  };
+
+  /**
+   * @brief Opens the recordings to replay.
+   *
+   * @param path   Path of a recording file, or of a directory of recording files.
+   * @param pacing Pace at which the frames are replayed.
+   * @param pool   Pool providing the buffers of the replayed frames.
+   * @throws std::runtime_error if no recording can be read from @p path.
+   */
+  ReplayCamera(
+    const std::string&        path,
+    Pacing                    pacing = Pacing::ORIGINAL,
+    irsol::utils::BufferPool& pool   = irsol::utils::BufferPool::global());
+
+  std::string              serialNumber() const override;
+  std::string              cameraStatusAsString() const override;
+  irsol::types::duration_t getExposure() const override;
+  irsol::types::duration_t setExposure(irsol::types::duration_t exposure) override;
+  irsol::types::duration_t cachedExposure() const override;
+  int64_t                  getIntParam(const std::string& param) const override;
+  int64_t                  setIntParam(const std::string& param, int64_t value) override;
+
+  /**
+   * @brief Produces the next recorded frame.
+   *
+   * With @ref Pacing::ORIGINAL, waits until the recorded time of the frame. The first frame is
+   * produced at once, and defines the start of the timeline of the replay.
+   *
+   * @return The frame, whose timestamp and frame ID are moved onto the replay (see the class
+   *         description).
+   * @throws std::runtime_error if a recording can't be read.
+   */
+  RecordedFrame next();
+
+  /// Paths of the replayed recordings, in replay order.
+  const std::vector<std::string>& recordings() const;
+
+  /// Number of frames replayed so far.
+  uint64_t numReplayedFrames() const;
+
+  /// Number of completed passes over all the recordings.
+  uint64_t numPasses() const;
+
+private:
+  /// Consecutive frames of a recording, replayed on a common timeline.
+  struct Segment
+  {
+    irsol::types::timepoint_t recordedStart;  ///< Recorded timestamp of the first frame.
+    irsol::types::timepoint_t replayStart;    ///< Replay time of the first frame.
+    irsol::types::timepoint_t recordedLast;   ///< Recorded timestamp of the last frame.
+    uint64_t                  numFrames;      ///< Number of frames replayed so far.
+  };
+
+  /**
+   * @brief Internal, non-thread-safe reader of the next recorded frame.
+   *
+   * Goes to the next recording when the current one ends, starting a new segment, and to the
+   * first recording once all were replayed, starting a new pass.
+   */
+  RecordedFrame readNextNonThreadSafe();
+
+  /// Paths of the replayed recordings, in replay order.
+  std::vector<std::string> m_recordings;
+
+  /// Pace at which the frames are replayed.
+  const Pacing m_pacing;
+
+  /// Pool providing the buffers of the replayed frames.
+  irsol::utils::BufferPool& m_pool;
+
+  /// Mutex to protect the state of the replay.
+  mutable std::mutex m_mutex;
+
+  /// Header of the first recording, describing the camera.
+  RecordingHeader m_header;
+
+  /// Reader of the current recording.
+  std::unique_ptr<RecordingReader> m_reader;
+
+  /// Index of the current recording in @ref m_recordings.
+  size_t m_recordingIndex{0};
+
+  /// Current segment, `std::nullopt` until its first frame is replayed.
+  std::optional<Segment> m_segment;
+
+  /// Whether the next frame starts a new pass over the recordings.
+  bool m_newPass{false};
+
+  /// Shift of the frame IDs of the current pass.
+  uint64_t m_idShift{0};
+
+  /// Number of frames replayed so far.
+  uint64_t m_numReplayedFrames{0};
+
+  /// Number of completed passes over all the recordings.
+  uint64_t m_numPasses{0};
+
+  /// Replay time of the last frame, and the mean interval between the frames of its segment.
+  std::optional<std::pair<irsol::types::timepoint_t, irsol::types::duration_t>> m_lastReplay;
+
+  uint64_t m_lastFrameId{0};  ///< Frame ID of the last replayed frame.
+  uint64_t m_lastWidth{0};    ///< Width of the last replayed frame.
+  uint64_t m_lastHeight{0};   ///< Height of the last replayed frame.
+};
+
+}  // namespace camera
+}  // namespace irsol
@@ -0,0 +1,296 @@
+/**
+ * @file irsol/camera/simulated_camera.hpp
+ * @brief Simulated camera, implementing the @ref irsol::camera::Backend without hardware.
+ *
+ * The @ref irsol::camera::SimulatedCamera behaves as a Mono12 sensor behind the GenICam features
+ * used by the server: its region of interest and binning constrain each other as on the camera,
+ * its captures last the exposure time plus the readout of the region of interest, and it produces
+ * frames with increasing frame IDs, either on trigger or free-running at a configurable rate. Its
+ * triggered acquisition follows the timing model of @ref irsol::camera::TriggerTiming. It
+ * lets the full server path (collector, handlers, clients) be exercised and benchmarked on any
+ * machine.
+ */
+
+#pragma once
+
+#include "irsol/camera/backend.hpp"
+#include "irsol/camera/trigger_timing.hpp"
+#include "irsol/types.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace irsol {
+namespace camera {
+
+/**
+ * @brief Simulated Mono12 camera.
+ *
+ * Supported integer features:
+ * - `Width`, `Height`, `OffsetX`, `OffsetY`: region of interest, in binned pixels. Sizes and
+ *   offsets are rounded down to @ref Config::roiIncrement, and clamped so that the region stays
+ *   within the (binned) sensor.
+ * - `BinningHorizontal`, `BinningVertical`: binning factors, between 1 and @ref Config::maxBinning.
+ *   Changing the binning rescales the region of interest, so that it covers the same sensor area.
+ * - `ExposureTime`: exposure, in microseconds.
+ * - `WidthMax`, `HeightMax`, `SensorWidth`, `SensorHeight`, `FrameCounter`: read-only.
+ *
+ * A capture lasts the exposure time plus the readout time, the latter being proportional to the
+ * height of the region of interest (see @ref readoutTime()). A free-running acquisition produces
+ * frames on a regular time grid, whose period is bounded by the duration of a capture. Frames
+ * missed by a slow consumer are dropped, as the camera would, and their frame IDs are skipped.
+ *
+ * The triggered acquisition (see @ref startTriggered()) reads the frames out on a background
+ * thread, as the callback thread of a camera driver would. The triggers arriving while the camera
+ * is not ready (see @ref irsol::camera::TriggerTiming) are skipped, as on a camera.
+ *
+ * The parameters are thread-safe. The acquisition methods must be called from a single thread
+ * (e.g. the acquisition thread of a frame collector).
+ */
+class SimulatedCamera : public Backend
+{
+public:
+  /// Default exposure time of the camera.
+  static constexpr irsol::types::duration_t DEFAULT_EXPOSURE_TIME = std::chrono::milliseconds(2);
+
+  /// Static characteristics of the simulated camera.
+  struct Config
+  {
+    /// Serial number of the camera.
+    std::string serialNumber{"SIM-0000"};
+    /// Width of the sensor, in pixels.
+    uint64_t sensorWidth{2880};
+    /// Height of the sensor, in pixels.
+    uint64_t sensorHeight{2160};
+    /// Increment of the sizes and offsets of the region of interest.
+    uint64_t roiIncrement{4};
+    /// Highest binning factor, in each direction.
+    uint64_t maxBinning{4};
+    /// Time needed to read out one row of the region of interest.
+    irsol::types::duration_t lineTime{std::chrono::microseconds(5)};
+    /// Shortest exposure time.
+    irsol::types::duration_t minExposure{std::chrono::microseconds(20)};
+    /// Longest exposure time.
+    irsol::types::duration_t maxExposure{std::chrono::seconds(10)};
+    /// Whether overlapped triggering is enabled initially, see @ref setTriggerOverlap().
+    bool triggerOverlap{false};
+  };
+
+  /// Identity and geometry of a frame produced by the camera.
+  struct Frame
+  {
+    uint64_t                  frameId;            ///< Frame ID, as counted by the camera.
+    irsol::types::timepoint_t timestamp;          ///< Time at which the exposure started.
+    uint64_t                  width;              ///< Width of the frame, in binned pixels.
+    uint64_t                  height;             ///< Height of the frame, in binned pixels.
+    uint64_t                  offsetX;            ///< Horizontal offset, in binned pixels.
+    uint64_t                  offsetY;            ///< Vertical offset, in binned pixels.
+    uint64_t                  binningHorizontal;  ///< Horizontal binning factor.
+    uint64_t                  binningVertical;    ///< Vertical binning factor.
+
+    /// Size of the Mono12 image, stored on 2 bytes per pixel.
+    size_t numBytes() const
+    {
+      return width * height * sizeof(uint16_t);
+    }
+  };
+
+  /// Callback receiving the frames of a triggered acquisition, once read out.
+  using frame_callback_t = std::function<void(const Frame&)>;
+
+  /// Constructs a camera with the default characteristics, see @ref Config.
+  SimulatedCamera();
+
+  /**
+   * @brief Constructs a camera, whose region of interest covers the whole (unbinned) sensor.
+   *
+   * The exposure is @ref DEFAULT_EXPOSURE_TIME.
+   *
+   * @param config Static characteristics of the camera.
+   */
+  explicit SimulatedCamera(Config config);
+
+  /// Stops the triggered acquisition, if active.
+  ~SimulatedCamera() override;
+
+  std::string              serialNumber() const override;
+  std::string              cameraStatusAsString() const override;
+  irsol::types::duration_t getExposure() const override;
+  irsol::types::duration_t setExposure(irsol::types::duration_t exposure) override;
+  irsol::types::duration_t cachedExposure() const override;
+  int64_t                  getIntParam(const std::string& param) const override;
+  int64_t                  setIntParam(const std::string& param, int64_t value) override;
+
+  /// Time needed to read out a frame of the current region of interest.
+  irsol::types::duration_t readoutTime() const;
+
+  /// Duration of a single capture (exposure and readout) with the current parameters.
+  irsol::types::duration_t captureTime() const;
+
+  /**
+   * @brief Enables (or disables) overlapped triggering.
+   *
+   * @param enable Whether the exposure of a frame may overlap the readout of the previous one.
+   */
+  void setTriggerOverlap(bool enable);
+
+  /// Timing of the triggered captures with the current parameters.
+  TriggerTiming triggerTiming() const;
+
+  /**
+   * @brief Triggers and captures a single frame.
+   *
+   * Blocks for @ref captureTime().
+   */
+  Frame captureSingle();
+
+  /**
+   * @brief Starts (or restarts with a new rate) a free-running acquisition.
+   *
+   * @param fps Rate at which frames are produced. If `fps <= 0`, or if the rate is higher than
+   *            allowed by @ref captureTime(), frames are produced as fast as the camera allows.
+   */
+  void startContinuous(double fps);
+
+  /**
+   * @brief Waits for the next frame produced by the free-running acquisition.
+   *
+   * The period of the acquisition follows the changes of the parameters (e.g. a longer exposure
+   * lowers the frame rate).
+   */
+  Frame nextContinuous();
+
+  /// Stops the free-running acquisition.
+  void stopContinuous();
+
+  /**
+   * @brief Starts a triggered acquisition.
+   *
+   * @param callback Receives each frame once it's read out, on a background thread.
+   */
+  void startTriggered(frame_callback_t callback);
+
+  /**
+   * @brief Triggers the capture of a frame, without waiting for it.
+   *
+   * Thread-safe. The exposure starts at once, if the camera is ready for a new trigger.
+   *
+   * @return false if the trigger is skipped, as the camera is not ready.
+   */
+  bool submitTrigger();
+
+  /**
+   * @brief Stops the triggered acquisition.
+   *
+   * The frames not read out yet are discarded. Once this method returns, the callback is no
+   * longer called.
+   */
+  void stopTriggered();
+
+  /// Number of triggers skipped as they arrived while the camera was not ready.
+  uint64_t numSkippedTriggers() const;
+
+  /// Number of frames dropped by the free-running acquisitions, as not waited for in time.
+  uint64_t numDroppedFrames() const;
+
+  /**
+   * @brief Writes the Mono12 pixels of a frame.
+   *
+   * The value of each pixel depends on its (unbinned) sensor coordinates and on the frame ID, so
+   * that the region of interest and the identity of a frame can be checked from its content.
+   *
+   * @param frame Frame to render.
+   * @param data  Destination of the image, of at least @ref Frame::numBytes() bytes.
+   */
+  static void render(const Frame& frame, irsol::types::byte_t* data);
+
+  /**
+   * @brief Value of a pixel, as written by @ref render().
+   *
+   * @param frame Frame the pixel belongs to.
+   * @param x     Column of the pixel in the frame.
+   * @param y     Row of the pixel in the frame.
+   * @return The 12-bit value of the pixel.
+   */
+  static uint16_t pixelValue(const Frame& frame, uint64_t x, uint64_t y);
+
+private:
+  /// Internal, non-thread-safe parameter setter, applying the constraints of the features.
+  int64_t setIntParamNonThreadSafe(const std::string& param, int64_t value);
+
+  /// Internal, non-thread-safe version of @ref captureTime().
+  irsol::types::duration_t captureTimeNonThreadSafe() const;
+
+  /// Internal, non-thread-safe snapshot of the geometry of the next frame.
+  Frame nextFrameNonThreadSafe(irsol::types::timepoint_t timestamp);
+
+  /// Internal, non-thread-safe version of @ref triggerTiming().
+  TriggerTiming triggerTimingNonThreadSafe() const;
+
+  /// Rounds @p value down to the increment of the region of interest, and to 0 if negative.
+  int64_t roundToIncrement(int64_t value) const;
+
+  /// Hands the triggered frames to the callback, once read out, until the acquisition stops.
+  void runReadout();
+
+  const Config m_config;  ///< Static characteristics of the camera.
+
+  /// Mutex to protect the parameters.
+  mutable std::mutex m_mutex;
+
+  /// Current values of the integer features, by name.
+  std::map<std::string, int64_t> m_params;
+
+  /// ID of the next frame.
+  uint64_t m_nextFrameId{0};
+
+  /// Number of frames dropped by the free-running acquisitions.
+  uint64_t m_numDroppedFrames{0};
+
+  /// Requested period of the current free-running acquisition, zero if as fast as possible.
+  irsol::types::duration_t m_requestedPeriod{};
+
+  /// Whether a free-running acquisition is active.
+  bool m_continuous{false};
+
+  /// Time at which the last free-running frame was read out.
+  irsol::types::timepoint_t m_lastTick{};
+
+  /// Whether overlapped triggering is enabled.
+  bool m_triggerOverlap;
+
+  /// Number of skipped triggers.
+  uint64_t m_numSkippedTriggers{0};
+
+  /// End of the exposure of the last triggered frame.
+  irsol::types::timepoint_t m_lastExposureEnd{};
+
+  /// End of the readout of the last triggered frame.
+  irsol::types::timepoint_t m_lastReadoutEnd{};
+
+  /// Triggered frames and the end of their readout, in trigger order.
+  std::deque<std::pair<irsol::types::timepoint_t, Frame>> m_readouts;
+
+  /// Receives the frames of the triggered acquisition.
+  frame_callback_t m_frameCallback;
+
+  /// Whether @ref m_readoutThread must exit.
+  bool m_stopReadout{false};
+
+  /// Signals the triggered frames, and the stop requests, to @ref m_readoutThread.
+  std::condition_variable m_readoutCondition;
+
+  /// Thread reading the triggered frames out, while the triggered acquisition is active.
+  std::thread m_readoutThread;
+};
+
+}  // namespace camera
+}  // namespace irsol
@@ -0,0 +1,49 @@
+/**
+ * @file irsol/camera/trigger_timing.hpp
+ * @brief Timing model of the software-triggered captures of a camera.
+ *
+ * A triggered capture exposes the sensor, then reads the frame out. Unless the camera supports
+ * overlapped triggering (`TriggerOverlap`), the next trigger is accepted only once the readout of
+ * the previous frame is complete. With overlapped triggering, the exposure of the next frame runs
+ * during the readout of the previous one, which nearly doubles the attainable frame rate when the
+ * exposure and the readout last about as long.
+ */
+
+#pragma once
+
+#include "irsol/types.hpp"
+
+#include <cstddef>
+
+namespace irsol {
+namespace camera {
+
+/**
+ * @brief Durations of the phases of a triggered capture, and the trigger cadence they allow.
+ *
+ * With overlapped triggering, a trigger is accepted once the exposure of the previous frame is
+ * over, provided that the new exposure ends after the readout of the previous frame (the sensor
+ * reads out a single frame at a time): two triggers are then at least `max(exposure, readout)`
+ * apart, instead of `exposure + readout`.
+ */
+struct TriggerTiming
+{
+  irsol::types::duration_t exposure;  ///< Exposure time of a frame.
+  irsol::types::duration_t readout;   ///< Readout time of a frame.
+  bool                     overlap;   ///< Whether exposures may overlap the previous readout.
+
+  /// Shortest interval between two accepted triggers.
+  irsol::types::duration_t triggerInterval() const;
+
+  /// Time between a trigger and the end of the readout of its frame.
+  irsol::types::duration_t captureTime() const;
+
+  /// Maximum number of triggers whose frame is not read out yet.
+  size_t maxPendingTriggers() const;
+
+  /// Highest rate of triggered captures, in frames per second.
+  double maxFrameRate() const;
+};
+
+}  // namespace camera
+}  // namespace irsol
@@ -0,0 +1,275 @@
+/**
+ * @file irsol/camera/user_buffers.hpp
+ * @brief Application-owned acquisition buffers, written directly by the camera driver.
+ *
+ * By default, NeoAPI acquires images into buffers it allocates internally, and the image bytes
+ * must be copied out of the `NeoAPI::Image` before it can be returned to the driver. In user
+ * buffer mode instead, the driver writes the images into memory provided by the application.
+ *
+ * This header declares the components used to manage such a ring of buffers:
+ * - @ref irsol::camera::UserBuffer, a buffer owned by the application and registered to NeoAPI;
+ * - @ref irsol::camera::UserBufferDriver, the driver-side operations on user buffers, with an
+ *   implementation for NeoAPI cameras and a simulated stand-in for tests;
+ * - @ref irsol::camera::UserBufferRing, the ring of buffers, which exposes the content of a
+ *   filled buffer as shared, read-only storage. The buffer is handed back to the driver once the
+ *   last holder of the storage releases it, so the image bytes flow to the clients without any
+ *   intermediate copy.
+ */
+
+#pragma once
+
+#include "irsol/types.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <neoapi/neoapi.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace irsol {
+namespace camera {
+
+/**
+ * @brief Whether writing a camera feature may change the size of the acquired images.
+ *
+ * A ring of user buffers sized after the previous `PayloadSize` must be rebuilt after such a
+ * write (see @ref irsol::camera::UserBufferRing::refit()), as the camera can't acquire images
+ * into buffers smaller than the payload.
+ *
+ * @param feature Name of the feature, e.g. `Width`.
+ */
+bool affectsPayloadSize(const std::string& feature);
+
+/**
+ * @brief Acquisition buffer owned by the application, and registered to NeoAPI as user buffer.
+ *
+ * The memory of the buffer is allocated (and pre-faulted) once, at construction, and is never
+ * re-allocated afterwards.
+ */
+class UserBuffer : public NeoAPI::BufferBase
+{
+public:
+  /**
+   * @param index    Position of the buffer in its ring.
+   * @param numBytes Size of the buffer, i.e. of the images acquired in it.
+   */
+  UserBuffer(size_t index, size_t numBytes);
+
+  ~UserBuffer() override;
+
+  UserBuffer(const UserBuffer&) = delete;
+  UserBuffer& operator=(const UserBuffer&) = delete;
+
+  /// Position of the buffer in its ring.
+  size_t index() const;
+
+  /// Writable view on the buffer memory, used by the producer of the image.
+  irsol::types::byte_t* data();
+
+  /// The buffer memory.
+  const std::vector<irsol::types::byte_t>& memory() const;
+
+private:
+  const size_t                      m_index;   ///< Position of the buffer in its ring.
+  std::vector<irsol::types::byte_t> m_memory;  ///< Memory registered to the driver.
+};
+
+/**
+ * @brief Driver-side operations on user buffers.
+ *
+ * Mirrors the user buffer API of NeoAPI, so that the buffer lifecycle can be exercised without a
+ * camera (see @ref irsol::camera::SimulatedUserBufferDriver).
+ */
+class UserBufferDriver
+{
+public:
+  virtual ~UserBufferDriver() = default;
+
+  /**
+   * @brief Switches the driver to user buffer mode, with the given number of buffers.
+   */
+  virtual void enable(size_t numBuffers) = 0;
+
+  /**
+   * @brief Switches the driver back to its internally allocated buffers.
+   */
+  virtual void disable() = 0;
+
+  /**
+   * @brief Hands a buffer to the driver, which can then acquire images into it.
+   */
+  virtual void add(UserBuffer& buffer) = 0;
+
+  /**
+   * @brief Withdraws a buffer from the driver, which no longer acquires images into it.
+   */
+  virtual void revoke(UserBuffer& buffer) = 0;
+};
+
+/**
+ * @brief User buffer operations of a NeoAPI camera.
+ *
+ * Buffers handed to the camera are re-used for acquisition once the `NeoAPI::Image` acquired in
+ * them is destroyed.
+ */
+class NeoAPIUserBufferDriver : public UserBufferDriver
+{
+public:
+  /**
+   * @param cam Camera acquiring into the user buffers. It must outlive the driver.
+   */
+  explicit NeoAPIUserBufferDriver(NeoAPI::Cam& cam);
+
+  void enable(size_t numBuffers) override;
+  void disable() override;
+  void add(UserBuffer& buffer) override;
+  void revoke(UserBuffer& buffer) override;
+
+private:
+  NeoAPI::Cam& m_cam;  ///< Camera acquiring into the user buffers.
+};
+
+/**
+ * @brief Stand-in for a camera driver acquiring into user buffers.
+ *
+ * The driver keeps a queue of the buffers it was handed. Each acquisition (see @ref acquire())
+ * takes the buffer at the front of the queue, and the buffer is queued again once the returned
+ * lease is released, as NeoAPI does when the `NeoAPI::Image` is destroyed. If no buffer is
+ * queued, the acquisition fails, as a camera running out of buffers would drop frames. The
+ * acquisition fails as well if the buffer is smaller than the simulated payload (see
+ * @ref setPayloadSize()), as a camera can't deliver an image into such a buffer.
+ *
+ * Leases may safely outlive the driver.
+ */
+class SimulatedUserBufferDriver : public UserBufferDriver
+{
+public:
+  /// A buffer being filled by (or holding a frame acquired by) the driver.
+  struct Acquisition
+  {
+    UserBuffer*           buffer;  ///< Buffer holding the acquired image.
+    std::shared_ptr<void> lease;   ///< Keeps the buffer out of the driver's queue while alive.
+  };
+
+  SimulatedUserBufferDriver();
+
+  void enable(size_t numBuffers) override;
+  void disable() override;
+  void add(UserBuffer& buffer) override;
+  void revoke(UserBuffer& buffer) override;
+
+  /**
+   * @brief Takes the next queued buffer to acquire an image into it.
+   *
+   * @return The acquisition, or `std::nullopt` if no buffer is queued, or if the next buffer is
+   *         smaller than the payload.
+   */
+  std::optional<Acquisition> acquire();
+
+  /**
+   * @brief Sets the size of the simulated images, as changed by the region of interest.
+   *
+   * @param numBytes Size of the images, 0 (the default) to accept buffers of any size.
+   */
+  void setPayloadSize(size_t numBytes);
+
+  /// Whether the driver is in user buffer mode.
+  bool enabled() const;
+
+  /// Number of buffers currently queued to the driver.
+  size_t numQueued() const;
+
+  /// Number of times a released buffer was queued again to the driver.
+  uint64_t numRequeued() const;
+
+  /// Number of acquisitions that failed because no buffer was queued.
+  uint64_t numStarved() const;
+
+  /// Number of acquisitions that failed because the next buffer was smaller than the payload.
+  uint64_t numUndersized() const;
+
+private:
+  /// State shared with the outstanding leases.
+  struct State
+  {
+    std::mutex               mutex;             ///< Protects the state.
+    bool                     enabled{false};    ///< Whether the user buffer mode is enabled.
+    std::deque<UserBuffer*>  queue;             ///< Buffers available to the driver.
+    std::vector<UserBuffer*> added;             ///< Buffers handed to the driver, not revoked.
+    uint64_t                 numRequeued{0};    ///< Number of buffers queued again after release.
+    uint64_t                 numStarved{0};     ///< Number of failed acquisitions.
+    uint64_t                 numUndersized{0};  ///< Acquisitions failed on a too small buffer.
+    size_t                   payloadSize{0};    ///< Size of the simulated images, 0 if any.
+  };
+
+  std::shared_ptr<State> m_state;  ///< State shared with the outstanding leases.
+};
+
+/**
+ * @brief Ring of application-owned acquisition buffers.
+ *
+ * On construction, the buffers are allocated and handed to the driver; on destruction, they are
+ * revoked and the driver is switched back to its internal buffers. Buffers still referenced by
+ * frames at that point stay valid until the last reference is released.
+ */
+class UserBufferRing
+{
+public:
+  /// Immutable, shared storage of the image bytes held by a buffer.
+  using storage_t = std::shared_ptr<const std::vector<irsol::types::byte_t>>;
+
+  /**
+   * @param driver     Driver acquiring into the buffers. It must outlive the ring.
+   * @param numBuffers Number of buffers of the ring.
+   * @param bufferSize Size of each buffer, i.e. of the acquired images, in bytes.
+   */
+  UserBufferRing(UserBufferDriver& driver, size_t numBuffers, size_t bufferSize);
+
+  ~UserBufferRing();
+
+  UserBufferRing(const UserBufferRing&) = delete;
+  UserBufferRing& operator=(const UserBufferRing&) = delete;
+
+  /**
+   * @brief Exposes the content of a buffer filled by the driver as shared storage.
+   *
+   * No bytes are copied. The returned storage keeps @p lease alive: the buffer is given back to
+   * the driver once the storage, and all its copies, are destroyed.
+   *
+   * @param buffer Buffer of this ring holding an acquired image.
+   * @param lease  Driver-side handle keeping the buffer out of acquisition (e.g. the
+   *               `NeoAPI::Image` acquired in the buffer).
+   * @return The shared storage of the buffer, or `nullptr` if @p buffer is not part of this ring.
+   */
+  storage_t wrap(UserBuffer* buffer, std::shared_ptr<void> lease) const;
+
+  /// Number of buffers of the ring.
+  size_t numBuffers() const;
+
+  /// Size of each buffer of the ring, in bytes.
+  size_t bufferSize() const;
+
+  /**
+   * @brief Replaces a ring by a new one, with buffers of the given size, on the same driver.
+   *
+   * Meant to be called after a change of the frame size (see @ref affectsPayloadSize()), while
+   * the camera is not acquiring. The new ring has as many buffers as the replaced one. Frames
+   * still holding buffers of the replaced ring stay valid until they're released.
+   *
+   * @param ring       Ring to replace. Nothing is done if it's `nullptr`.
+   * @param bufferSize New size of the buffers, i.e. the `PayloadSize` of the camera.
+   * @return true if the ring was replaced, false if its buffers already have the given size.
+   */
+  static bool refit(std::unique_ptr<UserBufferRing>& ring, size_t bufferSize);
+
+private:
+  UserBufferDriver&                        m_driver;      ///< Driver acquiring into the buffers.
+  const size_t                             m_bufferSize;  ///< Size of each buffer, in bytes.
+  std::vector<std::shared_ptr<UserBuffer>> m_buffers;     ///< Buffers of the ring.
+};
+
+}  // namespace camera
+}  // namespace irsol
@@ -16,6 +16,7 @@
 #include "irsol/types.hpp"
 
 #include <array>
+#include <memory>
 #include <numeric>
 #include <sstream>
 #include <string_view>
@@ -91,14 +92,17 @@ struct BinaryDataBufferName
  * @ingroup Protocol
  * @brief Represents a binary data object within the protocol.
  *
- * This class owns a contiguous block of binary data elements and their shape,
- * along with optional additional attributes. It supports only move semantics
- * to avoid unnecessary copies of potentially large data buffers.
+ * This class holds a contiguous block of binary data elements and their shape,
+ * along with optional additional attributes. The data bytes live in an immutable,
+ * reference-counted storage, so that several BinaryData objects (e.g. the same camera frame
+ * delivered to many clients) can view the same bytes without copying them.
+ * Use @ref share() to obtain a new object viewing the same storage, and @ref mutableData() to
+ * obtain a private, writable copy of the bytes (copy-on-write).
  *
  * @tparam NBytes Number of bytes per element (e.g., 1 for 8-bit data, 2 for 16-bit).
  * @tparam N Dimensionality of the binary data (e.g., 2 for images).
  *
- * @note Copy construction and assignment are disabled to prevent expensive copies.
+ * @note Copy construction and assignment are disabled to make sharing explicit via @ref share().
  * Move semantics are supported to allow ownership transfer.
  * Members are non-const to facilitate move operations.
  */
@@ -114,6 +118,9 @@ struct BinaryData
   /// Dimensionality of the binary data.
   static constexpr uint8_t DIM = N;
 
+  /// Immutable, reference-counted storage of the binary data bytes.
+  using storage_t = std::shared_ptr<const std::vector<irsol::types::byte_t>>;
+
   /**
    * @brief Constructs a BinaryData object.
    * @param data Rvalue reference to the binary data bytes; ownership is transferred.
@@ -126,20 +133,35 @@ struct BinaryData
     std::vector<irsol::types::byte_t>&& data,
     const std::array<uint64_t, N>&      shape,
     std::vector<BinaryDataAttribute>&&  attributes = {})
-    : data(std::move(data))
-    , shape(shape)
-    , numElements(std::accumulate(shape.begin(), shape.end(), 1ull, std::multiplies<>{}))
-    , numBytes(numElements * BYTES_PER_ELEMENT)
-    , attributes(std::move(attributes))
+    : BinaryData(
+        SharedStorageTag{},
+        std::make_shared<std::vector<irsol::types::byte_t>>(std::move(data)),
+        shape,
+        std::move(attributes))
   {
-    IRSOL_LOG_TRACE("BinaryData constructed: {}", toString());
-    IRSOL_ASSERT_ERROR(
-      this->data.size() == this->numBytes,
-      "Data size (%lu) does not match the number of elements (%lu) multiplied by bytes per element "
-      "(%d).",
-      this->data.size(),
-      this->numElements,
-      this->BYTES_PER_ELEMENT);
+    m_ownsWritableStorage = true;
+  }
+
+  /**
+   * @brief Constructs a BinaryData object viewing already existing shared storage.
+   *
+   * No data bytes are copied: the returned object keeps a reference on @p data.
+   * As @p data may have been allocated as a const vector, or may alias memory owned by someone
+   * else, the first call to @ref mutableData() on the returned object always copies the bytes.
+   *
+   * @param data Shared storage holding the binary data bytes.
+   * @param shape Shape of the data as an array of size N.
+   * @param attributes Optional additional attributes; ownership is transferred.
+   * @return A BinaryData viewing @p data.
+   *
+   * @throws irsol::AssertException if the data size does not match shape * bytes per element.
+   */
+  static BinaryData fromSharedData(
+    storage_t                          data,
+    const std::array<uint64_t, N>&     shape,
+    std::vector<BinaryDataAttribute>&& attributes = {})
+  {
+    return BinaryData(SharedStorageTag{}, std::move(data), shape, std::move(attributes));
   }
 
   /**
@@ -155,8 +177,8 @@ struct BinaryData
   // Disable move assignment to avoid accidental reassignment.
   BinaryData& operator=(BinaryData&& other) noexcept = delete;
 
-  /// Owned binary data bytes.
-  std::vector<irsol::types::byte_t> data;
+  /// Shared, immutable binary data bytes.
+  storage_t data;
 
   /// Shape of the binary data.
   std::array<uint64_t, DIM> shape;
@@ -170,6 +192,47 @@ struct BinaryData
   /// Additional attributes related to the binary data.
   std::vector<BinaryDataAttribute> attributes;
 
+  /**
+   * @brief Creates a new BinaryData object viewing the same data storage as this one.
+   *
+   * The data bytes are not copied, only the shape and the attributes are.
+   * @return A BinaryData sharing the data bytes with this object.
+   */
+  BinaryData share() const
+  {
+    auto attributesCopy = attributes;
+    return fromSharedData(data, shape, std::move(attributesCopy));
+  }
+
+  /**
+   * @brief Returns the number of objects currently sharing the data storage.
+   */
+  long useCount() const
+  {
+    return data.use_count();
+  }
+
+  /**
+   * @brief Provides write access to the data bytes, copying them first if they are shared.
+   *
+   * If other BinaryData objects view the same storage, or if the storage was not allocated by
+   * this object (see @ref fromSharedData()), the bytes are copied into a new storage private to
+   * this object, so that the modifications never leak to other holders.
+   *
+   * @return A mutable reference to the data bytes owned exclusively by this object.
+   */
+  std::vector<irsol::types::byte_t>& mutableData()
+  {
+    if(!m_ownsWritableStorage || data.use_count() != 1) {
+      IRSOL_LOG_TRACE("Copy-on-write of shared {}", toString());
+      data                  = std::make_shared<std::vector<irsol::types::byte_t>>(*data);
+      m_ownsWritableStorage = true;
+    }
+    // The storage is exclusively owned at this point, and it was allocated as a non-const vector
+    // by this object, so removing the constness is safe.
+    return const_cast<std::vector<irsol::types::byte_t>&>(*data);
+  }
+
   /**
    * @brief Returns a string summary of the binary data buffer.
    * @return A string describing dimensionality, shape, and size in bytes.
@@ -185,6 +248,36 @@ struct BinaryData
     ss << ")](" << std::to_string(numBytes) << " bytes)";
     return ss.str();
   }
+
+private:
+  /// Whether @ref data was allocated as a non-const vector by this object (and not adopted).
+  bool m_ownsWritableStorage{false};
+
+  /// Tag used to select the constructor adopting shared storage.
+  struct SharedStorageTag
+  {};
+
+  BinaryData(
+    SharedStorageTag,
+    storage_t                          data,
+    const std::array<uint64_t, N>&     shape,
+    std::vector<BinaryDataAttribute>&& attributes)
+    : data(std::move(data))
+    , shape(shape)
+    , numElements(std::accumulate(shape.begin(), shape.end(), 1ull, std::multiplies<>{}))
+    , numBytes(numElements * BYTES_PER_ELEMENT)
+    , attributes(std::move(attributes))
+  {
+    IRSOL_LOG_TRACE("BinaryData constructed: {}", toString());
+    IRSOL_ASSERT_ERROR(this->data != nullptr, "BinaryData constructed without data storage.");
+    IRSOL_ASSERT_ERROR(
+      this->data->size() == this->numBytes,
+      "Data size (%lu) does not match the number of elements (%lu) multiplied by bytes per element "
+      "(%d).",
+      this->data->size(),
+      this->numElements,
+      this->BYTES_PER_ELEMENT);
+  }
 };
 
 }  // namespace internal
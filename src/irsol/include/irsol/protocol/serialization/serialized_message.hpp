@@ -17,6 +17,7 @@
 
 #include "irsol/types.hpp"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -31,7 +32,9 @@ namespace internal {
  * This structure stores the serialized form of an outgoing protocol message.
  * It consists of:
  * - A textual header stored as a `std::string`.
- * - A binary payload stored as a `std::vector<irsol::types::byte_t>`.
+ * - A binary payload stored as an immutable, reference-counted `std::vector<irsol::types::byte_t>`.
+ *   The payload storage may come from a @ref irsol::utils::BufferPool, in which case it goes back
+ *   to the pool once the message is destroyed.
  *
  * The class supports move semantics but disables copying to avoid expensive copies of potentially
  * large payloads.
@@ -48,12 +51,16 @@ struct SerializedMessage
    */
   std::string header;
 
+  /// Immutable, reference-counted storage of the binary payload.
+  using payload_t = std::shared_ptr<const std::vector<irsol::types::byte_t>>;
+
   /**
    * @brief The binary payload of the serialized message.
    *
-   * This vector contains the binary data part of the message, following the header.
+   * This vector contains the binary data part of the message, following the header. It's `nullptr`
+   * for messages without payload.
    */
-  std::vector<irsol::types::byte_t> payload{};
+  payload_t payload{};
 
   /**
    * @brief Constructs a SerializedMessage with a header and binary payload.
@@ -65,6 +72,15 @@ struct SerializedMessage
    */
   SerializedMessage(const std::string& header, std::vector<irsol::types::byte_t>&& payload);
 
+  /**
+   * @brief Constructs a SerializedMessage adopting an already existing payload storage.
+   *
+   * @param header The message header string.
+   * @param payload Shared storage of the binary payload, which is not copied.
+   * @return The serialized message.
+   */
+  static SerializedMessage fromSharedPayload(const std::string& header, payload_t payload);
+
   /// Move constructor (defaulted).
   SerializedMessage(SerializedMessage&&) noexcept = default;
 
@@ -95,6 +111,11 @@ struct SerializedMessage
    */
   size_t payloadSize() const;
 
+  /**
+   * @brief Returns a pointer to the payload bytes, `nullptr` if the message has no payload.
+   */
+  const irsol::types::byte_t* payloadData() const;
+
   /**
    * @brief Converts the serialized message to a string representation.
    *
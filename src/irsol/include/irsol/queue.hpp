@@ -6,20 +6,104 @@
  * a thread-safe queue with blocking push/pop operations and optional
  * maximum size bounding. It is designed for safe communication
  * between one producer and one consumer thread.
+ *
+ * Bounded queues can be configured with an @ref irsol::utils::OverflowPolicy, deciding what happens
+ * when an item is pushed into a full queue.
+ *
+ * Consumers can wait for items with a timeout, abandon the wait as soon as a stop flag is raised,
+ * and drain several items at once (see @ref irsol::utils::SafeQueue::popMany()).
  */
 
 #pragma once
 
 #include "irsol/assert.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <string>
+#include <vector>
 
 namespace irsol {
 namespace utils {
 
+/**
+ * @brief Behavior of a bounded @ref irsol::utils::SafeQueue when an item is pushed while it's full.
+ */
+enum class OverflowPolicy
+{
+  BLOCK,        ///< The producer waits until space becomes available.
+  DROP_OLDEST,  ///< The oldest item in the queue is discarded to make room for the new one.
+  DROP_NEWEST,  ///< The pushed item is discarded.
+  LATEST_ONLY   ///< The queue holds at most one item, always the most recently pushed one.
+};
+
+/**
+ * @brief Returns the name of an overflow policy, as used by the protocol (e.g. `drop_oldest`).
+ * @param policy The overflow policy.
+ * @return The lowercase name of the policy.
+ */
+inline const char*
+overflowPolicyToString(OverflowPolicy policy)
+{
+  switch(policy) {
+    case OverflowPolicy::BLOCK:
+      return "block";
+    case OverflowPolicy::DROP_OLDEST:
+      return "drop_oldest";
+    case OverflowPolicy::DROP_NEWEST:
+      return "drop_newest";
+    case OverflowPolicy::LATEST_ONLY:
+      return "latest_only";
+  }
+  return "unknown";
+}
+
+/**
+ * @brief Parses the name of an overflow policy, as returned by @ref overflowPolicyToString().
+ * @param name The lowercase name of the policy.
+ * @return The overflow policy, or `std::nullopt` if @p name is not a known policy.
+ */
+inline std::optional<OverflowPolicy>
+overflowPolicyFromString(const std::string& name)
+{
+  for(auto policy : {OverflowPolicy::BLOCK,
+                     OverflowPolicy::DROP_OLDEST,
+                     OverflowPolicy::DROP_NEWEST,
+                     OverflowPolicy::LATEST_ONLY}) {
+    if(name == overflowPolicyToString(policy)) {
+      return policy;
+    }
+  }
+  return std::nullopt;
+}
+
+/**
+ * @brief Returns whether a @ref irsol::utils::SafeQueue using an overflow policy must be bounded.
+ *
+ * The @ref OverflowPolicy::DROP_OLDEST and @ref OverflowPolicy::DROP_NEWEST policies only apply to
+ * a full queue: an unbounded queue would never drop any item.
+ */
+inline bool
+overflowPolicyRequiresBound(OverflowPolicy policy)
+{
+  return policy == OverflowPolicy::DROP_OLDEST || policy == OverflowPolicy::DROP_NEWEST;
+}
+
+/**
+ * @brief Outcome of the waiting pops of a @ref irsol::utils::SafeQueue.
+ */
+enum class PopResult
+{
+  POPPED,   ///< At least one item was popped.
+  DONE,     ///< The queue is done and empty: no item will ever be popped.
+  TIMEOUT,  ///< No item became available before the timeout.
+  STOPPED   ///< The stop flag of the consumer was raised.
+};
+
 /**
  * @class SafeQueue
  * @brief A thread-safe, optionally bounded queue with blocking push and pop operations.
@@ -30,8 +114,15 @@ namespace utils {
  * the default `max_size` parameter as 0.
  *
  * The queue supports:
- * - Blocking push: waits when full (if bounded) until space becomes available.
+ * - Blocking push: waits when full (if bounded) until space becomes available, unless a dropping
+ *   @ref irsol::utils::OverflowPolicy is used, in which case pushing never blocks and the number
+ *   of discarded items is tracked (see @ref dropped()).
+ * - Non-blocking push: see @ref tryPush().
  * - Blocking pop: waits when empty until an item is available or the queue is marked done.
+ * - Timed, cancellable pops: see @ref popFor() and @ref popMany(). A consumer waiting on a stop
+ *   flag is woken up by @ref interrupt(), once the flag is raised.
+ * - Batched pop: all the ready items, up to a maximum, are drained in a single lock acquisition,
+ *   see @ref popMany().
  * - Notification when the producer finishes to unblock consumers.
  *
  * @tparam T The type of elements stored in the queue. Must be movable or copyable.
@@ -69,8 +160,19 @@ public:
    * @brief Constructs a SafeQueue with an optional maximum size.
    * @param max_size The maximum number of elements the queue can hold.
    *                 Zero (default) means the queue is unbounded.
+   * @param policy   Behavior when pushing into a full queue. A dropping policy requires a bounded
+   *                 queue, except for @ref OverflowPolicy::LATEST_ONLY, which always holds at most
+   *                 one item.
    */
-  explicit SafeQueue(size_t max_size = 0): m_maxSize(max_size), m_done(false) {}
+  explicit SafeQueue(size_t max_size = 0, OverflowPolicy policy = OverflowPolicy::BLOCK)
+    : m_maxSize(policy == OverflowPolicy::LATEST_ONLY ? 1 : max_size)
+    , m_policy(policy)
+    , m_done(false)
+  {
+    IRSOL_ASSERT_ERROR(
+      !overflowPolicyRequiresBound(m_policy) || m_maxSize > 0,
+      "SafeQueue with a dropping overflow policy must be bounded");
+  }
 
   /// Deleted copy constructor to prevent copying.
   SafeQueue(const SafeQueue&) = delete;
@@ -81,50 +183,76 @@ public:
   /**
    * @brief Push an item into the queue.
    *
-   * Blocks if the queue is bounded and currently full until space becomes available.
+   * With the @ref OverflowPolicy::BLOCK policy, blocks if the queue is bounded and currently full
+   * until space becomes available. With the other policies, never blocks: an item is discarded
+   * according to the policy if the queue is full.
    *
    * @param item An rvalue reference to the item to push into the queue.
+   * @return `true` if the item was enqueued, `false` if it was discarded.
    *
    * @throws irsol::AssertionException error if the queue is marked done.
    *
    * @note This method uses move semantics to efficiently transfer ownership of the item.
    */
-  void push(T&& item)
+  bool push(T&& item)
   {
     std::unique_lock<std::mutex> lock(m_mutex);
 
     IRSOL_ASSERT_ERROR(!m_done, "SafeQueue::push() called on an already done queue");
 
-    m_producerConditionVariable.wait(
-      lock, [&]() { return m_done || m_maxSize == 0 || m_queue.size() < m_maxSize; });
+    if(m_policy == OverflowPolicy::BLOCK) {
+      m_producerConditionVariable.wait(
+        lock, [&]() { return m_done || m_maxSize == 0 || m_queue.size() < m_maxSize; });
 
-    if(m_done)
-      return;
+      if(m_done)
+        return false;
+    }
 
-    m_queue.push(std::move(item));
-    m_consumerConditionVariable.notify_one();
+    return pushNonThreadSafe(std::move(item));
+  }
+
+  /**
+   * @brief Push an item into the queue, without ever blocking.
+   *
+   * Behaves as @ref push() for the dropping policies. With the @ref OverflowPolicy::BLOCK policy,
+   * if the queue is full the item is rejected (left untouched) and counted as rejected (see
+   * @ref rejected()), not as dropped.
+   *
+   * @param item An rvalue reference to the item to push into the queue.
+   * @return `true` if the item was enqueued, `false` otherwise.
+   *
+   * @throws irsol::AssertionException error if the queue is marked done.
+   */
+  bool tryPush(T&& item)
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+
+    IRSOL_ASSERT_ERROR(!m_done, "SafeQueue::tryPush() called on an already done queue");
+
+    if(m_policy == OverflowPolicy::BLOCK && isFullNonThreadSafe()) {
+      ++m_rejected;
+      return false;
+    }
+    return pushNonThreadSafe(std::move(item));
   }
 
   /**
    * @brief Pop an item from the queue.
    *
    * Blocks if the queue is empty until an item becomes available or the queue
-   * is marked done.
+   * is marked done. Items pushed before the queue was marked done are still
+   * handed out, so that the consumer can drain the queue.
    *
    * @param out Reference to a variable where the popped item will be stored.
    * @return `true` if an item was successfully popped, `false` if the queue
    *         is done and empty.
    *
-   * @throws irsol::AssertionException error if called after the queue is marked done.
-   *
    * @note The popped item is moved to the provided output variable.
    */
   bool pop(T& out)
   {
     std::unique_lock<std::mutex> lock(m_mutex);
 
-    IRSOL_ASSERT_ERROR(!m_done, "SafeQueue::pop() called on an already done queue");
-
     m_consumerConditionVariable.wait(lock, [&]() { return m_done || !m_queue.empty(); });
 
     if(m_queue.empty())
@@ -136,6 +264,97 @@ public:
     return true;
   }
 
+  /**
+   * @brief Pop an item from the queue, waiting at most for the given time.
+   *
+   * @param out           Reference to a variable where the popped item will be stored.
+   * @param timeout       Maximum time to wait for an item.
+   * @param stopRequested Optional stop flag: the wait is abandoned as soon as it's raised (see
+   *                      @ref interrupt()).
+   * @return @ref PopResult::POPPED if an item was popped, otherwise the reason why not.
+   */
+  template<typename Rep, typename Period>
+  PopResult popFor(
+    T&                                        out,
+    const std::chrono::duration<Rep, Period>& timeout,
+    const std::atomic<bool>*                  stopRequested = nullptr)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    if(const auto result = waitForItems(lock, stopRequested, &deadline);
+       result != PopResult::POPPED) {
+      return result;
+    }
+
+    out = std::move(m_queue.front());
+    m_queue.pop();
+    m_producerConditionVariable.notify_one();
+    return PopResult::POPPED;
+  }
+
+  /**
+   * @brief Pop all the ready items, up to a maximum, waiting until at least one is available.
+   *
+   * The items are drained in a single lock acquisition: a consumer that fell behind the producer
+   * catches up in batches.
+   *
+   * @param out           Vector to which the popped items are appended, oldest first.
+   * @param maxItems      Maximum number of items to pop.
+   * @param stopRequested Optional stop flag: the wait is abandoned as soon as it's raised (see
+   *                      @ref interrupt()).
+   * @return @ref PopResult::POPPED if at least one item was popped, otherwise the reason why not.
+   */
+  PopResult popMany(
+    std::vector<T>&          out,
+    size_t                   maxItems,
+    const std::atomic<bool>* stopRequested = nullptr)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if(const auto result = waitForItems(lock, stopRequested, nullptr);
+       result != PopResult::POPPED) {
+      return result;
+    }
+
+    for(size_t i = 0; i < maxItems && !m_queue.empty(); ++i) {
+      out.push_back(std::move(m_queue.front()));
+      m_queue.pop();
+    }
+    m_producerConditionVariable.notify_all();
+    return PopResult::POPPED;
+  }
+
+  /**
+   * @brief Waits until the producer has finished, without popping any item.
+   *
+   * Used by consumers that only process the items once all of them are produced.
+   *
+   * @param stopRequested Optional stop flag: the wait is abandoned as soon as it's raised (see
+   *                      @ref interrupt()).
+   * @return @ref PopResult::DONE once the producer has finished, @ref PopResult::STOPPED if the
+   *         stop flag was raised first.
+   */
+  PopResult waitDone(const std::atomic<bool>* stopRequested = nullptr)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const auto stopped = [stopRequested]() { return stopRequested && stopRequested->load(); };
+    m_consumerConditionVariable.wait(lock, [&]() { return m_done || stopped(); });
+    return stopped() ? PopResult::STOPPED : PopResult::DONE;
+  }
+
+  /**
+   * @brief Wakes up the consumers waiting for items, so that they check their stop flag.
+   *
+   * Must be called after raising the stop flag passed to @ref popFor(), @ref popMany() or
+   * @ref waitDone().
+   */
+  void interrupt()
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_consumerConditionVariable.notify_all();
+  }
+
   /**
    * @brief Signals that the producer has finished producing items.
    *
@@ -172,10 +391,8 @@ public:
    */
   bool full() const
   {
-    if(m_maxSize == 0) {
-      return false;
-    }
-    return m_queue.size() >= m_maxSize;
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    return isFullNonThreadSafe();
   }
 
   /**
@@ -197,15 +414,114 @@ public:
     return m_done;
   }
 
+  /**
+   * @brief Returns the number of items discarded by a dropping overflow policy because the queue
+   * was full.
+   */
+  size_t dropped() const
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    return m_dropped;
+  }
+
+  /**
+   * @brief Returns the number of items rejected by @ref tryPush() with the
+   * @ref OverflowPolicy::BLOCK policy because the queue was full.
+   *
+   * Unlike dropped items, rejected items are left to the producer, which may push them again
+   * later.
+   */
+  size_t rejected() const
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    return m_rejected;
+  }
+
+  /**
+   * @brief Returns the overflow policy of the queue.
+   */
+  OverflowPolicy policy() const
+  {
+    return m_policy;
+  }
+
 private:
+  /**
+   * @brief Waits until the queue has items, is done, the stop flag is raised or the deadline
+   * expires.
+   *
+   * @note The mutex must be held by the caller, through @p lock.
+   */
+  PopResult waitForItems(
+    std::unique_lock<std::mutex>&                lock,
+    const std::atomic<bool>*                     stopRequested,
+    const std::chrono::steady_clock::time_point* deadline)
+  {
+    const auto stopped = [stopRequested]() { return stopRequested && stopRequested->load(); };
+    const auto ready   = [&]() { return m_done || !m_queue.empty() || stopped(); };
+    if(deadline) {
+      if(!m_consumerConditionVariable.wait_until(lock, *deadline, ready)) {
+        return PopResult::TIMEOUT;
+      }
+    } else {
+      m_consumerConditionVariable.wait(lock, ready);
+    }
+
+    if(stopped()) {
+      return PopResult::STOPPED;
+    }
+    if(m_queue.empty()) {
+      return PopResult::DONE;
+    }
+    return PopResult::POPPED;
+  }
+
+  bool isFullNonThreadSafe() const
+  {
+    return m_maxSize != 0 && m_queue.size() >= m_maxSize;
+  }
+
+  /**
+   * @brief Enqueues an item, applying the dropping overflow policy if the queue is full.
+   *
+   * @note The mutex must be held by the caller.
+   */
+  bool pushNonThreadSafe(T&& item)
+  {
+    if(isFullNonThreadSafe()) {
+      switch(m_policy) {
+        case OverflowPolicy::DROP_NEWEST:
+          ++m_dropped;
+          return false;
+        case OverflowPolicy::DROP_OLDEST:
+        case OverflowPolicy::LATEST_ONLY:
+          while(isFullNonThreadSafe()) {
+            m_queue.pop();
+            ++m_dropped;
+          }
+          break;
+        case OverflowPolicy::BLOCK:
+          // Space is guaranteed by the callers.
+          break;
+      }
+    }
+
+    m_queue.push(std::move(item));
+    m_consumerConditionVariable.notify_one();
+    return true;
+  }
+
   mutable std::mutex m_mutex;  ///< Mutex protecting the queue and state.
   std::condition_variable
     m_producerConditionVariable;  ///< Condition variable for producer blocking.
   std::condition_variable
-                m_consumerConditionVariable;  ///< Condition variable for consumer blocking.
-  std::queue<T> m_queue;                      ///< Underlying queue holding the data.
-  size_t        m_maxSize;                    ///< Maximum queue size (0 means unbounded).
-  bool          m_done;                       ///< Flag indicating the queue is done.
+                 m_consumerConditionVariable;  ///< Condition variable for consumer blocking.
+  std::queue<T>  m_queue;                      ///< Underlying queue holding the data.
+  size_t         m_maxSize;                    ///< Maximum queue size (0 means unbounded).
+  OverflowPolicy m_policy;                     ///< Behavior when pushing into a full queue.
+  bool           m_done;                       ///< Flag indicating the queue is done.
+  size_t         m_dropped{0};                 ///< Number of discarded items.
+  size_t         m_rejected{0};                ///< Number of items rejected by tryPush().
 };
 
 }  // namespace utils
@@ -7,7 +7,7 @@
  * including:
  * - Accepting client connections
  * - Managing client sessions
- * - Distributing captured frames from the camera
+ * - Distributing captured frames from the cameras
  * - Handling incoming protocol messages
  *
  * This class owns all components necessary to run a live server application.
@@ -15,9 +15,10 @@
 
 #pragma once
 
-#include "irsol/camera/interface.hpp"
+#include "irsol/camera/backend.hpp"
 #include "irsol/server/acceptor.hpp"
 #include "irsol/server/client.hpp"
+#include "irsol/server/device.hpp"
 #include "irsol/server/handlers/factory.hpp"
 #include "irsol/server/image_collector.hpp"
 #include "irsol/server/message_handler.hpp"
@@ -27,6 +28,7 @@
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace irsol {
 namespace server {
@@ -41,6 +43,10 @@ class ClientSession;
  * The App class starts the TCP server, listens for new connections,
  * instantiates a new @ref irsol::server::ClientSession per client, and coordinates the camera
  * interface, frame collection, and message dispatching.
+ *
+ * The App serves one or more cameras (see @ref irsol::server::Device), each with its own frame
+ * collector. The first device is the default one: a client acquires from it until it selects
+ * another device by name or serial number (`cam=<name>`).
  */
 class App
 {
@@ -48,11 +54,25 @@ class App
     std::unordered_map<irsol::types::client_id_t, std::shared_ptr<ClientSession>>;
 
 public:
+  /// Maximum time the `image_data` command waits for its image.
+  constexpr static irsol::types::duration_t IMAGE_DATA_TIMEOUT = std::chrono::seconds(10);
+
   /**
-   * @brief Constructs the App.
+   * @brief Constructs the App, serving the default camera.
    * @param port The TCP port on which the server will listen for client connections.
+   * @param collectionMode Acquisition strategy used by the frame collector.
+   */
+  explicit App(
+    irsol::types::port_t            port,
+    frame_collector::CollectionMode collectionMode = frame_collector::CollectionMode::JUST_IN_TIME);
+
+  /**
+   * @brief Constructs the App, serving the given devices.
+   * @param port    The TCP port on which the server will listen for client connections.
+   * @param devices Devices served by the application, the first one being the default device.
+   *                Their names must be unique.
    */
-  explicit App(irsol::types::port_t port);
+  App(irsol::types::port_t port, std::vector<std::unique_ptr<Device>> devices);
 
   /**
    * @brief Starts the server.
@@ -90,21 +110,50 @@ public:
     const std::optional<irsol::types::client_id_t>& excludeClient = std::nullopt);
 
   /**
-   * @brief Accessor for the camera interface.
-   * @return Reference to the owned camera interface.
+   * @brief Accessor for the camera of the default device.
+   * @return Reference to the owned camera.
    */
-  camera::Interface& camera()
+  camera::Backend& camera()
   {
-    return *m_cameraInterface;
+    return device().camera();
   };
 
   /**
-   * @brief Accessor for the frame collector.
+   * @brief Accessor for the frame collector of the default device.
    * @return Reference to the owned frame collector.
    */
   frame_collector::FrameCollector& frameCollector()
   {
-    return *m_frameCollector;
+    return device().frameCollector();
+  }
+
+  /**
+   * @brief Accessor for the default device.
+   */
+  Device& device()
+  {
+    return *m_devices.front();
+  }
+
+  /**
+   * @brief Accessor for the device selected by a client session.
+   * @return The device selected by the session, or the default device if none was selected.
+   */
+  Device& device(const ClientSession& session);
+
+  /**
+   * @brief Looks up a device.
+   * @param nameOrSerial Name or serial number of the device.
+   * @return The device, or nullptr if not found.
+   */
+  Device* findDevice(const std::string& nameOrSerial);
+
+  /**
+   * @brief Accessor for all the devices served by the application.
+   */
+  const std::vector<std::unique_ptr<Device>>& devices() const
+  {
+    return m_devices;
   }
 
   /**
@@ -132,11 +181,8 @@ private:
   /// Map of connected clients.
   client_map_t m_clients;
 
-  /// Interface to the camera.
-  std::unique_ptr<camera::Interface> m_cameraInterface;
-
-  /// Frame collector for capturing and broadcasting camera frames.
-  std::unique_ptr<frame_collector::FrameCollector> m_frameCollector;
+  /// Cameras served by the application, each with its frame collector. The first is the default.
+  std::vector<std::unique_ptr<Device>> m_devices;
 
   /// Central handler for processing protocol messages.
   std::unique_ptr<handlers::MessageHandler> m_messageHandler;
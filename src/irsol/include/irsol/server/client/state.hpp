@@ -21,12 +21,14 @@
 #pragma once
 
 #include "irsol/logging.hpp"
+#include "irsol/queue.hpp"
 #include "irsol/types.hpp"
 
 #include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 
 namespace irsol {
@@ -50,6 +52,15 @@ struct GisParams
 
   /// Desired frame rate for this client's stream.
   double frameRate{4.0};
+
+  /// Maximum number of frames waiting to be sent to the client.
+  size_t frameQueueCapacity{4};
+
+  /// Behavior when the client doesn't keep up with the stream and its frame queue is full.
+  irsol::utils::OverflowPolicy frameQueuePolicy{irsol::utils::OverflowPolicy::BLOCK};
+
+  /// Number of frames of the last stream discarded by the overflow policy of the full queue.
+  uint64_t droppedFrames{0};
 };
 
 /**
@@ -88,6 +99,8 @@ struct FrameListeningState
    * @tparam Callable A callable accepting a `std::shared_ptr<std::atomic<bool>>` as stop flag.
    * @param task The function to execute inside the background thread.
    * @param description A human-readable label for logging and error tracing.
+   * @param interrupt Optional function called by @ref stop() once the stop flag is raised, to wake
+   * up the task if it's blocked (e.g. @ref irsol::utils::SafeQueue::interrupt()).
    *
    * @throws std::logic_error if a thread is already running.
    *
@@ -98,7 +111,10 @@ struct FrameListeningState
    * frame-listening process is pushed into the listening background thread.
    */
   template<typename Callable>
-  void start(Callable&& task, const std::string& description)
+  void start(
+    Callable&&            task,
+    const std::string&    description,
+    std::function<void()> interrupt = {})
   {
     std::scoped_lock<std::mutex> lock(m_threadMutex);
     if(m_running.load()) {
@@ -107,6 +123,7 @@ struct FrameListeningState
 
     IRSOL_LOG_INFO("Locking the running of the thread");
     m_stopRequested = std::make_shared<std::atomic<bool>>(false);
+    m_interrupt     = std::move(interrupt);
     m_running.store(true);
 
     std::thread([this,
@@ -131,7 +148,8 @@ struct FrameListeningState
    * @brief Requests the active thread (if any) to stop by setting the stop flag.
    *
    * This does not join the thread (which is detached), but signals the loop
-   * to exit if the user task respects the stop token.
+   * to exit if the user task respects the stop token. The task is woken up through the interrupt
+   * function passed to @ref start(), if any.
    */
   void stop();
 
@@ -144,6 +162,9 @@ private:
 
   /// Shared stop token used to cancel the thread's task loop.
   std::shared_ptr<std::atomic<bool>> m_stopRequested;
+
+  /// Wakes up the task of the thread after a stop request.
+  std::function<void()> m_interrupt;
 };
 
 /**
@@ -162,6 +183,9 @@ struct UserSessionData
 {
   /// Client-specific state for image frame listening, including parameters and worker thread.
   FrameListeningState frameListeningState{};
+
+  /// Name of the device selected by the client, empty for the default device of the application.
+  std::string deviceName{};
 };
 
 }  // namespace internal
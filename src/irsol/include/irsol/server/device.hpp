@@ -0,0 +1,151 @@
+/**
+ * @file irsol/server/device.hpp
+ * @brief Declaration of the Device class.
+ *
+ * Defines @ref irsol::server::Device, one of the cameras served by the
+ * @ref irsol::server::App, together with the frame collector acquiring from it.
+ */
+
+#pragma once
+
+#include "irsol/camera/backend.hpp"
+#include "irsol/camera/replay_camera.hpp"
+#include "irsol/camera/simulated_camera.hpp"
+#include "irsol/server/image_collector.hpp"
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace irsol {
+namespace server {
+
+/**
+ * @brief A camera served by the application, and its frame collector.
+ *
+ * Each device has its own @ref irsol::server::frame_collector::FrameCollector, and thus its own
+ * acquisition and distribution threads: the devices of an application acquire in parallel. The
+ * threads of a device can be pinned to a CPU (see @ref pinToCpu()), so that devices do not compete
+ * for the same core.
+ *
+ * Clients address a device either by its name, or by its serial number.
+ *
+ * A device is either a physical camera (see @ref connect()), or a synthetic stand-in producing
+ * frames without any hardware (see @ref simulated() and @ref replay()), e.g. to test the scaling of
+ * the server over many cameras. The camera of a device is accessed through the
+ * @ref irsol::camera::Backend it implements: synthetic devices built on a
+ * @ref irsol::camera::SimulatedCamera or a @ref irsol::camera::ReplayCamera have camera
+ * parameters, as physical devices do, while synthetic devices built on a bare frame source have
+ * none.
+ */
+class Device
+{
+public:
+  /**
+   * @brief Connects to a camera, configured at half resolution.
+   *
+   * The camera acquires directly into user buffers, if supported.
+   *
+   * @param name         Name of the device, as used by the clients.
+   * @param serialNumber Serial number of the camera, the default camera if empty.
+   * @param mode         Acquisition strategy of the frame collector.
+   * @return The connected device.
+   */
+  static std::unique_ptr<Device> connect(
+    const std::string&              name,
+    const std::string&              serialNumber = {},
+    frame_collector::CollectionMode mode         = frame_collector::CollectionMode::JUST_IN_TIME);
+
+  /**
+   * @brief Creates a synthetic device, producing the frames of the given source.
+   *
+   * @param name   Name of the device, as used by the clients. It's also its serial number.
+   * @param source Frame source of the device. Ownership is transferred.
+   * @param mode   Acquisition strategy of the frame collector.
+   * @return The synthetic device.
+   */
+  static std::unique_ptr<Device> simulated(
+    const std::string&                            name,
+    std::unique_ptr<frame_collector::FrameSource> source,
+    frame_collector::CollectionMode mode = frame_collector::CollectionMode::JUST_IN_TIME);
+
+  /**
+   * @brief Creates a synthetic device, acquiring from a simulated camera.
+   *
+   * The parameters of the camera are accessible to the clients, as for a physical camera.
+   *
+   * @param name   Name of the device, as used by the clients.
+   * @param camera Simulated camera of the device. Ownership is transferred.
+   * @param mode   Acquisition strategy of the frame collector.
+   * @return The synthetic device, whose serial number is the one of the camera.
+   */
+  static std::unique_ptr<Device> simulated(
+    const std::string&                       name,
+    std::unique_ptr<camera::SimulatedCamera> camera,
+    frame_collector::CollectionMode mode = frame_collector::CollectionMode::JUST_IN_TIME);
+
+  /**
+   * @brief Creates a synthetic device, replaying recorded frames.
+   *
+   * @param name   Name of the device, as used by the clients.
+   * @param camera Replay camera of the device. Ownership is transferred.
+   * @param mode   Acquisition strategy of the frame collector.
+   * @return The synthetic device, whose serial number is the one of the recording camera.
+   */
+  static std::unique_ptr<Device> replay(
+    const std::string&                    name,
+    std::unique_ptr<camera::ReplayCamera> camera,
+    frame_collector::CollectionMode mode = frame_collector::CollectionMode::JUST_IN_TIME);
+
+  /// Name of the device.
+  const std::string& name() const;
+
+  /// Serial number of the device.
+  const std::string& serialNumber() const;
+
+  /// Whether @p nameOrSerial is the name or the serial number of the device.
+  bool matches(const std::string& nameOrSerial) const;
+
+  /// Whether the device has a camera, whose parameters can be accessed.
+  bool hasCamera() const;
+
+  /**
+   * @brief Accessor for the camera of the device.
+   * @throws irsol::AssertionException if the device has no camera (see @ref hasCamera()).
+   */
+  camera::Backend& camera();
+
+  /// Accessor for the frame collector of the device.
+  frame_collector::FrameCollector& frameCollector();
+
+  /**
+   * @brief Pins the threads of the device to a CPU.
+   * @see irsol::server::frame_collector::FrameCollector::pinToCpu
+   */
+  bool pinToCpu(size_t cpu);
+
+  /// CPU the threads of the device are pinned to, if any.
+  std::optional<size_t> cpu() const;
+
+private:
+  Device(
+    std::string                                      name,
+    std::string                                      serialNumber,
+    std::unique_ptr<camera::Backend>                 camera,
+    std::unique_ptr<frame_collector::FrameCollector> frameCollector);
+
+  const std::string m_name;          ///< Name of the device.
+  const std::string m_serialNumber;  ///< Serial number of the device.
+
+  /// Camera of the device, `nullptr` for synthetic devices without camera.
+  std::unique_ptr<camera::Backend> m_camera;
+
+  /// Frame collector acquiring from the device (destroyed before the camera it uses).
+  std::unique_ptr<frame_collector::FrameCollector> m_frameCollector;
+
+  /// CPU the threads of the device are pinned to, if any.
+  std::optional<size_t> m_cpu;
+};
+
+}  // namespace server
+}  // namespace irsol
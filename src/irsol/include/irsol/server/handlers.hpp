@@ -1,12 +1,18 @@
 #pragma once
 
+#include "irsol/server/handlers/assignment_camera.hpp"
+#include "irsol/server/handlers/assignment_frame_history.hpp"
+#include "irsol/server/handlers/assignment_frame_queue.hpp"
 #include "irsol/server/handlers/assignment_frame_rate.hpp"
 #include "irsol/server/handlers/assignment_image_size.hpp"
 #include "irsol/server/handlers/assignment_input_sequence_length.hpp"
 #include "irsol/server/handlers/assignment_integration_time.hpp"
 #include "irsol/server/handlers/command_abort.hpp"
+#include "irsol/server/handlers/command_burst.hpp"
 #include "irsol/server/handlers/command_gi.hpp"
 #include "irsol/server/handlers/command_gis.hpp"
+#include "irsol/server/handlers/inquiry_camera.hpp"
+#include "irsol/server/handlers/inquiry_frame_queue.hpp"
 #include "irsol/server/handlers/inquiry_frame_rate.hpp"
 #include "irsol/server/handlers/inquiry_image_size.hpp"
 #include "irsol/server/handlers/inquiry_input_sequence_length.hpp"
@@ -0,0 +1,48 @@
+/**
+ * @file irsol/server/handlers/assignment_camera.hpp
+ * @brief Declaration of the AssignmentCameraHandler class.
+ * @ingroup Handlers
+ *
+ * Defines the @ref irsol::server::handlers::AssignmentCameraHandler class,
+ * which handles assignment messages to select the device a client session acquires from.
+ */
+
+#pragma once
+
+#include "irsol/server/handlers/base.hpp"
+
+namespace irsol {
+namespace server {
+namespace handlers {
+
+/**
+ * @brief Handler for assignment of the device parameter `cam`.
+ * @ingroup Handlers
+ *
+ * Processes assignment messages selecting, by name or serial number, the
+ * @ref irsol::server::Device that the following acquisition and camera parameter messages of the
+ * client session refer to.
+ */
+class AssignmentCameraHandler : public AssignmentHandler
+{
+public:
+  /**
+   * @brief Constructs the AssignmentCameraHandler.
+   * @param ctx Handler context.
+   */
+  AssignmentCameraHandler(std::shared_ptr<Context> ctx);
+
+protected:
+  /**
+   * @brief Processes an assignment message to select the device of the session.
+   * @param session The client session.
+   * @param message The assignment message.
+   * @return Vector of outbound messages (success or error).
+   */
+  std::vector<out_message_t> process(
+    std::shared_ptr<irsol::server::ClientSession> session,
+    protocol::Assignment&&                        message) final override;
+};
+}  // namespace handlers
+}  // namespace server
+}  // namespace irsol
@@ -0,0 +1,143 @@
+/**
+ * @file irsol/server/handlers/assignment_frame_history.hpp
+ * @brief Declaration of the handlers retrieving frames from the history of the frame collector.
+ * @ingroup Handlers
+ *
+ * Defines the handlers of the `gh_*` assignments, which send to the client frames that were already
+ * captured, as kept in the @ref irsol::server::frame_collector::FrameHistory, without triggering a
+ * new capture:
+ * - `gh_age=<ms>`: the latest frame, if it's not older than the given number of milliseconds;
+ * - `gh_since=<id>`: all the frames following the frame with the given ID;
+ * - `gh_at=<time>`: the frame nearest to the given time, either as a timestamp string (the format
+ *   of the `timestamp` attribute of the frames) or as a number of seconds since the Unix epoch.
+ *
+ * The frames are sent as image messages, carrying their `imageId` and `timestamp` attributes,
+ * followed by the success of the assignment.
+ */
+
+#pragma once
+
+#include "irsol/server/handlers/base.hpp"
+#include "irsol/server/image_collector.hpp"
+
+#include <vector>
+
+namespace irsol {
+namespace server {
+namespace handlers {
+namespace internal {
+
+/**
+ * @brief Base handler for the retrieval of frames from the frame history (`gh_*`).
+ * @ingroup Handlers
+ *
+ * @see irsol::server::handlers::AssignmentFrameHistoryAgeHandler
+ * @see irsol::server::handlers::AssignmentFrameHistorySinceHandler
+ * @see irsol::server::handlers::AssignmentFrameHistoryAtHandler
+ */
+class AssignmentFrameHistoryHandlerBase : public AssignmentHandler
+{
+public:
+  using frame_ptr_t = irsol::server::frame_collector::FrameHistory::frame_ptr_t;
+
+  /**
+   * @brief Constructs the AssignmentFrameHistoryHandlerBase.
+   * @param ctx Handler context.
+   */
+  AssignmentFrameHistoryHandlerBase(std::shared_ptr<Context> ctx);
+
+protected:
+  /**
+   * @brief Sends the requested frames of the history to the client.
+   * @param session The client session.
+   * @param message The assignment message.
+   * @return Vector of outbound messages (success or error).
+   */
+  std::vector<out_message_t> process(
+    std::shared_ptr<irsol::server::ClientSession> session,
+    protocol::Assignment&&                        message) final override;
+
+private:
+  /**
+   * @brief Validates the value of the assignment.
+   * @param message The assignment message.
+   * @return Error description, empty if the value is valid.
+   */
+  virtual std::string validate(const protocol::Assignment& message) const = 0;
+
+  /**
+   * @brief Retrieves the requested frames from the history.
+   * @param history The history of the frame collector.
+   * @param message The (validated) assignment message.
+   * @return The requested frames, oldest first.
+   */
+  virtual std::vector<frame_ptr_t> retrieve(
+    const irsol::server::frame_collector::FrameHistory& history,
+    const protocol::Assignment&                         message) const = 0;
+
+  /**
+   * @brief Whether an empty result is a valid answer to the request (e.g. no new frame), instead
+   * of an error.
+   */
+  virtual bool acceptsEmptyResult() const;
+};
+}  // namespace internal
+
+/**
+ * @brief Handler for `gh_age`: the latest frame, if it's not older than the given number of
+ * milliseconds.
+ * @ingroup Handlers
+ */
+class AssignmentFrameHistoryAgeHandler : public internal::AssignmentFrameHistoryHandlerBase
+{
+public:
+  using internal::AssignmentFrameHistoryHandlerBase::AssignmentFrameHistoryHandlerBase;
+
+private:
+  std::string validate(const protocol::Assignment& message) const override;
+
+  std::vector<frame_ptr_t> retrieve(
+    const irsol::server::frame_collector::FrameHistory& history,
+    const protocol::Assignment&                         message) const override;
+};
+
+/**
+ * @brief Handler for `gh_since`: the frames following the frame with the given ID.
+ * @ingroup Handlers
+ *
+ * No frame following the given one is a valid answer: the client is up to date.
+ */
+class AssignmentFrameHistorySinceHandler : public internal::AssignmentFrameHistoryHandlerBase
+{
+public:
+  using internal::AssignmentFrameHistoryHandlerBase::AssignmentFrameHistoryHandlerBase;
+
+private:
+  std::string validate(const protocol::Assignment& message) const override;
+
+  std::vector<frame_ptr_t> retrieve(
+    const irsol::server::frame_collector::FrameHistory& history,
+    const protocol::Assignment&                         message) const override;
+
+  bool acceptsEmptyResult() const override;
+};
+
+/**
+ * @brief Handler for `gh_at`: the frame nearest to the given time.
+ * @ingroup Handlers
+ */
+class AssignmentFrameHistoryAtHandler : public internal::AssignmentFrameHistoryHandlerBase
+{
+public:
+  using internal::AssignmentFrameHistoryHandlerBase::AssignmentFrameHistoryHandlerBase;
+
+private:
+  std::string validate(const protocol::Assignment& message) const override;
+
+  std::vector<frame_ptr_t> retrieve(
+    const irsol::server::frame_collector::FrameHistory& history,
+    const protocol::Assignment&                         message) const override;
+};
+}  // namespace handlers
+}  // namespace server
+}  // namespace irsol
@@ -0,0 +1,81 @@
+/**
+ * @file irsol/server/handlers/assignment_frame_queue.hpp
+ * @brief Declaration of the handlers configuring the frame queue of a client session.
+ * @ingroup Handlers
+ *
+ * Defines the handlers of the `fq_*` assignments, which configure the queue through which the
+ * frame collector hands the frames of the next `gis` stream to the client:
+ * - `fq_cap=<n>`: maximum number of frames waiting to be sent, 0 for an unbounded queue;
+ * - `fq_policy=<name>`: behavior once the queue is full, one of `block`, `drop_oldest`,
+ *   `drop_newest` and `latest_only` (see @ref irsol::utils::OverflowPolicy).
+ *
+ * The `drop_oldest` and `drop_newest` policies need a bounded queue: the assignments making them
+ * apply to an unbounded queue are rejected.
+ */
+
+#pragma once
+
+#include "irsol/server/handlers/base.hpp"
+
+namespace irsol {
+namespace server {
+namespace handlers {
+
+/**
+ * @brief Handler for assignment of the frame queue capacity parameter `fq_cap`.
+ * @ingroup Handlers
+ *
+ * Processes assignment messages to set the maximum number of frames waiting to be sent to the
+ * client during the `gis` @ref irsol::protocol::Command.
+ */
+class AssignmentFrameQueueCapacityHandler : public AssignmentHandler
+{
+public:
+  /**
+   * @brief Constructs the AssignmentFrameQueueCapacityHandler.
+   * @param ctx Handler context.
+   */
+  AssignmentFrameQueueCapacityHandler(std::shared_ptr<Context> ctx);
+
+protected:
+  /**
+   * @brief Processes an assignment message to set the frame queue capacity.
+   * @param session The client session.
+   * @param message The assignment message.
+   * @return Vector of outbound messages (success or error).
+   */
+  std::vector<out_message_t> process(
+    std::shared_ptr<irsol::server::ClientSession> session,
+    protocol::Assignment&&                        message) final override;
+};
+
+/**
+ * @brief Handler for assignment of the frame queue overflow policy parameter `fq_policy`.
+ * @ingroup Handlers
+ *
+ * Processes assignment messages to set how the frame collector deals with the client not keeping
+ * up with the `gis` @ref irsol::protocol::Command stream.
+ */
+class AssignmentFrameQueuePolicyHandler : public AssignmentHandler
+{
+public:
+  /**
+   * @brief Constructs the AssignmentFrameQueuePolicyHandler.
+   * @param ctx Handler context.
+   */
+  AssignmentFrameQueuePolicyHandler(std::shared_ptr<Context> ctx);
+
+protected:
+  /**
+   * @brief Processes an assignment message to set the frame queue overflow policy.
+   * @param session The client session.
+   * @param message The assignment message.
+   * @return Vector of outbound messages (success or error).
+   */
+  std::vector<out_message_t> process(
+    std::shared_ptr<irsol::server::ClientSession> session,
+    protocol::Assignment&&                        message) final override;
+};
+}  // namespace handlers
+}  // namespace server
+}  // namespace irsol
@@ -80,17 +80,28 @@ protected:
    * @return Vector of outbound messages (success or error).
    */
   std::vector<out_message_t> process(
-    IRSOL_MAYBE_UNUSED std::shared_ptr<irsol::server::ClientSession> session,
-    protocol::Assignment&&                                           message) final override
+    std::shared_ptr<irsol::server::ClientSession> session,
+    protocol::Assignment&&                        message) final override
   {
-    auto& cam      = ctx->app.camera();
-    auto  resValue = cam.setParam(std::string(name), irsol::utils::toInt(message.value));
+    auto& device = ctx->app.device(*session);
+    if(!device.hasCamera()) {
+      IRSOL_NAMED_LOG_WARN(session->id(), "Device '{}' has no camera parameters", device.name());
+      std::vector<out_message_t> result;
+      result.emplace_back(
+        irsol::protocol::Error::from(message, "The selected device has no camera parameters"));
+      return result;
+    }
+    // The parameter is changed by the acquisition thread, between two captures.
+    auto&      cam      = device.camera();
+    const auto value    = irsol::utils::toInt(message.value);
+    auto       setParam = [&cam, value]() { return cam.setIntParam(std::string(name), value); };
+    auto       resValue = device.frameCollector().control(std::string(name), setParam).get();
     std::vector<out_message_t> result;
 
     // Update the message value with the resulting value after setting the camera parameter.
     // In this way, the resulting value is included in the response message that we broadcast to all
     // clients.
-    message.value = irsol::types::protocol_value_t{resValue};
+    message.value = irsol::types::protocol_value_t{static_cast<int>(resValue)};
     ctx->broadcastMessage(protocol::Success::from(message));
     return {};
   }
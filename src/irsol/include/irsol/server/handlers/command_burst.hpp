@@ -0,0 +1,105 @@
+/**
+ * @file irsol/server/handlers/command_burst.hpp
+ * @brief Declaration of the CommandBurstHandler class.
+ * @ingroup Handlers
+ *
+ * Defines the @ref irsol::server::handlers::CommandBurstHandler class,
+ * which handles the `burst` command for burst frame acquisition.
+ */
+
+#pragma once
+
+#include "irsol/server/handlers/command_gi_base.hpp"
+
+namespace irsol {
+namespace server {
+namespace handlers {
+
+/**
+ * @brief Handler for the `burst` command (burst frame acquisition).
+ * @ingroup Handlers
+ *
+ * Processes the `burst` command to acquire a sequence of frames as fast as the camera allows,
+ * faster than they could be sent over the network. The number of frames is the input sequence
+ * length of the session (as for the `gis` command). The frames are captured back-to-back into
+ * memory, and only then sent to the client, at the rate its connection allows. Each frame is
+ * followed by its input sequence number (`isn`) and by its actual interval from the previous
+ * frame, in microseconds (`dt`).
+ *
+ * @see irsol::server::frame_collector::FrameCollector::registerBurst
+ */
+class CommandBurstHandler : public internal::CommandGIBaseHandler
+{
+public:
+  /// Longest burst, bounding the memory held by the frames of a burst.
+  constexpr static uint64_t MAX_BURST_LENGTH = 1000;
+
+  /**
+   * @brief Constructs the CommandBurstHandler.
+   * @param ctx Handler context.
+   */
+  CommandBurstHandler(std::shared_ptr<Context> ctx);
+
+private:
+  /**
+   * @brief Validates the `burst` command parameters.
+   * @param message The command message.
+   * @param session The client session.
+   * @return Vector of outbound error messages (empty if valid).
+   */
+  std::vector<irsol::protocol::OutMessage> validate(
+    const protocol::Command&                      message,
+    std::shared_ptr<irsol::server::ClientSession> session) const override;
+
+  /**
+   * @brief Returns the number of frames of the burst.
+   * @param message The command message.
+   * @param session The client session.
+   * @return Number of frames to acquire.
+   * @note This method picks the input sequence length from the @ref irsol::server::ClientSession
+   * state.
+   */
+  uint64_t getInputSequenceLength(
+    const protocol::Command&                      message,
+    std::shared_ptr<irsol::server::ClientSession> session) const override;
+
+  /**
+   * @brief Returns the frame rate for the `burst` command.
+   * @param message The command message.
+   * @param session The client session.
+   * @return 0: the frames are captured as fast as possible.
+   */
+  double getFrameRate(
+    const protocol::Command&                      message,
+    std::shared_ptr<irsol::server::ClientSession> session) const override;
+
+  /**
+   * @brief Creates the frame queue for the `burst` command.
+   * @param message The command message.
+   * @param session The client session.
+   * @return Frame queue holding the whole burst.
+   */
+  std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t> makeFrameQueue(
+    const protocol::Command&                      message,
+    std::shared_ptr<irsol::server::ClientSession> session) const override;
+
+  /**
+   * @brief Registers the client for a burst in the frame collector.
+   * @see irsol::server::frame_collector::FrameCollector::registerBurst
+   */
+  void registerClient(
+    irsol::server::frame_collector::FrameCollector&                                collector,
+    std::shared_ptr<irsol::server::ClientSession>                                  session,
+    std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t> queue,
+    uint64_t                                                                       numFrames,
+    double fps) const override;
+
+  /**
+   * @brief The frames of a burst are sent once all of them have been acquired.
+   * @return Always `true`.
+   */
+  bool deliversAfterAcquisition() const override;
+};
+}  // namespace handlers
+}  // namespace server
+}  // namespace irsol
@@ -60,6 +60,16 @@ private:
   double getFrameRate(
     const protocol::Command&                      message,
     std::shared_ptr<irsol::server::ClientSession> session) const override;
+
+  /**
+   * @brief Creates the frame queue for the `gi` command.
+   * @param message The command message.
+   * @param session The client session.
+   * @return Frame queue holding the single requested frame.
+   */
+  std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t> makeFrameQueue(
+    const protocol::Command&                      message,
+    std::shared_ptr<irsol::server::ClientSession> session) const override;
 };
 }  // namespace handlers
 }  // namespace server
@@ -8,6 +8,7 @@
  *
  * @see irsol::server::handlers::CommandGIHandler
  * @see irsol::server::handlers::CommandGISHandler
+ * @see irsol::server::handlers::CommandBurstHandler
  */
 
 #pragma once
@@ -21,17 +22,26 @@ namespace handlers {
 namespace internal {
 
 /**
- * @brief Base handler for frame acquisition commands (`gi`, `gis`).
+ * @brief Base handler for frame acquisition commands (`gi`, `gis`, `burst`).
  * @ingroup Handlers
  *
  * Provides common logic for starting frame collection and managing client registration.
  *
+ * The frames are sent by a listening thread, which drains the frames queued for the client in
+ * batches (see @ref MAX_FRAMES_PER_BATCH), and which stops within milliseconds of an `abort`,
+ * whatever the frame rate of the acquisition. Commands delivering after the acquisition (see
+ * @ref deliversAfterAcquisition()) only start sending once all their frames are captured.
+ *
  * @see irsol::server::handlers::CommandGIHandler
  * @see irsol::server::handlers::CommandGISHandler
+ * @see irsol::server::handlers::CommandBurstHandler
  */
 class CommandGIBaseHandler : public CommandHandler
 {
 public:
+  /// Maximum number of queued frames sent to the client in a single batch.
+  constexpr static size_t MAX_FRAMES_PER_BATCH = 8;
+
   /**
    * @brief Constructs the CommandGIBaseHandler.
    * @param ctx Handler context.
@@ -100,6 +110,51 @@ private:
     const protocol::Command&                      message,
     std::shared_ptr<irsol::server::ClientSession> session) const = 0;
 
+  /**
+   * @brief Creates the queue through which the collected frames are handed to the client.
+   * @param message The command message.
+   * @param session The client session.
+   * @return Frame queue, whose capacity and overflow policy define how the frame collector deals
+   * with a client consuming frames slower than they are produced.
+   * @note This method must be implemented by derived classes to provide specific queueing logic.
+   * @see irsol::server::frame_collector::FrameCollector::makeQueuePtr
+   * @see irsol::server::handlers::CommandGIHandler::makeFrameQueue
+   * @see irsol::server::handlers::CommandGISHandler::makeFrameQueue
+   */
+  virtual std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t>
+  makeFrameQueue(
+    const protocol::Command&                      message,
+    std::shared_ptr<irsol::server::ClientSession> session) const = 0;
+
+  /**
+   * @brief Registers the client in the frame collector.
+   *
+   * By default, the client is registered for @p numFrames frames at @p fps frames per second.
+   *
+   * @param collector The frame collector of the session's device.
+   * @param session   The client session.
+   * @param queue     The frame queue of the client.
+   * @param numFrames Number of frames to acquire.
+   * @param fps       Frame rate for acquisition.
+   * @see irsol::server::frame_collector::FrameCollector::registerClient
+   */
+  virtual void registerClient(
+    irsol::server::frame_collector::FrameCollector&                                collector,
+    std::shared_ptr<irsol::server::ClientSession>                                  session,
+    std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t> queue,
+    uint64_t                                                                       numFrames,
+    double                                                                         fps) const;
+
+  /**
+   * @brief Whether the frames are sent only once all of them have been acquired.
+   *
+   * In this case, nothing is sent to the client during the acquisition, and each frame is
+   * followed by its interval from the previous frame, in microseconds (`dt` status).
+   *
+   * @return `false` by default: frames are sent as soon as they are acquired.
+   */
+  virtual bool deliversAfterAcquisition() const;
+
   /**
    * @brief Starts the frame listening thread for the client session.
    * @param session The client session.
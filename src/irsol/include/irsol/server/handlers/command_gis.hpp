@@ -63,6 +63,17 @@ private:
   double getFrameRate(
     const protocol::Command&                      message,
     std::shared_ptr<irsol::server::ClientSession> session) const override;
+
+  /**
+   * @brief Creates the frame queue for the `gis` command.
+   * @param message The command message.
+   * @param session The client session.
+   * @return Frame queue with the capacity and overflow policy stored in the
+   * @ref irsol::server::ClientSession state.
+   */
+  std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t> makeFrameQueue(
+    const protocol::Command&                      message,
+    std::shared_ptr<irsol::server::ClientSession> session) const override;
 };
 }  // namespace handlers
 }  // namespace server
@@ -0,0 +1,47 @@
+/**
+ * @file irsol/server/handlers/inquiry_camera.hpp
+ * @brief Declaration of the InquiryCameraHandler class.
+ * @ingroup Handlers
+ *
+ * Defines the @ref irsol::server::handlers::InquiryCameraHandler class,
+ * which handles inquiry messages to retrieve the device a client session acquires from.
+ */
+
+#pragma once
+
+#include "irsol/server/handlers/base.hpp"
+
+namespace irsol {
+namespace server {
+namespace handlers {
+
+/**
+ * @brief Handler for inquiry of the device parameter `cam`.
+ * @ingroup Handlers
+ *
+ * Processes inquiry messages to retrieve the name of the device selected by the client session,
+ * the default device of the application if none was selected.
+ */
+class InquiryCameraHandler : public InquiryHandler
+{
+public:
+  /**
+   * @brief Constructs the InquiryCameraHandler.
+   * @param ctx Handler context.
+   */
+  InquiryCameraHandler(std::shared_ptr<Context> ctx);
+
+protected:
+  /**
+   * @brief Processes an inquiry message to retrieve the device of the session.
+   * @param session The client session.
+   * @param message The inquiry message.
+   * @return Vector of outbound messages containing the device name.
+   */
+  std::vector<out_message_t> process(
+    std::shared_ptr<irsol::server::ClientSession> session,
+    protocol::Inquiry&&                           message) final override;
+};
+}  // namespace handlers
+}  // namespace server
+}  // namespace irsol
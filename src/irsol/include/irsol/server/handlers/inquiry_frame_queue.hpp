@@ -0,0 +1,104 @@
+/**
+ * @file irsol/server/handlers/inquiry_frame_queue.hpp
+ * @brief Declaration of the handlers inquiring the frame queue of a client session.
+ * @ingroup Handlers
+ *
+ * Defines the handlers of the `fq_*` inquiries:
+ * - `fq_cap?`: capacity of the frame queue (see @ref
+ *   irsol::server::handlers::AssignmentFrameQueueCapacityHandler);
+ * - `fq_policy?`: overflow policy of the frame queue (see @ref
+ *   irsol::server::handlers::AssignmentFrameQueuePolicyHandler);
+ * - `fq_dropped?`: number of frames that could not be delivered to the client because its queue
+ *   was full, for the running stream or, if none, for the last one.
+ */
+
+#pragma once
+
+#include "irsol/server/handlers/base.hpp"
+
+namespace irsol {
+namespace server {
+namespace handlers {
+
+/**
+ * @brief Handler for inquiry of the frame queue capacity parameter.
+ * @ingroup Handlers
+ */
+class InquiryFrameQueueCapacityHandler : public InquiryHandler
+{
+public:
+  /**
+   * @brief Constructs the InquiryFrameQueueCapacityHandler.
+   * @param ctx Handler context.
+   */
+  InquiryFrameQueueCapacityHandler(std::shared_ptr<Context> ctx);
+
+protected:
+  /**
+   * @brief Processes an inquiry message to retrieve the frame queue capacity.
+   * @param session The client session.
+   * @param message The inquiry message.
+   * @return Vector of outbound messages containing the frame queue capacity.
+   */
+  std::vector<out_message_t> process(
+    std::shared_ptr<irsol::server::ClientSession> session,
+    protocol::Inquiry&&                           message) final override;
+};
+
+/**
+ * @brief Handler for inquiry of the frame queue overflow policy parameter.
+ * @ingroup Handlers
+ */
+class InquiryFrameQueuePolicyHandler : public InquiryHandler
+{
+public:
+  /**
+   * @brief Constructs the InquiryFrameQueuePolicyHandler.
+   * @param ctx Handler context.
+   */
+  InquiryFrameQueuePolicyHandler(std::shared_ptr<Context> ctx);
+
+protected:
+  /**
+   * @brief Processes an inquiry message to retrieve the frame queue overflow policy.
+   * @param session The client session.
+   * @param message The inquiry message.
+   * @return Vector of outbound messages containing the name of the overflow policy.
+   */
+  std::vector<out_message_t> process(
+    std::shared_ptr<irsol::server::ClientSession> session,
+    protocol::Inquiry&&                           message) final override;
+};
+
+/**
+ * @brief Handler for inquiry of the number of frames dropped for the client.
+ * @ingroup Handlers
+ *
+ * While the client is registered in the frame collector, the count is read from
+ * @ref irsol::server::frame_collector::FrameCollector::droppedFrames(), otherwise the count of the
+ * last stream of the session is returned. With the `block` policy, no frame is dropped: the
+ * delivery of a frame that doesn't fit in the full queue is postponed to the next capture.
+ */
+class InquiryFrameQueueDroppedHandler : public InquiryHandler
+{
+public:
+  /**
+   * @brief Constructs the InquiryFrameQueueDroppedHandler.
+   * @param ctx Handler context.
+   */
+  InquiryFrameQueueDroppedHandler(std::shared_ptr<Context> ctx);
+
+protected:
+  /**
+   * @brief Processes an inquiry message to retrieve the number of dropped frames.
+   * @param session The client session.
+   * @param message The inquiry message.
+   * @return Vector of outbound messages containing the number of dropped frames.
+   */
+  std::vector<out_message_t> process(
+    std::shared_ptr<irsol::server::ClientSession> session,
+    protocol::Inquiry&&                           message) final override;
+};
+}  // namespace handlers
+}  // namespace server
+}  // namespace irsol
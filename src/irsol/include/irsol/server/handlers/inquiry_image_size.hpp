@@ -78,11 +78,19 @@ protected:
    * @return Vector of outbound messages containing the parameter value.
    */
   std::vector<out_message_t> process(
-    IRSOL_MAYBE_UNUSED std::shared_ptr<irsol::server::ClientSession> session,
-    protocol::Inquiry&&                                              message) final override
+    std::shared_ptr<irsol::server::ClientSession> session,
+    protocol::Inquiry&&                           message) final override
   {
-    auto&                      cam   = ctx->app.camera();
-    int                        value = cam.getParam<int>(std::string(name));
+    auto& device = ctx->app.device(*session);
+    if(!device.hasCamera()) {
+      IRSOL_NAMED_LOG_WARN(session->id(), "Device '{}' has no camera parameters", device.name());
+      std::vector<out_message_t> result;
+      result.emplace_back(
+        irsol::protocol::Error::from(message, "The selected device has no camera parameters"));
+      return result;
+    }
+    auto&                      cam   = device.camera();
+    auto                       value = static_cast<int>(cam.getIntParam(std::string(name)));
     std::vector<out_message_t> result;
     result.emplace_back(protocol::Success::from(message, irsol::types::protocol_value_t{value}));
     return result;
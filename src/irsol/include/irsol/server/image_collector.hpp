@@ -1,5 +1,10 @@
 #pragma once
 
 #include "irsol/server/image_collector/collector.hpp"
+#include "irsol/server/image_collector/control.hpp"
 #include "irsol/server/image_collector/frame.hpp"
+#include "irsol/server/image_collector/history.hpp"
 #include "irsol/server/image_collector/params.hpp"
+#include "irsol/server/image_collector/scheduler.hpp"
+#include "irsol/server/image_collector/source.hpp"
+#include "irsol/server/image_collector/statistics.hpp"
@@ -1,18 +1,25 @@
 #pragma once
 
 #include "irsol/camera/interface.hpp"
+#include "irsol/queue.hpp"
+#include "irsol/server/image_collector/control.hpp"
 #include "irsol/server/image_collector/frame.hpp"
+#include "irsol/server/image_collector/history.hpp"
 #include "irsol/server/image_collector/params.hpp"
+#include "irsol/server/image_collector/scheduler.hpp"
+#include "irsol/server/image_collector/source.hpp"
 #include "irsol/types.hpp"
 #include "irsol/utils.hpp"
 
 #include <atomic>
 #include <condition_variable>
 #include <deque>
-#include <map>
+#include <future>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 /**
@@ -30,6 +37,18 @@ namespace irsol {
 namespace server {
 namespace frame_collector {
 
+/**
+ * @ingroup FrameCollector
+ * @brief Strategy used by the @ref irsol::server::frame_collector::FrameCollector to acquire
+ * frames.
+ */
+enum class CollectionMode
+{
+  JUST_IN_TIME,  ///< A software-triggered capture is performed for each scheduled delivery.
+  CONTINUOUS,    ///< The camera runs freely, and captured frames are selected for delivery.
+  HARMONIC  ///< Like just-in-time, with the frame rates snapped to a grid of power-of-two rates.
+};
+
 /**
  * @ingroup FrameCollector
  * @brief Coordinates frame acquisition from a camera and distributes frames to registered clients.
@@ -43,26 +62,80 @@ namespace frame_collector {
  * frame image is requested from the camera and distributed to all those clients.
  *
  * The collector maintains a background thread that monitors client schedules, captures frames
- * just-in-time, and pushes them into client-specific @ref irsol::utils::SafeQueue. Clients can
+ * just-in-time, and pushes them into client-specific @ref irsol::utils::SafeQueue. The frame
+ * pushed to the queues is shared among all clients served by the same capture, so the cost of
+ * a capture does not depend on the number of clients receiving it. Clients can
  * consume frames from these queues at their own pace. When a client has received its requested
  * number of frames, it is automatically deregistered and its queue is marked as complete.
  *
  * The scheduling strategy is as follows:
  * - Each client registers with a desired frame rate (fps) and frame count.
  * - The collector maintains a schedule of when each client is next due to receive a frame.
- * - When the earliest scheduled time arrives (or is within the allowed slack), the collector
- *   captures a single frame and distributes it to all clients whose schedules fall within the
- *   slack window.
+ * - When the earliest scheduled time arrives, the collector captures a single frame and
+ *   distributes it to all clients whose schedules fall within their slack window.
  * - This batching reduces redundant camera captures and ensures efficient resource usage.
+ *
+ * The slack of each client is adapted to its own frame interval: a client may be served up to
+ * @ref MAX_EARLY_FRACTION of its interval early, so that slow clients are easily merged into the
+ * captures of the others, while fast clients see no visible timing jitter. As the camera is busy
+ * for the whole duration of a capture, a client due before the capture would complete is also
+ * served by it (instead of waiting for the next capture), up to half its interval. The duration
+ * of a capture is estimated from the exposure of the frame source, and from the measured duration
+ * of the previous captures. The number of captures saved by batching is reported by
+ * @ref numSavedCaptures().
  * - The collector supports dynamic registration and deregistration of clients at runtime.
  *
- * @note
- * The current scheduling strategy can be extended or modified. For example, one might restrict
- * allowed FPS values to multiples of 0.125s (i.e., FPS = 0.125, 0.25, 0.5, 1, 2, 4, 8, 16).
- * In this approach, the FrameCollector would continuously capture frames at the highest frame
- * rate required by any connected client, without scheduling individual capture times. A delivery
- * selection mechanism could then be implemented to determine which captured frames are delivered
- * to which clients, simplifying the scheduling logic and potentially improving efficiency.
+ * Single-frame clients (e.g. the `gi` command) are served with the lowest possible latency: a
+ * client registering while a capture is in flight joins that capture, otherwise a capture is
+ * triggered at once (together with the other clients due within their slack).
+ *
+ * Burst clients (e.g. the `burst` command, see @ref registerBurst()) have their frames captured
+ * back-to-back, as fast as the frame source allows, and queued in memory: the acquisition rate
+ * doesn't depend on the rate at which they are delivered.
+ *
+ * Internally, each registered client is identified by a small integer handle, and the due times
+ * are kept in a @ref irsol::server::frame_collector::Scheduler (a min-heap indexed by handle).
+ * The string client identifiers are only looked up on (de)registration, and the distribution loop
+ * does not allocate memory for scheduling in steady state.
+ *
+ * Two acquisition strategies are available, see @ref irsol::server::frame_collector::CollectionMode:
+ * - In the just-in-time mode (default), the strategy above is used: a software-triggered capture
+ *   is performed each time a batch of clients is due.
+ * - In the continuous mode, the frame source runs freely at the highest frame rate required by
+ *   any registered client (or as fast as possible if only single-frame clients are registered),
+ *   avoiding the start/trigger/stop overhead of each capture. Each produced frame is then delivered
+ *   to the clients whose next due time falls within half a frame period of the frame's timestamp.
+ *   The acquisition is restarted whenever the required frame rate changes, and stopped when no
+ *   clients are registered.
+ * - In the harmonic mode, the requested frame rates are snapped to the nearest power of two
+ *   between @ref HARMONIC_MIN_FPS and @ref HARMONIC_MAX_FPS, and all the deliveries happen on a
+ *   single master cadence of ticks, @ref HARMONIC_TICK apart. A client at `f` fps is served every
+ *   `HARMONIC_MAX_FPS / f` ticks, on the ticks that are a multiple of that number: the ticks of a
+ *   slower client are a subset of the ones of any faster client, so the clients always share
+ *   their captures, and the camera is triggered at the rate of the fastest client only. A client
+ *   joining running streams receives its first frame on its next tick, i.e. within one of its
+ *   intervals. Single-frame clients are served immediately, as in the just-in-time mode.
+ *
+ * Acquisition and distribution are pipelined over two background threads:
+ * - the acquisition thread decides when frames are needed, and talks to the frame source. The
+ *   lock protecting the client tables is only held for the scheduling bookkeeping, and never
+ *   while waiting for the camera, so (de)registrations do not wait for an exposure to complete;
+ * - the distribution thread receives the captured frames through a small hand-off queue, and
+ *   pushes them to the client queues.
+ * In this way, the capture of a frame overlaps the distribution of the previous one. In the
+ * just-in-time and harmonic modes, the captures are submitted to the frame source without waiting
+ * for them (see @ref FrameSource::submitCapture()): the acquisition thread goes on scheduling
+ * while the frame is acquired, and triggers the next capture as soon as it's due, up to
+ * @ref FrameSource::maxPendingCaptures() pending captures, and no more often than every
+ * @ref FrameSource::triggerInterval(). When the source accepts several pending captures (e.g. with
+ * overlapped triggering), a streaming client is scheduled for its next frame as soon as its
+ * capture is submitted, so that the next exposure can start during the readout of the current
+ * frame. A capture that doesn't complete within its expected duration plus
+ * @ref CAPTURE_TIMEOUT_MARGIN fails, together with the captures submitted after it.
+ *
+ * Changes to the camera parameters are submitted through @ref control(), and applied by the
+ * acquisition thread between two captures (see @ref irsol::server::frame_collector::ControlQueue):
+ * a parameter never changes while a frame is being acquired.
  *
  * Thread safety: All public methods are thread-safe unless otherwise noted.
  */
@@ -74,28 +147,148 @@ public:
   /**
    * @brief Utility static function to create a shared pointer to a frame queue.
    *
-   * Clients may use this to obtain a queue prior to registering with the collector.
+   * Clients may use this to obtain a queue prior to registering with the collector. The capacity
+   * and overflow policy of the queue decide how the collector handles a client that consumes
+   * frames slower than they are delivered:
+   * - @ref irsol::utils::OverflowPolicy::BLOCK: once the queue is full, the frames due to the client
+   *   are skipped, without consuming its requested frame count. The client then receives all the
+   *   frames it requested, at the rate it is able to sustain.
+   * - @ref irsol::utils::OverflowPolicy::DROP_OLDEST, @ref irsol::utils::OverflowPolicy::DROP_NEWEST:
+   *   the oldest queued frame, or the new frame, is discarded.
+   * - @ref irsol::utils::OverflowPolicy::LATEST_ONLY: only the most recent frame is kept, which is
+   *   what live viewers want.
+   *
+   * In all cases the collector never waits for a client. The number of frames discarded by a
+   * dropping policy is tracked (see @ref droppedFrames()); the skipped deliveries of the BLOCK
+   * policy are not lost frames, and are only counted by the `rejected()` count of the queue.
+   *
+   * @param capacity Maximum number of frames held by the queue, 0 for an unbounded queue.
+   * @param policy   Behavior of the queue when it's full.
    * @return Shared pointer to a new frame queue.
    * @see irsol::utils::SafeQueue
    * @see irsol::server::handlers::CommandGIHandler
    * @see irsol::server::handlers::CommandGISHandler
    */
-  static std::shared_ptr<frame_queue_t> makeQueuePtr();
+  static std::shared_ptr<frame_queue_t> makeQueuePtr(
+    size_t                       capacity = 0,
+    irsol::utils::OverflowPolicy policy   = irsol::utils::OverflowPolicy::BLOCK);
+
+  /**
+   * @brief Builds the shared frame distributed to all the clients served by a single capture.
+   *
+   * The image data is moved into the frame and never copied afterwards: every client queue
+   * receives a reference to the same, read-only, frame.
+   *
+   * @param metadata  Metadata of the captured frame.
+   * @param imageData Raw image bytes; ownership is transferred to the frame.
+   * @return Shared pointer to the newly created frame.
+   */
+  static std::shared_ptr<const Frame> makeFrame(
+    FrameMetadata                       metadata,
+    std::vector<irsol::types::byte_t>&& imageData);
+
+  /**
+   * @brief Builds the shared frame distributed to all the clients served by a single capture.
+   *
+   * @param metadata  Metadata of the captured frame.
+   * @param imageData Shared storage of the raw image bytes (e.g. a buffer of a
+   *                  @ref irsol::utils::BufferPool), which is not copied.
+   * @return Shared pointer to the newly created frame.
+   */
+  static std::shared_ptr<const Frame> makeFrame(
+    FrameMetadata                               metadata,
+    irsol::protocol::ImageBinaryData::storage_t imageData);
+
+  /**
+   * @brief Delay of the first delivery to a newly registered streaming client, in just-in-time
+   * mode.
+   *
+   * Clients registering at about the same time can in this way share their first capture.
+   * Single-frame clients are not delayed: they are served by the capture in flight, if any, or
+   * else by a capture triggered at once.
+   */
+  constexpr static irsol::types::duration_t REGISTRATION_DELAY = std::chrono::milliseconds(50);
+
+  /**
+   * @brief Fraction of its frame interval by which a client may be served early, in
+   * just-in-time mode.
+   *
+   * Clients whose scheduled delivery times fall within this fraction of their interval from a
+   * capture all receive the same frame. This reduces redundant captures and improves efficiency.
+   */
+  constexpr static double MAX_EARLY_FRACTION = 0.1;
+
+  /**
+   * @brief Weight of the last measured capture duration in the running estimate of the duration
+   * of a capture.
+   */
+  constexpr static double CAPTURE_DURATION_WEIGHT = 0.125;
+
+  /**
+   * @brief Maximum number of captured frames waiting to be distributed.
+   *
+   * When the distribution stage lags behind, the acquisition stage waits before capturing more
+   * frames.
+   */
+  constexpr static size_t HANDOFF_CAPACITY = 4;
+
+  /**
+   * @brief Time waited for a submitted capture, on top of its expected duration, before the
+   * pending captures are stopped.
+   */
+  constexpr static irsol::types::duration_t CAPTURE_TIMEOUT_MARGIN =
+    std::chrono::milliseconds(200);
+
+  /**
+   * @brief Default number of frames kept in the history of the collector.
+   *
+   * The frames of the history stay referenced, and so does their image data: a camera acquiring
+   * into user buffers needs this many buffers on top of the ones it captures into.
+   */
+  constexpr static size_t DEFAULT_HISTORY_CAPACITY = 8;
+
+  /// Lowest frame rate of the harmonic mode, see @ref CollectionMode::HARMONIC.
+  constexpr static double HARMONIC_MIN_FPS = 0.125;
+
+  /// Highest frame rate of the harmonic mode, see @ref CollectionMode::HARMONIC.
+  constexpr static double HARMONIC_MAX_FPS = 16.0;
+
+  /// Interval between two ticks of the master cadence of the harmonic mode.
+  constexpr static std::chrono::microseconds HARMONIC_TICK =
+    std::chrono::microseconds(static_cast<int64_t>(1000000.0 / HARMONIC_MAX_FPS));
 
   /**
-   * @brief Slack window for batching frame delivery to clients.
+   * @brief Snaps a frame rate to the grid of the harmonic mode.
    *
-   * Clients whose scheduled delivery times fall within this window of a captured frame
-   * will all receive the same frame. This reduces redundant captures and improves efficiency.
+   * @param fps Requested frame rate.
+   * @return The power of two nearest to @p fps (in ratio), clamped to the range
+   *         [@ref HARMONIC_MIN_FPS, @ref HARMONIC_MAX_FPS].
    */
-  constexpr static irsol::types::duration_t SLACK = std::chrono::milliseconds(50);
+  static double snapToHarmonicGrid(double fps);
 
   /**
    * @brief Constructs a FrameCollector for the given camera interface.
    *
-   * @param camera Reference to a camera interface for capturing frames.
+   * @param camera          Reference to a camera interface for capturing frames.
+   * @param mode            Acquisition strategy used by the collector.
+   * @param historyCapacity Number of frames kept in the history, see @ref history().
+   */
+  FrameCollector(
+    irsol::camera::Interface& camera,
+    CollectionMode            mode            = CollectionMode::JUST_IN_TIME,
+    size_t                    historyCapacity = DEFAULT_HISTORY_CAPACITY);
+
+  /**
+   * @brief Constructs a FrameCollector acquiring frames from an arbitrary frame source.
+   *
+   * @param source          Frame source used for capturing frames. Ownership is transferred.
+   * @param mode            Acquisition strategy used by the collector.
+   * @param historyCapacity Number of frames kept in the history, see @ref history().
    */
-  FrameCollector(irsol::camera::Interface& camera);
+  FrameCollector(
+    std::unique_ptr<FrameSource> source,
+    CollectionMode               mode            = CollectionMode::JUST_IN_TIME,
+    size_t                       historyCapacity = DEFAULT_HISTORY_CAPACITY);
 
   /**
    * @brief Destructor. Stops any running threads and cleans up resources.
@@ -103,7 +296,7 @@ public:
   ~FrameCollector();
 
   /**
-   * @brief Starts the frame collection and distribution thread.
+   * @brief Starts the frame acquisition and distribution threads.
    *
    * If the collector is already running, this call is ignored.
    */
@@ -123,6 +316,11 @@ public:
    */
   bool isBusy() const;
 
+  /**
+   * @brief Returns the acquisition strategy used by the collector.
+   */
+  CollectionMode mode() const;
+
   /**
    * @brief Registers a client to receive frames at a specified frame rate.
    *
@@ -143,6 +341,30 @@ public:
     std::shared_ptr<frame_queue_t> queue,
     int64_t                        frameCount = -1);
 
+  /**
+   * @brief Registers a client for a burst of frames, captured as fast as the source allows.
+   *
+   * The frames are captured back-to-back, whatever the collection mode, and pushed into the queue
+   * of the client as they are captured: the rate at which the client sends them on (e.g. to a
+   * socket) doesn't slow down the acquisition. The buffers of all the frames are allocated up
+   * front (see @ref FrameSource::reserveFrames()), and the queue must be able to hold the whole
+   * burst. The timestamps of the frames record their actual acquisition times.
+   *
+   * After the last frame has been pushed, the client is deregistered and its queue marked as
+   * complete. Once no burst client is registered anymore (whether its burst completed or not),
+   * the reservation of the source is released (see @ref FrameSource::releaseFrames()).
+   *
+   * @param clientId   Unique identifier for the client.
+   * @param queue      Queue receiving the frames of the burst.
+   * @param frameCount Number of frames of the burst, at least 1.
+   * @see irsol::server::handlers::CommandBurstHandler
+   * @note This method is thread-safe.
+   */
+  void registerBurst(
+    irsol::types::client_id_t      clientId,
+    std::shared_ptr<frame_queue_t> queue,
+    uint64_t                       frameCount);
+
   /**
    * @brief Deregisters a client and stops frame delivery.
    *
@@ -153,16 +375,234 @@ public:
    */
   void deregisterClient(irsol::types::client_id_t clientId);
 
+  /**
+   * @brief Returns the number of frames discarded by the overflow policy of a client's queue,
+   * because it was full.
+   *
+   * @param clientId The client's unique identifier.
+   * @return The number of dropped frames, or `std::nullopt` if the client is not registered.
+   * @note This method is thread-safe.
+   */
+  std::optional<uint64_t> droppedFrames(const irsol::types::client_id_t& clientId);
+
+  /**
+   * @brief Returns the timing statistics of the frames delivered to a client.
+   *
+   * @param clientId The client's unique identifier.
+   * @return A copy of the statistics, or `std::nullopt` if the client is not registered.
+   * @note This method is thread-safe.
+   */
+  std::optional<TimingStatistics> timingStatistics(const irsol::types::client_id_t& clientId);
+
+  /**
+   * @brief Returns the number of frames captured for delivery since construction.
+   */
+  uint64_t numCaptures() const;
+
+  /**
+   * @brief Returns the number of captures saved by batching deliveries, since construction.
+   *
+   * Each capture serving `N` clients saves `N - 1` captures.
+   */
+  uint64_t numSavedCaptures() const;
+
+  /**
+   * @brief Returns the history of the last captured frames.
+   *
+   * Every captured frame enters the history, whether it was delivered to a client or not (e.g.
+   * in continuous mode). Retrieving frames from the history does not trigger any capture.
+   */
+  const FrameHistory& history() const;
+
+  /**
+   * @brief Restricts the acquisition and distribution threads of the collector to a single CPU.
+   *
+   * Collectors of different cameras pinned to different CPUs acquire in parallel without
+   * competing for the same core, and keep their working set in that core's cache.
+   *
+   * @param cpu Index of the CPU.
+   * @return true if the threads were pinned, false if not supported or if the CPU is invalid.
+   */
+  bool pinToCpu(size_t cpu);
+
+  /**
+   * @brief Queues an operation on the camera, executed by the acquisition thread between captures.
+   *
+   * The operation is executed at once (on the calling thread) if the acquisition thread is not
+   * running. Consecutive operations on the same feature are coalesced, see
+   * @ref irsol::server::frame_collector::ControlQueue.
+   *
+   * @param feature   Name of the camera feature targeted by the operation.
+   * @param operation Callable performing the operation, and returning its result.
+   * @return Future receiving the result of the operation.
+   */
+  template<typename Callable>
+  auto control(const std::string& feature, Callable&& operation)
+  {
+    auto future = m_control.submit(feature, std::forward<Callable>(operation));
+    bool acquiring;
+    {
+      // Checked under the lock, so that the acquisition thread either drains the operation before
+      // exiting, or is observed as not running.
+      std::scoped_lock<std::mutex> lock(m_clientsMutex);
+      acquiring = m_acquiring;
+    }
+    if(acquiring) {
+      m_scheduleCondition.notify_all();
+    } else {
+      m_control.runPending();
+    }
+    return future;
+  }
+
+  /// Number of camera operations that were coalesced into a following one.
+  uint64_t numCoalescedControls() const;
+
 private:
+  /// A client served by a frame in the acquisition pipeline.
+  struct ReadyClient
+  {
+    Scheduler::Entry entry;               ///< Handle and due time of the client.
+    uint64_t         generation;          ///< Generation of the handle when it was selected.
+    bool             rescheduled{false};  ///< Whether the next frame was scheduled ahead.
+  };
+
+  /// A captured frame handed over from the acquisition to the distribution stage.
+  struct CapturedFrame
+  {
+    FrameSource::captured_data_t data;  ///< Metadata and raw image data of the frame.
+    std::vector<ReadyClient>
+      clients;  ///< Just-in-time mode: clients for which the frame was captured.
+    irsol::types::duration_t
+      tolerance{};  ///< Continuous mode: tolerance used to select the clients due for the frame.
+    std::optional<irsol::types::timepoint_t>
+      triggerTime{};  ///< Just-in-time mode: time at which the capture was triggered.
+    FrameSource::capture_future_t
+      pending{};  ///< Just-in-time mode: submitted capture, completed by the frame source.
+    irsol::types::timepoint_t
+      deadline{};  ///< Just-in-time mode: time after which the submitted capture is abandoned.
+  };
+
+  /**
+   * @brief Runs the frame acquisition loop in a background thread.
+   *
+   * Dispatches to the loop matching the collector's @ref CollectionMode, and marks the hand-off
+   * queue as finished once the collector is stopped.
+   */
+  void runAcquisition();
+
+  /**
+   * @brief Frame acquisition loop of the just-in-time mode.
+   *
+   * This method monitors client schedules and, once clients are due, selects all the clients
+   * whose scheduled delivery times fall within the current slack window. A single frame capture
+   * is then submitted for all of them, and handed over to the distribution stage without waiting
+   * for it: up to @ref FrameSource::maxPendingCaptures() captures are in the pipeline at once.
+   * The selected clients are rescheduled by the distribution stage, once the frame is delivered.
+   */
+  void runJustInTime();
+
+  /**
+   * @brief Frame acquisition loop of the continuous mode.
+   *
+   * Keeps the frame source running at the rate required by the registered clients, and hands
+   * over each produced frame to the distribution stage.
+   */
+  void runContinuous();
+
+  /**
+   * @brief Accounts for the completion of a submitted capture.
+   *
+   * The clients that joined the pending captures are served by the completed one. If the capture
+   * failed, its clients are rescheduled.
+   *
+   * @param captured   The submitted capture, receiving the captured frame.
+   * @param result     Result of the capture.
+   * @param completion Time at which the capture completed.
+   * @return true if the captured frame must be delivered.
+   * @note This method is NOT thread-safe and should only be called with appropriate locking.
+   */
+  bool completeCapture(
+    CapturedFrame&                  captured,
+    FrameSource::captured_frame_t&& result,
+    irsol::types::timepoint_t       completion);
+
+  /**
+   * @brief Executes the queued camera operations, between two captures.
+   * @param lock Lock on @ref m_clientsMutex, released while the operations are executed.
+   */
+  void runControls(std::unique_lock<std::mutex>& lock);
+
+  /**
+   * @brief Computes the first due time of a streaming client in harmonic mode.
+   *
+   * Restarts the master cadence if no other streaming client is registered, so that a lone client
+   * is served without waiting for its tick.
+   *
+   * @param ticksPerFrame Number of master ticks between two frames of the client.
+   * @param now           Current timestamp.
+   * @return The time of the first tick at or after @p now that is a multiple of
+   *         @p ticksPerFrame.
+   * @note This method is NOT thread-safe and should only be called with appropriate locking.
+   */
+  irsol::types::timepoint_t firstHarmonicDue(uint64_t ticksPerFrame, irsol::types::timepoint_t now);
+
   /**
    * @brief Runs the frame distribution loop in a background thread.
    *
-   * This method monitors client schedules, captures frames as needed, and distributes them
-   * to all clients whose scheduled delivery times fall within the current slack window.
+   * Delivers the frames handed over by the acquisition stage to the clients due to receive them.
    * It also handles automatic deregistration of clients who have received their requested
    * number of frames.
    */
-  void run();
+  void runDistribution();
+
+  /**
+   * @brief Computes the rate at which the frame source must run in continuous mode.
+   *
+   * @return The highest frame rate requested by the registered clients, or 0 if only
+   * single-frame clients are registered, or if a burst is in progress (in which case frames are
+   * produced as fast as possible).
+   * @note This method is NOT thread-safe and should only be called with appropriate locking.
+   */
+  double continuousFps() const;
+
+  /**
+   * @brief Delivers a captured frame to the given clients, and reschedules them.
+   *
+   * Clients that deregistered since they were selected are skipped. Clients that have received
+   * all their requested frames are deregistered.
+   *
+   * The timing statistics of the clients receiving the frame are updated.
+   *
+   * @param frame       The captured frame, shared by all the clients.
+   * @param clients     Clients to which the frame is delivered.
+   * @param triggerTime Time at which the capture was triggered, if the frame was captured for
+   *                    these clients.
+   * @note This method is NOT thread-safe and should only be called with appropriate locking.
+   */
+  void deliver(
+    const std::shared_ptr<const Frame>&      frame,
+    const std::vector<ReadyClient>&          clients,
+    std::optional<irsol::types::timepoint_t> triggerTime = std::nullopt);
+
+  /**
+   * @brief Updates the timing statistics of a client receiving a frame.
+   *
+   * @note This method is NOT thread-safe and should only be called with appropriate locking.
+   */
+  static void recordTiming(
+    ClientCollectionParams&                  clientParams,
+    const ReadyClient&                       client,
+    irsol::types::timepoint_t                frameTimestamp,
+    std::optional<irsol::types::timepoint_t> triggerTime);
+
+  /**
+   * @brief Stores and schedules a new client, replacing any previous registration of its id.
+   *
+   * @param clientParams Parameters of the client, due at `clientParams.nextFrameDue`.
+   * @note This method is NOT thread-safe and should only be called with appropriate locking.
+   */
+  void addClientNonThreadSafe(ClientCollectionParams&& clientParams);
 
   /**
    * @brief Deregisters a client and stops frame delivery (not thread-safe).
@@ -177,49 +617,143 @@ private:
   /**
    * @brief Collects clients who are scheduled to receive a frame at the given time.
    *
+   * The collected clients are removed from the schedule, and stored, together with their
+   * schedule time, in @p out.
+   *
    * @param now   Current timestamp.
    * @param slack Allowed slack between now and client's schedule for considering a client to be
    *              ready for receiving data.
-   * @return A pair of vectors: the first is a list of ready client IDs, the second contains the
-   *         actual schedule times of the returned clients.
+   * @param out   Vector that is filled with the ready clients, ordered by due time.
+   * @note This method is NOT thread-safe and should only be called with appropriate locking.
+   */
+  void collectReadyClients(
+    irsol::types::timepoint_t now,
+    irsol::types::duration_t  slack,
+    std::vector<ReadyClient>& out);
+
+  /**
+   * @brief Collects the clients served by a just-in-time capture performed now.
+   *
+   * Each client is served if it's due within its own slack (see @ref slackOf()). When a single
+   * client is registered, nothing can be batched, and the client is served on time. In harmonic
+   * mode, the clients sharing a tick are due at the very same time, and no slack is used.
+   *
+   * @param now Current timestamp.
+   * @param out Vector that is filled with the ready clients, ordered by due time.
+   * @return The largest slack allowed to the registered clients.
+   * @note This method is NOT thread-safe and should only be called with appropriate locking.
+   */
+  irsol::types::duration_t collectBatch(
+    irsol::types::timepoint_t now,
+    std::vector<ReadyClient>& out);
+
+  /**
+   * @brief Computes how early a client may be served, to share a capture with other clients.
+   *
+   * @param clientParams    Parameters of the client.
+   * @param captureDuration Expected duration of a capture.
+   * @return The slack of the client: the largest of @ref MAX_EARLY_FRACTION of its interval and
+   *         of the capture duration, but never more than half its interval.
    */
-  std::pair<std::vector<irsol::types::client_id_t>, std::vector<irsol::types::timepoint_t>>
-  collectReadyClients(irsol::types::timepoint_t now, irsol::types::duration_t slack) const;
+  static irsol::types::duration_t slackOf(
+    const ClientCollectionParams& clientParams,
+    irsol::types::duration_t      captureDuration);
 
   /**
-   * @brief Removes schedules from the schedule map.
+   * @brief Returns the expected duration of the next capture.
    *
-   * @param schedules Vector of schedule times to clean up.
+   * @note This method is NOT thread-safe and should only be called with appropriate locking.
+   */
+  irsol::types::duration_t expectedCaptureDuration() const;
+
+  /**
+   * @brief Schedules the next frame of the streaming clients of a capture being submitted.
+   *
+   * The clients are then due again before the current frame is delivered, so that the source can
+   * acquire their next frame meanwhile. The last frame of a client is not rescheduled: the client
+   * finishes once it's delivered.
+   *
+   * @note This method is NOT thread-safe and should only be called with appropriate locking.
    */
-  void cleanUpSchedule(const std::vector<irsol::types::timepoint_t> schedules);
+  void rescheduleAhead(std::vector<ReadyClient>& clients);
 
   /**
-   * @brief Captures an image and returns it along with associated metadata.
+   * @brief Puts back in the schedule the clients of a failed capture, at their original due time.
+   *
+   * The clients rescheduled ahead (see @ref rescheduleAhead()) get back the frame they were
+   * counted for.
    *
-   * @return A pair containing frame metadata and the image data buffer if image acquisition was
-   *         successful, `std::nullopt` otherwise.
+   * @note This method is NOT thread-safe and should only be called with appropriate locking.
    */
-  std::optional<std::pair<FrameMetadata, std::vector<irsol::types::byte_t>>> grabImageData() const;
+  void rescheduleFailed(const std::vector<ReadyClient>& clients);
+
+  /**
+   * @brief Checks whether a selected client is still registered.
+   *
+   * @note This method is NOT thread-safe and should only be called with appropriate locking.
+   */
+  bool isRegistered(const ReadyClient& client) const;
+
+  /**
+   * @brief Logs the ready clients that are served earlier than requested due to the slack.
+   *
+   * @param clients Ready clients, ordered by due time.
+   * @param slack   Allowed slack used to collect the ready clients.
+   */
+  void logSlackUsage(const std::vector<ReadyClient>& clients, irsol::types::duration_t slack) const;
 
   /**
    * @brief Schedules the next frame delivery for a client.
    *
-   * @param clientId     The client to schedule.
+   * @param handle       Handle of the client to schedule.
    * @param nextFrameDue The next timestamp when the client should receive a frame.
    * @return true if successfully scheduled, false if the client is no longer active and can later
    *         be removed from the frame collector.
    */
-  bool schedule(const irsol::types::client_id_t& clientId, irsol::types::timepoint_t nextFrameDue);
+  bool schedule(client_handle_t handle, irsol::types::timepoint_t nextFrameDue);
+
+  std::unique_ptr<FrameSource> m_source;  ///< Source of the captured frames.
+  const CollectionMode         m_mode;    ///< Acquisition strategy of the collector.
+
+  std::mutex m_clientsMutex;  ///< Protects access to the client tables and to the scheduler.
+  std::vector<std::optional<ClientCollectionParams>>
+    m_clients;  ///< Parameters of each registered client, indexed by client handle.
+  std::unordered_map<irsol::types::client_id_t, client_handle_t>
+    m_handles;  ///< Maps the registered client IDs to their handle.
+  std::vector<client_handle_t> m_freeHandles;  ///< Handles available for re-use.
+  std::vector<uint64_t>
+    m_generations;  ///< Number of times each handle was released, to detect stale selections.
+  Scheduler m_scheduler;  ///< Next due time of each scheduled client.
+
+  std::vector<Scheduler::Entry> m_dueClients;       ///< Scratch buffer of the due clients.
+  std::vector<ReadyClient>      m_readyClients;     ///< Clients served by the distributed frame.
+  std::vector<client_handle_t>  m_finishedClients;  ///< Clients that received all their frames.
+  std::vector<std::vector<ReadyClient>>
+    m_spareClientLists;  ///< Client lists of distributed frames, re-used for the next captures.
+  std::vector<ReadyClient>
+    m_joiningClients;  ///< Single-frame clients registered while captures are pending.
+  size_t m_numPendingCaptures{0};  ///< Number of submitted captures that are not completed yet.
+  size_t m_numBurstClients{0};     ///< Number of burst clients, holding the frame reservation.
+  irsol::types::timepoint_t
+    m_lastTrigger{};  ///< Time of the last submitted capture, start of the trigger cadence.
+  bool   m_acquiring{false};       ///< Whether the acquisition thread drains the control queue.
+
+  irsol::types::duration_t
+    m_captureDuration{};  ///< Running estimate of the measured duration of a capture.
+  std::atomic<uint64_t> m_numCaptures{0};       ///< Number of frames captured for delivery.
+  std::atomic<uint64_t> m_numSavedCaptures{0};  ///< Number of captures saved by batching.
+
+  irsol::types::timepoint_t
+    m_harmonicEpoch{};  ///< Harmonic mode: time of the tick 0 of the master cadence.
 
-  irsol::camera::Interface& m_cam;  ///< Reference to the camera interface used for capturing.
+  FrameHistory m_history;  ///< Last captured frames.
+  ControlQueue m_control;  ///< Camera operations waiting for the end of the current capture.
 
-  std::mutex m_clientsMutex;  ///< Protects access to m_clients and m_scheduleMap.
-  std::unordered_map<irsol::types::client_id_t, ClientCollectionParams>
-    m_clients;  ///< Stores parameters for each registered client.
-  std::map<irsol::types::timepoint_t, std::vector<irsol::types::client_id_t>>
-    m_scheduleMap;  ///< Maps timestamps to client IDs scheduled at that time.
+  irsol::utils::SafeQueue<CapturedFrame> m_handoff{
+    HANDOFF_CAPACITY};  ///< Captured frames waiting to be distributed.
 
   std::condition_variable m_scheduleCondition;  ///< Signals when a new client is scheduled.
+  std::thread             m_acquisitionThread;  ///< Thread responsible for frame acquisition.
   std::thread             m_distributorThread;  ///< Thread responsible for frame distribution.
 
   std::atomic<bool> m_stop{
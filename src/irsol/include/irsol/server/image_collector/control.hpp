@@ -0,0 +1,150 @@
+/**
+ * @file irsol/server/image_collector/control.hpp
+ * @brief Queue of the camera parameter changes applied by the frame collector.
+ * @ingroup FrameCollector
+ *
+ * Parameter changes requested by the clients are not applied by the session threads, but queued
+ * in a @ref irsol::server::frame_collector::ControlQueue, which the acquisition thread of the
+ * collector drains between two captures. In this way, a parameter never changes in the middle of
+ * an acquisition, and the session threads never compete with the acquisition for the camera.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace irsol {
+namespace server {
+namespace frame_collector {
+
+/**
+ * @ingroup FrameCollector
+ * @brief FIFO of camera operations, executed in order by a single consumer.
+ *
+ * Each operation targets a feature of the camera (e.g. `ExposureTime`), and its result is
+ * delivered through the future returned by @ref submit(). Consecutive operations on the same
+ * feature are coalesced: if the last pending operation targets the same feature, it's replaced by
+ * the new one, and both requesters receive the result of the new operation. A burst of writes to
+ * the same feature (e.g. a slider in a GUI) thus costs a single access to the camera. Operations
+ * on different features are never reordered.
+ *
+ * Thread-safe.
+ */
+class ControlQueue
+{
+public:
+  /**
+   * @brief Queues an operation on a feature of the camera.
+   *
+   * @param feature   Name of the feature targeted by the operation.
+   * @param operation Callable performing the operation, and returning its result.
+   * @return Future receiving the result of the operation (or of the operation it was coalesced
+   * into), or the exception thrown by it.
+   */
+  template<typename Callable, typename Result = std::invoke_result_t<Callable>>
+  std::future<Result> submit(const std::string& feature, Callable&& operation)
+  {
+    std::promise<Result> promise;
+    auto                 future = promise.get_future();
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    if(!m_pending.empty() && m_pending.back().feature == feature) {
+      if(auto* last = dynamic_cast<Request<Result>*>(m_pending.back().request.get())) {
+        last->operation = std::forward<Callable>(operation);
+        last->promises.push_back(std::move(promise));
+        ++m_numCoalesced;
+        return future;
+      }
+    }
+    auto request       = std::make_unique<Request<Result>>();
+    request->operation = std::forward<Callable>(operation);
+    request->promises.push_back(std::move(promise));
+    m_pending.push_back({feature, std::move(request)});
+    m_size.store(m_pending.size());
+    return future;
+  }
+
+  /**
+   * @brief Executes the pending operations, in the order they were submitted.
+   *
+   * Operations submitted while the pending ones are executing are left for the next call.
+   *
+   * @return Number of executed operations.
+   */
+  size_t runPending();
+
+  /// Whether no operation is pending. Lock-free, to be polled between captures.
+  bool empty() const;
+
+  /// Number of pending operations.
+  size_t size() const;
+
+  /// Number of operations that were coalesced into a following one.
+  uint64_t numCoalesced() const;
+
+private:
+  /// A pending operation, type-erased.
+  struct RequestBase
+  {
+    virtual ~RequestBase() = default;
+
+    /// Performs the operation, and delivers its result to all the requesters.
+    virtual void execute() = 0;
+  };
+
+  /// A pending operation returning a @p Result.
+  template<typename Result>
+  struct Request : RequestBase
+  {
+    std::function<Result()>           operation;  ///< Latest operation submitted for the feature.
+    std::vector<std::promise<Result>> promises;   ///< Requesters of the (coalesced) operations.
+
+    void execute() override
+    {
+      try {
+        if constexpr(std::is_void_v<Result>) {
+          operation();
+          for(auto& promise : promises) {
+            promise.set_value();
+          }
+        } else {
+          const Result result = operation();
+          for(auto& promise : promises) {
+            promise.set_value(result);
+          }
+        }
+      } catch(...) {
+        for(auto& promise : promises) {
+          promise.set_exception(std::current_exception());
+        }
+      }
+    }
+  };
+
+  /// An entry of the queue.
+  struct Entry
+  {
+    std::string                  feature;  ///< Feature targeted by the operation.
+    std::unique_ptr<RequestBase> request;  ///< The operation and its requesters.
+  };
+
+  mutable std::mutex m_mutex;    ///< Protects the pending operations.
+  std::deque<Entry>  m_pending;  ///< Pending operations, in submission order.
+  std::mutex m_runMutex;  ///< Serializes the executions, so that operations are never reordered.
+  std::atomic<size_t>   m_size{0};          ///< Number of pending operations.
+  std::atomic<uint64_t> m_numCoalesced{0};  ///< Number of coalesced operations.
+};
+
+}  // namespace frame_collector
+}  // namespace server
+}  // namespace irsol
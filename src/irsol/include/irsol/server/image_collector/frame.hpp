@@ -3,20 +3,30 @@
 #include "irsol/camera/interface.hpp"
 #include "irsol/protocol.hpp"
 
+#include <memory>
+#include <mutex>
+
 namespace irsol {
 namespace server {
 namespace frame_collector {
 
 struct FrameMetadata
 {
-  irsol::types::timepoint_t timestamp;
-  uint64_t                  frameId;
-  uint64_t                  height;
-  uint64_t                  width;
+  irsol::types::timepoint_t timestamp;  ///< Host time of the start of the exposure.
+  uint64_t                  frameId;    ///< Identifier of the frame, as assigned by the source.
+  uint64_t                  height;     ///< Height of the image, in pixels.
+  uint64_t                  width;      ///< Width of the image, in pixels.
 };
 
 /**
  * Represents data captured from the FrameCollector, and distributed to clients.
+ *
+ * A single Frame instance is created per camera capture and shared, read-only, among all the
+ * clients that receive it. Consumers that need their own copy of the image (e.g. to move it into
+ * an outgoing message) should use `image.share()`, which does not copy the pixel data.
+ *
+ * The wire representation of the image is identical for all the clients, so it is computed once
+ * per frame, by the first client sending it, and shared with the others (see @ref serialized()).
  */
 struct Frame
 {
@@ -26,10 +36,29 @@ struct Frame
   Frame(FrameMetadata metadata, irsol::protocol::ImageBinaryData&& data)
     : metadata(metadata), image(std::move(data))
   {}
-  Frame(const Frame& other)     = delete;
-  Frame(Frame&& other) noexcept = default;
+  // The lazily serialized image is not transferable: frames are shared via pointers only.
+  Frame(const Frame& other)            = delete;
+  Frame(Frame&& other)                 = delete;
   Frame& operator=(const Frame& other) = delete;
-  Frame& operator=(Frame&& other) noexcept = default;
+  Frame& operator=(Frame&& other)      = delete;
+
+  /**
+   * @brief Returns the serialized image, ready to be sent to a client.
+   *
+   * The image is serialized on the first call only, and the result is shared by all the callers:
+   * the cost of serializing a frame does not depend on the number of clients it is sent to.
+   * Per-client data (e.g. the input sequence number) must be sent as separate messages.
+   *
+   * Thread-safe.
+   */
+  std::shared_ptr<const irsol::protocol::internal::SerializedMessage> serialized() const;
+
+private:
+  /// Guards the one-time serialization of the image.
+  mutable std::once_flag m_serializeOnce;
+
+  /// Serialized image, set by the first call to @ref serialized().
+  mutable std::shared_ptr<const irsol::protocol::internal::SerializedMessage> m_serialized;
 };
 }
 }
@@ -0,0 +1,107 @@
+/**
+ * @file irsol/server/image_collector/history.hpp
+ * @brief In-memory history of the last frames produced by the frame collector.
+ * @ingroup FrameCollector
+ *
+ * The collector keeps its most recent frames in a
+ * @ref irsol::server::frame_collector::FrameHistory, so that clients can retrieve frames that were
+ * already captured (e.g. the latest one, or the ones they missed while disconnected) without
+ * triggering a new exposure.
+ */
+
+#pragma once
+
+#include "irsol/server/image_collector/frame.hpp"
+#include "irsol/types.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace irsol {
+namespace server {
+namespace frame_collector {
+
+/**
+ * @ingroup FrameCollector
+ * @brief Ring of the last frames, addressable by frame ID and by timestamp.
+ *
+ * Frames are stored in the order they are added, which is expected to be the order of their IDs
+ * and timestamps. A frame whose ID does not follow the last stored one (e.g. the camera restarted
+ * its numbering) discards the whole history, so that the stored frames are always ordered.
+ *
+ * The frames are shared, read-only, with the clients: keeping a frame in the history only keeps a
+ * reference to it. The ring is allocated once at construction, so adding a frame never allocates
+ * memory.
+ *
+ * Thread-safe.
+ */
+class FrameHistory
+{
+public:
+  using frame_ptr_t = std::shared_ptr<const Frame>;
+
+  /**
+   * @param capacity Maximum number of frames kept in the history. A null capacity disables the
+   *                 history.
+   */
+  explicit FrameHistory(size_t capacity);
+
+  /**
+   * @brief Adds a frame to the history, discarding the oldest one if the history is full.
+   */
+  void add(frame_ptr_t frame);
+
+  /**
+   * @brief Returns the most recent frame, if it's not older than @p maxAge.
+   *
+   * @param maxAge Maximum age of the frame, measured from its timestamp.
+   * @param now    Reference time for the age of the frame.
+   * @return The most recent frame, or `nullptr` if the history is empty or its most recent frame
+   *         is too old.
+   */
+  frame_ptr_t latest(
+    irsol::types::duration_t  maxAge,
+    irsol::types::timepoint_t now = irsol::types::clock_t::now()) const;
+
+  /**
+   * @brief Returns the frames following the frame with the given ID.
+   *
+   * @param frameId ID of the last frame known to the caller.
+   * @return The stored frames with an ID larger than @p frameId, oldest first.
+   */
+  std::vector<frame_ptr_t> since(uint64_t frameId) const;
+
+  /**
+   * @brief Returns the frame whose timestamp is the closest to @p timestamp.
+   *
+   * @return The closest frame, or `nullptr` if the history is empty.
+   */
+  frame_ptr_t nearest(irsol::types::timepoint_t timestamp) const;
+
+  /// Maximum number of frames kept in the history.
+  size_t capacity() const;
+
+  /// Number of frames currently in the history.
+  size_t size() const;
+
+  /// Discards all the frames of the history.
+  void clear();
+
+private:
+  /// Returns the position in the ring of the i-th oldest frame (not thread-safe).
+  size_t positionOf(size_t i) const;
+
+  /// Discards all the frames of the history (not thread-safe).
+  void clearNonThreadSafe();
+
+  mutable std::mutex       m_mutex;      ///< Protects the ring.
+  std::vector<frame_ptr_t> m_frames;     ///< Ring of the stored frames.
+  size_t                   m_oldest{0};  ///< Position in the ring of the oldest frame.
+  size_t                   m_size{0};    ///< Number of stored frames.
+};
+
+}  // namespace frame_collector
+}  // namespace server
+}  // namespace irsol
@@ -1,12 +1,14 @@
 #pragma once
 
 #include "irsol/server/image_collector/frame.hpp"
+#include "irsol/server/image_collector/statistics.hpp"
 #include "irsol/types.hpp"
 #include "irsol/utils.hpp"
 
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <optional>
 
 namespace irsol {
 namespace server {
@@ -14,28 +16,39 @@ namespace frame_collector {
 
 struct ClientCollectionParams
 {
-  using frame_queue_t = irsol::utils::SafeQueue<std::unique_ptr<Frame>>;
+  /// Frames are shared (read-only) among all the clients receiving the same capture.
+  using frame_queue_t = irsol::utils::SafeQueue<std::shared_ptr<const Frame>>;
 
+  irsol::types::client_id_t      clientId;
   double                         fps = 0.0;
   std::chrono::microseconds      interval;
   irsol::types::timepoint_t      nextFrameDue;
   std::shared_ptr<frame_queue_t> queue;
   int64_t                        remainingFrames = -1;     // -1 for infinite
   bool                           immediate       = false;  // true for "immediate-once" clients
+  bool                           burst           = false;  // true for back-to-back captures
+
+  // Timing of the frames delivered so far, and timestamp of the last one.
+  TimingStatistics                         timing;
+  std::optional<irsol::types::timepoint_t> lastFrame;
 
   ClientCollectionParams(
+    irsol::types::client_id_t      clientId,
     double                         fps,
     std::chrono::microseconds      interval,
     irsol::types::timepoint_t      nextFrameDue,
     std::shared_ptr<frame_queue_t> queue,
     int64_t                        remainingFrames,
-    bool                           immediate)
-    : fps(fps)
+    bool                           immediate,
+    bool                           burst = false)
+    : clientId(clientId)
+    , fps(fps)
     , interval(interval)
     , nextFrameDue(nextFrameDue)
     , queue(queue)
     , remainingFrames(remainingFrames)
     , immediate(immediate)
+    , burst(burst)
   {}
 };
 }
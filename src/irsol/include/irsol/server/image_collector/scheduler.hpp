@@ -0,0 +1,121 @@
+/**
+ * @file irsol/server/image_collector/scheduler.hpp
+ * @brief Delivery schedule of the clients registered in the
+ * @ref irsol::server::frame_collector::FrameCollector.
+ * @ingroup FrameCollector
+ */
+
+#pragma once
+
+#include "irsol/types.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace irsol {
+namespace server {
+namespace frame_collector {
+
+/// Compact, integer handle identifying a client registered in the collector.
+using client_handle_t = uint32_t;
+
+/**
+ * @ingroup FrameCollector
+ * @brief Min-heap of client due times, addressed by integer client handles.
+ *
+ * The scheduler stores, for each scheduled client handle, the next time at which the client is due
+ * to receive a frame. It supports:
+ * - O(1) access to the earliest due time;
+ * - O(log n) insertion, re-scheduling and removal of a client;
+ * - O(k log n) extraction of the k clients due before a given time.
+ *
+ * Handles are expected to be small, densely allocated integers (e.g. recycled slot indices), as
+ * they directly index the internal position table. The internal storage only grows when a new
+ * (larger) handle is scheduled: once all handles have been seen, scheduling and extracting
+ * clients does not allocate memory.
+ *
+ * @note This class is NOT thread-safe.
+ */
+class Scheduler
+{
+public:
+  /// A client handle, together with the time at which it's due.
+  struct Entry
+  {
+    irsol::types::timepoint_t due;     ///< Time at which the client is due.
+    client_handle_t           handle;  ///< Handle of the client.
+  };
+
+  /**
+   * @brief Pre-allocates the internal storage for handles in the range [0, numHandles).
+   */
+  void reserve(size_t numHandles);
+
+  /**
+   * @brief Schedules a client at the given time.
+   *
+   * If the client is already scheduled, its due time is updated.
+   */
+  void schedule(client_handle_t handle, irsol::types::timepoint_t due);
+
+  /**
+   * @brief Removes a client from the schedule.
+   *
+   * @return true if the client was scheduled, false otherwise.
+   */
+  bool remove(client_handle_t handle);
+
+  /**
+   * @brief Checks whether a client is currently scheduled.
+   */
+  bool contains(client_handle_t handle) const;
+
+  /**
+   * @brief Returns the earliest due time of the schedule.
+   *
+   * @note The schedule must not be empty.
+   */
+  irsol::types::timepoint_t nextDue() const;
+
+  /**
+   * @brief Removes all the clients due at or before @p limit from the schedule.
+   *
+   * The removed entries are appended to @p out, ordered by due time. Callers are encouraged to
+   * re-use the same output vector across calls, so that no memory is allocated.
+   *
+   * @param limit Latest due time of the extracted clients.
+   * @param out   Vector to which the extracted entries are appended.
+   * @return The number of extracted entries.
+   */
+  size_t popDue(irsol::types::timepoint_t limit, std::vector<Entry>& out);
+
+  /// Number of scheduled clients.
+  size_t size() const;
+
+  /// Checks whether no client is scheduled.
+  bool empty() const;
+
+private:
+  /// Position marking a handle that is not in the heap.
+  static constexpr size_t NOT_SCHEDULED = std::numeric_limits<size_t>::max();
+
+  /// Moves the entry at @p index towards the root, until the heap property is restored.
+  void siftUp(size_t index);
+
+  /// Moves the entry at @p index towards the leaves, until the heap property is restored.
+  void siftDown(size_t index);
+
+  /// Swaps two heap entries, updating their positions.
+  void swapEntries(size_t lhs, size_t rhs);
+
+  /// Removes the heap entry at the given position.
+  void removeAt(size_t index);
+
+  std::vector<Entry>  m_heap;       ///< Binary min-heap of entries, ordered by due time.
+  std::vector<size_t> m_positions;  ///< Position in m_heap of each handle.
+};
+
+}  // namespace frame_collector
+}  // namespace server
+}  // namespace irsol
@@ -0,0 +1,517 @@
+/**
+ * @file irsol/server/image_collector/source.hpp
+ * @brief Sources of frames used by the @ref irsol::server::frame_collector::FrameCollector.
+ * @ingroup FrameCollector
+ *
+ * A frame source abstracts the device producing frames for the collector. Two acquisition
+ * strategies are supported by every source:
+ * - single, triggered captures, used by the just-in-time scheduling of the collector. They are
+ *   submitted without waiting for them, and several of them can be pending at once if the device
+ *   allows it;
+ * - free-running (continuous) captures at a given frame rate, used by the continuous mode of the
+ *   collector.
+ */
+
+#pragma once
+
+#include "irsol/buffer_pool.hpp"
+#include "irsol/camera/interface.hpp"
+#include "irsol/camera/replay_camera.hpp"
+#include "irsol/camera/simulated_camera.hpp"
+#include "irsol/camera/user_buffers.hpp"
+#include "irsol/server/image_collector/frame.hpp"
+#include "irsol/types.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace irsol {
+namespace server {
+namespace frame_collector {
+
+/**
+ * @ingroup FrameCollector
+ * @brief Buffers of the frames of the bursts in progress, see @ref FrameSource::reserveFrames().
+ *
+ * The buffers are allocated in a pool of their own, created by the first reservation and dropped
+ * by @ref release(): the memory of a burst is freed as soon as its frames are delivered, instead
+ * of staying in the pool of the source (e.g. @ref irsol::utils::BufferPool::global()), which
+ * never frees its buffers.
+ *
+ * Thread-safe: buffers can be acquired while reservations are made or released.
+ */
+class BurstBuffers
+{
+public:
+  /**
+   * @brief Allocates the buffers of @p numFrames more frames of @p numBytes bytes.
+   *
+   * The buffers of the previous reservations are kept until @ref release().
+   */
+  void reserve(size_t numBytes, size_t numFrames);
+
+  /**
+   * @brief Drops the pool of the reserved buffers.
+   *
+   * The buffers still held by the frames of a burst are freed once the frames are released.
+   */
+  void release();
+
+  /**
+   * @brief Returns a reserved buffer of @p numBytes bytes, or `nullptr` if no burst is in progress.
+   */
+  irsol::utils::BufferPool::buffer_t acquire(size_t numBytes);
+
+private:
+  std::mutex m_mutex;  ///< Protects the pool and the number of reserved frames.
+  /// Pool of the reserved buffers, `nullptr` when no burst is in progress.
+  std::shared_ptr<irsol::utils::BufferPool> m_pool;
+  /// Number of frames reserved since the pool was created.
+  size_t m_numFrames{0};
+};
+
+/**
+ * @ingroup FrameCollector
+ * @brief Abstract producer of frames for the @ref irsol::server::frame_collector::FrameCollector.
+ */
+class FrameSource
+{
+public:
+  /// Captured frame metadata and shared storage of its raw image bytes.
+  using captured_data_t = std::pair<FrameMetadata, irsol::protocol::ImageBinaryData::storage_t>;
+
+  /// Captured frame, or `std::nullopt` if the capture failed.
+  using captured_frame_t = std::optional<captured_data_t>;
+
+  /// Submitted capture, receiving the captured frame.
+  using capture_future_t = std::future<captured_frame_t>;
+
+  virtual ~FrameSource() = default;
+
+  /**
+   * @brief Triggers and captures a single frame.
+   *
+   * Blocks for the whole duration of the acquisition (exposure and readout).
+   */
+  virtual captured_frame_t captureSingle() = 0;
+
+  /**
+   * @brief Triggers the capture of a single frame, without waiting for it.
+   *
+   * The submitted captures complete in submission order. The default implementation blocks on
+   * @ref captureSingle(), and returns a ready future.
+   *
+   * @return Future receiving the captured frame.
+   * @note Must not be mixed with @ref captureSingle(), nor with a free-running acquisition, until
+   * @ref stopCaptures() is called.
+   */
+  virtual capture_future_t submitCapture();
+
+  /**
+   * @brief Maximum number of submitted captures that can be pending at once.
+   *
+   * Further captures must be submitted once a pending one has completed.
+   */
+  virtual size_t maxPendingCaptures() const
+  {
+    return 1;
+  }
+
+  /**
+   * @brief Shortest interval between two submitted captures.
+   *
+   * A capture submitted sooner after the previous one may fail, as the device is not ready for
+   * it yet (see @ref irsol::camera::TriggerTiming). Sources without such constraint return zero.
+   */
+  virtual irsol::types::duration_t triggerInterval() const
+  {
+    return irsol::types::duration_t::zero();
+  }
+
+  /**
+   * @brief Stops the submitted captures, and brings the source back to its idle state.
+   *
+   * The pending captures complete with `std::nullopt`. Meant to be called before the device is
+   * reconfigured, when a capture doesn't complete in time, and when the acquisition stops. The
+   * next submitted capture restarts the source.
+   */
+  virtual void stopCaptures() {}
+
+  /**
+   * @brief Prepares the source for a burst of frames, all kept in memory until delivered.
+   *
+   * The buffers of @p numFrames frames are allocated up front (see
+   * @ref irsol::server::frame_collector::BurstBuffers), so that the burst is captured without
+   * allocating memory. Until @ref releaseFrames() is called, the frames are written into these
+   * buffers: sources sharing the memory of the device with the frames (e.g. user buffers) copy
+   * them out, as holding the whole burst would starve the device of buffers. Several bursts can
+   * reserve their frames at once. Sources without such concerns do nothing.
+   *
+   * Thread-safe: may be called while captures are pending.
+   *
+   * @param numFrames Number of frames of the burst.
+   */
+  virtual void reserveFrames(size_t numFrames);
+
+  /**
+   * @brief Ends the reservations of @ref reserveFrames(), once no burst is in progress.
+   *
+   * The next frames are acquired as before the bursts, and the reserved buffers are freed as soon
+   * as the frames of the bursts are released.
+   *
+   * Thread-safe: may be called while captures are pending.
+   */
+  virtual void releaseFrames();
+
+  /**
+   * @brief Starts (or restarts with a new rate) a free-running acquisition.
+   *
+   * @param fps Rate at which frames are produced. If `fps <= 0`, frames are produced as fast as
+   *            the source allows.
+   */
+  virtual void startContinuous(double fps) = 0;
+
+  /**
+   * @brief Waits for the next frame produced by the free-running acquisition.
+   */
+  virtual captured_frame_t nextContinuous() = 0;
+
+  /**
+   * @brief Stops the free-running acquisition.
+   */
+  virtual void stopContinuous() = 0;
+
+  /**
+   * @brief Returns the exposure time of the next captures, as a lower bound of their duration.
+   *
+   * Sources that don't know their exposure return zero.
+   */
+  virtual irsol::types::duration_t exposure() const
+  {
+    return irsol::types::duration_t::zero();
+  }
+};
+
+/**
+ * @ingroup FrameCollector
+ * @brief Frame source acquiring frames from a camera device.
+ *
+ * When the camera acquires into user buffers (see
+ * @ref irsol::camera::Interface::enableUserBuffers()), the frames share the memory written by the
+ * camera, which is handed back to the camera once all the clients released the frame. Otherwise,
+ * the image bytes of each frame are copied into a buffer of a @ref irsol::utils::BufferPool,
+ * which goes back to the pool once all the clients released the frame.
+ */
+class CameraFrameSource : public FrameSource
+{
+public:
+  /**
+   * @brief Time waited for a free-running frame, on top of the frame period and the exposure,
+   * before the frame is considered missing.
+   */
+  constexpr static irsol::types::duration_t CONTINUOUS_TIMEOUT_MARGIN =
+    std::chrono::milliseconds(200);
+
+  /// Longest wait for a free-running frame with the camera locked, see @ref nextContinuous().
+  constexpr static irsol::types::duration_t CONTINUOUS_POLL_INTERVAL =
+    std::chrono::milliseconds(100);
+
+  /**
+   * @param camera Reference to the camera interface used for the acquisitions.
+   * @param pool   Pool providing the buffers of the captured frames.
+   */
+  explicit CameraFrameSource(
+    irsol::camera::Interface& camera,
+    irsol::utils::BufferPool& pool = irsol::utils::BufferPool::global());
+
+  /// Stops the submitted captures, if any.
+  ~CameraFrameSource() override;
+
+  captured_frame_t         captureSingle() override;
+  capture_future_t         submitCapture() override;
+  size_t                   maxPendingCaptures() const override;
+  irsol::types::duration_t triggerInterval() const override;
+  void                     stopCaptures() override;
+  void                     reserveFrames(size_t numFrames) override;
+  void                     releaseFrames() override;
+  void                     startContinuous(double fps) override;
+  void                     stopContinuous() override;
+
+  /**
+   * @brief Waits for the next frame of the free-running camera.
+   *
+   * The camera may be idle for a whole frame period: the frame is only missing if it isn't
+   * received within the period, the exposure and @ref CONTINUOUS_TIMEOUT_MARGIN. The wait is split
+   * into polls of at most @ref CONTINUOUS_POLL_INTERVAL, so that the camera isn't locked for a
+   * whole (possibly long) frame period.
+   */
+  captured_frame_t nextContinuous() override;
+
+  irsol::types::duration_t exposure() const override;
+
+private:
+  /// Completes the oldest pending capture with an image received from the camera.
+  void onImage(const irsol::camera::Interface::image_t& image);
+
+  /**
+   * @brief Turns a camera image into a captured frame.
+   *
+   * Images acquired in user buffers are shared as-is, unless a burst is in progress (see
+   * @ref reserveFrames()). The content of any other image is copied into an owning buffer: in
+   * this way, when `image` is destroyed, it can return into the pool of NeoAPI::Images for next
+   * frames to be written to the buffer.
+   */
+  captured_frame_t extract(irsol::camera::Interface::image_t& image);
+
+  irsol::camera::Interface& m_cam;   ///< Reference to the camera interface used for capturing.
+  irsol::utils::BufferPool& m_pool;  ///< Pool providing the buffers of the captured frames.
+
+  /// Serializes the starts and stops of the triggered acquisition.
+  std::mutex m_triggeredMutex;
+  /// Whether the triggered acquisition of the camera is running.
+  bool m_triggered{false};
+  /// Maximum number of outstanding triggers, as allowed by the camera.
+  std::atomic<size_t> m_maxPendingCaptures{1};
+  /// Shortest interval between two triggers, in ticks of @ref irsol::types::duration_t.
+  std::atomic<irsol::types::duration_t::rep> m_triggerInterval{0};
+  /// Buffers the frames are copied into during a burst, see @ref reserveFrames().
+  BurstBuffers m_burstBuffers;
+  /// Frame period of the free-running acquisition, zero if it runs as fast as possible.
+  irsol::types::duration_t m_continuousPeriod{};
+
+  /// Protects @ref m_pendingCaptures, completed by the callback thread of the camera.
+  std::mutex m_pendingMutex;
+  /// Submitted captures waiting for their image, in trigger order.
+  std::deque<std::promise<captured_frame_t>> m_pendingCaptures;
+};
+
+/**
+ * @ingroup FrameCollector
+ * @brief Frame source producing synthetic frames at a fixed maximum rate.
+ *
+ * Useful for testing and benchmarking the collector without a camera. A single capture takes
+ * one full frame period (as an exposure plus readout would), while a free-running acquisition
+ * produces frames on a regular time grid. The frame ids are increasing, and the pixels of each
+ * frame are filled with the (12-bit truncated) frame id.
+ *
+ * The submitted captures are completed one after the other by a background thread, mimicking the
+ * callback thread of a camera driver. Up to @ref setMaxPendingCaptures() captures can be pending.
+ *
+ * By default, the frames are written into buffers of a @ref irsol::utils::BufferPool. After
+ * @ref useUserBuffers(), they are written instead into a fixed ring of user buffers handed to a
+ * @ref irsol::camera::SimulatedUserBufferDriver, mimicking a camera in user buffer mode: a frame
+ * is dropped when all the buffers are still held by clients. The frames of a burst (see
+ * @ref reserveFrames()) are written into the reserved buffers instead.
+ */
+class SimulatedFrameSource : public FrameSource
+{
+public:
+  /**
+   * @param height  Height of the produced frames.
+   * @param width   Width of the produced frames.
+   * @param maxFps  Highest rate at which the source can produce frames.
+   * @param pool    Pool providing the buffers of the produced frames.
+   */
+  SimulatedFrameSource(
+    uint64_t                  height,
+    uint64_t                  width,
+    double                    maxFps,
+    irsol::utils::BufferPool& pool = irsol::utils::BufferPool::global());
+
+  /// Stops the submitted captures, if any.
+  ~SimulatedFrameSource() override;
+
+  captured_frame_t captureSingle() override;
+  capture_future_t submitCapture() override;
+  size_t           maxPendingCaptures() const override;
+  void             stopCaptures() override;
+  void             reserveFrames(size_t numFrames) override;
+  void             releaseFrames() override;
+  void             startContinuous(double fps) override;
+  captured_frame_t nextContinuous() override;
+  void             stopContinuous() override;
+
+  irsol::types::duration_t exposure() const override;
+
+  /**
+   * @brief Sets the maximum number of submitted captures that can be pending at once.
+   *
+   * Must be called before the first capture.
+   *
+   * @param numCaptures Maximum number of pending captures, at least 1.
+   */
+  void setMaxPendingCaptures(size_t numCaptures);
+
+  /// Number of single (triggered) captures performed so far.
+  uint64_t numSingleCaptures() const;
+
+  /// Number of times a free-running acquisition has been started.
+  uint64_t numContinuousStarts() const;
+
+  /// Rate of the current free-running acquisition, 0 if not running.
+  double continuousFps() const;
+
+  /**
+   * @brief Produces the next frames into a ring of user buffers, instead of pooled buffers.
+   *
+   * Must be called before the first capture.
+   *
+   * @param numBuffers Number of buffers of the ring.
+   */
+  void useUserBuffers(size_t numBuffers);
+
+  /**
+   * @brief Simulated driver owning the user buffers, `nullptr` unless @ref useUserBuffers() was
+   * called.
+   */
+  const irsol::camera::SimulatedUserBufferDriver* userBufferDriver() const;
+
+private:
+  /// Produces the next synthetic frame, timestamped now.
+  captured_frame_t makeFrame();
+
+  /// Completes the submitted captures, in order, until @ref stopCaptures() is called.
+  void runCaptures();
+
+  const uint64_t                 m_height;         ///< Height of the produced frames.
+  const uint64_t                 m_width;          ///< Width of the produced frames.
+  const irsol::types::duration_t m_minPeriod;      ///< Time needed to produce a single frame.
+  irsol::utils::BufferPool&      m_pool;           ///< Pool providing the frame buffers.
+  uint64_t                       m_nextFrameId{};  ///< Id of the next produced frame.
+
+  /// Driver of the user buffers, set by @ref useUserBuffers().
+  std::unique_ptr<irsol::camera::SimulatedUserBufferDriver> m_userBufferDriver;
+  /// Ring of user buffers the frames are written into, set by @ref useUserBuffers().
+  std::unique_ptr<irsol::camera::UserBufferRing> m_userBuffers;
+  /// Buffers the frames are written into during a burst, see @ref reserveFrames().
+  BurstBuffers m_burstBuffers;
+
+  std::atomic<uint64_t> m_numSingleCaptures{0};    ///< Counter of single captures.
+  std::atomic<uint64_t> m_numContinuousStarts{0};  ///< Counter of continuous starts.
+  std::atomic<double>   m_continuousFps{0.0};      ///< Rate of the current continuous run.
+
+  irsol::types::duration_t  m_period{};    ///< Period of the current continuous acquisition.
+  irsol::types::timepoint_t m_nextTick{};  ///< Time at which the next continuous frame is ready.
+
+  /// Maximum number of pending submitted captures.
+  size_t m_maxPendingCaptures{1};
+  /// Serializes the starts and stops of @ref m_captureThread.
+  std::mutex m_captureStateMutex;
+  /// Protects the submitted captures, and @ref m_stopCaptures.
+  std::mutex m_captureMutex;
+  /// Signals the submitted captures, and the stop requests, to @ref m_captureThread.
+  std::condition_variable m_captureCondition;
+  /// Submitted captures, in submission order.
+  std::deque<std::promise<captured_frame_t>> m_pendingCaptures;
+  /// Whether @ref m_captureThread must exit.
+  bool m_stopCaptures{false};
+  /// Thread completing the submitted captures, started by the first one.
+  std::thread m_captureThread;
+};
+
+/**
+ * @ingroup FrameCollector
+ * @brief Frame source acquiring frames from a @ref irsol::camera::SimulatedCamera.
+ *
+ * Unlike @ref irsol::server::frame_collector::SimulatedFrameSource, the frames follow the
+ * parameters of the camera (region of interest, binning, exposure), which can be changed by the
+ * clients as on a physical camera. The image of each frame is rendered into a buffer of a
+ * @ref irsol::utils::BufferPool.
+ *
+ * The submitted captures use the triggered acquisition of the camera, following its timing model
+ * (see @ref irsol::camera::SimulatedCamera::triggerTiming()): with overlapped triggering, two
+ * captures can be pending at once.
+ */
+class SimulatedCameraFrameSource : public FrameSource
+{
+public:
+  /**
+   * @param camera Simulated camera used for the acquisitions.
+   * @param pool   Pool providing the buffers of the captured frames.
+   */
+  explicit SimulatedCameraFrameSource(
+    irsol::camera::SimulatedCamera& camera,
+    irsol::utils::BufferPool&       pool = irsol::utils::BufferPool::global());
+
+  /// Stops the submitted captures, if any.
+  ~SimulatedCameraFrameSource() override;
+
+  captured_frame_t         captureSingle() override;
+  capture_future_t         submitCapture() override;
+  size_t                   maxPendingCaptures() const override;
+  irsol::types::duration_t triggerInterval() const override;
+  void                     stopCaptures() override;
+  void                     reserveFrames(size_t numFrames) override;
+  void                     releaseFrames() override;
+  void                     startContinuous(double fps) override;
+  captured_frame_t         nextContinuous() override;
+  void                     stopContinuous() override;
+
+  irsol::types::duration_t exposure() const override;
+
+private:
+  /// Renders a frame of the camera into a pooled (or, during a burst, reserved) buffer.
+  captured_frame_t extract(const irsol::camera::SimulatedCamera::Frame& frame);
+
+  /// Completes the oldest pending capture with a frame read out by the camera.
+  void onFrame(const irsol::camera::SimulatedCamera::Frame& frame);
+
+  irsol::camera::SimulatedCamera& m_cam;   ///< Simulated camera used for capturing.
+  irsol::utils::BufferPool&       m_pool;  ///< Pool providing the buffers of the captured frames.
+
+  /// Buffers the frames are rendered into during a burst, see @ref reserveFrames().
+  BurstBuffers m_burstBuffers;
+
+  /// Serializes the submissions, and the starts and stops of the triggered acquisition.
+  std::mutex m_triggeredMutex;
+  /// Whether the triggered acquisition of the camera is running.
+  bool m_triggered{false};
+
+  /// Protects @ref m_pendingCaptures, completed by the readout thread of the camera.
+  std::mutex m_pendingMutex;
+  /// Submitted captures waiting for their frame, in trigger order.
+  std::deque<std::promise<captured_frame_t>> m_pendingCaptures;
+};
+
+/**
+ * @ingroup FrameCollector
+ * @brief Frame source replaying the recorded frames of a @ref irsol::camera::ReplayCamera.
+ *
+ * Single and free-running captures both produce the next recorded frame, at the pace of the
+ * camera: the rate requested for the free-running acquisition is ignored, as the frame rate is the
+ * one of the recording.
+ */
+class ReplayFrameSource : public FrameSource
+{
+public:
+  /**
+   * @param camera Replay camera producing the frames.
+   */
+  explicit ReplayFrameSource(irsol::camera::ReplayCamera& camera);
+
+  captured_frame_t captureSingle() override;
+  void             startContinuous(double fps) override;
+  captured_frame_t nextContinuous() override;
+  void             stopContinuous() override;
+
+  irsol::types::duration_t exposure() const override;
+
+private:
+  /// Produces the next recorded frame, or `std::nullopt` if the recording can't be read.
+  captured_frame_t replayNext();
+
+  irsol::camera::ReplayCamera& m_cam;  ///< Replay camera producing the frames.
+};
+
+}  // namespace frame_collector
+}  // namespace server
+}  // namespace irsol
@@ -0,0 +1,109 @@
+/**
+ * @file irsol/server/image_collector/statistics.hpp
+ * @brief Timing statistics of the frames delivered by the frame collector.
+ * @ingroup FrameCollector
+ *
+ * The collector keeps, for each client, rolling statistics on the timing of the frames it
+ * receives (see @ref irsol::server::frame_collector::TimingStatistics), so that a client missing
+ * its requested cadence can be diagnosed: either the frames were requested late by the collector,
+ * or the camera was late in exposing them.
+ */
+
+#pragma once
+
+#include "irsol/types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace irsol {
+namespace server {
+namespace frame_collector {
+
+/**
+ * @ingroup FrameCollector
+ * @brief Statistics over the last values of a series.
+ *
+ * The values are kept in a fixed-size ring, allocated once at construction: adding a value never
+ * allocates memory.
+ */
+class RollingStatistics
+{
+public:
+  /// Default number of values the statistics are computed on.
+  static constexpr size_t DEFAULT_WINDOW_SIZE = 64;
+
+  /**
+   * @param windowSize Number of values (the most recent ones) the statistics are computed on.
+   */
+  explicit RollingStatistics(size_t windowSize = DEFAULT_WINDOW_SIZE);
+
+  /// Adds a value to the series.
+  void add(double value);
+
+  /// Number of values in the window.
+  size_t count() const;
+
+  /// Number of values added since construction.
+  uint64_t total() const;
+
+  /// Mean of the values in the window, 0 if empty.
+  double mean() const;
+
+  /// Standard deviation of the values in the window, 0 if less than two values.
+  double stddev() const;
+
+  /// Smallest value in the window, 0 if empty.
+  double min() const;
+
+  /// Largest value in the window, 0 if empty.
+  double max() const;
+
+  /// Human-readable summary of the statistics.
+  std::string toString() const;
+
+private:
+  size_t              m_windowSize;  ///< Number of values the statistics are computed on.
+  std::vector<double> m_values;      ///< Ring of the last values.
+  size_t              m_next{0};     ///< Position of the next value in the ring.
+  uint64_t            m_total{0};    ///< Number of values added since construction.
+};
+
+/**
+ * @ingroup FrameCollector
+ * @brief Timing statistics of the frames delivered to a client, in microseconds.
+ */
+struct TimingStatistics
+{
+  /**
+   * @brief Difference between the actual interval separating two consecutive frames (as stamped
+   * by the camera) and the interval requested by the client.
+   *
+   * Its spread is the jitter of the client's cadence.
+   */
+  RollingStatistics intervalError;
+
+  /**
+   * @brief Delay between the time a frame was due, and the time the collector triggered its
+   * capture. Negative for clients served early, to share a capture with other clients.
+   *
+   * Only available in just-in-time mode.
+   */
+  RollingStatistics schedulingDelay;
+
+  /**
+   * @brief Delay between the trigger of a capture and the start of the exposure, as stamped by
+   * the camera.
+   *
+   * Only available in just-in-time mode.
+   */
+  RollingStatistics cameraDelay;
+
+  /// Human-readable summary of the statistics.
+  std::string toString() const;
+};
+
+}  // namespace frame_collector
+}  // namespace server
+}  // namespace irsol
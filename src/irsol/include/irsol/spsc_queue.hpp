@@ -0,0 +1,422 @@
+/**
+ * @file irsol/spsc_queue.hpp
+ * @brief Lock-free, bounded, single-producer/single-consumer queue.
+ *
+ * This header defines the `SpscQueue` template class, an alternative to
+ * @ref irsol::utils::SafeQueue for the queues that have exactly one producer thread and one
+ * consumer thread. It exposes the same push/pop/producerFinished semantics, without taking any
+ * lock on the data path.
+ */
+
+#pragma once
+
+#include "irsol/assert.hpp"
+#include "irsol/macros.hpp"
+#include "irsol/queue.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace irsol {
+namespace utils {
+namespace internal {
+
+/// Size of a cache line, used to keep the data of the producer apart from the one of the consumer.
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Blocks the calling thread until @p word is woken up, unless it doesn't hold @p expected.
+ *
+ * On Linux, this is a futex wait: the thread sleeps in the kernel without consuming CPU. Spurious
+ * wake-ups are possible, so callers re-check their condition after returning.
+ *
+ * @param word     Word to wait on.
+ * @param expected Value of the word for which the thread goes to sleep.
+ * @note Wakers must modify @p word before calling @ref wakeAll().
+ */
+void waitOn(std::atomic<uint32_t>& word, uint32_t expected);
+
+/**
+ * @brief Wakes up all the threads waiting on @p word.
+ *
+ * @param word Word the threads are waiting on, see @ref waitOn().
+ */
+void wakeAll(std::atomic<uint32_t>& word);
+
+/**
+ * @brief Sleeping side of a producer or of a consumer, woken up by the other side.
+ *
+ * The waiter announces itself before sleeping, so that the other side only pays for a system call
+ * when somebody is actually waiting.
+ */
+struct alignas(CACHE_LINE_SIZE) Wakeup
+{
+  std::atomic<uint32_t> sequence{0};  ///< Incremented at each wake-up, waited on by the sleeper.
+  std::atomic<uint32_t> waiting{0};   ///< Whether a thread is (about to be) sleeping.
+
+  /// Blocks until @p ready returns `true`.
+  template<typename Ready>
+  void waitUntil(Ready&& ready)
+  {
+    while(!ready()) {
+      const auto seen = sequence.load(std::memory_order_acquire);
+      waiting.store(1, std::memory_order_relaxed);
+      // Pairs with the fence of notify(): either the other side sees the waiter, or the waiter
+      // sees the change of state made by the other side.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if(!ready()) {
+        waitOn(sequence, seen);
+      }
+      waiting.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /// Wakes up the waiter, if any. Must be called after the change of state it's waiting for.
+  void notify()
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // A single wake-up per sleep: the waiter announces itself again if it has to sleep more.
+    if(waiting.load(std::memory_order_relaxed) && waiting.exchange(0, std::memory_order_relaxed)) {
+      sequence.fetch_add(1, std::memory_order_release);
+      wakeAll(sequence);
+    }
+  }
+};
+}  // namespace internal
+
+/**
+ * @class SpscQueue
+ * @brief A lock-free, bounded queue for exactly one producer thread and one consumer thread.
+ *
+ * The items are stored in a ring buffer whose read and write positions are only ever written by,
+ * respectively, the consumer and the producer: pushing and popping is a handful of atomic loads and
+ * stores, without any lock. The positions of the two sides live on separate cache lines, and each
+ * side keeps a private copy of the position of the other side, only refreshed when the ring looks
+ * full (or empty): in steady state, the two threads do not bounce cache lines between each other.
+ *
+ * The queue supports the same operations as @ref irsol::utils::SafeQueue:
+ * - Blocking push: waits when full until space becomes available, unless the
+ *   @ref OverflowPolicy::DROP_NEWEST policy is used.
+ * - Non-blocking push: see @ref tryPush().
+ * - Blocking pop: waits when empty until an item is available or the queue is marked done.
+ * - Notification when the producer finishes to unblock the consumer.
+ *
+ * A blocked thread sleeps in the kernel (futex wait on Linux) instead of spinning, and the other
+ * side only performs a system call to wake it up when it's actually sleeping.
+ *
+ * Only the @ref OverflowPolicy::BLOCK and @ref OverflowPolicy::DROP_NEWEST policies are supported:
+ * discarding queued items would require the producer to consume, which is reserved to the consumer.
+ *
+ * @tparam T The type of elements stored in the queue. Must be default-constructible and movable.
+ *
+ * @note @ref push(), @ref tryPush() and @ref producerFinished() must only be called by the
+ * producer, @ref pop() and @ref tryPop() only by the consumer (or by threads whose calls are
+ * otherwise serialized with them). The other methods can be called from any thread.
+ *
+ * ```cpp
+ * irsol::utils::SpscQueue<int> queue(64);
+ *
+ * std::thread producer([&queue]() {
+ *   for (int i = 0; i < 20; ++i) {
+ *     queue.push(std::move(i));
+ *   }
+ *   queue.producerFinished();
+ * });
+ *
+ * int value;
+ * while (queue.pop(value)) {
+ *   std::cout << "Got value: " << value << std::endl;
+ * }
+ * producer.join();
+ * ```
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+  /**
+   * @brief Constructs a SpscQueue.
+   * @param capacity Maximum number of elements the queue can hold. Must be positive.
+   * @param policy   Behavior when pushing into a full queue, either @ref OverflowPolicy::BLOCK or
+   *                 @ref OverflowPolicy::DROP_NEWEST.
+   */
+  explicit SpscQueue(size_t capacity, OverflowPolicy policy = OverflowPolicy::BLOCK)
+    : m_capacity(capacity)
+    , m_policy(policy)
+    , m_slots(ringSizeFor(capacity))
+    , m_mask(m_slots.size() - 1)
+  {
+    IRSOL_ASSERT_ERROR(m_capacity > 0, "SpscQueue must be bounded");
+    IRSOL_ASSERT_ERROR(
+      m_policy == OverflowPolicy::BLOCK || m_policy == OverflowPolicy::DROP_NEWEST,
+      "SpscQueue only supports the BLOCK and DROP_NEWEST overflow policies");
+  }
+
+  /// Deleted copy constructor to prevent copying.
+  SpscQueue(const SpscQueue&) = delete;
+
+  /// Deleted copy assignment operator to prevent copying.
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /**
+   * @brief Push an item into the queue.
+   *
+   * With the @ref OverflowPolicy::BLOCK policy, blocks while the queue is full. With the
+   * @ref OverflowPolicy::DROP_NEWEST policy, never blocks: the item is discarded if the queue is
+   * full.
+   *
+   * @param item An rvalue reference to the item to push into the queue.
+   * @return `true` if the item was enqueued, `false` if it was discarded.
+   *
+   * @throws irsol::AssertionException error if the queue is marked done.
+   */
+  bool push(T&& item)
+  {
+    IRSOL_ASSERT_ERROR(!done(), "SpscQueue::push() called on an already done queue");
+
+    const auto tail = m_producer.tail.load(std::memory_order_relaxed);
+    if(!writable(tail)) {
+      if(m_policy != OverflowPolicy::BLOCK) {
+        m_producer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      m_producerWakeup.waitUntil([this, tail]() { return writable(tail); });
+    }
+    write(tail, std::move(item));
+    return true;
+  }
+
+  /**
+   * @brief Push an item into the queue, without ever blocking.
+   *
+   * If the queue is full, the item is rejected (left untouched). It's counted as rejected (see
+   * @ref rejected()) with the @ref OverflowPolicy::BLOCK policy, and as dropped otherwise.
+   *
+   * @param item An rvalue reference to the item to push into the queue.
+   * @return `true` if the item was enqueued, `false` otherwise.
+   *
+   * @throws irsol::AssertionException error if the queue is marked done.
+   */
+  bool tryPush(T&& item)
+  {
+    IRSOL_ASSERT_ERROR(!done(), "SpscQueue::tryPush() called on an already done queue");
+
+    const auto tail = m_producer.tail.load(std::memory_order_relaxed);
+    if(!writable(tail)) {
+      auto& counter = m_policy == OverflowPolicy::BLOCK ? m_producer.rejected : m_producer.dropped;
+      counter.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    write(tail, std::move(item));
+    return true;
+  }
+
+  /**
+   * @brief Pop an item from the queue.
+   *
+   * Blocks if the queue is empty until an item becomes available or the queue is marked done.
+   * Items pushed before the queue was marked done are still handed out, so that the consumer can
+   * drain the queue.
+   *
+   * @param out Reference to a variable where the popped item will be stored.
+   * @return `true` if an item was successfully popped, `false` if the queue is done and empty.
+   */
+  bool pop(T& out)
+  {
+    const auto head = m_consumer.head.load(std::memory_order_relaxed);
+    if(!readable(head)) {
+      m_consumerWakeup.waitUntil([this, head]() { return readable(head) || done(); });
+      // Everything pushed before the queue was marked done is visible by now.
+      if(!readable(head)) {
+        return false;
+      }
+    }
+    read(head, out);
+    return true;
+  }
+
+  /**
+   * @brief Pop an item from the queue, without ever blocking.
+   *
+   * @param out Reference to a variable where the popped item will be stored.
+   * @return `true` if an item was popped, `false` if the queue is empty.
+   */
+  bool tryPop(T& out)
+  {
+    const auto head = m_consumer.head.load(std::memory_order_relaxed);
+    if(!readable(head)) {
+      return false;
+    }
+    read(head, out);
+    return true;
+  }
+
+  /**
+   * @brief Signals that the producer has finished producing items.
+   *
+   * After calling this method, no more items should be pushed. It will unblock the consumer.
+   *
+   * @throws irsol::AssertionException error if called more than once.
+   */
+  void producerFinished()
+  {
+    // Not inside the assertion, which is compiled out when assertions are disabled.
+    IRSOL_MAYBE_UNUSED const bool wasDone = m_done.exchange(true, std::memory_order_release);
+    IRSOL_ASSERT_ERROR(!wasDone, "SpscQueue::producerFinished() called on an already done queue");
+    m_consumerWakeup.notify();
+  }
+
+  /**
+   * @brief Returns the current size of the queue.
+   * @return Number of items currently stored in the queue. The value may be outdated as soon as
+   *         it's returned, if the producer or the consumer are running.
+   */
+  size_t size() const
+  {
+    const auto head = m_consumer.head.load(std::memory_order_acquire);
+    const auto tail = m_producer.tail.load(std::memory_order_acquire);
+    return tail >= head ? tail - head : 0;
+  }
+
+  /**
+   * @brief Checks if the queue is full.
+   * @return `true` if the queue holds @ref capacity() items.
+   */
+  bool full() const
+  {
+    return size() >= m_capacity;
+  }
+
+  /**
+   * @brief Checks if the queue is empty.
+   * @return `true` if the queue contains no items, otherwise `false`.
+   */
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  /**
+   * @brief Returns whether the queue is marked done.
+   * @return `true` if the producer has called @ref producerFinished(), otherwise `false`.
+   */
+  bool done() const
+  {
+    return m_done.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Returns the number of items discarded by the @ref OverflowPolicy::DROP_NEWEST policy
+   * because the queue was full.
+   */
+  size_t dropped() const
+  {
+    return m_producer.dropped.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the number of items rejected by @ref tryPush() with the
+   * @ref OverflowPolicy::BLOCK policy because the queue was full.
+   *
+   * Unlike dropped items, rejected items are left to the producer, which may push them again
+   * later.
+   */
+  size_t rejected() const
+  {
+    return m_producer.rejected.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the maximum number of items held by the queue.
+   */
+  size_t capacity() const
+  {
+    return m_capacity;
+  }
+
+  /**
+   * @brief Returns the overflow policy of the queue.
+   */
+  OverflowPolicy policy() const
+  {
+    return m_policy;
+  }
+
+private:
+  /// Number of slots of the ring: a power of two, so that positions are mapped to slots by masking.
+  static size_t ringSizeFor(size_t capacity)
+  {
+    size_t size = 1;
+    while(size < capacity) {
+      size <<= 1;
+    }
+    return size;
+  }
+
+  /// Whether the producer can write at @p tail, refreshing its copy of the consumer's position.
+  bool writable(size_t tail)
+  {
+    if(tail - m_producer.cachedHead < m_capacity) {
+      return true;
+    }
+    m_producer.cachedHead = m_consumer.head.load(std::memory_order_acquire);
+    return tail - m_producer.cachedHead < m_capacity;
+  }
+
+  /// Whether the consumer can read at @p head, refreshing its copy of the producer's position.
+  bool readable(size_t head)
+  {
+    if(head != m_consumer.cachedTail) {
+      return true;
+    }
+    m_consumer.cachedTail = m_producer.tail.load(std::memory_order_acquire);
+    return head != m_consumer.cachedTail;
+  }
+
+  void write(size_t tail, T&& item)
+  {
+    m_slots[tail & m_mask] = std::move(item);
+    m_producer.tail.store(tail + 1, std::memory_order_release);
+    m_consumerWakeup.notify();
+  }
+
+  void read(size_t head, T& out)
+  {
+    // Moving the item out of its slot releases the resources it holds (e.g. a shared frame).
+    out = std::move(m_slots[head & m_mask]);
+    m_consumer.head.store(head + 1, std::memory_order_release);
+    m_producerWakeup.notify();
+  }
+
+  /// Data written by the producer.
+  struct alignas(internal::CACHE_LINE_SIZE) ProducerSide
+  {
+    std::atomic<size_t> tail{0};        ///< Position of the next item to write.
+    size_t              cachedHead{0};  ///< Read position of the consumer, as last seen.
+    std::atomic<size_t> dropped{0};     ///< Number of discarded items.
+    std::atomic<size_t> rejected{0};    ///< Number of items rejected by tryPush().
+  };
+
+  /// Data written by the consumer.
+  struct alignas(internal::CACHE_LINE_SIZE) ConsumerSide
+  {
+    std::atomic<size_t> head{0};        ///< Position of the next item to read.
+    size_t              cachedTail{0};  ///< Write position of the producer, as last seen.
+  };
+
+  const size_t         m_capacity;  ///< Maximum number of items held by the queue.
+  const OverflowPolicy m_policy;    ///< Behavior when pushing into a full queue.
+  std::vector<T>       m_slots;     ///< Ring buffer of the items.
+  const size_t         m_mask;      ///< Maps a position to its slot in the ring.
+
+  ProducerSide      m_producer;        ///< State owned by the producer.
+  ConsumerSide      m_consumer;        ///< State owned by the consumer.
+  internal::Wakeup  m_producerWakeup;  ///< Wakes up the producer waiting for space.
+  internal::Wakeup  m_consumerWakeup;  ///< Wakes up the consumer waiting for items.
+  std::atomic<bool> m_done{false};     ///< Flag indicating the queue is done.
+};
+
+}  // namespace utils
+}  // namespace irsol
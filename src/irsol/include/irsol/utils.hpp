@@ -7,10 +7,12 @@
  */
 #pragma once
 
+#include "irsol/buffer_pool.hpp"
 #include "irsol/queue.hpp"
 #include "irsol/types.hpp"
 
 #include <neoapi/neoapi.hpp>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -130,6 +132,17 @@ std::string stripString(const std::string& s, const std::string& strippedString)
  */
 std::string timestampToString(irsol::types::timepoint_t tp);
 
+/**
+ * @brief Parses a time point formatted by @ref timestampToString.
+ *
+ * Converts a local date and time string (e.g. `"2025-06-01 12:34:56.789012"`, the fractional
+ * seconds being optional) back into a @ref irsol::types::timepoint_t.
+ *
+ * @param s The string to parse.
+ * @return The corresponding time point, or `std::nullopt` if the string is not a valid timestamp.
+ */
+std::optional<irsol::types::timepoint_t> timestampFromString(const std::string& s);
+
 /**
  * @brief Converts a duration to a human-readable string.
  *
@@ -172,6 +185,15 @@ std::string bytesToString(const std::vector<irsol::types::byte_t>& input);
  */
 NeoAPI::Cam loadDefaultCamera();
 
+/**
+ * @brief Loads the camera device with the given serial number.
+ *
+ * @param serialNumber Serial number of the camera to open.
+ * @throws std::runtime_error If no matching camera is found or initialization fails.
+ * @return A handle to the opened NeoAPI camera device.
+ */
+NeoAPI::Cam loadCamera(const std::string& serialNumber);
+
 /**
  * @brief Discovers all cameras connected to the system.
  *
@@ -0,0 +1,157 @@
+#include "irsol/buffer_pool.hpp"
+
+#include "irsol/logging.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace irsol {
+namespace utils {
+
+BufferPool::BufferPool(bool useHugePages): m_useHugePages(useHugePages) {}
+
+BufferPool::buffer_t
+BufferPool::acquire(size_t numBytes)
+{
+  const auto index = classIndex(numBytes);
+
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  if(m_classes.size() <= index) {
+    m_classes.resize(index + 1);
+  }
+
+  auto& buffers = m_classes[index];
+  auto  it      = std::find_if(buffers.begin(), buffers.end(), isAvailable);
+  if(it == buffers.end()) {
+    IRSOL_LOG_DEBUG(
+      "Buffer pool: no buffer available for {} bytes, allocating a new one ({} in this class)",
+      numBytes,
+      buffers.size() + 1);
+    buffers.push_back(allocateNonThreadSafe(MIN_CLASS_SIZE << index));
+    it = std::prev(buffers.end());
+  }
+
+  // The capacity of the buffer is the class size: resizing never re-allocates.
+  (*it)->resize(numBytes);
+  return *it;
+}
+
+void
+BufferPool::reserve(size_t numBytes, size_t count)
+{
+  const auto index = classIndex(numBytes);
+
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  if(m_classes.size() <= index) {
+    m_classes.resize(index + 1);
+  }
+  auto& buffers = m_classes[index];
+  while(buffers.size() < count) {
+    buffers.push_back(allocateNonThreadSafe(MIN_CLASS_SIZE << index));
+  }
+}
+
+void
+BufferPool::useHugePages(bool enabled)
+{
+  m_useHugePages.store(enabled);
+}
+
+uint64_t
+BufferPool::numAllocations() const
+{
+  return m_numAllocations.load();
+}
+
+size_t
+BufferPool::numBuffers() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  size_t                       result = 0;
+  for(const auto& buffers : m_classes) {
+    result += buffers.size();
+  }
+  return result;
+}
+
+size_t
+BufferPool::numAvailable() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  size_t                       result = 0;
+  for(const auto& buffers : m_classes) {
+    result += static_cast<size_t>(std::count_if(buffers.begin(), buffers.end(), isAvailable));
+  }
+  return result;
+}
+
+size_t
+BufferPool::classSize(size_t numBytes)
+{
+  return MIN_CLASS_SIZE << classIndex(numBytes);
+}
+
+BufferPool&
+BufferPool::global()
+{
+  static BufferPool pool;
+  return pool;
+}
+
+size_t
+BufferPool::classIndex(size_t numBytes)
+{
+  size_t index = 0;
+  while((MIN_CLASS_SIZE << index) < numBytes) {
+    ++index;
+  }
+  return index;
+}
+
+BufferPool::buffer_t
+BufferPool::allocateNonThreadSafe(size_t classSize)
+{
+  auto buffer = std::make_shared<std::vector<irsol::types::byte_t>>();
+  buffer->reserve(classSize);
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if(m_useHugePages.load() && classSize >= HUGE_PAGE_SIZE) {
+    // Only the huge-page aligned part of the buffer can be backed by huge pages.
+    const auto begin   = reinterpret_cast<std::uintptr_t>(buffer->data());
+    const auto end     = begin + classSize;
+    const auto aligned = (begin + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    if(aligned + HUGE_PAGE_SIZE <= end) {
+      const auto length = (end - aligned) & ~(HUGE_PAGE_SIZE - 1);
+      if(madvise(reinterpret_cast<void*>(aligned), length, MADV_HUGEPAGE) != 0) {
+        IRSOL_LOG_WARN("Buffer pool: huge pages are not available for a {} bytes buffer", classSize);
+      }
+    }
+  }
+#endif
+
+  // Pre-fault the buffer, by writing all its pages once.
+  buffer->resize(classSize);
+
+  ++m_numAllocations;
+  return buffer;
+}
+
+bool
+BufferPool::isAvailable(const buffer_t& buffer)
+{
+  if(buffer.use_count() != 1) {
+    return false;
+  }
+  // The last consumer released the buffer with a release decrement of the reference count: make
+  // its accesses to the buffer visible before the buffer is handed out again.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return true;
+}
+
+}  // namespace utils
+}  // namespace irsol
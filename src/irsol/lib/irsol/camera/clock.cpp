@@ -0,0 +1,130 @@
+#include "irsol/camera/clock.hpp"
+
+#include "irsol/assert.hpp"
+#include "irsol/logging.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace irsol {
+namespace camera {
+
+DeviceClock::DeviceClock(double ticksPerSecond, size_t windowSize)
+  : m_ticksPerSecond(ticksPerSecond), m_windowSize(windowSize)
+{
+  IRSOL_ASSERT_ERROR(ticksPerSecond > 0.0, "Device clock frequency must be positive");
+  IRSOL_ASSERT_ERROR(windowSize > 0, "Device clock requires at least one sample");
+}
+
+void
+DeviceClock::addSample(
+  uint64_t                  deviceTicks,
+  irsol::types::timepoint_t hostBefore,
+  irsol::types::timepoint_t hostAfter)
+{
+  IRSOL_ASSERT_ERROR(hostBefore <= hostAfter, "Invalid host interval for clock sample");
+  const auto   halfRoundTrip = (hostAfter - hostBefore) / 2;
+  const double uncertainty =
+    std::chrono::duration<double>(halfRoundTrip).count() + 1e-6;  // Never trust a sample below 1us
+
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  if(!m_samples.empty() && deviceTicks < m_samples.back().deviceTicks) {
+    IRSOL_LOG_WARN("Device timestamp counter went backwards, resetting clock mapping");
+    m_samples.clear();
+  }
+  m_samples.push_back({deviceTicks, hostBefore + halfRoundTrip, 1.0 / (uncertainty * uncertainty)});
+  while(m_samples.size() > m_windowSize) {
+    m_samples.pop_front();
+  }
+  fitNonThreadSafe();
+}
+
+std::optional<irsol::types::timepoint_t>
+DeviceClock::toHost(uint64_t deviceTicks) const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  if(m_samples.empty()) {
+    return std::nullopt;
+  }
+  // Signed difference, as the timestamp may precede the reference sample.
+  const double deviceSeconds =
+    deviceTicks >= m_refTicks
+      ? static_cast<double>(deviceTicks - m_refTicks) / m_ticksPerSecond
+      : -static_cast<double>(m_refTicks - deviceTicks) / m_ticksPerSecond;
+  return m_refHost + std::chrono::duration_cast<irsol::types::duration_t>(
+                       std::chrono::duration<double>(m_rate * (deviceSeconds - m_refSeconds)));
+}
+
+double
+DeviceClock::drift() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return 1.0 / m_rate - 1.0;
+}
+
+size_t
+DeviceClock::numSamples() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_samples.size();
+}
+
+std::optional<irsol::types::timepoint_t>
+DeviceClock::lastSampleTime() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  if(m_samples.empty()) {
+    return std::nullopt;
+  }
+  return m_samples.back().hostTime;
+}
+
+void
+DeviceClock::reset()
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_samples.clear();
+  m_rate = 1.0;
+}
+
+void
+DeviceClock::fitNonThreadSafe()
+{
+  // Weighted least squares fit of `host = a + rate * device`, computed relative to the first
+  // sample of the window.
+  const auto& first = m_samples.front();
+  double      sumW = 0.0, sumX = 0.0, sumY = 0.0;
+  for(const auto& sample : m_samples) {
+    const double x = static_cast<double>(sample.deviceTicks - first.deviceTicks) / m_ticksPerSecond;
+    const double y = std::chrono::duration<double>(sample.hostTime - first.hostTime).count();
+    sumW += sample.weight;
+    sumX += sample.weight * x;
+    sumY += sample.weight * y;
+  }
+  const double meanX = sumX / sumW;
+  const double meanY = sumY / sumW;
+
+  double sumXX = 0.0, sumXY = 0.0;
+  for(const auto& sample : m_samples) {
+    const double dx =
+      static_cast<double>(sample.deviceTicks - first.deviceTicks) / m_ticksPerSecond - meanX;
+    const double dy =
+      std::chrono::duration<double>(sample.hostTime - first.hostTime).count() - meanY;
+    sumXX += sample.weight * dx * dx;
+    sumXY += sample.weight * dx * dy;
+  }
+
+  // With a single sample (or samples taken at the same device time) the rate can't be estimated:
+  // assume both clocks run at the same speed.
+  double rate = sumXX > 0.0 ? sumXY / sumXX : 1.0;
+  rate        = std::clamp(rate, 1.0 - MAX_DRIFT, 1.0 + MAX_DRIFT);
+
+  m_refTicks   = first.deviceTicks;
+  m_refSeconds = meanX;
+  m_refHost    = first.hostTime + std::chrono::duration_cast<irsol::types::duration_t>(
+                                 std::chrono::duration<double>(meanY));
+  m_rate       = rate;
+}
+
+}  // namespace camera
+}  // namespace irsol
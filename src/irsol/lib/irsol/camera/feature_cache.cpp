@@ -0,0 +1,91 @@
+#include "irsol/camera/feature_cache.hpp"
+
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace irsol {
+namespace camera {
+
+namespace {
+/// Process-wide table of the interned feature names.
+struct FeatureNames
+{
+  std::mutex                              mutex;
+  std::deque<std::string>                 names;    ///< Stable storage of the names.
+  std::unordered_map<std::string, size_t> indices;  ///< Index of each name in @ref names.
+};
+
+FeatureNames&
+featureNames()
+{
+  static FeatureNames table;
+  return table;
+}
+}
+
+FeatureId::FeatureId(const std::string& name)
+{
+  auto&                        table = featureNames();
+  std::scoped_lock<std::mutex> lock(table.mutex);
+  auto [it, inserted] = table.indices.try_emplace(name, table.names.size());
+  if(inserted) {
+    table.names.push_back(name);
+  }
+  m_index = it->second;
+  m_name  = &table.names[m_index];
+}
+
+size_t
+FeatureId::numInterned()
+{
+  auto&                        table = featureNames();
+  std::scoped_lock<std::mutex> lock(table.mutex);
+  return table.names.size();
+}
+
+const std::string&
+SimulatedFeatureTree::Feature::GetName() const
+{
+  return m_node->name;
+}
+
+int64_t
+SimulatedFeatureTree::Feature::GetInt() const
+{
+  return m_node->value;
+}
+
+void
+SimulatedFeatureTree::Feature::SetInt(int64_t value)
+{
+  m_node->value = value;
+}
+
+void
+SimulatedFeatureTree::addFeature(const std::string& name, int64_t value)
+{
+  m_features[name] = std::make_shared<Node>(Node{name, value});
+}
+
+SimulatedFeatureTree::Feature&
+SimulatedFeatureTree::GetFeature(const NeoAPI::NeoString& name) const
+{
+  ++m_numLookups;
+  auto it = m_features.find(name.c_str());
+  if(it == m_features.end()) {
+    throw std::out_of_range(std::string("No feature '") + name.c_str() + "'");
+  }
+  m_scratch.m_node = it->second;
+  return m_scratch;
+}
+
+uint64_t
+SimulatedFeatureTree::numLookups() const
+{
+  return m_numLookups;
+}
+
+}  // namespace camera
+}  // namespace irsol
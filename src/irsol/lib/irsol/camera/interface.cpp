@@ -2,14 +2,129 @@
 
 #include "irsol/assert.hpp"
 #include "irsol/logging.hpp"
+#include "irsol/macros.hpp"
 #include "irsol/utils.hpp"
 
+#include <algorithm>
+#include <iterator>
 #include <neoapi/neoapi.hpp>
 #include <tabulate/table.hpp>
+#include <utility>
 
 namespace irsol {
 namespace camera {
 
+namespace {
+// Features accessed on every frame.
+const FeatureId ACQUISITION_START("AcquisitionStart");
+const FeatureId ACQUISITION_STOP("AcquisitionStop");
+const FeatureId TRIGGER_SOFTWARE("TriggerSoftware");
+const FeatureId EXPOSURE_TIME("ExposureTime");
+const FeatureId TIMESTAMP_LATCH("TimestampLatch");
+const FeatureId TIMESTAMP_LATCH_VALUE("TimestampLatchValue");
+
+// Features constraining others, in the order they must be written. Writing a feature may change
+// the features listed after it, and the ones not listed (e.g. 'WidthMax', or 'PayloadSize').
+const char* const DEPENDENCY_ORDER[] = {"TriggerMode",
+                                        "TriggerSource",
+                                        "AcquisitionMode",
+                                        "PixelFormat",
+                                        "BinningHorizontalMode",
+                                        "BinningHorizontal",
+                                        "BinningVerticalMode",
+                                        "BinningVertical",
+                                        "DecimationHorizontal",
+                                        "DecimationVertical",
+                                        "OffsetX",
+                                        "Width",
+                                        "OffsetY",
+                                        "Height",
+                                        "ExposureAuto",
+                                        "ExposureMode",
+                                        "ExposureTime",
+                                        "AcquisitionFrameRateEnable",
+                                        "AcquisitionFrameRate"};
+
+/// Identifiers of the features of @ref DEPENDENCY_ORDER, in the same order.
+const std::vector<FeatureId>&
+orderedFeatures()
+{
+  static const std::vector<FeatureId> features = []() {
+    std::vector<FeatureId> result;
+    for(const auto* name : DEPENDENCY_ORDER) {
+      result.emplace_back(name);
+    }
+    return result;
+  }();
+  return features;
+}
+
+/// Rank of a feature in @ref DEPENDENCY_ORDER, the size of the list if it's not listed.
+size_t
+dependencyRank(const std::string& name)
+{
+  const auto* begin = std::begin(DEPENDENCY_ORDER);
+  const auto* end   = std::end(DEPENDENCY_ORDER);
+  return static_cast<size_t>(std::find(begin, end, name) - begin);
+}
+
+/// Size of the axis of the region of interest whose offset is @p offset, if any.
+const char*
+roiSizeOf(const std::string& offset)
+{
+  if(offset == "OffsetX") {
+    return "Width";
+  }
+  if(offset == "OffsetY") {
+    return "Height";
+  }
+  return nullptr;
+}
+
+/// Value of a numeric parameter as an integer, `std::nullopt` for other parameters.
+std::optional<int64_t>
+toInteger(const Interface::camera_param_t& value)
+{
+  return std::visit(
+    [](const auto& arg) -> std::optional<int64_t> {
+      using U = std::decay_t<decltype(arg)>;
+      if constexpr(std::is_arithmetic_v<U> && !std::is_same_v<U, bool>) {
+        return static_cast<int64_t>(arg);
+      } else {
+        return std::nullopt;
+      }
+    },
+    value);
+}
+
+/// Representation in which a parameter set as @p U is read back.
+template<typename U>
+using readback_t = std::conditional_t<
+  std::is_same_v<U, bool>,
+  bool,
+  std::conditional_t<
+    std::is_integral_v<U>,
+    int64_t,
+    std::conditional_t<std::is_floating_point_v<U>, double, std::string>>>;
+
+/// Forwards the images pushed by the driver to a callback.
+class ImageCallbackForwarder : public NeoAPI::NeoImageCallback
+{
+public:
+  explicit ImageCallbackForwarder(Interface::image_callback_t callback)
+    : m_callback(std::move(callback))
+  {}
+
+  void ImageCallback(const NeoAPI::Image& image) override
+  {
+    m_callback(image);
+  }
+
+private:
+  Interface::image_callback_t m_callback;
+};
+}
+
 Interface::Interface(NeoAPI::Cam cam): m_cam(cam)
 {
 
@@ -41,15 +156,18 @@ Interface::Interface(Interface&& other): m_cam(other.m_cam) {}
 Interface&
 Interface::operator=(Interface&& other)
 {
+  std::scoped_lock<std::mutex> lock(m_camMutex);
   m_cam = other.m_cam;
+  m_features.invalidate();
+  m_shadow.invalidate();
+  m_nextClockSyncRetry.reset();
+  m_clockSyncFailed = false;
   return *this;
 }
 
 Interface
-Interface::FullResolution()
+Interface::FullResolution(NeoAPI::Cam cam)
 {
-  auto cam = irsol::utils::loadDefaultCamera();
-
   Interface interface(cam);
   interface.setMultiParam({{"BinningVertical", {1}},
                            {"BinningVerticalMode", {"Sum"}},
@@ -60,10 +178,8 @@ Interface::FullResolution()
 }
 
 Interface
-Interface::HalfResolution()
+Interface::HalfResolution(NeoAPI::Cam cam)
 {
-  auto cam = irsol::utils::loadDefaultCamera();
-
   Interface interface(cam);
   // For 'HalfResolution' we bin in both vertical and horizontal direction.
   interface.setMultiParam({{"BinningVertical", {2}},
@@ -75,6 +191,12 @@ Interface::HalfResolution()
   return interface;
 }
 
+std::string
+Interface::serialNumber() const
+{
+  return m_cam.GetInfo().GetSerialNumber().c_str();
+}
+
 std::string
 Interface::cameraInfoAsString() const
 {
@@ -155,6 +277,35 @@ Interface::getNeoCam()
   return m_cam;
 }
 
+void
+Interface::reconnect()
+{
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+  const std::string            serialNumber = m_cam.GetInfo().GetSerialNumber().c_str();
+  IRSOL_LOG_INFO("Reconnecting camera with SN '{}'", serialNumber);
+  // The feature tree of the camera is rebuilt on connection.
+  m_features.invalidate();
+  m_shadow.invalidate();
+  m_nextClockSyncRetry.reset();
+  m_clockSyncFailed = false;
+  m_cam.Disconnect();
+  m_cam.Connect(serialNumber.c_str());
+}
+
+void
+Interface::setRefreshPeriod(
+  const std::string&                      param,
+  std::optional<irsol::types::duration_t> period)
+{
+  m_shadow.setRefreshPeriod(FeatureId(param), period);
+}
+
+const ParameterShadow&
+Interface::parameterShadow() const
+{
+  return m_shadow;
+}
+
 void
 Interface::resetSensorArea()
 {
@@ -169,7 +320,7 @@ Interface::resetSensorArea()
 irsol::types::duration_t
 Interface::getExposure() const
 {
-  auto exposureInMicroSeconds = getParam<int64_t>("ExposureTime");
+  auto exposureInMicroSeconds = getParam<int64_t>(EXPOSURE_TIME);
   return std::chrono::microseconds(exposureInMicroSeconds);
 }
 
@@ -180,51 +331,147 @@ Interface::setExposure(irsol::types::duration_t exposure)
   auto exposureInMicroseconds =
     std::chrono::duration_cast<std::chrono::microseconds>(exposure).count();
   auto setExposureInMicroseconds =
-    setParam("ExposureTime", static_cast<int64_t>(exposureInMicroseconds));
+    setParam(EXPOSURE_TIME, static_cast<int64_t>(exposureInMicroseconds));
   m_CachedExposureTime = std::chrono::microseconds(setExposureInMicroseconds);
   return m_CachedExposureTime;
 }
 
+irsol::types::duration_t
+Interface::cachedExposure() const
+{
+  return m_CachedExposureTime;
+}
+
+int64_t
+Interface::getIntParam(const std::string& param) const
+{
+  return getParam<int64_t>(param);
+}
+
+int64_t
+Interface::setIntParam(const std::string& param, int64_t value)
+{
+  return setParam(param, value);
+}
+
 std::string
 Interface::getParam(const std::string& param) const
 {
-  IRSOL_LOG_DEBUG("Getting parameter '{}'", param);
+  return getParam(FeatureId(param));
+}
+
+std::string
+Interface::getParam(const FeatureId& feature) const
+{
+  if(auto shadowed = m_shadow.get<std::string>(feature)) {
+    return *shadowed;
+  }
+  IRSOL_LOG_DEBUG("Getting parameter '{}'", feature.name());
   try {
-    NeoAPI::NeoString neoParam(param.c_str());
-    auto              feature = m_cam.GetFeature(neoParam);
-    return NeoAPI::NeoString(feature).c_str();
+    std::scoped_lock<std::mutex> lock(m_camMutex);
+    std::string value = NeoAPI::NeoString(featureNonThreadSafe(feature)).c_str();
+    m_shadow.store(feature, value);
+    return value;
   } catch(const std::exception& e) {
-    IRSOL_LOG_ERROR("Failed to get parameter '{}': {}", param, e.what());
+    IRSOL_LOG_ERROR("Failed to get parameter '{}': {}", feature.name(), e.what());
     return "Unknown";
   }
 }
 
-void
+bool
 Interface::setMultiParam(const std::unordered_map<std::string, camera_param_t>& params)
 {
-  IRSOL_LOG_DEBUG("Setting multiple parameters");
+  IRSOL_LOG_DEBUG("Setting {} parameters", params.size());
+  std::vector<std::string> names;
+  names.reserve(params.size());
+  for(const auto& entry : params) {
+    names.push_back(entry.first);
+  }
+  names = dependencyOrder(std::move(names));
+
   std::scoped_lock<std::mutex> lock(m_camMutex);
-  for(const auto& [param, value] : params) {
+  bool                         success = true;
+  std::vector<size_t>          written;
+  for(size_t i = 0; i < names.size(); ++i) {
+    // If the offset of an axis of the region of interest grows, its size is reduced first, so
+    // that the region stays within the sensor.
+    if(const auto* size = roiSizeOf(names[i])) {
+      auto sizeIt          = std::find(names.begin() + i + 1, names.end(), size);
+      auto requestedOffset = toInteger(params.at(names[i]));
+      if(sizeIt != names.end() && requestedOffset) {
+        try {
+          if(*requestedOffset > readParamNonThreadSafe<int64_t>(FeatureId(names[i]))) {
+            std::iter_swap(names.begin() + i, sizeIt);
+          }
+        } catch(const std::exception& e) {
+          IRSOL_LOG_WARN("Failed to get parameter '{}': {}", names[i], e.what());
+        }
+      }
+    }
+
+    const FeatureId feature(names[i]);
     std::visit(
-      [&param, this](auto&& arg) {
+      [&](const auto& arg) {
         using U = std::decay_t<decltype(arg)>;
-        IRSOL_LOG_TRACE("Setting parameter '{}' to value '{}'", param, arg);
-        setParamNonThreadSafe<U>(param, arg);
+        using R = readback_t<U>;
+        if(auto shadowed = m_shadow.get<R>(feature); shadowed && *shadowed == R(arg)) {
+          IRSOL_LOG_TRACE("Parameter '{}' is already set to '{}'", names[i], arg);
+          return;
+        }
+        IRSOL_LOG_TRACE("Setting parameter '{}' to value '{}'", names[i], arg);
+        if(setParamNonThreadSafe<U>(feature, arg)) {
+          written.push_back(i);
+        } else {
+          success = false;
+        }
+      },
+      params.at(names[i]));
+  }
+
+  // The frame size is only read back once all the parameters are applied.
+  if(std::any_of(written.begin(), written.end(), [&names](size_t i) {
+       return affectsPayloadSize(names[i]);
+     })) {
+    refitUserBuffersNonThreadSafe();
+  }
+
+  // Only the written parameters are read back, once all of them are applied.
+  for(const auto i : written) {
+    std::visit(
+      [&](const auto& arg) {
+        using R = readback_t<std::decay_t<decltype(arg)>>;
+        // Only logged, but reading it back also refreshes the shadow.
+        IRSOL_MAYBE_UNUSED const auto applied = getParamNonThreadSafe<R>(FeatureId(names[i]));
+        IRSOL_LOG_TRACE("Parameter '{}' set to '{}'", names[i], applied);
       },
-      value);
+      params.at(names[i]));
   }
+  return success;
+}
+
+std::vector<std::string>
+Interface::dependencyOrder(std::vector<std::string> features)
+{
+  std::sort(features.begin(), features.end(), [](const auto& lhs, const auto& rhs) {
+    return std::make_pair(dependencyRank(lhs), lhs) < std::make_pair(dependencyRank(rhs), rhs);
+  });
+  return features;
 }
 
 void
 Interface::trigger(const std::string& param)
 {
-  IRSOL_LOG_TRACE("Triggering camera with parameter '{}'", param);
+  trigger(FeatureId(param));
+}
+
+void
+Interface::trigger(const FeatureId& feature)
+{
+  IRSOL_LOG_TRACE("Triggering camera with parameter '{}'", feature.name());
   try {
-    NeoAPI::NeoString neoParam(param.c_str());
-    auto              feature = m_cam.GetFeature(neoParam);
-    feature.Execute();
+    featureNonThreadSafe(feature).Execute();
   } catch(const std::exception& e) {
-    IRSOL_LOG_ERROR("Failed to trigger camera with parameter '{}': {}", param, e.what());
+    IRSOL_LOG_ERROR("Failed to trigger camera with parameter '{}': {}", feature.name(), e.what());
   }
 }
 
@@ -234,8 +481,8 @@ Interface::captureImage(std::optional<irsol::types::duration_t> timeout)
   std::scoped_lock<std::mutex> lock(m_camMutex);
 
   // Send software trigger to get an image
-  trigger("AcquisitionStart");
-  trigger("TriggerSoftware");
+  trigger(ACQUISITION_START);
+  trigger(TRIGGER_SOFTWARE);
   // Wait for image, either using the current cached exposure time with a small buffer
   // or using the user-provided timeout
   irsol::types::duration_t actualTimeout = m_CachedExposureTime + std::chrono::milliseconds(200);
@@ -255,8 +502,276 @@ Interface::captureImage(std::optional<irsol::types::duration_t> timeout)
   if(image.IsEmpty() || image.GetSize() == 0) {
     IRSOL_LOG_WARN("Timeout or empty image received.");
   }
-  trigger("AcquisitionStop");
+  trigger(ACQUISITION_STOP);
   return image;
 }
+
+void
+Interface::startTriggeredAcquisition(image_callback_t callback)
+{
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+  IRSOL_LOG_INFO("Starting triggered acquisition");
+
+  // The images are pushed by the driver, instead of being polled.
+  m_imageCallback = std::make_unique<ImageCallbackForwarder>(std::move(callback));
+  m_cam.EnableImageCallback(*m_imageCallback);
+  // Stay armed after each frame, waiting for the next software trigger.
+  setParamNonThreadSafe("AcquisitionMode", "Continuous");
+  trigger(ACQUISITION_START);
+}
+
+void
+Interface::submitTrigger()
+{
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+  trigger(TRIGGER_SOFTWARE);
+}
+
+void
+Interface::stopTriggeredAcquisition()
+{
+  {
+    std::scoped_lock<std::mutex> lock(m_camMutex);
+    IRSOL_LOG_INFO("Stopping triggered acquisition");
+    trigger(ACQUISITION_STOP);
+    setParamNonThreadSafe("AcquisitionMode", "SingleFrame");
+  }
+  // Without holding the lock, as the driver waits for a running callback, which may need it.
+  m_cam.DisableImageCallback();
+  m_cam.ClearImages();
+  m_imageCallback.reset();
+}
+
+size_t
+Interface::maxPendingTriggers() const
+{
+  return triggerTiming().maxPendingTriggers();
+}
+
+bool
+Interface::setTriggerOverlap(bool enable)
+{
+  IRSOL_LOG_INFO("{} overlapped triggering", enable ? "Enabling" : "Disabling");
+  return setParam("TriggerOverlap", enable ? "ReadOut" : "Off") != "Off";
+}
+
+TriggerTiming
+Interface::triggerTiming() const
+{
+  return {cachedExposure(),
+          std::chrono::microseconds(getParam<int64_t>("ReadOutTime")),
+          getParam("TriggerOverlap") != "Off"};
+}
+
+void
+Interface::startContinuousAcquisition(double fps)
+{
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+  IRSOL_LOG_INFO("Starting continuous acquisition at {} fps", fps);
+
+  // Let the camera run on its own clock, instead of waiting for software triggers.
+  setParamNonThreadSafe("TriggerMode", "Off");
+  setParamNonThreadSafe("AcquisitionMode", "Continuous");
+  if(fps > 0.0) {
+    setParamNonThreadSafe("AcquisitionFrameRateEnable", true);
+    setParamNonThreadSafe("AcquisitionFrameRate", fps);
+  } else {
+    // Run as fast as the exposure and readout allow.
+    setParamNonThreadSafe("AcquisitionFrameRateEnable", false);
+  }
+  trigger(ACQUISITION_START);
+}
+
+Interface::image_t
+Interface::grabContinuousImage(std::optional<irsol::types::duration_t> timeout)
+{
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+
+  irsol::types::duration_t actualTimeout =
+    timeout.value_or(m_CachedExposureTime + std::chrono::milliseconds(200));
+  uint32_t timeoutMs = static_cast<uint32_t>(
+    std::chrono::duration_cast<std::chrono::milliseconds>(actualTimeout).count());
+  auto image = m_cam.GetImage(timeoutMs);
+  if(image.IsEmpty() || image.GetSize() == 0) {
+    // Not necessarily a failure: the camera may be idle between two frames.
+    IRSOL_LOG_DEBUG(
+      "No image received within {} during continuous acquisition",
+      irsol::utils::durationToString(actualTimeout));
+  }
+  return image;
+}
+
+void
+Interface::stopContinuousAcquisition()
+{
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+  IRSOL_LOG_INFO("Stopping continuous acquisition");
+
+  trigger(ACQUISITION_STOP);
+  setParamNonThreadSafe("AcquisitionFrameRateEnable", false);
+  // Restore the configuration used for software-triggered acquisitions.
+  setParamNonThreadSafe("AcquisitionMode", "SingleFrame");
+  setParamNonThreadSafe("TriggerMode", "On");
+}
+
+void
+Interface::enableUserBuffers(size_t numBuffers)
+{
+  const auto payloadSize = getParam<int64_t>("PayloadSize");
+  IRSOL_ASSERT_ERROR(payloadSize > 0, "Invalid payload size %ld", static_cast<long>(payloadSize));
+
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+  IRSOL_LOG_INFO("Enabling {} user buffers of {} bytes", numBuffers, payloadSize);
+  // Revoke the previous ring (if any) before handing the new buffers to the camera.
+  m_userBuffers.reset();
+  if(!m_userBufferDriver) {
+    m_userBufferDriver = std::make_unique<NeoAPIUserBufferDriver>(m_cam);
+  }
+  m_userBuffers = std::make_unique<UserBufferRing>(
+    *m_userBufferDriver, numBuffers, static_cast<size_t>(payloadSize));
+}
+
+void
+Interface::disableUserBuffers()
+{
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+  if(m_userBuffers) {
+    IRSOL_LOG_INFO("Disabling user buffers");
+    m_userBuffers.reset();
+  }
+}
+
+bool
+Interface::usesUserBuffers() const
+{
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+  return m_userBuffers != nullptr;
+}
+
+UserBufferRing::storage_t
+Interface::shareImageData(const image_t& image) const
+{
+  auto* buffer = image.GetUserBuffer<UserBuffer*>();
+  if(buffer == nullptr) {
+    return nullptr;
+  }
+
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+  if(!m_userBuffers || image.GetSize() != m_userBuffers->bufferSize()) {
+    return nullptr;
+  }
+  // The camera re-uses the buffer once the last copy of the image is destroyed.
+  return m_userBuffers->wrap(buffer, std::make_shared<image_t>(image));
+}
+
+irsol::types::timepoint_t
+Interface::imageTimestamp(const image_t& image)
+{
+  const auto deviceTimestamp = image.GetTimestamp();
+  if(deviceTimestamp == 0) {
+    return irsol::types::clock_t::now();
+  }
+
+  const auto lastSync = m_deviceClock.lastSampleTime();
+  if(!lastSync || irsol::types::clock_t::now() - *lastSync > CLOCK_SYNC_PERIOD) {
+    synchronizeClock();
+  }
+  return m_deviceClock.toHost(deviceTimestamp).value_or(irsol::types::clock_t::now());
+}
+
+bool
+Interface::synchronizeClock()
+{
+  std::scoped_lock<std::mutex> lock(m_camMutex);
+  if(m_nextClockSyncRetry && irsol::types::clock_t::now() < *m_nextClockSyncRetry) {
+    return false;
+  }
+  try {
+    // Only the latch command is bracketed by the host times: reading back the latched value
+    // doesn't need to be timely.
+    auto&      latch      = featureNonThreadSafe(TIMESTAMP_LATCH);
+    const auto hostBefore = irsol::types::clock_t::now();
+    latch.Execute();
+    const auto hostAfter = irsol::types::clock_t::now();
+    const auto deviceTicks =
+      static_cast<uint64_t>(featureNonThreadSafe(TIMESTAMP_LATCH_VALUE).GetInt());
+    m_deviceClock.addSample(deviceTicks, hostBefore, hostAfter);
+    IRSOL_LOG_TRACE(
+      "Device clock synchronized in {}, drift {} ppm",
+      irsol::utils::durationToString(hostAfter - hostBefore),
+      m_deviceClock.drift() * 1e6);
+    m_nextClockSyncRetry.reset();
+    m_clockSyncFailed = false;
+    return true;
+  } catch(const std::exception& e) {
+    // The failure is likely to persist (e.g. the camera has no timestamp latch): it is only
+    // reported once, and the synchronization is not attempted again for a while.
+    m_nextClockSyncRetry = irsol::types::clock_t::now() + CLOCK_SYNC_RETRY_PERIOD;
+    if(!m_clockSyncFailed) {
+      IRSOL_LOG_WARN(
+        "Failed to synchronize the device clock, retrying every {}: {}",
+        irsol::utils::durationToString(CLOCK_SYNC_RETRY_PERIOD),
+        e.what());
+    } else {
+      IRSOL_LOG_DEBUG("Failed to synchronize the device clock: {}", e.what());
+    }
+    m_clockSyncFailed = true;
+    return false;
+  }
+}
+
+const DeviceClock&
+Interface::deviceClock() const
+{
+  return m_deviceClock;
+}
+
+std::vector<ParameterShadow::refresh_t>
+Interface::volatileFeatures()
+{
+  std::vector<ParameterShadow::refresh_t> features;
+  for(const auto* name : VOLATILE_FEATURES) {
+    features.emplace_back(FeatureId(name), VOLATILE_REFRESH_PERIOD);
+  }
+  return features;
+}
+
+NeoAPI::Feature&
+Interface::featureNonThreadSafe(const FeatureId& feature) const
+{
+  return m_features.get(m_cam, feature);
+}
+
+void
+Interface::invalidateDependentsNonThreadSafe(const FeatureId& feature) const
+{
+  const auto& ordered = orderedFeatures();
+  const auto  it = std::find_if(ordered.begin(), ordered.end(), [&feature](const FeatureId& other) {
+    return other.index() == feature.index();
+  });
+  m_shadow.invalidateAllBut({ordered.begin(), it});
+}
+
+void
+Interface::refitUserBuffersNonThreadSafe()
+{
+  if(!m_userBuffers) {
+    return;
+  }
+  const auto payloadSize = getParamNonThreadSafe<int64_t>(FeatureId("PayloadSize"));
+  if(payloadSize <= 0) {
+    IRSOL_LOG_ERROR("Invalid payload size {}, user buffers not re-allocated", payloadSize);
+    return;
+  }
+  try {
+    UserBufferRing::refit(m_userBuffers, static_cast<size_t>(payloadSize));
+  } catch(const std::exception& e) {
+    // Without user buffers, the images are acquired in the buffers of the camera, and copied.
+    IRSOL_LOG_ERROR("Failed to re-allocate the user buffers, disabling them: {}", e.what());
+    m_userBuffers.reset();
+    m_userBufferDriver->disable();
+  }
+}
+
 }  // namespace camera
 }  // namespace irsol
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "irsol/camera/parameter_shadow.hpp"
+
+#include <algorithm>
+
+namespace irsol {
+namespace camera {
+
+bool
+ParameterShadow::Entry::empty() const
+{
+  return !boolean && !integer && !real && !text;
+}
+
+void
+ParameterShadow::Entry::clear()
+{
+  boolean.reset();
+  integer.reset();
+  real.reset();
+  text.reset();
+}
+
+ParameterShadow::ParameterShadow(const std::vector<refresh_t>& volatileFeatures)
+{
+  for(const auto& [feature, period] : volatileFeatures) {
+    entryOf(feature).refreshPeriod = period;
+  }
+}
+
+void
+ParameterShadow::invalidate()
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  for(auto& entry : m_entries) {
+    entry.clear();
+  }
+}
+
+void
+ParameterShadow::invalidateAllBut(const std::vector<FeatureId>& kept)
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  for(size_t index = 0; index < m_entries.size(); ++index) {
+    const bool isKept = std::any_of(kept.begin(), kept.end(), [index](const FeatureId& feature) {
+      return feature.index() == index;
+    });
+    if(!isKept) {
+      m_entries[index].clear();
+    }
+  }
+}
+
+void
+ParameterShadow::setRefreshPeriod(
+  const FeatureId&                        feature,
+  std::optional<irsol::types::duration_t> period)
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  auto&                        entry = entryOf(feature);
+  entry.refreshPeriod                = period;
+  entry.clear();
+}
+
+uint64_t
+ParameterShadow::numHits() const
+{
+  return m_numHits.load();
+}
+
+uint64_t
+ParameterShadow::numMisses() const
+{
+  return m_numMisses.load();
+}
+
+const ParameterShadow::Entry*
+ParameterShadow::validEntry(const FeatureId& feature, irsol::types::timepoint_t now) const
+{
+  if(feature.index() >= m_entries.size()) {
+    return nullptr;
+  }
+  const auto& entry = m_entries[feature.index()];
+  if(entry.empty() || (entry.refreshPeriod && now - entry.fetched > *entry.refreshPeriod)) {
+    return nullptr;
+  }
+  return &entry;
+}
+
+ParameterShadow::Entry&
+ParameterShadow::freshEntry(const FeatureId& feature, irsol::types::timepoint_t now)
+{
+  auto& entry = entryOf(feature);
+  if(!validEntry(feature, now)) {
+    // Don't mix the representations of values read at different times.
+    entry.clear();
+    entry.fetched = now;
+  }
+  return entry;
+}
+
+ParameterShadow::Entry&
+ParameterShadow::entryOf(const FeatureId& feature)
+{
+  if(feature.index() >= m_entries.size()) {
+    m_entries.resize(feature.index() + 1);
+  }
+  return m_entries[feature.index()];
+}
+
+}  // namespace camera
+}  // namespace irsol
@@ -0,0 +1,162 @@
+#include "irsol/camera/recording.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace irsol {
+namespace camera {
+
+namespace {
+/// Magic string starting every recording file.
+constexpr char MAGIC[] = {'I', 'R', 'S', 'O', 'L', 'R', 'E', 'C'};
+
+/// Largest accepted serial number, to detect corrupted headers.
+constexpr uint32_t MAX_SERIAL_LENGTH = 1024;
+
+template<typename T>
+void
+writeValue(std::ofstream& file, const T& value)
+{
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool
+readValue(std::ifstream& file, T& value)
+{
+  return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+}
+
+RecordingWriter::RecordingWriter(const std::string& path, const RecordingHeader& header)
+  : m_file(path, std::ios::binary | std::ios::trunc), m_path(path)
+{
+  if(!m_file) {
+    throw std::runtime_error("Cannot create recording '" + path + "'");
+  }
+  m_file.write(MAGIC, sizeof(MAGIC));
+  writeValue(m_file, RecordingReader::FORMAT_VERSION);
+  writeValue(
+    m_file,
+    static_cast<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(header.exposure).count()));
+  writeValue(m_file, static_cast<uint32_t>(header.serialNumber.size()));
+  m_file.write(header.serialNumber.data(), header.serialNumber.size());
+  if(!m_file) {
+    throw std::runtime_error("Cannot write the header of recording '" + path + "'");
+  }
+}
+
+void
+RecordingWriter::write(
+  uint64_t                    frameId,
+  irsol::types::timepoint_t   timestamp,
+  uint64_t                    width,
+  uint64_t                    height,
+  const irsol::types::byte_t* data,
+  size_t                      numBytes)
+{
+  writeValue(m_file, frameId);
+  writeValue(
+    m_file,
+    static_cast<int64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count()));
+  writeValue(m_file, width);
+  writeValue(m_file, height);
+  writeValue(m_file, static_cast<uint64_t>(numBytes));
+  m_file.write(reinterpret_cast<const char*>(data), numBytes);
+  // Flushed, so that the recording is usable even if the recording process is interrupted.
+  m_file.flush();
+  if(!m_file) {
+    throw std::runtime_error(
+      "Cannot write frame " + std::to_string(frameId) + " to recording '" + m_path + "'");
+  }
+  ++m_numFrames;
+}
+
+uint64_t
+RecordingWriter::numFrames() const
+{
+  return m_numFrames;
+}
+
+RecordingReader::RecordingReader(const std::string& path)
+  : m_file(path, std::ios::binary), m_path(path)
+{
+  if(!m_file) {
+    throw std::runtime_error("Cannot open recording '" + path + "'");
+  }
+  char     magic[sizeof(MAGIC)];
+  uint32_t version      = 0;
+  int64_t  exposureUs   = 0;
+  uint32_t serialLength = 0;
+  if(
+    !m_file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+    !readValue(m_file, version)) {
+    throw std::runtime_error("File '" + path + "' is not a recording");
+  }
+  if(version != FORMAT_VERSION) {
+    throw std::runtime_error(
+      "Unsupported version " + std::to_string(version) + " of recording '" + path + "'");
+  }
+  if(
+    !readValue(m_file, exposureUs) || !readValue(m_file, serialLength) ||
+    serialLength > MAX_SERIAL_LENGTH) {
+    throw std::runtime_error("Corrupted header of recording '" + path + "'");
+  }
+  m_header.serialNumber.resize(serialLength);
+  if(!m_file.read(m_header.serialNumber.data(), serialLength)) {
+    throw std::runtime_error("Corrupted header of recording '" + path + "'");
+  }
+  m_header.exposure = std::chrono::microseconds(exposureUs);
+  m_firstFrame      = m_file.tellg();
+}
+
+const RecordingHeader&
+RecordingReader::header() const
+{
+  return m_header;
+}
+
+std::optional<RecordedFrame>
+RecordingReader::next(irsol::utils::BufferPool& pool)
+{
+  RecordedFrame frame;
+  int64_t       timestampNs = 0;
+  uint64_t      numBytes    = 0;
+  if(!readValue(m_file, frame.frameId)) {
+    // End of the recording.
+    return std::nullopt;
+  }
+  const auto corrupted = [this, &frame]() {
+    return std::runtime_error(
+      "Corrupted frame " + std::to_string(frame.frameId) + " in recording '" + m_path + "'");
+  };
+  if(
+    !readValue(m_file, timestampNs) || !readValue(m_file, frame.width) ||
+    !readValue(m_file, frame.height) || !readValue(m_file, numBytes)) {
+    throw corrupted();
+  }
+  // Mono12 pixels, stored on 2 bytes.
+  if(numBytes != frame.width * frame.height * sizeof(uint16_t)) {
+    throw corrupted();
+  }
+  frame.timestamp = irsol::types::timepoint_t(
+    std::chrono::duration_cast<irsol::types::duration_t>(std::chrono::nanoseconds(timestampNs)));
+  frame.data = pool.acquire(numBytes);
+  if(!m_file.read(reinterpret_cast<char*>(frame.data->data()), numBytes)) {
+    throw corrupted();
+  }
+  return frame;
+}
+
+void
+RecordingReader::rewind()
+{
+  m_file.clear();
+  m_file.seekg(m_firstFrame);
+}
+
+}  // namespace camera
+}  // namespace irsol
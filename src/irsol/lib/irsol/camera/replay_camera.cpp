@@ -0,0 +1,199 @@
+#include "irsol/camera/replay_camera.hpp"
+
+#include "irsol/logging.hpp"
+#include "irsol/macros.hpp"
+#include "irsol/utils.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <tabulate/table.hpp>
+#include <thread>
+
+namespace irsol {
+namespace camera {
+
+ReplayCamera::ReplayCamera(
+  const std::string&        path,
+  Pacing                    pacing,
+  irsol::utils::BufferPool& pool)
+  : m_pacing(pacing), m_pool(pool)
+{
+  if(std::filesystem::is_directory(path)) {
+    for(const auto& entry : std::filesystem::directory_iterator(path)) {
+      if(entry.is_regular_file()) {
+        m_recordings.push_back(entry.path().string());
+      }
+    }
+    std::sort(m_recordings.begin(), m_recordings.end());
+  } else {
+    m_recordings.push_back(path);
+  }
+  if(m_recordings.empty()) {
+    throw std::runtime_error("No recording found in '" + path + "'");
+  }
+
+  m_reader = std::make_unique<RecordingReader>(m_recordings.front());
+  m_header = m_reader->header();
+  IRSOL_LOG_INFO(
+    "Replaying {} recording(s) from '{}', captured with camera SN '{}'",
+    m_recordings.size(),
+    path,
+    m_header.serialNumber);
+}
+
+std::string
+ReplayCamera::serialNumber() const
+{
+  return m_header.serialNumber;
+}
+
+std::string
+ReplayCamera::cameraStatusAsString() const
+{
+  tabulate::Table featureInfo;
+  featureInfo.add_row({"Feature", "Value"});
+  featureInfo.add_row({"PixelFormat", "Mono12"});
+  for(const auto featureName : {"ExposureTime", "FrameCounter", "Height", "Width"}) {
+    featureInfo.add_row({featureName, std::to_string(getIntParam(featureName))});
+  }
+  featureInfo.column(0).format().font_align(tabulate::FontAlign::right);
+  return featureInfo.str();
+}
+
+irsol::types::duration_t
+ReplayCamera::getExposure() const
+{
+  return m_header.exposure;
+}
+
+irsol::types::duration_t
+ReplayCamera::setExposure(IRSOL_MAYBE_UNUSED irsol::types::duration_t exposure)
+{
+  IRSOL_LOG_ERROR("Feature 'ExposureTime' is not writable");
+  return m_header.exposure;
+}
+
+irsol::types::duration_t
+ReplayCamera::cachedExposure() const
+{
+  return m_header.exposure;
+}
+
+int64_t
+ReplayCamera::getIntParam(const std::string& param) const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  if(param == "ExposureTime") {
+    return std::chrono::duration_cast<std::chrono::microseconds>(m_header.exposure).count();
+  } else if(param == "FrameCounter") {
+    return static_cast<int64_t>(m_numReplayedFrames);
+  } else if(param == "Width" || param == "WidthMax") {
+    return static_cast<int64_t>(m_lastWidth);
+  } else if(param == "Height" || param == "HeightMax") {
+    return static_cast<int64_t>(m_lastHeight);
+  } else if(param == "OffsetX" || param == "OffsetY") {
+    return 0;
+  }
+  IRSOL_LOG_ERROR("Failed to get parameter '{}': no such feature", param);
+  return 0;
+}
+
+int64_t
+ReplayCamera::setIntParam(const std::string& param, IRSOL_MAYBE_UNUSED int64_t value)
+{
+  IRSOL_LOG_ERROR("Feature '{}' is not writable", param);
+  return getIntParam(param);
+}
+
+RecordedFrame
+ReplayCamera::next()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto                         frame = readNextNonThreadSafe();
+  const auto                   now   = irsol::types::clock_t::now();
+
+  // Frame IDs keep increasing over the passes.
+  if(m_newPass) {
+    m_idShift = m_lastFrameId + 1 - frame.frameId;
+    m_newPass = false;
+  }
+  frame.frameId += m_idShift;
+
+  // The first frame of a recording follows the last frame of the previous one.
+  if(!m_segment) {
+    const auto replayStart = m_lastReplay ? m_lastReplay->first + m_lastReplay->second : now;
+    m_segment              = Segment{frame.timestamp, replayStart, frame.timestamp, 0};
+  }
+  auto& segment = *m_segment;
+  ++segment.numFrames;
+  segment.recordedLast = frame.timestamp;
+
+  const auto replayTime   = segment.replayStart + (frame.timestamp - segment.recordedStart);
+  const auto meanInterval = segment.numFrames > 1
+                              ? (segment.recordedLast - segment.recordedStart) /
+                                  static_cast<int64_t>(segment.numFrames - 1)
+                              : m_header.exposure;
+  m_lastReplay            = std::make_pair(replayTime, meanInterval);
+
+  m_lastFrameId = frame.frameId;
+  m_lastWidth   = frame.width;
+  m_lastHeight  = frame.height;
+  ++m_numReplayedFrames;
+
+  if(m_pacing == Pacing::ORIGINAL) {
+    frame.timestamp = replayTime;
+    lock.unlock();
+    std::this_thread::sleep_until(replayTime);
+  } else {
+    frame.timestamp = now;
+  }
+  return frame;
+}
+
+const std::vector<std::string>&
+ReplayCamera::recordings() const
+{
+  return m_recordings;
+}
+
+uint64_t
+ReplayCamera::numReplayedFrames() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_numReplayedFrames;
+}
+
+uint64_t
+ReplayCamera::numPasses() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_numPasses;
+}
+
+RecordedFrame
+ReplayCamera::readNextNonThreadSafe()
+{
+  // A full round over the recordings without any frame means that there is nothing to replay.
+  for(size_t numEmpty = 0; numEmpty <= m_recordings.size(); ++numEmpty) {
+    if(auto frame = m_reader->next(m_pool)) {
+      return std::move(*frame);
+    }
+    if(++m_recordingIndex == m_recordings.size()) {
+      m_recordingIndex = 0;
+      m_newPass        = true;
+      ++m_numPasses;
+    }
+    if(m_recordings.size() == 1) {
+      m_reader->rewind();
+    } else {
+      m_reader = std::make_unique<RecordingReader>(m_recordings[m_recordingIndex]);
+    }
+    m_segment.reset();
+    IRSOL_LOG_DEBUG("Replaying recording '{}'", m_recordings[m_recordingIndex]);
+  }
+  throw std::runtime_error("The replayed recordings contain no frame");
+}
+
+}  // namespace camera
+}  // namespace irsol
@@ -0,0 +1,418 @@
+#include "irsol/camera/simulated_camera.hpp"
+
+#include "irsol/assert.hpp"
+#include "irsol/logging.hpp"
+#include "irsol/utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <tabulate/table.hpp>
+#include <thread>
+#include <vector>
+
+namespace irsol {
+namespace camera {
+
+namespace {
+/// Features that can only be read.
+const char* const READ_ONLY_FEATURES[] = {
+  "WidthMax", "HeightMax", "SensorWidth", "SensorHeight", "FrameCounter"};
+
+bool
+isReadOnly(const std::string& param)
+{
+  return std::any_of(
+    std::begin(READ_ONLY_FEATURES), std::end(READ_ONLY_FEATURES), [&param](const char* feature) {
+      return param == feature;
+    });
+}
+}
+
+SimulatedCamera::SimulatedCamera(): SimulatedCamera(Config{}) {}
+
+SimulatedCamera::SimulatedCamera(Config config)
+  : m_config(std::move(config)), m_triggerOverlap(m_config.triggerOverlap)
+{
+  IRSOL_ASSERT_ERROR(
+    m_config.roiIncrement > 0 && m_config.maxBinning > 0,
+    "Simulated camera requires a positive increment and maximum binning");
+  const auto sensorWidth  = roundToIncrement(static_cast<int64_t>(m_config.sensorWidth));
+  const auto sensorHeight = roundToIncrement(static_cast<int64_t>(m_config.sensorHeight));
+  IRSOL_ASSERT_ERROR(sensorWidth > 0 && sensorHeight > 0, "Simulated sensor is too small");
+
+  m_params = {{"SensorWidth", sensorWidth},
+              {"SensorHeight", sensorHeight},
+              {"WidthMax", sensorWidth},
+              {"HeightMax", sensorHeight},
+              {"Width", sensorWidth},
+              {"Height", sensorHeight},
+              {"OffsetX", 0},
+              {"OffsetY", 0},
+              {"BinningHorizontal", 1},
+              {"BinningVertical", 1},
+              {"ExposureTime", 0}};
+  setExposure(DEFAULT_EXPOSURE_TIME);
+}
+
+SimulatedCamera::~SimulatedCamera()
+{
+  stopTriggered();
+}
+
+std::string
+SimulatedCamera::serialNumber() const
+{
+  return m_config.serialNumber;
+}
+
+std::string
+SimulatedCamera::cameraStatusAsString() const
+{
+  std::vector<std::pair<std::string, int64_t>> values;
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    values.assign(m_params.begin(), m_params.end());
+    values.emplace_back("FrameCounter", static_cast<int64_t>(m_nextFrameId));
+  }
+
+  tabulate::Table featureInfo;
+  featureInfo.add_row({"Feature", "Value"});
+  featureInfo.add_row({"PixelFormat", "Mono12"});
+  for(const auto& [featureName, featureValue] : values) {
+    featureInfo.add_row({featureName, std::to_string(featureValue)});
+  }
+  featureInfo.column(0).format().font_align(tabulate::FontAlign::right);
+  return featureInfo.str();
+}
+
+irsol::types::duration_t
+SimulatedCamera::getExposure() const
+{
+  return std::chrono::microseconds(getIntParam("ExposureTime"));
+}
+
+irsol::types::duration_t
+SimulatedCamera::setExposure(irsol::types::duration_t exposure)
+{
+  IRSOL_ASSERT_ERROR(exposure.count() > 0, "Cannot set non-positive exposure");
+  const auto exposureInMicroseconds =
+    std::chrono::duration_cast<std::chrono::microseconds>(exposure).count();
+  return std::chrono::microseconds(setIntParam("ExposureTime", exposureInMicroseconds));
+}
+
+irsol::types::duration_t
+SimulatedCamera::cachedExposure() const
+{
+  // The simulated camera has no transport layer: reading the exposure is as cheap as caching it.
+  return getExposure();
+}
+
+int64_t
+SimulatedCamera::getIntParam(const std::string& param) const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  if(param == "FrameCounter") {
+    return static_cast<int64_t>(m_nextFrameId);
+  }
+  auto it = m_params.find(param);
+  if(it == m_params.end()) {
+    IRSOL_LOG_ERROR("Failed to get parameter '{}': no such feature", param);
+    return 0;
+  }
+  return it->second;
+}
+
+int64_t
+SimulatedCamera::setIntParam(const std::string& param, int64_t value)
+{
+  IRSOL_LOG_DEBUG("Setting parameter '{}' to value '{}'", param, value);
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return setIntParamNonThreadSafe(param, value);
+}
+
+irsol::types::duration_t
+SimulatedCamera::readoutTime() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return triggerTimingNonThreadSafe().readout;
+}
+
+irsol::types::duration_t
+SimulatedCamera::captureTime() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return captureTimeNonThreadSafe();
+}
+
+void
+SimulatedCamera::setTriggerOverlap(bool enable)
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_triggerOverlap = enable;
+}
+
+TriggerTiming
+SimulatedCamera::triggerTiming() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return triggerTimingNonThreadSafe();
+}
+
+SimulatedCamera::Frame
+SimulatedCamera::captureSingle()
+{
+  irsol::types::duration_t captureTime;
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    captureTime = captureTimeNonThreadSafe();
+  }
+  const auto exposureStart = irsol::types::clock_t::now();
+  std::this_thread::sleep_until(exposureStart + captureTime);
+
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return nextFrameNonThreadSafe(exposureStart);
+}
+
+void
+SimulatedCamera::startContinuous(double fps)
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_requestedPeriod = irsol::types::duration_t::zero();
+  if(fps > 0.0) {
+    m_requestedPeriod = std::chrono::duration_cast<irsol::types::duration_t>(
+      std::chrono::duration<double>(1.0 / fps));
+  }
+  m_continuous = true;
+  m_lastTick   = irsol::types::clock_t::now();
+  IRSOL_NAMED_LOG_DEBUG(
+    "simulated_camera",
+    "Started continuous acquisition with period {}",
+    irsol::utils::durationToString(std::max(m_requestedPeriod, captureTimeNonThreadSafe())));
+}
+
+SimulatedCamera::Frame
+SimulatedCamera::nextContinuous()
+{
+  irsol::types::duration_t  period;
+  irsol::types::timepoint_t tick;
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    IRSOL_ASSERT_ERROR(m_continuous, "Continuous acquisition was not started");
+    period = std::max(m_requestedPeriod, captureTimeNonThreadSafe());
+    tick   = m_lastTick + period;
+  }
+  std::this_thread::sleep_until(tick);
+
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  // Frames are produced on a regular grid: the frames read out while nobody waited for them are
+  // dropped, as a camera would, but they were still counted by the camera.
+  const auto now = irsol::types::clock_t::now();
+  while(tick + period <= now) {
+    tick += period;
+    ++m_nextFrameId;
+    ++m_numDroppedFrames;
+  }
+  m_lastTick = tick;
+  return nextFrameNonThreadSafe(tick - captureTimeNonThreadSafe());
+}
+
+void
+SimulatedCamera::stopContinuous()
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_continuous = false;
+}
+
+void
+SimulatedCamera::startTriggered(frame_callback_t callback)
+{
+  stopTriggered();
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_frameCallback = std::move(callback);
+  m_readoutThread = std::thread(&SimulatedCamera::runReadout, this);
+}
+
+bool
+SimulatedCamera::submitTrigger()
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  IRSOL_ASSERT_ERROR(m_readoutThread.joinable(), "Triggered acquisition was not started");
+  const auto now    = irsol::types::clock_t::now();
+  const auto timing = triggerTimingNonThreadSafe();
+  // Without overlap, the camera waits for the end of the readout. With overlap, it waits for the
+  // end of the exposure, and the new exposure must not end before the readout is complete.
+  const bool ready = timing.overlap
+                       ? now >= m_lastExposureEnd && now + timing.exposure >= m_lastReadoutEnd
+                       : now >= m_lastReadoutEnd;
+  if(!ready) {
+    ++m_numSkippedTriggers;
+    IRSOL_NAMED_LOG_WARN("simulated_camera", "Camera not ready, skipping trigger");
+    return false;
+  }
+
+  m_lastExposureEnd = now + timing.exposure;
+  m_lastReadoutEnd  = m_lastExposureEnd + timing.readout;
+  m_readouts.emplace_back(m_lastReadoutEnd, nextFrameNonThreadSafe(now));
+  m_readoutCondition.notify_one();
+  return true;
+}
+
+void
+SimulatedCamera::stopTriggered()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if(!m_readoutThread.joinable()) {
+    return;
+  }
+  m_stopReadout = true;
+  m_readoutCondition.notify_one();
+  lock.unlock();
+  m_readoutThread.join();
+
+  lock.lock();
+  m_stopReadout = false;
+  m_readouts.clear();
+  m_frameCallback = nullptr;
+}
+
+uint64_t
+SimulatedCamera::numSkippedTriggers() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_numSkippedTriggers;
+}
+
+uint64_t
+SimulatedCamera::numDroppedFrames() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_numDroppedFrames;
+}
+
+void
+SimulatedCamera::render(const Frame& frame, irsol::types::byte_t* data)
+{
+  std::vector<uint16_t> row(frame.width);
+  for(uint64_t y = 0; y < frame.height; ++y) {
+    for(uint64_t x = 0; x < frame.width; ++x) {
+      row[x] = pixelValue(frame, x, y);
+    }
+    const auto rowBytes = row.size() * sizeof(uint16_t);
+    std::memcpy(data + y * rowBytes, row.data(), rowBytes);
+  }
+}
+
+uint16_t
+SimulatedCamera::pixelValue(const Frame& frame, uint64_t x, uint64_t y)
+{
+  const uint64_t sensorX = (frame.offsetX + x) * frame.binningHorizontal;
+  const uint64_t sensorY = (frame.offsetY + y) * frame.binningVertical;
+  return static_cast<uint16_t>((frame.frameId + sensorX + sensorY) & 0x0fff);
+}
+
+int64_t
+SimulatedCamera::setIntParamNonThreadSafe(const std::string& param, int64_t value)
+{
+  if(isReadOnly(param)) {
+    IRSOL_LOG_ERROR("Feature '{}' is not writable", param);
+    return param == "FrameCounter" ? static_cast<int64_t>(m_nextFrameId) : m_params.at(param);
+  }
+  auto it = m_params.find(param);
+  if(it == m_params.end()) {
+    IRSOL_LOG_ERROR("Failed to set parameter '{}': no such feature", param);
+    return 0;
+  }
+
+  const auto clampTo = [](int64_t value, int64_t low, int64_t high) {
+    return std::clamp(value, low, std::max(low, high));
+  };
+  const auto increment  = static_cast<int64_t>(m_config.roiIncrement);
+  const bool horizontal = param == "BinningHorizontal" || param == "Width" || param == "OffsetX";
+  auto&      size       = m_params.at(horizontal ? "Width" : "Height");
+  auto&      offset     = m_params.at(horizontal ? "OffsetX" : "OffsetY");
+  auto&      sizeMax    = m_params.at(horizontal ? "WidthMax" : "HeightMax");
+
+  if(param == "BinningHorizontal" || param == "BinningVertical") {
+    const auto previous = it->second;
+    const auto binning  = clampTo(value, 1, static_cast<int64_t>(m_config.maxBinning));
+    const auto sensor   = m_params.at(horizontal ? "SensorWidth" : "SensorHeight");
+    it->second          = binning;
+    // The region of interest keeps covering the same area of the sensor.
+    sizeMax = roundToIncrement(sensor / binning);
+    size    = clampTo(roundToIncrement(size * previous / binning), increment, sizeMax);
+    offset  = clampTo(roundToIncrement(offset * previous / binning), 0, sizeMax - size);
+  } else if(param == "Width" || param == "Height") {
+    size   = clampTo(roundToIncrement(value), increment, sizeMax);
+    offset = clampTo(offset, 0, sizeMax - size);
+  } else if(param == "OffsetX" || param == "OffsetY") {
+    offset = clampTo(roundToIncrement(value), 0, sizeMax - size);
+  } else if(param == "ExposureTime") {
+    it->second = clampTo(
+      value,
+      std::chrono::duration_cast<std::chrono::microseconds>(m_config.minExposure).count(),
+      std::chrono::duration_cast<std::chrono::microseconds>(m_config.maxExposure).count());
+  } else {
+    it->second = value;
+  }
+  return it->second;
+}
+
+irsol::types::duration_t
+SimulatedCamera::captureTimeNonThreadSafe() const
+{
+  return triggerTimingNonThreadSafe().captureTime();
+}
+
+SimulatedCamera::Frame
+SimulatedCamera::nextFrameNonThreadSafe(irsol::types::timepoint_t timestamp)
+{
+  return Frame{m_nextFrameId++,
+               timestamp,
+               static_cast<uint64_t>(m_params.at("Width")),
+               static_cast<uint64_t>(m_params.at("Height")),
+               static_cast<uint64_t>(m_params.at("OffsetX")),
+               static_cast<uint64_t>(m_params.at("OffsetY")),
+               static_cast<uint64_t>(m_params.at("BinningHorizontal")),
+               static_cast<uint64_t>(m_params.at("BinningVertical"))};
+}
+
+TriggerTiming
+SimulatedCamera::triggerTimingNonThreadSafe() const
+{
+  return {std::chrono::microseconds(m_params.at("ExposureTime")),
+          m_config.lineTime * m_params.at("Height"),
+          m_triggerOverlap};
+}
+
+void
+SimulatedCamera::runReadout()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while(true) {
+    m_readoutCondition.wait(lock, [this]() { return m_stopReadout || !m_readouts.empty(); });
+    if(m_stopReadout) {
+      return;
+    }
+    // Wait for the end of the readout of the oldest triggered frame.
+    const auto readoutEnd = m_readouts.front().first;
+    if(m_readoutCondition.wait_until(lock, readoutEnd, [this]() { return m_stopReadout; })) {
+      return;
+    }
+    auto frame = m_readouts.front().second;
+    m_readouts.pop_front();
+    // The callback is free to trigger the next frames.
+    lock.unlock();
+    m_frameCallback(frame);
+    lock.lock();
+  }
+}
+
+int64_t
+SimulatedCamera::roundToIncrement(int64_t value) const
+{
+  const auto increment = static_cast<int64_t>(m_config.roiIncrement);
+  return std::max<int64_t>(value, 0) / increment * increment;
+}
+
+}  // namespace camera
+}  // namespace irsol
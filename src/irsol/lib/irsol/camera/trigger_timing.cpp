@@ -0,0 +1,34 @@
+#include "irsol/camera/trigger_timing.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace irsol {
+namespace camera {
+
+irsol::types::duration_t
+TriggerTiming::triggerInterval() const
+{
+  return overlap ? std::max(exposure, readout) : exposure + readout;
+}
+
+irsol::types::duration_t
+TriggerTiming::captureTime() const
+{
+  return exposure + readout;
+}
+
+size_t
+TriggerTiming::maxPendingTriggers() const
+{
+  return overlap ? 2 : 1;
+}
+
+double
+TriggerTiming::maxFrameRate() const
+{
+  return 1.0 / std::chrono::duration<double>(triggerInterval()).count();
+}
+
+}  // namespace camera
+}  // namespace irsol
@@ -0,0 +1,268 @@
+#include "irsol/camera/user_buffers.hpp"
+
+#include "irsol/assert.hpp"
+#include "irsol/logging.hpp"
+#include "irsol/macros.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace irsol {
+namespace camera {
+
+bool
+affectsPayloadSize(const std::string& feature)
+{
+  static const char* const PAYLOAD_FEATURES[] = {"PixelFormat",
+                                                 "BinningHorizontal",
+                                                 "BinningVertical",
+                                                 "DecimationHorizontal",
+                                                 "DecimationVertical",
+                                                 "Width",
+                                                 "Height"};
+  return std::find(std::begin(PAYLOAD_FEATURES), std::end(PAYLOAD_FEATURES), feature) !=
+         std::end(PAYLOAD_FEATURES);
+}
+
+UserBuffer::UserBuffer(size_t index, size_t numBytes)
+  : m_index(index), m_memory(numBytes)  // Value-initialization pre-faults the memory.
+{
+  RegisterMemory(m_memory.data(), m_memory.size());
+}
+
+UserBuffer::~UserBuffer()
+{
+  UnregisterMemory();
+}
+
+size_t
+UserBuffer::index() const
+{
+  return m_index;
+}
+
+irsol::types::byte_t*
+UserBuffer::data()
+{
+  return m_memory.data();
+}
+
+const std::vector<irsol::types::byte_t>&
+UserBuffer::memory() const
+{
+  return m_memory;
+}
+
+NeoAPIUserBufferDriver::NeoAPIUserBufferDriver(NeoAPI::Cam& cam): m_cam(cam) {}
+
+void
+NeoAPIUserBufferDriver::enable(size_t numBuffers)
+{
+  m_cam.SetUserBufferMode(true);
+  m_cam.SetImageBufferCount(numBuffers);
+}
+
+void
+NeoAPIUserBufferDriver::disable()
+{
+  m_cam.SetUserBufferMode(false);
+}
+
+void
+NeoAPIUserBufferDriver::add(UserBuffer& buffer)
+{
+  m_cam.AddUserBuffer(&buffer);
+}
+
+void
+NeoAPIUserBufferDriver::revoke(UserBuffer& buffer)
+{
+  m_cam.RevokeUserBuffer(&buffer);
+}
+
+SimulatedUserBufferDriver::SimulatedUserBufferDriver(): m_state(std::make_shared<State>()) {}
+
+void
+SimulatedUserBufferDriver::enable(IRSOL_MAYBE_UNUSED size_t numBuffers)
+{
+  std::scoped_lock<std::mutex> lock(m_state->mutex);
+  m_state->enabled = true;
+}
+
+void
+SimulatedUserBufferDriver::disable()
+{
+  std::scoped_lock<std::mutex> lock(m_state->mutex);
+  m_state->enabled = false;
+}
+
+void
+SimulatedUserBufferDriver::add(UserBuffer& buffer)
+{
+  std::scoped_lock<std::mutex> lock(m_state->mutex);
+  IRSOL_ASSERT_ERROR(m_state->enabled, "User buffers can only be added in user buffer mode");
+  m_state->added.push_back(&buffer);
+  m_state->queue.push_back(&buffer);
+}
+
+void
+SimulatedUserBufferDriver::revoke(UserBuffer& buffer)
+{
+  std::scoped_lock<std::mutex> lock(m_state->mutex);
+  auto&                        added = m_state->added;
+  added.erase(std::remove(added.begin(), added.end(), &buffer), added.end());
+  auto& queue = m_state->queue;
+  queue.erase(std::remove(queue.begin(), queue.end(), &buffer), queue.end());
+}
+
+std::optional<SimulatedUserBufferDriver::Acquisition>
+SimulatedUserBufferDriver::acquire()
+{
+  std::scoped_lock<std::mutex> lock(m_state->mutex);
+  if(!m_state->enabled || m_state->queue.empty()) {
+    ++m_state->numStarved;
+    return std::nullopt;
+  }
+  auto* buffer = m_state->queue.front();
+  if(buffer->memory().size() < m_state->payloadSize) {
+    // The buffer stays queued, as the camera keeps it until the acquisition is reconfigured.
+    ++m_state->numUndersized;
+    return std::nullopt;
+  }
+  m_state->queue.pop_front();
+
+  // Queue the buffer again once released, unless it was revoked in the meantime.
+  std::weak_ptr<State> weakState = m_state;
+  auto                 lease     = std::shared_ptr<void>(nullptr, [weakState, buffer](void*) {
+    auto state = weakState.lock();
+    if(!state) {
+      return;
+    }
+    std::scoped_lock<std::mutex> lock(state->mutex);
+    if(std::find(state->added.begin(), state->added.end(), buffer) != state->added.end()) {
+      state->queue.push_back(buffer);
+      ++state->numRequeued;
+    }
+  });
+  return Acquisition{buffer, std::move(lease)};
+}
+
+void
+SimulatedUserBufferDriver::setPayloadSize(size_t numBytes)
+{
+  std::scoped_lock<std::mutex> lock(m_state->mutex);
+  m_state->payloadSize = numBytes;
+}
+
+bool
+SimulatedUserBufferDriver::enabled() const
+{
+  std::scoped_lock<std::mutex> lock(m_state->mutex);
+  return m_state->enabled;
+}
+
+size_t
+SimulatedUserBufferDriver::numQueued() const
+{
+  std::scoped_lock<std::mutex> lock(m_state->mutex);
+  return m_state->queue.size();
+}
+
+uint64_t
+SimulatedUserBufferDriver::numRequeued() const
+{
+  std::scoped_lock<std::mutex> lock(m_state->mutex);
+  return m_state->numRequeued;
+}
+
+uint64_t
+SimulatedUserBufferDriver::numStarved() const
+{
+  std::scoped_lock<std::mutex> lock(m_state->mutex);
+  return m_state->numStarved;
+}
+
+uint64_t
+SimulatedUserBufferDriver::numUndersized() const
+{
+  std::scoped_lock<std::mutex> lock(m_state->mutex);
+  return m_state->numUndersized;
+}
+
+UserBufferRing::UserBufferRing(UserBufferDriver& driver, size_t numBuffers, size_t bufferSize)
+  : m_driver(driver), m_bufferSize(bufferSize)
+{
+  IRSOL_ASSERT_ERROR(numBuffers > 0, "A user buffer ring requires at least one buffer");
+  IRSOL_ASSERT_ERROR(bufferSize > 0, "User buffers must not be empty");
+  IRSOL_LOG_INFO("Allocating {} user buffers of {} bytes", numBuffers, bufferSize);
+
+  m_buffers.reserve(numBuffers);
+  for(size_t i = 0; i < numBuffers; ++i) {
+    m_buffers.push_back(std::make_shared<UserBuffer>(i, bufferSize));
+  }
+
+  m_driver.enable(numBuffers);
+  for(auto& buffer : m_buffers) {
+    m_driver.add(*buffer);
+  }
+}
+
+UserBufferRing::~UserBufferRing()
+{
+  for(auto& buffer : m_buffers) {
+    m_driver.revoke(*buffer);
+  }
+  m_driver.disable();
+}
+
+UserBufferRing::storage_t
+UserBufferRing::wrap(UserBuffer* buffer, std::shared_ptr<void> lease) const
+{
+  if(buffer == nullptr || buffer->index() >= m_buffers.size() ||
+     m_buffers[buffer->index()].get() != buffer) {
+    return nullptr;
+  }
+
+  // The owner releases the lease first (handing the buffer back to the driver), and only then
+  // its reference on the buffer memory, which may be the last one if the ring was destroyed.
+  struct Owner
+  {
+    std::shared_ptr<UserBuffer> buffer;
+    std::shared_ptr<void>       lease;
+  };
+  auto owner = std::make_shared<Owner>(Owner{m_buffers[buffer->index()], std::move(lease)});
+  return storage_t(owner, &owner->buffer->memory());
+}
+
+size_t
+UserBufferRing::numBuffers() const
+{
+  return m_buffers.size();
+}
+
+size_t
+UserBufferRing::bufferSize() const
+{
+  return m_bufferSize;
+}
+
+bool
+UserBufferRing::refit(std::unique_ptr<UserBufferRing>& ring, size_t bufferSize)
+{
+  if(!ring || ring->bufferSize() == bufferSize) {
+    return false;
+  }
+  IRSOL_LOG_INFO(
+    "Frame size changed from {} to {} bytes, re-allocating the user buffers",
+    ring->bufferSize(),
+    bufferSize);
+  auto&        driver     = ring->m_driver;
+  const size_t numBuffers = ring->numBuffers();
+  // The buffers of the previous ring are revoked before the new ones are handed to the driver.
+  ring.reset();
+  ring = std::make_unique<UserBufferRing>(driver, numBuffers, bufferSize);
+  return true;
+}
+
+}  // namespace camera
+}  // namespace irsol
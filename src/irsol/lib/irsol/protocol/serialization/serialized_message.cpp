@@ -9,9 +9,20 @@ namespace internal {
 SerializedMessage::SerializedMessage(
   const std::string&                  header,
   std::vector<irsol::types::byte_t>&& payload)
-  : header(header), payload(std::move(payload))
+  : header(header)
+  , payload(
+      payload.empty() ? nullptr
+                      : std::make_shared<const std::vector<irsol::types::byte_t>>(std::move(payload)))
 {}
 
+SerializedMessage
+SerializedMessage::fromSharedPayload(const std::string& header, payload_t payload)
+{
+  SerializedMessage message(header, {});
+  message.payload = std::move(payload);
+  return message;
+}
+
 bool
 SerializedMessage::hasHeader() const
 {
@@ -27,8 +38,15 @@ SerializedMessage::hasPayload() const
 size_t
 SerializedMessage::payloadSize() const
 {
-  return payload.size();
+  return payload ? payload->size() : 0;
 }
+
+const irsol::types::byte_t*
+SerializedMessage::payloadData() const
+{
+  return payload ? payload->data() : nullptr;
+}
+
 std::string
 SerializedMessage::toString() const
 {
@@ -36,7 +54,7 @@ SerializedMessage::toString() const
   oss << "SerializedMessage{"
       << "header: '" << header << "'";
   if(hasPayload()) {
-    oss << ", payload size: " << payload.size() << "bytes";
+    oss << ", payload size: " << payloadSize() << "bytes";
   } else {
     oss << ", no payload";
   }
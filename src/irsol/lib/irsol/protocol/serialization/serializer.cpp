@@ -1,10 +1,13 @@
 #include "irsol/protocol/serialization/serializer.hpp"
 
+#include "irsol/buffer_pool.hpp"
 #include "irsol/camera/pixel_format.hpp"
 #include "irsol/logging.hpp"
 #include "irsol/protocol/utils.hpp"
 #include "irsol/utils.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <variant>
 
 namespace irsol {
@@ -72,15 +75,10 @@ Serializer::serializeImageBinaryData(ImageBinaryData&& msg)
 {
   IRSOL_LOG_TRACE("Serializing image binary data: {}", msg.toString());
 
-  std::vector<irsol::types::byte_t> payload;
-  payload.reserve(msg.data.size() + 128);  // Reserve extra for header/meta
-
-  {
-    std::string imagePrefix        = "img=";
-    auto        imagePrefixAsBytes = irsol::utils::stringToBytes(imagePrefix);
-    std::move(imagePrefixAsBytes.begin(), imagePrefixAsBytes.end(), std::back_inserter(payload));
-  }
-  payload.emplace_back(Serializer::SpecialBytes::SOH);
+  // Serialize the header (prefix, shape and attributes) first, so that the whole payload can be
+  // written into a single buffer of the right size, taken from the pool.
+  std::vector<irsol::types::byte_t> header = irsol::utils::stringToBytes("img=");
+  header.emplace_back(Serializer::SpecialBytes::SOH);
   {
     std::stringstream ss;
     ss << "u" << msg.BYTES_PER_ELEMENT * 8 << "[" << msg.shape[0] << "," << msg.shape[1] << "]";
@@ -92,24 +90,25 @@ Serializer::serializeImageBinaryData(ImageBinaryData&& msg)
       "Attributes for message '{}' serialized to {}", msg.toString(), attributesString);
     auto attributesStringAsBytes = irsol::utils::stringToBytes(attributesString);
 
-    payload.insert(payload.end(), attributesStringAsBytes.begin(), attributesStringAsBytes.end());
+    header.insert(header.end(), attributesStringAsBytes.begin(), attributesStringAsBytes.end());
   }
-  payload.emplace_back(Serializer::SpecialBytes::STX);
+  header.emplace_back(Serializer::SpecialBytes::STX);
+
+  auto payload = irsol::utils::BufferPool::global().acquire(header.size() + msg.data->size() + 1);
+  std::copy(header.begin(), header.end(), payload->begin());
 
-  // Copy image data to the end of the payload buffer
-  size_t dataOffset = payload.size();
-  payload.resize(payload.size() + msg.data.size());
-  std::memcpy(&payload[dataOffset], msg.data.data(), msg.data.size());
+  // Copy image data after the header
+  size_t dataOffset = header.size();
+  std::memcpy(payload->data() + dataOffset, msg.data->data(), msg.data->size());
 
   // Swap bytes in-place for 16-bit data (assume always 16-bit)
   // This swaps each pair of bytes in the image data region of the payload.
   irsol::camera::PixelByteSwapper<true>()(
-    payload.begin() + static_cast<std::ptrdiff_t>(dataOffset), payload.end());
+    payload->begin() + static_cast<std::ptrdiff_t>(dataOffset), payload->end() - 1);
 
-  payload.emplace_back(Serializer::SpecialBytes::ETX);
+  payload->back() = Serializer::SpecialBytes::ETX;
 
-  auto message = internal::SerializedMessage("", std::move(payload));
-  return std::move(message);
+  return internal::SerializedMessage::fromSharedPayload("", std::move(payload));
 }
 
 internal::SerializedMessage
@@ -10,15 +10,36 @@
 namespace irsol {
 namespace server {
 
-App::App(irsol::types::port_t port)
+App::App(irsol::types::port_t port, frame_collector::CollectionMode collectionMode)
+  : App(port, [collectionMode]() {
+    std::vector<std::unique_ptr<Device>> devices;
+    devices.push_back(Device::connect("default", {}, collectionMode));
+    return devices;
+  }())
+{}
+
+App::App(irsol::types::port_t port, std::vector<std::unique_ptr<Device>> devices)
   : m_port(port)
   , m_acceptor(
       m_port,
       std::bind(&App::addClient, this, std::placeholders::_1, std::placeholders::_2))
-  , m_cameraInterface(std::make_unique<camera::Interface>(camera::Interface::HalfResolution()))
-  , m_frameCollector(std::make_unique<frame_collector::FrameCollector>(*m_cameraInterface.get()))
+  , m_devices(std::move(devices))
   , m_messageHandler(std::make_unique<handlers::MessageHandler>())
 {
+  IRSOL_ASSERT_FATAL(!m_devices.empty(), "The application requires at least one device");
+  for(size_t i = 0; i < m_devices.size(); ++i) {
+    for(size_t j = 0; j < i; ++j) {
+      IRSOL_ASSERT_FATAL(
+        m_devices[i]->name() != m_devices[j]->name(),
+        "Duplicated device name '%s'",
+        m_devices[i]->name().c_str());
+    }
+    IRSOL_LOG_INFO(
+      "Serving device '{}' (SN '{}'){}",
+      m_devices[i]->name(),
+      m_devices[i]->serialNumber(),
+      i == 0 ? " as default device" : "");
+  }
   registerMessageHandlers();
 }
 
@@ -45,10 +66,34 @@ App::stop()
     IRSOL_LOG_DEBUG("Joining accept thread");
     m_acceptThread.join();
   }
-  m_frameCollector->stop();
+  for(auto& device : m_devices) {
+    device->frameCollector().stop();
+  }
   IRSOL_LOG_INFO("Server stopped");
 }
 
+Device&
+App::device(const ClientSession& session)
+{
+  const auto& deviceName = session.userData().deviceName;
+  if(deviceName.empty()) {
+    return device();
+  }
+  auto* selected = findDevice(deviceName);
+  return selected ? *selected : device();
+}
+
+Device*
+App::findDevice(const std::string& nameOrSerial)
+{
+  for(auto& device : m_devices) {
+    if(device->matches(nameOrSerial)) {
+      return device.get();
+    }
+  }
+  return nullptr;
+}
+
 std::shared_ptr<ClientSession>
 App::getClientSession(const irsol::types::client_id_t& clientId)
 {
@@ -121,7 +166,9 @@ App::removeClient(const irsol::types::client_id_t& clientId)
     IRSOL_LOG_ERROR("Client '{}' not found in session list", clientId);
   } else {
     auto client = clientIt->second;
-    m_frameCollector->deregisterClient(client->id());
+    for(auto& device : m_devices) {
+      device->frameCollector().deregisterClient(client->id());
+    }
     m_clients.erase(clientIt);
     IRSOL_LOG_DEBUG(
       "Client {} removed from session list, remaining clients: {}", clientId, m_clients.size());
@@ -135,6 +182,8 @@ App::registerMessageHandlers()
   auto ctx = std::make_shared<irsol::server::handlers::Context>(*this);
 
   // Register message handlers for specific message types
+  registerMessageHandler<protocol::Inquiry, handlers::InquiryCameraHandler>("cam", ctx);
+  registerMessageHandler<protocol::Assignment, handlers::AssignmentCameraHandler>("cam", ctx);
   registerMessageHandler<protocol::Inquiry, handlers::InquiryFrameRateHandler>("fr", ctx);
   registerMessageHandler<protocol::Assignment, handlers::AssignmentFrameRateHandler>("fr", ctx);
   registerMessageHandler<protocol::Assignment, handlers::AssignmentInputSequenceLengthHandler>(
@@ -144,9 +193,20 @@ App::registerMessageHandlers()
   registerMessageHandler<protocol::Inquiry, handlers::InquiryIntegrationTimeHandler>("it", ctx);
   registerMessageHandler<protocol::Inquiry, handlers::InquiryInputSequenceLengthHandler>(
     "isl", ctx);
+  registerMessageHandler<protocol::Assignment, handlers::AssignmentFrameQueueCapacityHandler>(
+    "fq_cap", ctx);
+  registerMessageHandler<protocol::Inquiry, handlers::InquiryFrameQueueCapacityHandler>(
+    "fq_cap", ctx);
+  registerMessageHandler<protocol::Assignment, handlers::AssignmentFrameQueuePolicyHandler>(
+    "fq_policy", ctx);
+  registerMessageHandler<protocol::Inquiry, handlers::InquiryFrameQueuePolicyHandler>(
+    "fq_policy", ctx);
+  registerMessageHandler<protocol::Inquiry, handlers::InquiryFrameQueueDroppedHandler>(
+    "fq_dropped", ctx);
   registerMessageHandler<protocol::Command, handlers::CommandAbortHandler>("abort", ctx);
   registerMessageHandler<protocol::Command, handlers::CommandGIHandler>("gi", ctx);
   registerMessageHandler<protocol::Command, handlers::CommandGISHandler>("gis", ctx);
+  registerMessageHandler<protocol::Command, handlers::CommandBurstHandler>("burst", ctx);
   registerMessageHandler<protocol::Inquiry, handlers::InquiryImgLeftHandler>("img_l", ctx);
   registerMessageHandler<protocol::Inquiry, handlers::InquiryImgTopHandler>("img_t", ctx);
   registerMessageHandler<protocol::Inquiry, handlers::InquiryImgWidthHandler>("img_w", ctx);
@@ -155,6 +215,12 @@ App::registerMessageHandlers()
   registerMessageHandler<protocol::Assignment, handlers::AssignmentImgTopHandler>("img_t", ctx);
   registerMessageHandler<protocol::Assignment, handlers::AssignmentImgWidthHandler>("img_w", ctx);
   registerMessageHandler<protocol::Assignment, handlers::AssignmentImgHeightHandler>("img_h", ctx);
+  registerMessageHandler<protocol::Assignment, handlers::AssignmentFrameHistoryAgeHandler>(
+    "gh_age", ctx);
+  registerMessageHandler<protocol::Assignment, handlers::AssignmentFrameHistorySinceHandler>(
+    "gh_since", ctx);
+  registerMessageHandler<protocol::Assignment, handlers::AssignmentFrameHistoryAtHandler>(
+    "gh_at", ctx);
 
   registerLambdaHandler<protocol::Command>(
     "image_data",
@@ -164,25 +230,28 @@ App::registerMessageHandlers()
       std::shared_ptr<irsol::server::ClientSession> client,
       protocol::Command&&                           cmd) -> std::vector<protocol::OutMessage> {
       std::vector<protocol::OutMessage> result;
-      auto&                             cam = ctx->app.camera();
-      auto                              img = cam.captureImage(std::chrono::milliseconds(10000));
 
-      if(img.IsEmpty()) {
+      // The image is acquired by the frame collector, as a single-frame client: it joins the
+      // capture in flight, if any, instead of competing with it for the camera. The client ID
+      // differs from the session's one, so that a stream running for the session is not replaced.
+      auto&      collector = ctx->app.device(*client).frameCollector();
+      auto       queue     = frame_collector::FrameCollector::makeQueuePtr(1);
+      const auto clientId  = client->id() + "/image_data";
+      collector.registerClient(clientId, -1.0, queue, 1);
+
+      std::shared_ptr<const frame_collector::Frame> frame;
+      if(queue->popFor(frame, App::IMAGE_DATA_TIMEOUT) == irsol::utils::PopResult::TIMEOUT) {
+        collector.deregisterClient(clientId);
+      }
+      if(!frame) {
         IRSOL_NAMED_LOG_ERROR(client->id(), "Failed to capture image.");
         result.emplace_back(irsol::protocol::Error::from(cmd, "Failed to capture image"));
         return result;
       }
 
-      uint32_t width    = static_cast<uint32_t>(img.GetWidth());
-      uint32_t height   = static_cast<uint32_t>(img.GetHeight());
-      size_t   dataSize = img.GetSize();
-
-      const void*                       imageBuffer = img.GetImageData();
-      std::vector<irsol::types::byte_t> rawData(dataSize);
-      memcpy(rawData.data(), imageBuffer, dataSize);
-
-      result.emplace_back(
-        irsol::protocol::ImageBinaryData(std::move(rawData), {height, width}, {}));
+      auto serializedImage = frame->serialized();
+      auto lock            = std::scoped_lock(client->socketMutex());
+      client->handleSerializedMessage(*serializedImage);
       return result;
     });
 }
@@ -92,7 +92,7 @@ ClientSession::handleSerializedMessage(
     send(serializedMessage.header);
   }
   if(serializedMessage.hasPayload()) {
-    send(serializedMessage.payload.data(), serializedMessage.payloadSize());
+    send(serializedMessage.payloadData(), serializedMessage.payloadSize());
   }
 }
 
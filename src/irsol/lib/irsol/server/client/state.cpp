@@ -16,6 +16,9 @@ FrameListeningState::stop()
   std::scoped_lock<std::mutex> lock(m_threadMutex);
   if(m_stopRequested) {
     m_stopRequested->store(true);
+    if(m_interrupt) {
+      m_interrupt();
+    }
   }
 }
 
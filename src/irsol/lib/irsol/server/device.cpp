@@ -0,0 +1,156 @@
+#include "irsol/server/device.hpp"
+
+#include "irsol/assert.hpp"
+#include "irsol/camera/interface.hpp"
+#include "irsol/logging.hpp"
+#include "irsol/utils.hpp"
+
+namespace irsol {
+namespace server {
+
+std::unique_ptr<Device>
+Device::connect(
+  const std::string&              name,
+  const std::string&              serialNumber,
+  frame_collector::CollectionMode mode)
+{
+  auto cam    = serialNumber.empty() ? irsol::utils::loadDefaultCamera()
+                                     : irsol::utils::loadCamera(serialNumber);
+  auto camera = std::make_unique<camera::Interface>(camera::Interface::HalfResolution(cam));
+  IRSOL_LOG_INFO("Connected camera '{}' with SN '{}'", name, camera->serialNumber());
+
+  // No frame is acquired before the first client connects: the camera can still be switched to
+  // acquiring directly into our own buffers, so that frames reach the clients without copies.
+  // The frames kept in the history of the collector hold their buffer: the camera needs as many
+  // additional buffers to keep acquiring. The buffers are re-allocated by the interface when a
+  // client changes the frame size, which the collector only applies between captures.
+  try {
+    camera->enableUserBuffers(
+      camera::Interface::DEFAULT_USER_BUFFER_COUNT +
+      frame_collector::FrameCollector::DEFAULT_HISTORY_CAPACITY);
+  } catch(const std::exception& e) {
+    IRSOL_LOG_WARN(
+      "User buffers not available for camera '{}', image data will be copied: {}", name, e.what());
+  }
+
+  // With overlapped triggering, the next exposure starts while the previous frame is read out,
+  // and the collector triggers on the cadence of the camera's timing model.
+  try {
+    if(!camera->setTriggerOverlap(true)) {
+      IRSOL_LOG_WARN("Camera '{}' refused overlapped triggering", name);
+    }
+  } catch(const std::exception& e) {
+    IRSOL_LOG_WARN(
+      "Overlapped triggering not available for camera '{}', frames are acquired one at a time: {}",
+      name,
+      e.what());
+  }
+
+  auto collector = std::make_unique<frame_collector::FrameCollector>(*camera, mode);
+  auto serial    = camera->serialNumber();
+  return std::unique_ptr<Device>(
+    new Device(name, std::move(serial), std::move(camera), std::move(collector)));
+}
+
+std::unique_ptr<Device>
+Device::simulated(
+  const std::string&                            name,
+  std::unique_ptr<frame_collector::FrameSource> source,
+  frame_collector::CollectionMode               mode)
+{
+  auto collector = std::make_unique<frame_collector::FrameCollector>(std::move(source), mode);
+  return std::unique_ptr<Device>(new Device(name, name, nullptr, std::move(collector)));
+}
+
+std::unique_ptr<Device>
+Device::simulated(
+  const std::string&                       name,
+  std::unique_ptr<camera::SimulatedCamera> camera,
+  frame_collector::CollectionMode          mode)
+{
+  auto source    = std::make_unique<frame_collector::SimulatedCameraFrameSource>(*camera);
+  auto collector = std::make_unique<frame_collector::FrameCollector>(std::move(source), mode);
+  auto serial    = camera->serialNumber();
+  return std::unique_ptr<Device>(
+    new Device(name, std::move(serial), std::move(camera), std::move(collector)));
+}
+
+std::unique_ptr<Device>
+Device::replay(
+  const std::string&                    name,
+  std::unique_ptr<camera::ReplayCamera> camera,
+  frame_collector::CollectionMode       mode)
+{
+  auto source    = std::make_unique<frame_collector::ReplayFrameSource>(*camera);
+  auto collector = std::make_unique<frame_collector::FrameCollector>(std::move(source), mode);
+  auto serial    = camera->serialNumber();
+  return std::unique_ptr<Device>(
+    new Device(name, std::move(serial), std::move(camera), std::move(collector)));
+}
+
+Device::Device(
+  std::string                                      name,
+  std::string                                      serialNumber,
+  std::unique_ptr<camera::Backend>                 camera,
+  std::unique_ptr<frame_collector::FrameCollector> frameCollector)
+  : m_name(std::move(name))
+  , m_serialNumber(std::move(serialNumber))
+  , m_camera(std::move(camera))
+  , m_frameCollector(std::move(frameCollector))
+{}
+
+const std::string&
+Device::name() const
+{
+  return m_name;
+}
+
+const std::string&
+Device::serialNumber() const
+{
+  return m_serialNumber;
+}
+
+bool
+Device::matches(const std::string& nameOrSerial) const
+{
+  return nameOrSerial == m_name || nameOrSerial == m_serialNumber;
+}
+
+bool
+Device::hasCamera() const
+{
+  return m_camera != nullptr;
+}
+
+camera::Backend&
+Device::camera()
+{
+  IRSOL_ASSERT_ERROR(m_camera != nullptr, "Device '%s' has no camera", m_name.c_str());
+  return *m_camera;
+}
+
+frame_collector::FrameCollector&
+Device::frameCollector()
+{
+  return *m_frameCollector;
+}
+
+bool
+Device::pinToCpu(size_t cpu)
+{
+  if(!m_frameCollector->pinToCpu(cpu)) {
+    return false;
+  }
+  m_cpu = cpu;
+  return true;
+}
+
+std::optional<size_t>
+Device::cpu() const
+{
+  return m_cpu;
+}
+
+}  // namespace server
+}  // namespace irsol
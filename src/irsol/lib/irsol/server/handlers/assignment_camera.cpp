@@ -0,0 +1,56 @@
+#include "irsol/server/handlers/assignment_camera.hpp"
+
+#include "irsol/server/app.hpp"
+#include "irsol/server/client/session.hpp"
+#include "irsol/utils.hpp"
+
+#include <string>
+
+namespace irsol {
+namespace server {
+namespace handlers {
+AssignmentCameraHandler::AssignmentCameraHandler(std::shared_ptr<Context> ctx)
+  : AssignmentHandler(ctx)
+{}
+
+std::vector<out_message_t>
+AssignmentCameraHandler::process(
+  std::shared_ptr<irsol::server::ClientSession> session,
+  protocol::Assignment&&                        message)
+{
+  std::vector<out_message_t> result;
+  if(session->userData().frameListeningState.running()) {
+    // The running acquisition is bound to the frame collector of the current device.
+    IRSOL_NAMED_LOG_WARN(
+      session->id(), "Session is already listening to frames. Cannot select a device.");
+    result.emplace_back(irsol::protocol::Error::from(
+      message, "Session is already listening to frames. Cannot select a device."));
+    return result;
+  }
+
+  if(message.hasDouble()) {
+    IRSOL_NAMED_LOG_WARN(session->id(), "Invalid device '{}'", message.toString());
+    result.emplace_back(
+      irsol::protocol::Error::from(message, "The device must be a name or a serial number"));
+    return result;
+  }
+  // Serial numbers made of digits only are parsed as integers.
+  const auto nameOrSerial = message.hasInt() ? std::to_string(irsol::utils::toInt(message.value))
+                                             : irsol::utils::toString(message.value);
+  auto*      device       = ctx->app.findDevice(nameOrSerial);
+  if(!device) {
+    IRSOL_NAMED_LOG_WARN(session->id(), "Unknown device '{}'", nameOrSerial);
+    result.emplace_back(irsol::protocol::Error::from(message, "Unknown device"));
+    return result;
+  }
+  IRSOL_NAMED_LOG_INFO(
+    session->id(), "Selecting device '{}' (SN '{}')", device->name(), device->serialNumber());
+
+  session->userData().deviceName = device->name();
+  result.emplace_back(
+    irsol::protocol::Success::from(message, irsol::types::protocol_value_t{device->name()}));
+  return result;
+}
+}  // namespace handlers
+}  // namespace server
+}  // namespace irsol
@@ -0,0 +1,178 @@
+#include "irsol/server/handlers/assignment_frame_history.hpp"
+
+#include "irsol/logging.hpp"
+#include "irsol/protocol.hpp"
+#include "irsol/server/app.hpp"
+#include "irsol/server/client/session.hpp"
+#include "irsol/utils.hpp"
+
+#include <mutex>
+#include <optional>
+#include <variant>
+
+namespace irsol {
+namespace server {
+namespace handlers {
+
+namespace {
+/// Returns the numeric value of a protocol value, `std::nullopt` if it's not a number.
+std::optional<double>
+toNumber(const irsol::types::protocol_value_t& value)
+{
+  if(std::holds_alternative<int>(value)) {
+    return static_cast<double>(irsol::utils::toInt(value));
+  }
+  if(std::holds_alternative<double>(value)) {
+    return irsol::utils::toDouble(value);
+  }
+  return std::nullopt;
+}
+
+/// Converts a number of seconds since the Unix epoch to a time point of the host clock.
+irsol::types::timepoint_t
+fromUnixSeconds(double seconds)
+{
+  using system_clock_t = std::chrono::system_clock;
+  const auto systemTp  = system_clock_t::time_point(
+    std::chrono::duration_cast<system_clock_t::duration>(std::chrono::duration<double>(seconds)));
+  return irsol::types::clock_t::now() +
+         std::chrono::duration_cast<irsol::types::duration_t>(systemTp - system_clock_t::now());
+}
+}  // namespace
+
+namespace internal {
+
+AssignmentFrameHistoryHandlerBase::AssignmentFrameHistoryHandlerBase(
+  std::shared_ptr<Context> ctx)
+  : AssignmentHandler(ctx)
+{}
+
+std::vector<out_message_t>
+AssignmentFrameHistoryHandlerBase::process(
+  std::shared_ptr<irsol::server::ClientSession> session,
+  protocol::Assignment&&                        message)
+{
+  std::vector<out_message_t> result;
+  if(session->userData().frameListeningState.running()) {
+    // The frames of the history would be interleaved with the ones of the running acquisition.
+    IRSOL_NAMED_LOG_WARN(
+      session->id(), "Session is already listening to frames. Cannot retrieve past frames.");
+    result.emplace_back(
+      irsol::protocol::Error::from(message, "Session is already listening to frames"));
+    return result;
+  }
+  if(auto error = validate(message); !error.empty()) {
+    IRSOL_NAMED_LOG_WARN(session->id(), "Invalid request '{}': {}", message.toString(), error);
+    result.emplace_back(irsol::protocol::Error::from(message, error));
+    return result;
+  }
+
+  const auto frames = retrieve(ctx->app.device(*session).frameCollector().history(), message);
+  if(frames.empty() && !acceptsEmptyResult()) {
+    IRSOL_NAMED_LOG_INFO(session->id(), "No frame in the history for '{}'", message.toString());
+    result.emplace_back(
+      irsol::protocol::Error::from(message, "No frame in the history matches the request"));
+    return result;
+  }
+
+  IRSOL_NAMED_LOG_INFO(
+    session->id(),
+    "Sending {} frames from the history for '{}'",
+    frames.size(),
+    message.toString());
+  for(const auto& frame : frames) {
+    // The frames of the history were already serialized if they were sent to any client.
+    auto serializedImage = frame->serialized();
+    auto lock            = std::scoped_lock(session->socketMutex());
+    session->handleSerializedMessage(*serializedImage);
+  }
+  result.emplace_back(irsol::protocol::Success::from(message));
+  return result;
+}
+
+bool
+AssignmentFrameHistoryHandlerBase::acceptsEmptyResult() const
+{
+  return false;
+}
+}  // namespace internal
+
+std::string
+AssignmentFrameHistoryAgeHandler::validate(const protocol::Assignment& message) const
+{
+  const auto maxAge = toNumber(message.value);
+  if(!maxAge || *maxAge < 0.0) {
+    return "The maximum age must be a non-negative number of milliseconds";
+  }
+  return {};
+}
+
+std::vector<AssignmentFrameHistoryAgeHandler::frame_ptr_t>
+AssignmentFrameHistoryAgeHandler::retrieve(
+  const irsol::server::frame_collector::FrameHistory& history,
+  const protocol::Assignment&                         message) const
+{
+  const auto maxAge = std::chrono::duration_cast<irsol::types::duration_t>(
+    std::chrono::duration<double, std::milli>(*toNumber(message.value)));
+  if(auto frame = history.latest(maxAge)) {
+    return {frame};
+  }
+  return {};
+}
+
+std::string
+AssignmentFrameHistorySinceHandler::validate(const protocol::Assignment& message) const
+{
+  if(!std::holds_alternative<int>(message.value) || irsol::utils::toInt(message.value) < 0) {
+    return "The frame ID must be a non-negative integer";
+  }
+  return {};
+}
+
+std::vector<AssignmentFrameHistorySinceHandler::frame_ptr_t>
+AssignmentFrameHistorySinceHandler::retrieve(
+  const irsol::server::frame_collector::FrameHistory& history,
+  const protocol::Assignment&                         message) const
+{
+  return history.since(static_cast<uint64_t>(irsol::utils::toInt(message.value)));
+}
+
+bool
+AssignmentFrameHistorySinceHandler::acceptsEmptyResult() const
+{
+  return true;
+}
+
+std::string
+AssignmentFrameHistoryAtHandler::validate(const protocol::Assignment& message) const
+{
+  if(std::holds_alternative<std::string>(message.value)) {
+    if(!irsol::utils::timestampFromString(irsol::utils::toString(message.value))) {
+      return "The time must be formatted as 'YYYY-MM-DD HH:MM:SS.ffffff'";
+    }
+    return {};
+  }
+  if(!toNumber(message.value)) {
+    return "The time must be a timestamp or a number of seconds since the Unix epoch";
+  }
+  return {};
+}
+
+std::vector<AssignmentFrameHistoryAtHandler::frame_ptr_t>
+AssignmentFrameHistoryAtHandler::retrieve(
+  const irsol::server::frame_collector::FrameHistory& history,
+  const protocol::Assignment&                         message) const
+{
+  const auto timestamp =
+    std::holds_alternative<std::string>(message.value)
+      ? *irsol::utils::timestampFromString(irsol::utils::toString(message.value))
+      : fromUnixSeconds(*toNumber(message.value));
+  if(auto frame = history.nearest(timestamp)) {
+    return {frame};
+  }
+  return {};
+}
+
+}  // namespace handlers
+}  // namespace server
+}  // namespace irsol
@@ -0,0 +1,117 @@
+#include "irsol/server/handlers/assignment_frame_queue.hpp"
+
+#include "irsol/queue.hpp"
+#include "irsol/server/client/session.hpp"
+#include "irsol/utils.hpp"
+
+#include <variant>
+
+namespace irsol {
+namespace server {
+namespace handlers {
+AssignmentFrameQueueCapacityHandler::AssignmentFrameQueueCapacityHandler(
+  std::shared_ptr<Context> ctx)
+  : AssignmentHandler(ctx)
+{}
+
+std::vector<out_message_t>
+AssignmentFrameQueueCapacityHandler::process(
+  std::shared_ptr<irsol::server::ClientSession> session,
+  protocol::Assignment&&                        message)
+{
+  auto& frameListeningState = session->userData().frameListeningState;
+  if(frameListeningState.running()) {
+    IRSOL_NAMED_LOG_WARN(
+      session->id(), "Session is already listening to frames. Cannot set a frameQueueCapacity.");
+    std::vector<out_message_t> result;
+    result.emplace_back(irsol::protocol::Error::from(
+      message, "Session is already listening to frames. Cannot set a frameQueueCapacity."));
+    return result;
+  }
+  if(!std::holds_alternative<int>(message.value) || irsol::utils::toInt(message.value) < 0) {
+    IRSOL_NAMED_LOG_WARN(
+      session->id(), "frameQueueCapacity ({}) must be a non-negative integer.", message.toString());
+    std::vector<out_message_t> result;
+    result.emplace_back(
+      irsol::protocol::Error::from(message, "FrameQueueCapacity must be a non-negative integer."));
+    return result;
+  }
+  const int frameQueueCapacity = irsol::utils::toInt(message.value);
+  if(
+    frameQueueCapacity == 0 &&
+    irsol::utils::overflowPolicyRequiresBound(frameListeningState.gisParams.frameQueuePolicy)) {
+    IRSOL_NAMED_LOG_WARN(
+      session->id(),
+      "An unbounded frameQueueCapacity is incompatible with the '{}' frameQueuePolicy.",
+      irsol::utils::overflowPolicyToString(frameListeningState.gisParams.frameQueuePolicy));
+    std::vector<out_message_t> result;
+    result.emplace_back(irsol::protocol::Error::from(
+      message,
+      "FrameQueueCapacity 0 (unbounded) is incompatible with the drop_oldest and drop_newest "
+      "frameQueuePolicy."));
+    return result;
+  }
+  IRSOL_NAMED_LOG_INFO(session->id(), "Setting 'frameQueueCapacity' to {}", frameQueueCapacity);
+
+  frameListeningState.gisParams.frameQueueCapacity = static_cast<size_t>(frameQueueCapacity);
+  std::vector<out_message_t> result;
+  result.emplace_back(irsol::protocol::Success::from(message));
+  return result;
+}
+
+AssignmentFrameQueuePolicyHandler::AssignmentFrameQueuePolicyHandler(std::shared_ptr<Context> ctx)
+  : AssignmentHandler(ctx)
+{}
+
+std::vector<out_message_t>
+AssignmentFrameQueuePolicyHandler::process(
+  std::shared_ptr<irsol::server::ClientSession> session,
+  protocol::Assignment&&                        message)
+{
+  auto& frameListeningState = session->userData().frameListeningState;
+  if(frameListeningState.running()) {
+    IRSOL_NAMED_LOG_WARN(
+      session->id(), "Session is already listening to frames. Cannot set a frameQueuePolicy.");
+    std::vector<out_message_t> result;
+    result.emplace_back(irsol::protocol::Error::from(
+      message, "Session is already listening to frames. Cannot set a frameQueuePolicy."));
+    return result;
+  }
+  const auto policy = std::holds_alternative<std::string>(message.value)
+                        ? irsol::utils::overflowPolicyFromString(
+                            irsol::utils::toString(message.value))
+                        : std::nullopt;
+  if(!policy) {
+    IRSOL_NAMED_LOG_WARN(session->id(), "Unknown frameQueuePolicy in {}", message.toString());
+    std::vector<out_message_t> result;
+    result.emplace_back(irsol::protocol::Error::from(
+      message, "FrameQueuePolicy must be one of block, drop_oldest, drop_newest, latest_only."));
+    return result;
+  }
+  if(
+    irsol::utils::overflowPolicyRequiresBound(*policy) &&
+    frameListeningState.gisParams.frameQueueCapacity == 0) {
+    IRSOL_NAMED_LOG_WARN(
+      session->id(),
+      "The '{}' frameQueuePolicy is incompatible with an unbounded frameQueueCapacity.",
+      irsol::utils::overflowPolicyToString(*policy));
+    std::vector<out_message_t> result;
+    result.emplace_back(irsol::protocol::Error::from(
+      message,
+      "FrameQueuePolicy drop_oldest and drop_newest need a bounded queue: set a positive "
+      "frameQueueCapacity first."));
+    return result;
+  }
+  IRSOL_NAMED_LOG_INFO(
+    session->id(),
+    "Setting 'frameQueuePolicy' to {}",
+    irsol::utils::overflowPolicyToString(*policy));
+
+  frameListeningState.gisParams.frameQueuePolicy = *policy;
+  std::vector<out_message_t> result;
+  result.emplace_back(irsol::protocol::Success::from(message));
+  return result;
+}
+}  // namespace handlers
+}  // namespace server
+}  // namespace irsol
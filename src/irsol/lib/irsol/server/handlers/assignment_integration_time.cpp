@@ -37,8 +37,18 @@ AssignmentIntegrationTimeHandler::process(
     session->id(),
     "Setting camera integration time to {}",
     irsol::utils::durationToString(integrationTime));
-  auto& cam               = session->app().camera();
-  auto  resultingExposure = cam.setExposure(integrationTime);
+  auto& device = session->app().device(*session);
+  if(!device.hasCamera()) {
+    IRSOL_NAMED_LOG_WARN(session->id(), "Device '{}' has no camera parameters", device.name());
+    std::vector<out_message_t> result;
+    result.emplace_back(
+      irsol::protocol::Error::from(message, "The selected device has no camera parameters"));
+    return result;
+  }
+  // The exposure is changed by the acquisition thread, between two captures.
+  auto& cam         = device.camera();
+  auto  setExposure = [&cam, integrationTime]() { return cam.setExposure(integrationTime); };
+  auto  resultingExposure = device.frameCollector().control("ExposureTime", setExposure).get();
 
   int resultingExposureMs = static_cast<int>(
     1.0 * std::chrono::duration_cast<std::chrono::microseconds>(resultingExposure).count() / 1000);
@@ -0,0 +1,93 @@
+#include "irsol/server/handlers/command_burst.hpp"
+
+#include "irsol/macros.hpp"
+#include "irsol/protocol.hpp"
+#include "irsol/server/client/session.hpp"
+
+#include <string>
+
+namespace irsol {
+namespace server {
+namespace handlers {
+
+CommandBurstHandler::CommandBurstHandler(std::shared_ptr<Context> ctx)
+  : internal::CommandGIBaseHandler(ctx)
+{}
+
+std::vector<irsol::protocol::OutMessage>
+CommandBurstHandler::validate(
+  const protocol::Command&                      message,
+  std::shared_ptr<irsol::server::ClientSession> session) const
+{
+  const auto&                state = session->userData().frameListeningState;
+  std::vector<out_message_t> result;
+  if(state.gisParams.inputSequenceLength == 0) {
+    IRSOL_NAMED_LOG_WARN(
+      session->id(), "Burst inputSequenceLength param is 0, this is not allowed.");
+    result.emplace_back(irsol::protocol::Error::from(
+      message, "Burst inputSequenceLength param is 0, this is not allowed"));
+    return result;
+  }
+  if(state.gisParams.inputSequenceLength > MAX_BURST_LENGTH) {
+    IRSOL_NAMED_LOG_WARN(
+      session->id(),
+      "Burst inputSequenceLength param {} exceeds the maximum of {} frames.",
+      state.gisParams.inputSequenceLength,
+      MAX_BURST_LENGTH);
+    result.emplace_back(irsol::protocol::Error::from(
+      message,
+      "Burst inputSequenceLength param exceeds the maximum of " +
+        std::to_string(MAX_BURST_LENGTH) + " frames"));
+    return result;
+  }
+  return result;
+}
+
+uint64_t
+CommandBurstHandler::getInputSequenceLength(
+  IRSOL_MAYBE_UNUSED const protocol::Command&   message,
+  std::shared_ptr<irsol::server::ClientSession> session) const
+{
+  const auto& state = session->userData().frameListeningState;
+  return state.gisParams.inputSequenceLength;
+}
+
+double
+CommandBurstHandler::getFrameRate(
+  IRSOL_MAYBE_UNUSED const protocol::Command& message,
+  IRSOL_MAYBE_UNUSED std::shared_ptr<irsol::server::ClientSession> session) const
+{
+  // The rate of a burst is the one of the camera.
+  return 0.0;
+}
+
+std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t>
+CommandBurstHandler::makeFrameQueue(
+  IRSOL_MAYBE_UNUSED const protocol::Command&   message,
+  std::shared_ptr<irsol::server::ClientSession> session) const
+{
+  // The whole burst is queued before being sent: the collector never waits for the client.
+  const auto& state = session->userData().frameListeningState;
+  return frame_collector::FrameCollector::makeQueuePtr(state.gisParams.inputSequenceLength);
+}
+
+void
+CommandBurstHandler::registerClient(
+  irsol::server::frame_collector::FrameCollector&                                collector,
+  std::shared_ptr<irsol::server::ClientSession>                                  session,
+  std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t> queue,
+  uint64_t                                                                       numFrames,
+  IRSOL_MAYBE_UNUSED double                                                      fps) const
+{
+  collector.registerBurst(session->id(), queue, numFrames);
+}
+
+bool
+CommandBurstHandler::deliversAfterAcquisition() const
+{
+  return true;
+}
+
+}  // namespace handlers
+}  // namespace server
+}  // namespace irsol
@@ -41,6 +41,15 @@ CommandGIHandler::getFrameRate(
   return -1.0;
 }
 
+std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t>
+CommandGIHandler::makeFrameQueue(
+  IRSOL_MAYBE_UNUSED const protocol::Command& message,
+  IRSOL_MAYBE_UNUSED std::shared_ptr<irsol::server::ClientSession> session) const
+{
+  // A single frame is ever pushed for the 'gi' command
+  return frame_collector::FrameCollector::makeQueuePtr(1);
+}
+
 }  // namespace handlers
 }  // namespace server
 }  // namespace irsol
@@ -8,8 +8,10 @@
 #include "irsol/types.hpp"
 #include "irsol/utils.hpp"
 
+#include <chrono>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <sstream>
 #include <vector>
 
@@ -26,7 +28,7 @@ CommandGIBaseHandler::process(
   IRSOL_MAYBE_UNUSED protocol::Command&& message)
 {
 
-  auto& collector = ctx->app.frameCollector();
+  auto& collector = ctx->app.device(*session).frameCollector();
   auto& state     = session->userData().frameListeningState;
 
   if(state.running()) {
@@ -40,17 +42,34 @@ CommandGIBaseHandler::process(
     return errors;
   }
 
-  auto queue = collector.makeQueuePtr();
+  auto queue = makeFrameQueue(message, session);
   startListeningThread(session, queue, std::move(message), getDescription(message, session));
 
   const uint64_t numFrames = getInputSequenceLength(message, session);
   const double   fps       = getFrameRate(message, session);
-  collector.registerClient(session->id(), fps, queue, numFrames);
+  registerClient(collector, session, queue, numFrames, fps);
 
   IRSOL_NAMED_LOG_INFO(session->id(), "Client registered for {} frames at FPS {}", numFrames, fps);
   return {};
 }
 
+void
+CommandGIBaseHandler::registerClient(
+  irsol::server::frame_collector::FrameCollector&                                collector,
+  std::shared_ptr<irsol::server::ClientSession>                                  session,
+  std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t> queue,
+  uint64_t                                                                       numFrames,
+  double                                                                         fps) const
+{
+  collector.registerClient(session->id(), fps, queue, numFrames);
+}
+
+bool
+CommandGIBaseHandler::deliversAfterAcquisition() const
+{
+  return false;
+}
+
 std::string
 CommandGIBaseHandler::getDescription(
   const protocol::Command&                      message,
@@ -68,43 +87,79 @@ CommandGIBaseHandler::startListeningThread(
   protocol::Command&&                                                            command,
   const std::string&                                                             description)
 {
-  auto& state = session->userData().frameListeningState;
+  auto&      state            = session->userData().frameListeningState;
+  const bool afterAcquisition = deliversAfterAcquisition();
 
   state.start(
-    [session, queue, message = std::move(command)](
+    [session, queue, afterAcquisition, message = std::move(command)](
       std::shared_ptr<std::atomic<bool>> stopRequest) mutable {
       // Reset the state of the user-data related to frame-listening
       auto& state                         = session->userData().frameListeningState;
       state.gisParams.inputSequenceNumber = 0;
+      state.gisParams.droppedFrames       = 0;
 
       IRSOL_NAMED_LOG_INFO(
         session->id(), "Started frame listening thread for {}", message.toString());
 
-      std::unique_ptr<frame_collector::Frame> framePtr;
-      bool                                    interrupted = false;
-      while(!interrupted && (!queue->done() && queue->pop(framePtr))) {
+      // Nothing is sent until all the frames are acquired, if so requested: the acquisition is
+      // not slowed down by the network.
+      irsol::utils::PopResult result = irsol::utils::PopResult::POPPED;
+      if(afterAcquisition) {
+        result = queue->waitDone(stopRequest.get());
+      }
+
+      // A consumer that fell behind the acquisition sends all its ready frames at once, and an
+      // abort wakes the thread up at once, instead of after the next frame.
+      std::vector<std::shared_ptr<const frame_collector::Frame>> frames;
+      std::optional<irsol::types::timepoint_t>                   lastTimestamp;
+      while(result != irsol::utils::PopResult::STOPPED &&
+            (result = queue->popMany(frames, MAX_FRAMES_PER_BATCH, stopRequest.get())) ==
+              irsol::utils::PopResult::POPPED) {
         IRSOL_NAMED_LOG_DEBUG(
           session->id(),
-          "Sending frame {} to client: {}",
-          state.gisParams.inputSequenceNumber,
-          framePtr->image.toString());
+          "Sending {} frames to client, from frame {}",
+          frames.size(),
+          state.gisParams.inputSequenceNumber);
         {
-          auto                                     lock = std::scoped_lock(session->socketMutex());
-          std::vector<irsol::protocol::OutMessage> result;
-          result.emplace_back(irsol::protocol::OutMessage(std::move(framePtr->image)));
-          result.emplace_back(irsol::protocol::Success::asStatus(
-            "isn", {static_cast<int>(state.gisParams.inputSequenceNumber)}));
-          session->handleOutMessages(std::move(result));
+          // The frames are shared with the other clients served by the same captures: their wire
+          // representation is computed once, and only the per-client input sequence number is
+          // serialized here.
+          auto lock = std::scoped_lock(session->socketMutex());
+          for(const auto& framePtr : frames) {
+            auto serializedImage = framePtr->serialized();
+            session->handleSerializedMessage(*serializedImage);
+            session->handleOutMessage(irsol::protocol::Success::asStatus(
+              "isn", {static_cast<int>(state.gisParams.inputSequenceNumber)}));
+            ++state.gisParams.inputSequenceNumber;
+            if(afterAcquisition) {
+              // The frames are received long after their acquisition: their actual interval is
+              // sent along.
+              const auto timestamp = framePtr->metadata.timestamp;
+              const auto interval  = lastTimestamp ? timestamp - *lastTimestamp
+                                                   : irsol::types::duration_t::zero();
+              session->handleOutMessage(irsol::protocol::Success::asStatus(
+                "dt",
+                {static_cast<int>(
+                  std::chrono::duration_cast<std::chrono::microseconds>(interval).count())}));
+              lastTimestamp = timestamp;
+            }
+          }
         }
-        ++state.gisParams.inputSequenceNumber;
+        frames.clear();
         if(stopRequest->load()) {
-          interrupted = true;
+          result = irsol::utils::PopResult::STOPPED;
+          break;
         }
       }
 
-      if(interrupted) {
+      // Kept for the `fq_dropped` inquiry, once the client is deregistered from the collector.
+      state.gisParams.droppedFrames = queue->dropped();
+
+      if(result == irsol::utils::PopResult::STOPPED) {
         IRSOL_NAMED_LOG_INFO(
           session->id(), "Stopping execution of frame-collection due to stop-request.");
+        // The remaining frames of the sequence are not captured for nothing.
+        session->app().device(*session).frameCollector().deregisterClient(session->id());
         // TODO: on user-stop requests do we want to return a success?
         return;
       }
@@ -115,7 +170,8 @@ CommandGIBaseHandler::startListeningThread(
       }
       IRSOL_NAMED_LOG_INFO(session->id(), "{} frame sending complete", message.toString());
     },
-    description);
+    description,
+    [queue]() { queue->interrupt(); });
 }
 }  // namespace internal
 }  // namespace handlers
@@ -51,6 +51,16 @@ CommandGISHandler::getFrameRate(
   return state.gisParams.frameRate;
 }
 
+std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t>
+CommandGISHandler::makeFrameQueue(
+  IRSOL_MAYBE_UNUSED const protocol::Command&   message,
+  std::shared_ptr<irsol::server::ClientSession> session) const
+{
+  const auto& state = session->userData().frameListeningState;
+  return frame_collector::FrameCollector::makeQueuePtr(
+    state.gisParams.frameQueueCapacity, state.gisParams.frameQueuePolicy);
+}
+
 }  // namespace handlers
 }  // namespace server
 }  // namespace irsol
\ No newline at end of file
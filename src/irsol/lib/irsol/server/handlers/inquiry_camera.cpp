@@ -0,0 +1,25 @@
+#include "irsol/server/handlers/inquiry_camera.hpp"
+
+#include "irsol/server/app.hpp"
+#include "irsol/server/client/session.hpp"
+
+namespace irsol {
+namespace server {
+namespace handlers {
+InquiryCameraHandler::InquiryCameraHandler(std::shared_ptr<Context> ctx): InquiryHandler(ctx) {}
+
+std::vector<out_message_t>
+InquiryCameraHandler::process(
+  std::shared_ptr<irsol::server::ClientSession> session,
+  protocol::Inquiry&&                           message)
+{
+  const auto& device = ctx->app.device(*session);
+
+  std::vector<out_message_t> result;
+  result.emplace_back(
+    irsol::protocol::Success::from(message, irsol::types::protocol_value_t{device.name()}));
+  return result;
+}
+}  // namespace handlers
+}  // namespace server
+}  // namespace irsol
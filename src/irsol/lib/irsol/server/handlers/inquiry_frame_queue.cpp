@@ -0,0 +1,69 @@
+#include "irsol/server/handlers/inquiry_frame_queue.hpp"
+
+#include "irsol/queue.hpp"
+#include "irsol/server/app.hpp"
+#include "irsol/server/client/session.hpp"
+#include "irsol/server/image_collector.hpp"
+
+namespace irsol {
+namespace server {
+namespace handlers {
+InquiryFrameQueueCapacityHandler::InquiryFrameQueueCapacityHandler(std::shared_ptr<Context> ctx)
+  : InquiryHandler(ctx)
+{}
+
+std::vector<out_message_t>
+InquiryFrameQueueCapacityHandler::process(
+  std::shared_ptr<irsol::server::ClientSession> session,
+  IRSOL_MAYBE_UNUSED protocol::Inquiry&& message)
+{
+  const auto& gisParams = session->userData().frameListeningState.gisParams;
+
+  std::vector<out_message_t> result;
+  result.emplace_back(irsol::protocol::Success::from(
+    std::move(message),
+    irsol::types::protocol_value_t{static_cast<int>(gisParams.frameQueueCapacity)}));
+  return result;
+}
+
+InquiryFrameQueuePolicyHandler::InquiryFrameQueuePolicyHandler(std::shared_ptr<Context> ctx)
+  : InquiryHandler(ctx)
+{}
+
+std::vector<out_message_t>
+InquiryFrameQueuePolicyHandler::process(
+  std::shared_ptr<irsol::server::ClientSession> session,
+  IRSOL_MAYBE_UNUSED protocol::Inquiry&& message)
+{
+  const auto& gisParams = session->userData().frameListeningState.gisParams;
+
+  std::vector<out_message_t> result;
+  result.emplace_back(irsol::protocol::Success::from(
+    std::move(message),
+    irsol::types::protocol_value_t{
+      std::string(irsol::utils::overflowPolicyToString(gisParams.frameQueuePolicy))}));
+  return result;
+}
+
+InquiryFrameQueueDroppedHandler::InquiryFrameQueueDroppedHandler(std::shared_ptr<Context> ctx)
+  : InquiryHandler(ctx)
+{}
+
+std::vector<out_message_t>
+InquiryFrameQueueDroppedHandler::process(
+  std::shared_ptr<irsol::server::ClientSession> session,
+  IRSOL_MAYBE_UNUSED protocol::Inquiry&& message)
+{
+  const auto& gisParams = session->userData().frameListeningState.gisParams;
+  const auto  dropped   = ctx->app.device(*session).frameCollector().droppedFrames(session->id());
+
+  std::vector<out_message_t> result;
+  result.emplace_back(irsol::protocol::Success::from(
+    std::move(message),
+    irsol::types::protocol_value_t{
+      static_cast<int>(dropped.value_or(gisParams.droppedFrames))}));
+  return result;
+}
+}  // namespace handlers
+}  // namespace server
+}  // namespace irsol
@@ -17,7 +17,15 @@ InquiryIntegrationTimeHandler::process(
   std::shared_ptr<irsol::server::ClientSession> session,
   IRSOL_MAYBE_UNUSED irsol::protocol::Inquiry&& message)
 {
-  auto& cam      = session->app().camera();
+  auto& device = session->app().device(*session);
+  if(!device.hasCamera()) {
+    IRSOL_NAMED_LOG_WARN(session->id(), "Device '{}' has no camera parameters", device.name());
+    std::vector<out_message_t> result;
+    result.emplace_back(
+      irsol::protocol::Error::from(message, "The selected device has no camera parameters"));
+    return result;
+  }
+  auto& cam      = device.camera();
   auto  exposure = cam.getExposure();
 
   std::vector<out_message_t> result;
@@ -4,8 +4,13 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iostream>
-#include <set>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace irsol {
 namespace server {
@@ -13,13 +18,56 @@ namespace server {
 namespace frame_collector {
 
 std::shared_ptr<FrameCollector::frame_queue_t>
-FrameCollector::makeQueuePtr()
+FrameCollector::makeQueuePtr(size_t capacity, irsol::utils::OverflowPolicy policy)
 {
-  return std::make_shared<FrameCollector::frame_queue_t>();
+  return std::make_shared<FrameCollector::frame_queue_t>(capacity, policy);
 }
 
-FrameCollector::FrameCollector(irsol::camera::Interface& camera): m_cam(camera)
+std::shared_ptr<const Frame>
+FrameCollector::makeFrame(FrameMetadata metadata, std::vector<irsol::types::byte_t>&& imageData)
 {
+  return makeFrame(
+    metadata, std::make_shared<std::vector<irsol::types::byte_t>>(std::move(imageData)));
+}
+
+std::shared_ptr<const Frame>
+FrameCollector::makeFrame(
+  FrameMetadata                               metadata,
+  irsol::protocol::ImageBinaryData::storage_t imageData)
+{
+  return std::make_shared<const Frame>(
+    metadata,
+    irsol::protocol::ImageBinaryData::fromSharedData(
+      std::move(imageData),
+      {metadata.height, metadata.width},
+      {irsol::protocol::BinaryDataAttribute("imageId", static_cast<int>(metadata.frameId)),
+       irsol::protocol::BinaryDataAttribute(
+         "timestamp", irsol::utils::timestampToString(metadata.timestamp))}));
+}
+
+double
+FrameCollector::snapToHarmonicGrid(double fps)
+{
+  if(!(fps > HARMONIC_MIN_FPS)) {
+    return HARMONIC_MIN_FPS;
+  }
+  return std::min(std::exp2(std::round(std::log2(fps))), HARMONIC_MAX_FPS);
+}
+
+FrameCollector::FrameCollector(
+  irsol::camera::Interface& camera,
+  CollectionMode            mode,
+  size_t                    historyCapacity)
+  : FrameCollector(std::make_unique<CameraFrameSource>(camera), mode, historyCapacity)
+{}
+
+FrameCollector::FrameCollector(
+  std::unique_ptr<FrameSource> source,
+  CollectionMode               mode,
+  size_t                       historyCapacity)
+  : m_source(std::move(source)), m_mode(mode), m_history(historyCapacity)
+{
+  IRSOL_ASSERT_FATAL(m_source != nullptr, "FrameCollector requires a frame source");
   start();
 }
 
@@ -36,14 +84,26 @@ FrameCollector::start()
       "frame_collector", "Collector was requested to stop already. Ignoring re-start request");
     return;
   }
-  m_distributorThread = std::thread(&FrameCollector::run, this);
+  {
+    std::scoped_lock<std::mutex> lock(m_clientsMutex);
+    m_acquiring = true;
+  }
+  m_distributorThread = std::thread(&FrameCollector::runDistribution, this);
+  m_acquisitionThread = std::thread(&FrameCollector::runAcquisition, this);
 }
 
 void
 FrameCollector::stop()
 {
-  m_stop.store(true);
+  {
+    // Setting the flag under the lock guarantees that the acquisition thread either observes it,
+    // or is already waiting for the notification below.
+    std::scoped_lock<std::mutex> lock(m_clientsMutex);
+    m_stop.store(true);
+  }
   m_scheduleCondition.notify_all();
+  if(m_acquisitionThread.joinable())
+    m_acquisitionThread.join();
   if(m_distributorThread.joinable())
     m_distributorThread.join();
 }
@@ -51,7 +111,13 @@ FrameCollector::stop()
 bool
 FrameCollector::isBusy() const
 {
-  return !m_clients.empty();
+  return !m_handles.empty();
+}
+
+CollectionMode
+FrameCollector::mode() const
+{
+  return m_mode;
 }
 
 void
@@ -72,6 +138,16 @@ FrameCollector::registerClient(
     immediate  = true;
     frameCount = 1;
     fps        = 0.0;
+  } else if(m_mode == CollectionMode::HARMONIC) {
+    const double requestedFps = fps;
+    fps                       = snapToHarmonicGrid(fps);
+    interval                  = HARMONIC_TICK * static_cast<int64_t>(HARMONIC_MAX_FPS / fps);
+    IRSOL_NAMED_LOG_INFO(
+      "frame_collector",
+      "registering client at {} fps (requested {} fps) with interval of {}",
+      fps,
+      requestedFps,
+      irsol::utils::durationToString(interval));
   } else {
     interval = std::chrono::microseconds(static_cast<uint64_t>(1000000.0 / fps));
     IRSOL_NAMED_LOG_INFO(
@@ -80,11 +156,18 @@ FrameCollector::registerClient(
       irsol::utils::durationToString(interval));
   }
 
-  // Registers the client so that the next due time is in SLACK ms.
-  // This is to allow the collector thread to batch multiple clients, that desire a frame at a
-  // specific timestamp, but all within the SLACK duration and to serve them all with the same frame
-  // image.
-  auto nextDue = irsol::types::clock_t::now() + FrameCollector::SLACK;
+  // In just-in-time mode, registers streaming clients so that the next due time is in
+  // REGISTRATION_DELAY ms. This is to allow the collector thread to batch multiple clients
+  // registering at about the same time, and to serve them all with the same frame image.
+  // Single-frame clients want their frame as soon as possible, and are due at once.
+  // In continuous mode frames are produced anyway, so the client is served by the next frame.
+  // In harmonic mode, the client is due on its next tick of the master cadence.
+  auto nextDue = irsol::types::clock_t::now();
+  if(m_mode == CollectionMode::JUST_IN_TIME && !immediate) {
+    nextDue += FrameCollector::REGISTRATION_DELAY;
+  } else if(m_mode == CollectionMode::HARMONIC && !immediate) {
+    nextDue = firstHarmonicDue(static_cast<uint64_t>(interval / HARMONIC_TICK), nextDue);
+  }
 
   IRSOL_NAMED_LOG_INFO(
     "frame_collector",
@@ -96,10 +179,80 @@ FrameCollector::registerClient(
     irsol::utils::timestampToString(nextDue),
     frameCount,
     immediate);
+  addClientNonThreadSafe({clientId, fps, interval, nextDue, queue, frameCount, immediate});
+}
 
-  m_clients.emplace(
-    clientId, ClientCollectionParams(fps, interval, nextDue, queue, frameCount, immediate));
-  schedule(clientId, nextDue);
+void
+FrameCollector::registerBurst(
+  irsol::types::client_id_t                      clientId,
+  std::shared_ptr<FrameCollector::frame_queue_t> queue,
+  uint64_t                                       frameCount)
+{
+  IRSOL_ASSERT_ERROR(frameCount > 0, "A burst needs at least one frame.");
+  {
+    // The reservation lasts until the last burst client deregisters: count this one before the
+    // source starts reserving, so that the end of another burst meanwhile doesn't release it.
+    std::scoped_lock<std::mutex> lock(m_clientsMutex);
+    ++m_numBurstClients;
+  }
+  // The buffers of the whole burst are allocated before its first capture, without holding the
+  // lock.
+  m_source->reserveFrames(frameCount);
+
+  std::scoped_lock<std::mutex> lock(m_clientsMutex);
+
+  // A burst client has no interval: it's due at once, and stays due until all its frames are
+  // captured, so that they are captured back-to-back, as fast as the source allows.
+  const auto nextDue = irsol::types::clock_t::now();
+  IRSOL_NAMED_LOG_INFO(
+    "frame_collector", "Registering client {} for a burst of {} frames", clientId, frameCount);
+  addClientNonThreadSafe(
+    {clientId,
+     0.0,
+     std::chrono::microseconds(0),
+     nextDue,
+     queue,
+     static_cast<int64_t>(frameCount),
+     false,
+     true});
+}
+
+void
+FrameCollector::addClientNonThreadSafe(ClientCollectionParams&& clientParams)
+{
+  const auto clientId = clientParams.clientId;
+  const auto nextDue  = clientParams.nextFrameDue;
+  if(m_handles.find(clientId) != m_handles.end()) {
+    IRSOL_NAMED_LOG_WARN(
+      "frame_collector",
+      "Client {} is already registered, replacing its previous registration.",
+      clientId);
+    deregisterClientNonThreadSafe(clientId);
+  }
+
+  // Re-use the handle of a previously deregistered client, if any, so that the handles stay
+  // densely allocated.
+  client_handle_t handle;
+  if(!m_freeHandles.empty()) {
+    handle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+  } else {
+    handle = static_cast<client_handle_t>(m_clients.size());
+    m_clients.emplace_back();
+    m_generations.emplace_back(0);
+  }
+  const bool immediate = clientParams.immediate;
+  m_clients[handle].emplace(std::move(clientParams));
+  m_handles.emplace(clientId, handle);
+  schedule(handle, nextDue);
+
+  if(immediate && m_numPendingCaptures > 0) {
+    // The capture in flight completes sooner than any new one: the client joins it, and leaves
+    // the schedule as the clients selected for that capture did.
+    IRSOL_NAMED_LOG_DEBUG("frame_collector", "Client {} joins the capture in flight", clientId);
+    m_scheduler.remove(handle);
+    m_joiningClients.push_back({{nextDue, handle}, m_generations[handle]});
+  }
 }
 
 void
@@ -109,23 +262,152 @@ FrameCollector::deregisterClient(irsol::types::client_id_t clientId)
   deregisterClientNonThreadSafe(clientId);
 }
 
+std::optional<uint64_t>
+FrameCollector::droppedFrames(const irsol::types::client_id_t& clientId)
+{
+  std::scoped_lock<std::mutex> lock(m_clientsMutex);
+  auto                         it = m_handles.find(clientId);
+  if(it == m_handles.end()) {
+    return std::nullopt;
+  }
+  return m_clients[it->second]->queue->dropped();
+}
+
+std::optional<TimingStatistics>
+FrameCollector::timingStatistics(const irsol::types::client_id_t& clientId)
+{
+  std::scoped_lock<std::mutex> lock(m_clientsMutex);
+  auto                         it = m_handles.find(clientId);
+  if(it == m_handles.end()) {
+    return std::nullopt;
+  }
+  return m_clients[it->second]->timing;
+}
+
+uint64_t
+FrameCollector::numCaptures() const
+{
+  return m_numCaptures.load();
+}
+
+uint64_t
+FrameCollector::numSavedCaptures() const
+{
+  return m_numSavedCaptures.load();
+}
+
+uint64_t
+FrameCollector::numCoalescedControls() const
+{
+  return m_control.numCoalesced();
+}
+
+const FrameHistory&
+FrameCollector::history() const
+{
+  return m_history;
+}
+
+bool
+FrameCollector::pinToCpu(IRSOL_MAYBE_UNUSED size_t cpu)
+{
+#ifdef __linux__
+  if(cpu >= CPU_SETSIZE) {
+    IRSOL_NAMED_LOG_WARN("frame_collector", "Invalid CPU index {}", cpu);
+    return false;
+  }
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpu, &cpuSet);
+  for(auto* thread : {&m_acquisitionThread, &m_distributorThread}) {
+    if(!thread->joinable()) {
+      continue;
+    }
+    if(const auto error = pthread_setaffinity_np(thread->native_handle(), sizeof(cpuSet), &cpuSet);
+       error != 0) {
+      IRSOL_NAMED_LOG_WARN(
+        "frame_collector", "Failed to pin collector threads to CPU {}: error {}", cpu, error);
+      return false;
+    }
+  }
+  IRSOL_NAMED_LOG_INFO("frame_collector", "Collector threads pinned to CPU {}", cpu);
+  return true;
+#else
+  IRSOL_NAMED_LOG_WARN("frame_collector", "Pinning threads to a CPU is not supported");
+  return false;
+#endif
+}
+
+void
+FrameCollector::runAcquisition()
+{
+  switch(m_mode) {
+    case CollectionMode::JUST_IN_TIME:
+    case CollectionMode::HARMONIC:
+      runJustInTime();
+      // Complete the captures still in the pipeline, so that the distribution thread can drain it.
+      m_source->stopCaptures();
+      break;
+    case CollectionMode::CONTINUOUS:
+      runContinuous();
+      break;
+  }
+
+  // Let the distribution thread know that no more frames are coming.
+  m_handoff.producerFinished();
+
+  // The camera operations queued from now on are executed by their requesters.
+  {
+    std::scoped_lock<std::mutex> lock(m_clientsMutex);
+    m_acquiring = false;
+  }
+  m_control.runPending();
+  IRSOL_NAMED_LOG_INFO(
+    "frame_collector",
+    "Performed {} captures, {} more were saved by batching deliveries",
+    m_numCaptures.load(),
+    m_numSavedCaptures.load());
+}
+
 void
-FrameCollector::run()
+FrameCollector::runJustInTime()
 {
   std::unique_lock<std::mutex> lock(m_clientsMutex);
 
   while(!m_stop) {
-    if(m_scheduleMap.empty()) {
-      // Wait until at least one new client is registered in the map, or if a stop request has
-      // arrived.
+    const size_t maxPendingCaptures = m_source->maxPendingCaptures();
+    if(
+      m_numPendingCaptures >= maxPendingCaptures ||
+      (m_numPendingCaptures > 0 && !m_control.empty())) {
+      // Wait for a pending capture to complete: the source accepts no more captures, or the
+      // queued camera operations wait until the camera is idle.
+      m_scheduleCondition.wait(lock, [this, maxPendingCaptures]() {
+        return m_stop || m_numPendingCaptures == 0 ||
+               (m_numPendingCaptures < maxPendingCaptures && m_control.empty());
+      });
+      continue;
+    }
+
+    // The camera is idle between two captures: apply the pending parameter changes.
+    if(!m_control.empty()) {
+      lock.unlock();
+      m_source->stopCaptures();
+      lock.lock();
+    }
+    runControls(lock);
+
+    if(m_scheduler.empty()) {
+      // Wait until at least one new client is scheduled, a camera operation is queued, or if a
+      // stop request has arrived.
       m_scheduleCondition.wait(lock, [this]() {
         IRSOL_NAMED_LOG_DEBUG(
           "frame_collector",
           "Waiting until a client is scheduled (clients size: {}, schedule size: {})",
-          m_clients.size(),
-          m_scheduleMap.size());
-        return m_stop || !m_scheduleMap.empty();
+          m_handles.size(),
+          m_scheduler.size());
+        return m_stop || !m_scheduler.empty() || !m_control.empty();
       });
+      continue;
     }
 
     if(m_stop.load()) {
@@ -133,9 +415,11 @@ FrameCollector::run()
       break;
     }
 
-    // Retrieve the nextDue time from the schedule map.
-    // This map is always sorted from small to high, as it's an ordered container.
-    irsol::types::timepoint_t nextDue = m_scheduleMap.begin()->first;
+    // Retrieve the nextDue time from the scheduler, which always exposes the earliest due time.
+    // The source is not triggered faster than its trigger cadence, even if clients are due
+    // earlier.
+    const irsol::types::timepoint_t nextTrigger = m_lastTrigger + m_source->triggerInterval();
+    irsol::types::timepoint_t       nextDue     = std::max(m_scheduler.nextDue(), nextTrigger);
     IRSOL_NAMED_LOG_DEBUG(
       "frame_collector",
       "Running for frame collection due at {}",
@@ -146,117 +430,366 @@ FrameCollector::run()
     // - m_stop is set to true due to a stop-request
     // - a new client is registered with a nextDue time that is smaller than the current nextDue
     // time
-    m_scheduleCondition.wait_until(lock, nextDue, [this, currentNextDue = nextDue]() {
+    // - a camera operation is queued
+    m_scheduleCondition.wait_until(lock, nextDue, [this, nextTrigger, currentNextDue = nextDue]() {
       if(m_stop.load()) {
         // stopped externally, exit the wait
         return true;
       }
-      if(m_scheduleMap.empty()) {
-        // Don't wake up early unnecessarily, as there's no schedules in the map
+      if(!m_control.empty()) {
+        return true;
+      }
+      if(m_scheduler.empty()) {
+        // Don't wake up early unnecessarily, as there's no schedules
         return false;
       }
 
-      // Check if a new schedule has been inserted into the map, which happens
-      // earlier than the due time we captured prior to sleeping.
-      auto newNextDue = m_scheduleMap.begin()->first;
-
-      IRSOL_NAMED_LOG_DEBUG(
-        "frame_collector",
-        "Current first timestamp in the map: {}, current nextDue: {}",
-        irsol::utils::timestampToString(newNextDue),
-        irsol::utils::timestampToString(currentNextDue));
-      return newNextDue < currentNextDue;
+      // Check if a new schedule has been inserted, which happens earlier than the due time we
+      // captured prior to sleeping.
+      return std::max(m_scheduler.nextDue(), nextTrigger) < currentNextDue;
     });
 
     if(m_stop.load()) {
       IRSOL_NAMED_LOG_INFO(
         "frame_collector", "Frame collection stop request received, breaking loop");
-      return;
+      break;
+    }
+    if(m_scheduler.empty() || !m_control.empty()) {
+      // All the clients deregistered while waiting, or a camera operation must be applied first.
+      continue;
     }
 
     // Refresh the nextDue, as the above condition might have finished due to a new client being
     // registered earlier than the 'nextDue' time that was initially selected.
-    nextDue = m_scheduleMap.begin()->first;
+    nextDue = m_scheduler.nextDue();
 
     // Clients due now or earlier
     irsol::types::timepoint_t now = irsol::types::clock_t::now();
+    if(now < nextTrigger) {
+      // Woken up before the source is ready for the next trigger.
+      continue;
+    }
     IRSOL_NAMED_LOG_DEBUG(
       "frame_collector",
       "Woken up at timestamp {}, with next due at {}",
       irsol::utils::timestampToString(now),
       irsol::utils::timestampToString(nextDue));
 
-    const auto slack = m_clients.size() == 1 ? std::chrono::milliseconds(0) : FrameCollector::SLACK;
-    auto [readyClients, clientsSchedules] = collectReadyClients(now, slack);
+    // Re-use the client list of an already distributed frame, if available.
+    std::vector<ReadyClient> clients;
+    if(!m_spareClientLists.empty()) {
+      clients = std::move(m_spareClientLists.back());
+      m_spareClientLists.pop_back();
+    }
+
+    const auto slack = collectBatch(now, clients);
     IRSOL_NAMED_LOG_DEBUG(
-      "frame_collector", "Found {} clients that need an image now!", readyClients.size());
-    {
-      auto uniqueSchedules =
-        std::set<irsol::types::timepoint_t>(clientsSchedules.begin(), clientsSchedules.end());
-      for(auto uniqueSchedule : uniqueSchedules) {
-        auto numClientsWithSchedule = std::count_if(
-          clientsSchedules.begin(),
-          clientsSchedules.end(),
-          [&uniqueSchedule](const auto& schedule) { return schedule == uniqueSchedule; });
-
-        if(uniqueSchedule != nextDue) {
-          IRSOL_NAMED_LOG_WARN(
-            "frame_collector_slack",
-            "Actual schedule: {}, also considering {} clients with schedule {} due to allowed "
-            "slack of {}",
-            irsol::utils::timestampToString(nextDue),
-            numClientsWithSchedule,
-            irsol::utils::timestampToString(uniqueSchedule),
-            irsol::utils::durationToString(slack));
-        }
+      "frame_collector", "Found {} clients that need an image now!", clients.size());
+    if(clients.empty()) {
+      // Woken up slightly before the due time.
+      m_spareClientLists.push_back(std::move(clients));
+      continue;
+    }
+    logSlackUsage(clients, slack);
+    if(maxPendingCaptures > 1) {
+      // The next frames of these clients may be captured before this one is delivered.
+      rescheduleAhead(clients);
+    }
+
+    // Unless rescheduled ahead, the selected clients are no longer in the schedule until the
+    // distribution thread delivers them the frame. The capture is submitted without waiting for
+    // it: the distribution thread receives the frame, while this thread goes on scheduling the
+    // next captures. The lock is released meanwhile, so that clients can (de)register.
+    const auto numCapturesAhead = static_cast<int64_t>(m_numPendingCaptures);
+    const auto timeout =
+      expectedCaptureDuration() * (numCapturesAhead + 1) + CAPTURE_TIMEOUT_MARGIN;
+    ++m_numPendingCaptures;
+    lock.unlock();
+    const auto captureStart = irsol::types::clock_t::now();
+    auto       pending      = m_source->submitCapture();
+    // The trigger cadence counts from the actual submission of the capture.
+    const auto submitted = irsol::types::clock_t::now();
+    // The distribution thread needs the lock to make room in a full hand-off queue.
+    m_handoff.push(
+      {{}, std::move(clients), {}, captureStart, std::move(pending), captureStart + timeout});
+    lock.lock();
+    m_lastTrigger = submitted;
+  }
+}
+
+void
+FrameCollector::runContinuous()
+{
+  std::unique_lock<std::mutex> lock(m_clientsMutex);
+
+  bool   running    = false;
+  double runningFps = 0.0;
+  while(!m_stop) {
+    // Apply the pending parameter changes between two frames.
+    runControls(lock);
+
+    if(m_handles.empty()) {
+      if(running) {
+        IRSOL_NAMED_LOG_INFO("frame_collector", "No more clients, stopping continuous acquisition");
+        lock.unlock();
+        m_source->stopContinuous();
+        running = false;
+        lock.lock();
+        continue;
       }
+      // Wait until at least one new client is registered, or if a stop request has arrived.
+      m_scheduleCondition.wait(
+        lock, [this]() { return m_stop || !m_handles.empty() || !m_control.empty(); });
+      continue;
     }
-    cleanUpSchedule(clientsSchedules);
-    IRSOL_NAMED_LOG_DEBUG(
-      "frame_collector",
-      "After schedule cleanup, there are still {} schedules",
-      m_scheduleMap.size());
 
-    auto grabResult = grabImageData();
-    if(!grabResult) {
+    const double desiredFps = continuousFps();
+
+    // Talk to the source without holding the lock, as clients must be able to (de)register while
+    // the source is producing frames.
+    lock.unlock();
+
+    // (Re-)start the acquisition if the rate required by the clients has changed.
+    if(!running || desiredFps != runningFps) {
+      IRSOL_NAMED_LOG_INFO(
+        "frame_collector", "(Re-)starting continuous acquisition at {} fps", desiredFps);
+      m_source->startContinuous(desiredFps);
+      running    = true;
+      runningFps = desiredFps;
+    }
+
+    auto captured = m_source->nextContinuous();
+    if(m_stop.load()) {
+      IRSOL_NAMED_LOG_INFO(
+        "frame_collector", "Frame collection stop request received, breaking loop");
+      lock.lock();
+      break;
+    }
+    if(!captured) {
       IRSOL_NAMED_LOG_WARN("frame_collector", "Image acquisition failed.");
-      continue;
+    } else {
+      // A client is served by this frame if its next due time is closer to this frame than to
+      // the next one.
+      const auto tolerance = runningFps > 0.0
+                               ? std::chrono::duration_cast<irsol::types::duration_t>(
+                                   std::chrono::duration<double>(0.5 / runningFps))
+                               : irsol::types::duration_t::zero();
+      ++m_numCaptures;
+      m_handoff.push({std::move(*captured), {}, tolerance});
     }
-    auto& [frameMetadata, imageRawBuffer] = *grabResult;
-
-    // Deliver the frame to clients
-    std::vector<irsol::types::client_id_t> finishedClient;
-    for(auto clientId : readyClients) {
-      IRSOL_NAMED_LOG_DEBUG("frame_collector", "Notifying client {} for new image data", clientId);
-      auto& clientParams = m_clients.at(clientId);
-      // Push a new frame created on the fly to the current client's queue.
-      // This creates a copy of the image data into the queue, and this is wanted, so that if a
-      // consumer modifies the image, it doesn't affect other clients.
-      clientParams.queue->push(std::make_unique<Frame>(
-        frameMetadata,
-        irsol::protocol::ImageBinaryData(
-          {imageRawBuffer.begin(), imageRawBuffer.end()},
-          {frameMetadata.height, frameMetadata.width},
-          {irsol::protocol::BinaryDataAttribute("imageId", static_cast<int>(frameMetadata.frameId)),
-           irsol::protocol::BinaryDataAttribute(
-             "timestamp", irsol::utils::timestampToString(frameMetadata.timestamp))})));
-
-      // Try to schedule the client, if no longer needed, register it in the finishedClients
-      if(!schedule(clientId, clientParams.nextFrameDue + clientParams.interval)) {
-        finishedClient.push_back(clientId);
+    lock.lock();
+  }
+
+  lock.unlock();
+  if(running) {
+    m_source->stopContinuous();
+  }
+}
+
+bool
+FrameCollector::completeCapture(
+  CapturedFrame&                  captured,
+  FrameSource::captured_frame_t&& result,
+  irsol::types::timepoint_t       completion)
+{
+  // The acquisition thread may submit the next capture, or apply the camera operations.
+  --m_numPendingCaptures;
+  m_scheduleCondition.notify_all();
+
+  // Single-frame clients that registered during the capture are served by it as well.
+  captured.clients.insert(
+    captured.clients.end(), m_joiningClients.begin(), m_joiningClients.end());
+  m_joiningClients.clear();
+  // Keep a running estimate of the capture duration, which defines the slack of fast clients.
+  const auto captureTime = completion - *captured.triggerTime;
+  m_captureDuration      = m_captureDuration.count() == 0
+                             ? captureTime
+                             : std::chrono::duration_cast<irsol::types::duration_t>(
+                                 m_captureDuration * (1.0 - CAPTURE_DURATION_WEIGHT) +
+                                 captureTime * CAPTURE_DURATION_WEIGHT);
+  if(result) {
+    ++m_numCaptures;
+    captured.data = std::move(*result);
+    return true;
+  }
+
+  IRSOL_NAMED_LOG_WARN("frame_collector", "Image acquisition failed.");
+  // Retry to serve the same clients as soon as possible.
+  rescheduleFailed(captured.clients);
+  captured.clients.clear();
+  m_spareClientLists.push_back(std::move(captured.clients));
+  return false;
+}
+
+void
+FrameCollector::runControls(std::unique_lock<std::mutex>& lock)
+{
+  if(m_control.empty()) {
+    return;
+  }
+  // Clients can (de)register while the camera is being configured.
+  lock.unlock();
+  const auto numExecuted = m_control.runPending();
+  IRSOL_NAMED_LOG_DEBUG(
+    "frame_collector", "Applied {} camera operations between captures", numExecuted);
+  lock.lock();
+}
+
+void
+FrameCollector::runDistribution()
+{
+  CapturedFrame captured;
+  while(m_handoff.pop(captured)) {
+    const bool                    submitted = captured.pending.valid();
+    FrameSource::captured_frame_t result;
+    irsol::types::timepoint_t     completion;
+    if(submitted) {
+      // Wait for the submitted capture without holding the lock.
+      if(captured.pending.wait_until(captured.deadline) == std::future_status::timeout) {
+        IRSOL_NAMED_LOG_WARN(
+          "frame_collector", "Capture timed out, stopping the pending captures");
+        m_source->stopCaptures();
       }
+      result     = captured.pending.get();
+      completion = irsol::types::clock_t::now();
     }
 
-    // Unlock the clients so we can remove finished clients
-    for(const auto& clientId : finishedClient) {
+    std::scoped_lock<std::mutex> lock(m_clientsMutex);
+    if(submitted && !completeCapture(captured, std::move(result), completion)) {
+      continue;
+    }
+    if(m_stop.load()) {
+      // Drain the frames still in the pipeline, without delivering them.
+      continue;
+    }
+
+    // A single frame is built per capture, and the very same (read-only) frame is kept in the
+    // history and handed to all the ready clients. Consumers that need to modify the image data
+    // get a private copy through the copy-on-write semantics of the image buffer.
+    auto& [frameMetadata, imageRawBuffer] = captured.data;
+    auto frame = makeFrame(frameMetadata, std::move(imageRawBuffer));
+    m_history.add(frame);
+
+    switch(m_mode) {
+      case CollectionMode::JUST_IN_TIME:
+      case CollectionMode::HARMONIC:
+        deliver(frame, captured.clients, captured.triggerTime);
+        captured.clients.clear();
+        m_spareClientLists.push_back(std::move(captured.clients));
+        break;
+      case CollectionMode::CONTINUOUS:
+        // Select the clients that are due for this frame.
+        collectReadyClients(frameMetadata.timestamp, captured.tolerance, m_readyClients);
+        IRSOL_NAMED_LOG_DEBUG(
+          "frame_collector",
+          "Frame {} selected for {} clients",
+          frameMetadata.frameId,
+          m_readyClients.size());
+        if(!m_readyClients.empty()) {
+          deliver(frame, m_readyClients);
+        }
+        break;
+    }
+  }
+}
+
+double
+FrameCollector::continuousFps() const
+{
+  double fps = 0.0;
+  for(const auto& clientParams : m_clients) {
+    if(!clientParams) {
+      continue;
+    }
+    if(clientParams->burst) {
+      // Run as fast as possible until the burst is complete.
+      return 0.0;
+    }
+    fps = std::max(fps, clientParams->fps);
+  }
+  return fps;
+}
+
+void
+FrameCollector::deliver(
+  const std::shared_ptr<const Frame>&      frame,
+  const std::vector<ReadyClient>&          clients,
+  std::optional<irsol::types::timepoint_t> triggerTime)
+{
+  // Deliver the frame to clients
+  m_finishedClients.clear();
+  uint64_t numServed = 0;
+  for(const auto& client : clients) {
+    if(!isRegistered(client)) {
+      // The client deregistered while the frame was being captured.
+      continue;
+    }
+    ++numServed;
+    const auto& entry        = client.entry;
+    auto&       clientParams = *m_clients[entry.handle];
+    IRSOL_NAMED_LOG_DEBUG(
+      "frame_collector", "Notifying client {} for new image data", clientParams.clientId);
+    // Never wait for a slow client: a full queue either discards a frame, or rejects the new one.
+    if(clientParams.queue->tryPush(std::shared_ptr<const Frame>(frame))) {
+      recordTiming(clientParams, client, frame->metadata.timestamp, triggerTime);
+    } else if(clientParams.queue->policy() == irsol::utils::OverflowPolicy::BLOCK) {
+      // The frame is skipped for this client, but it doesn't count as one of the frames it
+      // requested: delivery is postponed to the client's next due time.
       IRSOL_NAMED_LOG_DEBUG(
         "frame_collector",
-        "Deregistering client {}, as it has consumed all the frames it needed.",
-        clientId);
-      deregisterClientNonThreadSafe(clientId);
+        "Queue of client {} is full, postponing delivery",
+        clientParams.clientId);
+      if(clientParams.remainingFrames >= 0) {
+        ++clientParams.remainingFrames;
+      }
+    }
+
+    if(client.rescheduled) {
+      // Already scheduled for its next frame when the capture started.
+      continue;
     }
+    // Try to schedule the client, if no longer needed, register it in the finishedClients
+    if(!schedule(entry.handle, clientParams.nextFrameDue + clientParams.interval)) {
+      m_finishedClients.push_back(entry.handle);
+    }
+  }
+
+  // Each client served in addition to the first one would otherwise require its own capture.
+  if(numServed > 1) {
+    m_numSavedCaptures += numServed - 1;
+  }
+
+  // Remove finished clients
+  for(const auto handle : m_finishedClients) {
+    IRSOL_NAMED_LOG_DEBUG(
+      "frame_collector",
+      "Deregistering client {}, as it has consumed all the frames it needed.",
+      m_clients[handle]->clientId);
+    deregisterClientNonThreadSafe(m_clients[handle]->clientId);
+  }
+}
+
+void
+FrameCollector::recordTiming(
+  ClientCollectionParams&                  clientParams,
+  const ReadyClient&                       client,
+  irsol::types::timepoint_t                frameTimestamp,
+  std::optional<irsol::types::timepoint_t> triggerTime)
+{
+  const auto toMicroseconds = [](irsol::types::duration_t duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+  };
 
-    IRSOL_NAMED_LOG_DEBUG("frame_collector", "Loop finished, restarting loop");
+  auto& timing = clientParams.timing;
+  if(clientParams.lastFrame && !clientParams.immediate) {
+    timing.intervalError.add(
+      toMicroseconds(frameTimestamp - *clientParams.lastFrame - clientParams.interval));
+  }
+  clientParams.lastFrame = frameTimestamp;
+
+  if(triggerTime) {
+    timing.schedulingDelay.add(toMicroseconds(*triggerTime - client.entry.due));
+    timing.cameraDelay.add(toMicroseconds(frameTimestamp - *triggerTime));
   }
 }
 
@@ -267,134 +800,232 @@ FrameCollector::deregisterClientNonThreadSafe(irsol::types::client_id_t clientId
   // no more data will be pushed to him
   IRSOL_NAMED_LOG_INFO("frame_collector", "Deregistering client {}", clientId);
 
-  if(m_clients.find(clientId) == m_clients.end()) {
+  auto it = m_handles.find(clientId);
+  if(it == m_handles.end()) {
     IRSOL_NAMED_LOG_WARN(
       "frame_collector", "Client {} was already deregistered, ignoring request.", clientId);
     return;
   }
-  auto& clientParams = m_clients.at(clientId);
-  clientParams.queue->producerFinished();
-
-  // Removes the client from the storage
-  auto dueNext = clientParams.nextFrameDue;
-
-  m_clients.erase(clientId);
-  IRSOL_NAMED_LOG_DEBUG(
-    "frame_collector", "Removed client {}, now remaining  {} clients", clientId, m_clients.size());
-
-  if(m_scheduleMap.find(dueNext) == m_scheduleMap.end()) {
-    IRSOL_NAMED_LOG_WARN(
+  const auto handle = it->second;
+  auto       queue  = m_clients[handle]->queue;
+  if(auto dropped = queue->dropped(); dropped > 0) {
+    IRSOL_NAMED_LOG_INFO(
+      "frame_collector", "Client {} could not receive {} frames (queue full)", clientId, dropped);
+  }
+  if(auto rejected = queue->rejected(); rejected > 0) {
+    IRSOL_NAMED_LOG_INFO(
       "frame_collector",
-      "Scheduled time {} was already deregistered. Ignoring request.",
-      irsol::utils::timestampToString(dueNext));
-    return;
+      "Delivery to client {} was postponed {} times (queue full)",
+      clientId,
+      rejected);
+  }
+  if(const auto& timing = m_clients[handle]->timing; timing.intervalError.total() > 0) {
+    IRSOL_NAMED_LOG_INFO(
+      "frame_collector", "Timing of client {}: {}", clientId, timing.toString());
+  }
+
+  if(m_clients[handle]->burst && --m_numBurstClients == 0) {
+    // Whether the burst completed or was aborted, the next frames are no longer reserved, and the
+    // buffers of the bursts are freed once their frames are delivered.
+    m_source->releaseFrames();
   }
-  auto& clientsAtDue = m_scheduleMap.at(dueNext);
 
+  // Removes the client from the storage and from the schedule, and makes its handle available
+  // for future registrations.
+  m_scheduler.remove(handle);
+  m_clients[handle].reset();
+  ++m_generations[handle];
+  m_freeHandles.push_back(handle);
+  m_handles.erase(it);
   IRSOL_NAMED_LOG_DEBUG(
-    "frame_collector",
-    "Deregistering client {} from next schedule at {}",
-    clientId,
-    irsol::utils::timestampToString(dueNext));
-  clientsAtDue.erase(
-    std::remove(clientsAtDue.begin(), clientsAtDue.end(), clientId), clientsAtDue.end());
+    "frame_collector", "Removed client {}, now remaining  {} clients", clientId, m_handles.size());
 
-  if(clientsAtDue.empty()) {
-    IRSOL_NAMED_LOG_DEBUG(
-      "frame_collector",
-      "No more clients for schedule {}. Removing schedule.",
-      irsol::utils::timestampToString(dueNext));
-    m_scheduleMap.erase(dueNext);
-  }
+  // Notify the client only once it's no longer known to the collector.
+  queue->producerFinished();
 
   m_scheduleCondition.notify_one();
 }
 
-std::pair<std::vector<irsol::types::client_id_t>, std::vector<irsol::types::timepoint_t>>
-FrameCollector::collectReadyClients(irsol::types::timepoint_t now, irsol::types::duration_t slack)
-  const
+void
+FrameCollector::collectReadyClients(
+  irsol::types::timepoint_t now,
+  irsol::types::duration_t  slack,
+  std::vector<ReadyClient>& out)
 {
   IRSOL_NAMED_LOG_DEBUG(
     "frame_collector",
     "Collecting clients for time {}, with slack of {}",
     irsol::utils::timestampToString(now),
     irsol::utils::durationToString(slack));
-  std::vector<irsol::types::client_id_t> readyClients;
-  std::vector<irsol::types::timepoint_t> clientsSchedule;
-
-  for(const auto& [scheduleTime, clients] : m_scheduleMap) {
-    // As soon as the scheduleTime of the client is above now+slack, break the loop.
-    // We can break early, as m_scheduleMap is an ordered container, that is iterated over
-    // in a way that smaller keys (scheduledTimes) are always iterated over at the beginning.
-    if(scheduleTime > now + slack) {
-      break;
-    }
-    for(const auto& client : clients) {
-      readyClients.push_back(client);
-      clientsSchedule.push_back(scheduleTime);
+  m_dueClients.clear();
+  m_scheduler.popDue(now + slack, m_dueClients);
+
+  // Remember the generation of each handle, so that the frame is not delivered to another client
+  // re-using the same handle in the meantime.
+  out.clear();
+  for(const auto& entry : m_dueClients) {
+    out.push_back({entry, m_generations[entry.handle]});
+  }
+}
+
+irsol::types::timepoint_t
+FrameCollector::firstHarmonicDue(uint64_t ticksPerFrame, irsol::types::timepoint_t now)
+{
+  const bool streaming =
+    std::any_of(m_clients.begin(), m_clients.end(), [](const auto& clientParams) {
+      return clientParams && !clientParams->immediate && !clientParams->burst;
+    });
+  if(!streaming) {
+    // Nothing to align with: restart the cadence, so that the client is served on tick 0. Clients
+    // registering at about the same time share their first capture, as in just-in-time mode.
+    m_harmonicEpoch = now + REGISTRATION_DELAY;
+    return m_harmonicEpoch;
+  }
+
+  // The running clients are due on the multiples of their own number of ticks per frame. As all
+  // these numbers are powers of two, the ticks of the slower clients are ticks of the faster ones.
+  const auto elapsedTicks =
+    now <= m_harmonicEpoch
+      ? uint64_t{0}
+      : static_cast<uint64_t>(
+          std::ceil(std::chrono::duration<double>(now - m_harmonicEpoch) / HARMONIC_TICK));
+  const auto tick = (elapsedTicks + ticksPerFrame - 1) / ticksPerFrame * ticksPerFrame;
+  return m_harmonicEpoch + HARMONIC_TICK * static_cast<int64_t>(tick);
+}
+
+irsol::types::duration_t
+FrameCollector::collectBatch(irsol::types::timepoint_t now, std::vector<ReadyClient>& out)
+{
+  if(m_mode == CollectionMode::HARMONIC) {
+    // The clients sharing a tick have the very same due time: no slack is needed to batch them.
+    collectReadyClients(now, irsol::types::duration_t::zero(), out);
+    return irsol::types::duration_t::zero();
+  }
+  if(m_handles.size() == 1) {
+    // A single client can't share its captures: serve it on time.
+    collectReadyClients(now, irsol::types::duration_t::zero(), out);
+    return irsol::types::duration_t::zero();
+  }
+
+  const auto               captureDuration = expectedCaptureDuration();
+  irsol::types::duration_t maxSlack{};
+  for(const auto& clientParams : m_clients) {
+    if(clientParams) {
+      maxSlack = std::max(maxSlack, slackOf(*clientParams, captureDuration));
     }
   }
+  collectReadyClients(now, maxSlack, out);
 
-  return {readyClients, clientsSchedule};
+  // Put back in the schedule the clients that would be served too early for their own rate.
+  auto last = std::remove_if(out.begin(), out.end(), [&](const ReadyClient& client) {
+    const auto& clientParams = *m_clients[client.entry.handle];
+    if(client.entry.due <= now + slackOf(clientParams, captureDuration)) {
+      return false;
+    }
+    m_scheduler.schedule(client.entry.handle, client.entry.due);
+    return true;
+  });
+  out.erase(last, out.end());
+  return maxSlack;
+}
+
+irsol::types::duration_t
+FrameCollector::slackOf(
+  const ClientCollectionParams& clientParams,
+  irsol::types::duration_t      captureDuration)
+{
+  const auto interval = std::chrono::duration_cast<irsol::types::duration_t>(clientParams.interval);
+  const auto fraction = std::chrono::duration_cast<irsol::types::duration_t>(
+    interval * FrameCollector::MAX_EARLY_FRACTION);
+  return std::min(std::max(fraction, captureDuration), interval / 2);
+}
+
+irsol::types::duration_t
+FrameCollector::expectedCaptureDuration() const
+{
+  return std::max(m_source->exposure(), m_captureDuration);
 }
 
 void
-FrameCollector::cleanUpSchedule(const std::vector<irsol::types::timepoint_t> schedules)
+FrameCollector::rescheduleAhead(std::vector<ReadyClient>& clients)
 {
-  // Erase all the schedules in the input vector
-  for(auto schedule : schedules) {
-    m_scheduleMap.erase(schedule);
+  for(auto& client : clients) {
+    auto& clientParams = *m_clients[client.entry.handle];
+    if(clientParams.remainingFrames == 0) {
+      // Last frame of the client.
+      continue;
+    }
+    schedule(client.entry.handle, clientParams.nextFrameDue + clientParams.interval);
+    client.rescheduled = true;
   }
 }
 
-std::optional<std::pair<FrameMetadata, std::vector<irsol::types::byte_t>>>
-FrameCollector::grabImageData() const
+void
+FrameCollector::rescheduleFailed(const std::vector<ReadyClient>& clients)
 {
-  // Capture the frame just-in-time
-  IRSOL_MAYBE_UNUSED auto t0    = irsol::types::clock_t::now();
-  auto                    image = m_cam.captureImage();
-  IRSOL_MAYBE_UNUSED auto t1    = irsol::types::clock_t::now();
-  IRSOL_NAMED_LOG_DEBUG(
-    "frame_collector",
-    "Capture image: start: {}, stop: {}, duration: {}",
-    irsol::utils::timestampToString(t0),
-    irsol::utils::timestampToString(t1),
-    irsol::utils::durationToString(t1 - t0));
-
-  // Extract the image data from the image buffer, and copy it into an
-  // owning structure. In this way, when `image` is destroyed at the end of the
-  // execution of this function, it can return into the pool of NeoAPI::Images
-  // for next frames to be written to the buffer.
-  auto* imageData = image.GetImageData();
-  auto  numBytes  = image.GetSize();
-
-  if(numBytes == 0) {
-    return std::nullopt;
+  for(const auto& client : clients) {
+    if(!isRegistered(client)) {
+      continue;
+    }
+    if(client.rescheduled) {
+      // The failed frame was already counted for the client.
+      auto& clientParams        = *m_clients[client.entry.handle];
+      clientParams.nextFrameDue = client.entry.due;
+      if(clientParams.remainingFrames >= 0) {
+        ++clientParams.remainingFrames;
+      }
+    }
+    m_scheduler.schedule(client.entry.handle, client.entry.due);
   }
+  m_scheduleCondition.notify_one();
+}
 
-  std::vector<irsol::types::byte_t> rawData(numBytes);
-  std::memcpy(rawData.data(), imageData, numBytes);
+bool
+FrameCollector::isRegistered(const ReadyClient& client) const
+{
+  const auto handle = client.entry.handle;
+  return handle < m_clients.size() && m_clients[handle].has_value() &&
+         m_generations[handle] == client.generation;
+}
 
-  return std::make_pair<FrameMetadata, std::vector<irsol::types::byte_t>>(
-    {irsol::types::clock_t::now(), image.GetImageID(), image.GetHeight(), image.GetWidth()},
-    std::move(rawData));
+void
+FrameCollector::logSlackUsage(
+  IRSOL_MAYBE_UNUSED const std::vector<ReadyClient>& clients,
+  IRSOL_MAYBE_UNUSED irsol::types::duration_t        slack) const
+{
+  // The ready clients are ordered by due time: the ones scheduled after the first one are served
+  // earlier than requested thanks to the allowed slack.
+  IRSOL_MAYBE_UNUSED const auto nextDue = clients.front().entry.due;
+  IRSOL_MAYBE_UNUSED auto       numSlackClients =
+    std::count_if(clients.begin(), clients.end(), [nextDue](const auto& client) {
+      return client.entry.due != nextDue;
+    });
+  if(numSlackClients > 0) {
+    IRSOL_NAMED_LOG_WARN(
+      "frame_collector_slack",
+      "Actual schedule: {}, also considering {} clients scheduled up to {} due to allowed "
+      "slack of {}",
+      irsol::utils::timestampToString(nextDue),
+      numSlackClients,
+      irsol::utils::timestampToString(clients.back().entry.due),
+      irsol::utils::durationToString(slack));
+  }
 }
 
 bool
-FrameCollector::schedule(
-  const irsol::types::client_id_t& clientId,
-  irsol::types::timepoint_t        nextFrameDue)
+FrameCollector::schedule(client_handle_t handle, irsol::types::timepoint_t nextFrameDue)
 {
   IRSOL_ASSERT_ERROR(
-    m_clients.find(clientId) != m_clients.end(), "Impossible to schedule an unregistered client.");
+    handle < m_clients.size() && m_clients[handle].has_value(),
+    "Impossible to schedule an unregistered client.");
   // Update the parameters of the client.
-  auto& clientParams = m_clients.at(clientId);
+  auto& clientParams = *m_clients[handle];
   if(clientParams.remainingFrames-- == 0 && clientParams.remainingFrames < 0) {
     // Client no longer expects frames.
     // This handles also clients that are listening forever, as their 'remainingFrames' is negative
     // so this¨ condition is never fully met.
     IRSOL_NAMED_LOG_DEBUG(
-      "frame_collector", "Client {} had no longer frames to produce.", clientId);
+      "frame_collector", "Client {} had no longer frames to produce.", clientParams.clientId);
     return false;
   }
 
@@ -403,14 +1034,14 @@ FrameCollector::schedule(
     IRSOL_NAMED_LOG_DEBUG(
       "frame_collector",
       "Client {} has been scheduled for timestamp {}.",
-      clientId,
+      clientParams.clientId,
       irsol::utils::timestampToString(clientParams.nextFrameDue));
   } else {
 
     IRSOL_NAMED_LOG_DEBUG(
       "frame_collector",
       "(Rescheduling client {} for next frame, previous due: {}, next due {}, # count {}",
-      clientId,
+      clientParams.clientId,
       irsol::utils::timestampToString(clientParams.nextFrameDue),
       irsol::utils::timestampToString(nextFrameDue),
       clientParams.remainingFrames);
@@ -420,7 +1051,7 @@ FrameCollector::schedule(
   clientParams.nextFrameDue = nextFrameDue;
 
   // Registers the client for the scheduled timestamp.
-  m_scheduleMap[nextFrameDue].push_back(clientId);
+  m_scheduler.schedule(handle, nextFrameDue);
 
   // Notify the condition variable, that a new client has been scheduled
   m_scheduleCondition.notify_one();
@@ -429,4 +1060,4 @@ FrameCollector::schedule(
 
 }  // namespace frame_collector
 }  // namespace server
-}  // namespace irsol
\ No newline at end of file
+}  // namespace irsol
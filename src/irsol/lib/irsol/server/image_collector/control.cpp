@@ -0,0 +1,46 @@
+#include "irsol/server/image_collector/control.hpp"
+
+namespace irsol {
+namespace server {
+namespace frame_collector {
+
+size_t
+ControlQueue::runPending()
+{
+  std::scoped_lock<std::mutex> runLock(m_runMutex);
+
+  std::deque<Entry> pending;
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    pending.swap(m_pending);
+    m_size.store(0);
+  }
+  // The operations are executed without holding the lock, so that new operations can be queued
+  // (and not coalesced into the ones being executed) in the meantime.
+  for(auto& entry : pending) {
+    entry.request->execute();
+  }
+  return pending.size();
+}
+
+bool
+ControlQueue::empty() const
+{
+  return m_size.load() == 0;
+}
+
+size_t
+ControlQueue::size() const
+{
+  return m_size.load();
+}
+
+uint64_t
+ControlQueue::numCoalesced() const
+{
+  return m_numCoalesced.load();
+}
+
+}  // namespace frame_collector
+}  // namespace server
+}  // namespace irsol
@@ -0,0 +1,19 @@
+#include "irsol/server/image_collector/frame.hpp"
+
+namespace irsol {
+namespace server {
+namespace frame_collector {
+
+std::shared_ptr<const irsol::protocol::internal::SerializedMessage>
+Frame::serialized() const
+{
+  std::call_once(m_serializeOnce, [this]() {
+    m_serialized = std::make_shared<const irsol::protocol::internal::SerializedMessage>(
+      irsol::protocol::Serializer::serialize(irsol::protocol::OutMessage(image.share())));
+  });
+  return m_serialized;
+}
+
+}  // namespace frame_collector
+}  // namespace server
+}  // namespace irsol
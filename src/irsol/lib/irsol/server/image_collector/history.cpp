@@ -0,0 +1,123 @@
+#include "irsol/server/image_collector/history.hpp"
+
+#include "irsol/logging.hpp"
+
+namespace irsol {
+namespace server {
+namespace frame_collector {
+
+FrameHistory::FrameHistory(size_t capacity): m_frames(capacity) {}
+
+void
+FrameHistory::add(frame_ptr_t frame)
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  if(m_frames.empty() || !frame) {
+    return;
+  }
+
+  if(m_size > 0) {
+    const auto& newest = m_frames[positionOf(m_size - 1)];
+    if(frame->metadata.frameId <= newest->metadata.frameId) {
+      IRSOL_NAMED_LOG_INFO(
+        "frame_history",
+        "Frame {} does not follow frame {}, discarding the history",
+        frame->metadata.frameId,
+        newest->metadata.frameId);
+      clearNonThreadSafe();
+    }
+  }
+
+  if(m_size < m_frames.size()) {
+    m_frames[positionOf(m_size)] = std::move(frame);
+    ++m_size;
+  } else {
+    // Overwrite the oldest frame, releasing it.
+    m_frames[m_oldest] = std::move(frame);
+    m_oldest           = (m_oldest + 1) % m_frames.size();
+  }
+}
+
+FrameHistory::frame_ptr_t
+FrameHistory::latest(irsol::types::duration_t maxAge, irsol::types::timepoint_t now) const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  if(m_size == 0) {
+    return nullptr;
+  }
+  const auto& newest = m_frames[positionOf(m_size - 1)];
+  return newest->metadata.timestamp + maxAge >= now ? newest : nullptr;
+}
+
+std::vector<FrameHistory::frame_ptr_t>
+FrameHistory::since(uint64_t frameId) const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  std::vector<frame_ptr_t>     result;
+  for(size_t i = 0; i < m_size; ++i) {
+    const auto& frame = m_frames[positionOf(i)];
+    if(frame->metadata.frameId > frameId) {
+      result.push_back(frame);
+    }
+  }
+  return result;
+}
+
+FrameHistory::frame_ptr_t
+FrameHistory::nearest(irsol::types::timepoint_t timestamp) const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  frame_ptr_t                  result;
+  irsol::types::duration_t     bestDistance = irsol::types::duration_t::max();
+  for(size_t i = 0; i < m_size; ++i) {
+    const auto& frame    = m_frames[positionOf(i)];
+    const auto  distance = frame->metadata.timestamp > timestamp
+                             ? frame->metadata.timestamp - timestamp
+                             : timestamp - frame->metadata.timestamp;
+    if(distance < bestDistance) {
+      bestDistance = distance;
+      result       = frame;
+    }
+  }
+  return result;
+}
+
+size_t
+FrameHistory::capacity() const
+{
+  return m_frames.size();
+}
+
+size_t
+FrameHistory::size() const
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_size;
+}
+
+void
+FrameHistory::clear()
+{
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  clearNonThreadSafe();
+}
+
+size_t
+FrameHistory::positionOf(size_t i) const
+{
+  return (m_oldest + i) % m_frames.size();
+}
+
+void
+FrameHistory::clearNonThreadSafe()
+{
+  for(auto& frame : m_frames) {
+    frame.reset();
+  }
+  m_oldest = 0;
+  m_size   = 0;
+}
+
+}  // namespace frame_collector
+}  // namespace server
+}  // namespace irsol
@@ -0,0 +1,154 @@
+#include "irsol/server/image_collector/scheduler.hpp"
+
+#include "irsol/assert.hpp"
+
+#include <utility>
+
+namespace irsol {
+namespace server {
+namespace frame_collector {
+
+void
+Scheduler::reserve(size_t numHandles)
+{
+  m_heap.reserve(numHandles);
+  if(m_positions.size() < numHandles) {
+    m_positions.resize(numHandles, NOT_SCHEDULED);
+  }
+}
+
+void
+Scheduler::schedule(client_handle_t handle, irsol::types::timepoint_t due)
+{
+  if(handle >= m_positions.size()) {
+    m_positions.resize(static_cast<size_t>(handle) + 1, NOT_SCHEDULED);
+  }
+
+  auto index = m_positions[handle];
+  if(index == NOT_SCHEDULED) {
+    m_heap.push_back({due, handle});
+    m_positions[handle] = m_heap.size() - 1;
+    siftUp(m_heap.size() - 1);
+    return;
+  }
+
+  // Update of an existing schedule: move the entry up or down depending on the new due time.
+  auto previousDue  = m_heap[index].due;
+  m_heap[index].due = due;
+  if(due < previousDue) {
+    siftUp(index);
+  } else {
+    siftDown(index);
+  }
+}
+
+bool
+Scheduler::remove(client_handle_t handle)
+{
+  if(!contains(handle)) {
+    return false;
+  }
+  removeAt(m_positions[handle]);
+  return true;
+}
+
+bool
+Scheduler::contains(client_handle_t handle) const
+{
+  return handle < m_positions.size() && m_positions[handle] != NOT_SCHEDULED;
+}
+
+irsol::types::timepoint_t
+Scheduler::nextDue() const
+{
+  IRSOL_ASSERT_ERROR(!m_heap.empty(), "Requested next due time of an empty schedule");
+  return m_heap.front().due;
+}
+
+size_t
+Scheduler::popDue(irsol::types::timepoint_t limit, std::vector<Entry>& out)
+{
+  size_t numPopped = 0;
+  while(!m_heap.empty() && m_heap.front().due <= limit) {
+    out.push_back(m_heap.front());
+    removeAt(0);
+    ++numPopped;
+  }
+  return numPopped;
+}
+
+size_t
+Scheduler::size() const
+{
+  return m_heap.size();
+}
+
+bool
+Scheduler::empty() const
+{
+  return m_heap.empty();
+}
+
+void
+Scheduler::siftUp(size_t index)
+{
+  while(index > 0) {
+    auto parent = (index - 1) / 2;
+    if(!(m_heap[index].due < m_heap[parent].due)) {
+      break;
+    }
+    swapEntries(index, parent);
+    index = parent;
+  }
+}
+
+void
+Scheduler::siftDown(size_t index)
+{
+  const auto size = m_heap.size();
+  while(true) {
+    auto smallest = index;
+    auto left     = 2 * index + 1;
+    auto right    = left + 1;
+    if(left < size && m_heap[left].due < m_heap[smallest].due) {
+      smallest = left;
+    }
+    if(right < size && m_heap[right].due < m_heap[smallest].due) {
+      smallest = right;
+    }
+    if(smallest == index) {
+      return;
+    }
+    swapEntries(index, smallest);
+    index = smallest;
+  }
+}
+
+void
+Scheduler::swapEntries(size_t lhs, size_t rhs)
+{
+  std::swap(m_heap[lhs], m_heap[rhs]);
+  m_positions[m_heap[lhs].handle] = lhs;
+  m_positions[m_heap[rhs].handle] = rhs;
+}
+
+void
+Scheduler::removeAt(size_t index)
+{
+  const auto last = m_heap.size() - 1;
+  if(index != last) {
+    swapEntries(index, last);
+  }
+  m_positions[m_heap.back().handle] = NOT_SCHEDULED;
+  m_heap.pop_back();
+
+  if(index < m_heap.size()) {
+    // The entry moved into the hole may need to go either up or down.
+    siftUp(index);
+    siftDown(index);
+  }
+}
+
+}  // namespace frame_collector
+}  // namespace server
+}  // namespace irsol
@@ -0,0 +1,664 @@
+#include "irsol/server/image_collector/source.hpp"
+
+#include "irsol/logging.hpp"
+#include "irsol/macros.hpp"
+#include "irsol/utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace irsol {
+namespace server {
+namespace frame_collector {
+
+void
+BurstBuffers::reserve(size_t numBytes, size_t numFrames)
+{
+  std::shared_ptr<irsol::utils::BufferPool> pool;
+  size_t                                    numReserved;
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    if(!m_pool) {
+      m_pool      = std::make_shared<irsol::utils::BufferPool>();
+      m_numFrames = 0;
+    }
+    m_numFrames += numFrames;
+    pool        = m_pool;
+    numReserved = m_numFrames;
+  }
+  // Allocate without holding the lock, so that the frames of a burst already in progress are
+  // still acquired meanwhile.
+  pool->reserve(numBytes, numReserved);
+}
+
+void
+BurstBuffers::release()
+{
+  std::shared_ptr<irsol::utils::BufferPool> pool;
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    pool = std::move(m_pool);
+  }
+  if(pool) {
+    IRSOL_NAMED_LOG_DEBUG(
+      "frame_collector",
+      "Releasing the buffers of the bursts, {} of {} already available",
+      pool->numAvailable(),
+      pool->numBuffers());
+  }
+}
+
+irsol::utils::BufferPool::buffer_t
+BurstBuffers::acquire(size_t numBytes)
+{
+  std::shared_ptr<irsol::utils::BufferPool> pool;
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    pool = m_pool;
+  }
+  return pool ? pool->acquire(numBytes) : nullptr;
+}
+
+FrameSource::capture_future_t
+FrameSource::submitCapture()
+{
+  std::promise<captured_frame_t> capture;
+  capture.set_value(captureSingle());
+  return capture.get_future();
+}
+
+void
+FrameSource::reserveFrames(IRSOL_MAYBE_UNUSED size_t numFrames)
+{}
+
+void
+FrameSource::releaseFrames()
+{}
+
+CameraFrameSource::CameraFrameSource(
+  irsol::camera::Interface& camera,
+  irsol::utils::BufferPool& pool)
+  : m_cam(camera), m_pool(pool)
+{}
+
+CameraFrameSource::~CameraFrameSource()
+{
+  stopCaptures();
+}
+
+FrameSource::captured_frame_t
+CameraFrameSource::captureSingle()
+{
+  // Capture the frame just-in-time
+  IRSOL_MAYBE_UNUSED auto t0    = irsol::types::clock_t::now();
+  auto                    image = m_cam.captureImage();
+  IRSOL_MAYBE_UNUSED auto t1    = irsol::types::clock_t::now();
+  IRSOL_NAMED_LOG_DEBUG(
+    "frame_collector",
+    "Capture image: start: {}, stop: {}, duration: {}",
+    irsol::utils::timestampToString(t0),
+    irsol::utils::timestampToString(t1),
+    irsol::utils::durationToString(t1 - t0));
+  return extract(image);
+}
+
+FrameSource::capture_future_t
+CameraFrameSource::submitCapture()
+{
+  std::scoped_lock<std::mutex> triggeredLock(m_triggeredMutex);
+  if(!m_triggered) {
+    // The camera stays armed until the captures are stopped, and pushes the images as soon as
+    // they are read out.
+    const auto timing    = m_cam.triggerTiming();
+    m_maxPendingCaptures = timing.maxPendingTriggers();
+    m_triggerInterval    = timing.triggerInterval().count();
+    m_cam.startTriggeredAcquisition(
+      [this](const irsol::camera::Interface::image_t& image) { onImage(image); });
+    m_triggered = true;
+  }
+
+  capture_future_t future;
+  {
+    std::scoped_lock<std::mutex> lock(m_pendingMutex);
+    m_pendingCaptures.emplace_back();
+    future = m_pendingCaptures.back().get_future();
+  }
+  m_cam.submitTrigger();
+  return future;
+}
+
+size_t
+CameraFrameSource::maxPendingCaptures() const
+{
+  return m_maxPendingCaptures.load();
+}
+
+irsol::types::duration_t
+CameraFrameSource::triggerInterval() const
+{
+  return irsol::types::duration_t(m_triggerInterval.load());
+}
+
+void
+CameraFrameSource::stopCaptures()
+{
+  std::scoped_lock<std::mutex> triggeredLock(m_triggeredMutex);
+  if(m_triggered) {
+    // Once stopped, no more images are pushed by the camera.
+    m_cam.stopTriggeredAcquisition();
+    m_triggered = false;
+  }
+
+  std::scoped_lock<std::mutex> lock(m_pendingMutex);
+  for(auto& capture : m_pendingCaptures) {
+    capture.set_value(std::nullopt);
+  }
+  m_pendingCaptures.clear();
+}
+
+void
+CameraFrameSource::onImage(const irsol::camera::Interface::image_t& image)
+{
+  // Extracted before taking the lock, so that new captures can be submitted meanwhile.
+  irsol::camera::Interface::image_t received = image;
+  auto                              captured = extract(received);
+
+  std::scoped_lock<std::mutex> lock(m_pendingMutex);
+  if(m_pendingCaptures.empty()) {
+    IRSOL_NAMED_LOG_WARN(
+      "frame_collector", "Received image {} without pending capture", image.GetImageID());
+    return;
+  }
+  m_pendingCaptures.front().set_value(std::move(captured));
+  m_pendingCaptures.pop_front();
+}
+
+void
+CameraFrameSource::startContinuous(double fps)
+{
+  m_cam.startContinuousAcquisition(fps);
+  m_continuousPeriod = fps > 0.0 ? std::chrono::duration_cast<irsol::types::duration_t>(
+                                     std::chrono::duration<double>(1.0 / fps))
+                                 : irsol::types::duration_t::zero();
+}
+
+FrameSource::captured_frame_t
+CameraFrameSource::nextContinuous()
+{
+  const auto timeout  = m_continuousPeriod + m_cam.cachedExposure() + CONTINUOUS_TIMEOUT_MARGIN;
+  auto       now      = irsol::types::clock_t::now();
+  const auto deadline = now + timeout;
+  while(now < deadline) {
+    // Polls that time out are expected while the camera is idle between two frames.
+    auto image = m_cam.grabContinuousImage(std::min(deadline - now, CONTINUOUS_POLL_INTERVAL));
+    if(!image.IsEmpty() && image.GetSize() > 0) {
+      return extract(image);
+    }
+    now = irsol::types::clock_t::now();
+  }
+  IRSOL_NAMED_LOG_WARN(
+    "frame_collector",
+    "No frame received within {} during continuous acquisition",
+    irsol::utils::durationToString(timeout));
+  return std::nullopt;
+}
+
+void
+CameraFrameSource::stopContinuous()
+{
+  m_cam.stopContinuousAcquisition();
+}
+
+void
+CameraFrameSource::reserveFrames(size_t numFrames)
+{
+  m_burstBuffers.reserve(static_cast<size_t>(m_cam.getParam<int64_t>("PayloadSize")), numFrames);
+}
+
+void
+CameraFrameSource::releaseFrames()
+{
+  m_burstBuffers.release();
+}
+
+irsol::types::duration_t
+CameraFrameSource::exposure() const
+{
+  return m_cam.cachedExposure();
+}
+
+FrameSource::captured_frame_t
+CameraFrameSource::extract(irsol::camera::Interface::image_t& image)
+{
+  auto* imageData = image.GetImageData();
+  auto  numBytes  = image.GetSize();
+
+  if(numBytes == 0) {
+    return std::nullopt;
+  }
+
+  // Stamp the frame with the exposure time, as measured by the camera clock.
+  FrameMetadata metadata{
+    m_cam.imageTimestamp(image), image.GetImageID(), image.GetHeight(), image.GetWidth()};
+
+  // The frames of a burst are held for long: they are copied out of the user buffers, into the
+  // buffers reserved for them.
+  auto rawData = m_burstBuffers.acquire(numBytes);
+  if(!rawData) {
+    // Zero-copy path: the frame keeps the user buffer (and the image) alive.
+    if(auto sharedData = m_cam.shareImageData(image)) {
+      return captured_data_t(std::move(metadata), std::move(sharedData));
+    }
+    rawData = m_pool.acquire(numBytes);
+  }
+  std::memcpy(rawData->data(), imageData, numBytes);
+
+  return captured_data_t(std::move(metadata), std::move(rawData));
+}
+
+SimulatedFrameSource::SimulatedFrameSource(
+  uint64_t                  height,
+  uint64_t                  width,
+  double                    maxFps,
+  irsol::utils::BufferPool& pool)
+  : m_height(height)
+  , m_width(width)
+  , m_minPeriod(std::chrono::duration_cast<irsol::types::duration_t>(
+      std::chrono::duration<double>(1.0 / maxFps)))
+  , m_pool(pool)
+{
+  IRSOL_ASSERT_ERROR(maxFps > 0.0, "Simulated frame source requires a positive maximum rate");
+}
+
+SimulatedFrameSource::~SimulatedFrameSource()
+{
+  stopCaptures();
+}
+
+FrameSource::captured_frame_t
+SimulatedFrameSource::captureSingle()
+{
+  // A triggered capture lasts a full frame period.
+  std::this_thread::sleep_for(m_minPeriod);
+  ++m_numSingleCaptures;
+  return makeFrame();
+}
+
+FrameSource::capture_future_t
+SimulatedFrameSource::submitCapture()
+{
+  std::scoped_lock<std::mutex> stateLock(m_captureStateMutex);
+  if(!m_captureThread.joinable()) {
+    m_captureThread = std::thread(&SimulatedFrameSource::runCaptures, this);
+  }
+
+  std::scoped_lock<std::mutex> lock(m_captureMutex);
+  m_pendingCaptures.emplace_back();
+  m_captureCondition.notify_one();
+  return m_pendingCaptures.back().get_future();
+}
+
+size_t
+SimulatedFrameSource::maxPendingCaptures() const
+{
+  return m_maxPendingCaptures;
+}
+
+void
+SimulatedFrameSource::stopCaptures()
+{
+  std::scoped_lock<std::mutex> stateLock(m_captureStateMutex);
+  if(m_captureThread.joinable()) {
+    {
+      std::scoped_lock<std::mutex> lock(m_captureMutex);
+      m_stopCaptures = true;
+    }
+    m_captureCondition.notify_one();
+    m_captureThread.join();
+  }
+
+  std::scoped_lock<std::mutex> lock(m_captureMutex);
+  m_stopCaptures = false;
+  for(auto& capture : m_pendingCaptures) {
+    capture.set_value(std::nullopt);
+  }
+  m_pendingCaptures.clear();
+}
+
+void
+SimulatedFrameSource::setMaxPendingCaptures(size_t numCaptures)
+{
+  IRSOL_ASSERT_ERROR(numCaptures > 0, "At least one capture must be allowed to be pending");
+  m_maxPendingCaptures = numCaptures;
+}
+
+void
+SimulatedFrameSource::runCaptures()
+{
+  std::unique_lock<std::mutex> lock(m_captureMutex);
+  while(true) {
+    m_captureCondition.wait(
+      lock, [this]() { return m_stopCaptures || !m_pendingCaptures.empty(); });
+    // A triggered capture lasts a full frame period, and the next pending one starts right after.
+    const auto completion = irsol::types::clock_t::now() + m_minPeriod;
+    if(m_captureCondition.wait_until(lock, completion, [this]() { return m_stopCaptures; })) {
+      return;
+    }
+    ++m_numSingleCaptures;
+    m_pendingCaptures.front().set_value(makeFrame());
+    m_pendingCaptures.pop_front();
+  }
+}
+
+void
+SimulatedFrameSource::startContinuous(double fps)
+{
+  m_period = m_minPeriod;
+  if(fps > 0.0) {
+    m_period = std::max(
+      m_minPeriod,
+      std::chrono::duration_cast<irsol::types::duration_t>(
+        std::chrono::duration<double>(1.0 / fps)));
+  }
+  m_nextTick = irsol::types::clock_t::now() + m_period;
+  m_continuousFps.store(fps);
+  ++m_numContinuousStarts;
+  IRSOL_NAMED_LOG_DEBUG(
+    "simulated_source",
+    "Started continuous acquisition with period {}",
+    irsol::utils::durationToString(m_period));
+}
+
+FrameSource::captured_frame_t
+SimulatedFrameSource::nextContinuous()
+{
+  IRSOL_ASSERT_ERROR(m_period.count() > 0, "Continuous acquisition was not started");
+  std::this_thread::sleep_until(m_nextTick);
+  // Frames are produced on a regular grid: skip the ticks that were missed by a slow consumer,
+  // as a camera would drop them.
+  auto now = irsol::types::clock_t::now();
+  while(m_nextTick <= now) {
+    m_nextTick += m_period;
+  }
+  return makeFrame();
+}
+
+void
+SimulatedFrameSource::stopContinuous()
+{
+  m_continuousFps.store(0.0);
+  m_period = irsol::types::duration_t::zero();
+}
+
+void
+SimulatedFrameSource::reserveFrames(size_t numFrames)
+{
+  m_burstBuffers.reserve(m_height * m_width * sizeof(uint16_t), numFrames);
+}
+
+void
+SimulatedFrameSource::releaseFrames()
+{
+  m_burstBuffers.release();
+}
+
+irsol::types::duration_t
+SimulatedFrameSource::exposure() const
+{
+  return m_minPeriod;
+}
+
+uint64_t
+SimulatedFrameSource::numSingleCaptures() const
+{
+  return m_numSingleCaptures.load();
+}
+
+uint64_t
+SimulatedFrameSource::numContinuousStarts() const
+{
+  return m_numContinuousStarts.load();
+}
+
+double
+SimulatedFrameSource::continuousFps() const
+{
+  return m_continuousFps.load();
+}
+
+void
+SimulatedFrameSource::useUserBuffers(size_t numBuffers)
+{
+  m_userBuffers.reset();
+  m_userBufferDriver = std::make_unique<irsol::camera::SimulatedUserBufferDriver>();
+  m_userBuffers      = std::make_unique<irsol::camera::UserBufferRing>(
+    *m_userBufferDriver, numBuffers, m_height * m_width * sizeof(uint16_t));
+}
+
+const irsol::camera::SimulatedUserBufferDriver*
+SimulatedFrameSource::userBufferDriver() const
+{
+  return m_userBufferDriver.get();
+}
+
+FrameSource::captured_frame_t
+SimulatedFrameSource::makeFrame()
+{
+  const uint64_t frameId = m_nextFrameId++;
+  // Mono12 pixels, stored on 2 bytes.
+  const auto pixelValue = static_cast<uint16_t>(frameId & 0x0fff);
+  const auto numBytes   = m_height * m_width * sizeof(uint16_t);
+
+  irsol::types::byte_t*                       data = nullptr;
+  irsol::protocol::ImageBinaryData::storage_t storage;
+  if(auto reserved = m_burstBuffers.acquire(numBytes)) {
+    data    = reserved->data();
+    storage = std::move(reserved);
+  } else if(m_userBuffers) {
+    auto acquisition = m_userBufferDriver->acquire();
+    if(!acquisition) {
+      IRSOL_NAMED_LOG_WARN(
+        "simulated_source", "No user buffer available, dropping frame {}", frameId);
+      return std::nullopt;
+    }
+    // The storage is read-only for the clients: the frame is written via the driver-side buffer.
+    data    = acquisition->buffer->data();
+    storage = m_userBuffers->wrap(acquisition->buffer, std::move(acquisition->lease));
+  } else {
+    auto rawData = m_pool.acquire(numBytes);
+    data         = rawData->data();
+    storage      = std::move(rawData);
+  }
+
+  for(size_t i = 0; i < numBytes; i += sizeof(uint16_t)) {
+    std::memcpy(data + i, &pixelValue, sizeof(uint16_t));
+  }
+  return captured_data_t(
+    {irsol::types::clock_t::now(), frameId, m_height, m_width}, std::move(storage));
+}
+
+SimulatedCameraFrameSource::SimulatedCameraFrameSource(
+  irsol::camera::SimulatedCamera& camera,
+  irsol::utils::BufferPool&       pool)
+  : m_cam(camera), m_pool(pool)
+{}
+
+SimulatedCameraFrameSource::~SimulatedCameraFrameSource()
+{
+  stopCaptures();
+}
+
+FrameSource::captured_frame_t
+SimulatedCameraFrameSource::captureSingle()
+{
+  return extract(m_cam.captureSingle());
+}
+
+FrameSource::capture_future_t
+SimulatedCameraFrameSource::submitCapture()
+{
+  std::scoped_lock<std::mutex> triggeredLock(m_triggeredMutex);
+  if(!m_triggered) {
+    m_cam.startTriggered(
+      [this](const irsol::camera::SimulatedCamera::Frame& frame) { onFrame(frame); });
+    m_triggered = true;
+  }
+
+  capture_future_t future;
+  {
+    std::scoped_lock<std::mutex> lock(m_pendingMutex);
+    m_pendingCaptures.emplace_back();
+    future = m_pendingCaptures.back().get_future();
+  }
+  if(!m_cam.submitTrigger()) {
+    // No frame comes for a skipped trigger. As submissions are serialized, the capture of the
+    // trigger is still the last pending one.
+    std::scoped_lock<std::mutex> lock(m_pendingMutex);
+    m_pendingCaptures.back().set_value(std::nullopt);
+    m_pendingCaptures.pop_back();
+  }
+  return future;
+}
+
+size_t
+SimulatedCameraFrameSource::maxPendingCaptures() const
+{
+  return m_cam.triggerTiming().maxPendingTriggers();
+}
+
+irsol::types::duration_t
+SimulatedCameraFrameSource::triggerInterval() const
+{
+  return m_cam.triggerTiming().triggerInterval();
+}
+
+void
+SimulatedCameraFrameSource::stopCaptures()
+{
+  std::scoped_lock<std::mutex> triggeredLock(m_triggeredMutex);
+  if(m_triggered) {
+    m_cam.stopTriggered();
+    m_triggered = false;
+  }
+
+  std::scoped_lock<std::mutex> lock(m_pendingMutex);
+  for(auto& capture : m_pendingCaptures) {
+    capture.set_value(std::nullopt);
+  }
+  m_pendingCaptures.clear();
+}
+
+void
+SimulatedCameraFrameSource::onFrame(const irsol::camera::SimulatedCamera::Frame& frame)
+{
+  // Rendered before taking the lock, so that new captures can be submitted meanwhile.
+  auto captured = extract(frame);
+
+  std::scoped_lock<std::mutex> lock(m_pendingMutex);
+  if(m_pendingCaptures.empty()) {
+    IRSOL_NAMED_LOG_WARN(
+      "frame_collector", "Received frame {} without pending capture", frame.frameId);
+    return;
+  }
+  m_pendingCaptures.front().set_value(std::move(captured));
+  m_pendingCaptures.pop_front();
+}
+
+void
+SimulatedCameraFrameSource::startContinuous(double fps)
+{
+  m_cam.startContinuous(fps);
+}
+
+FrameSource::captured_frame_t
+SimulatedCameraFrameSource::nextContinuous()
+{
+  return extract(m_cam.nextContinuous());
+}
+
+void
+SimulatedCameraFrameSource::stopContinuous()
+{
+  m_cam.stopContinuous();
+}
+
+void
+SimulatedCameraFrameSource::reserveFrames(size_t numFrames)
+{
+  // Mono12 pixels, stored on 2 bytes.
+  const auto numPixels = m_cam.getIntParam("Width") * m_cam.getIntParam("Height");
+  m_burstBuffers.reserve(static_cast<size_t>(numPixels) * sizeof(uint16_t), numFrames);
+}
+
+void
+SimulatedCameraFrameSource::releaseFrames()
+{
+  m_burstBuffers.release();
+}
+
+irsol::types::duration_t
+SimulatedCameraFrameSource::exposure() const
+{
+  return m_cam.cachedExposure();
+}
+
+FrameSource::captured_frame_t
+SimulatedCameraFrameSource::extract(const irsol::camera::SimulatedCamera::Frame& frame)
+{
+  auto rawData = m_burstBuffers.acquire(frame.numBytes());
+  if(!rawData) {
+    rawData = m_pool.acquire(frame.numBytes());
+  }
+  irsol::camera::SimulatedCamera::render(frame, rawData->data());
+  return captured_data_t(
+    {frame.timestamp, frame.frameId, frame.height, frame.width}, std::move(rawData));
+}
+
+ReplayFrameSource::ReplayFrameSource(irsol::camera::ReplayCamera& camera): m_cam(camera) {}
+
+FrameSource::captured_frame_t
+ReplayFrameSource::captureSingle()
+{
+  return replayNext();
+}
+
+void
+ReplayFrameSource::startContinuous(IRSOL_MAYBE_UNUSED double fps)
+{
+  IRSOL_NAMED_LOG_DEBUG(
+    "replay_source", "Replaying at the rate of the recording, ignoring the requested {} fps", fps);
+}
+
+FrameSource::captured_frame_t
+ReplayFrameSource::nextContinuous()
+{
+  return replayNext();
+}
+
+void
+ReplayFrameSource::stopContinuous()
+{}
+
+irsol::types::duration_t
+ReplayFrameSource::exposure() const
+{
+  return m_cam.cachedExposure();
+}
+
+FrameSource::captured_frame_t
+ReplayFrameSource::replayNext()
+{
+  try {
+    auto frame = m_cam.next();
+    return captured_data_t(
+      {frame.timestamp, frame.frameId, frame.height, frame.width}, std::move(frame.data));
+  } catch(const std::exception& e) {
+    IRSOL_NAMED_LOG_ERROR("replay_source", "Failed to replay frame: {}", e.what());
+    return std::nullopt;
+  }
+}
+
+}  // namespace frame_collector
+}  // namespace server
+}  // namespace irsol
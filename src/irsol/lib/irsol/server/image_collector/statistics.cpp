@@ -0,0 +1,108 @@
+#include "irsol/server/image_collector/statistics.hpp"
+
+#include "irsol/assert.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace irsol {
+namespace server {
+namespace frame_collector {
+
+RollingStatistics::RollingStatistics(size_t windowSize): m_windowSize(windowSize)
+{
+  IRSOL_ASSERT_ERROR(windowSize > 0, "Rolling statistics require a non-empty window");
+  m_values.reserve(windowSize);
+}
+
+void
+RollingStatistics::add(double value)
+{
+  if(m_values.size() < m_windowSize) {
+    m_values.push_back(value);
+  } else {
+    m_values[m_next] = value;
+  }
+  m_next = (m_next + 1) % m_windowSize;
+  ++m_total;
+}
+
+size_t
+RollingStatistics::count() const
+{
+  return m_values.size();
+}
+
+uint64_t
+RollingStatistics::total() const
+{
+  return m_total;
+}
+
+double
+RollingStatistics::mean() const
+{
+  if(m_values.empty()) {
+    return 0.0;
+  }
+  double sum = 0.0;
+  for(const auto value : m_values) {
+    sum += value;
+  }
+  return sum / static_cast<double>(m_values.size());
+}
+
+double
+RollingStatistics::stddev() const
+{
+  if(m_values.size() < 2) {
+    return 0.0;
+  }
+  const double average = mean();
+  double       sum     = 0.0;
+  for(const auto value : m_values) {
+    sum += (value - average) * (value - average);
+  }
+  return std::sqrt(sum / static_cast<double>(m_values.size() - 1));
+}
+
+double
+RollingStatistics::min() const
+{
+  return m_values.empty() ? 0.0 : *std::min_element(m_values.begin(), m_values.end());
+}
+
+double
+RollingStatistics::max() const
+{
+  return m_values.empty() ? 0.0 : *std::max_element(m_values.begin(), m_values.end());
+}
+
+std::string
+RollingStatistics::toString() const
+{
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1) << "mean " << mean() << ", stddev " << stddev()
+     << ", min " << min() << ", max " << max() << " (last " << count() << " of " << total() << ")";
+  return ss.str();
+}
+
+std::string
+TimingStatistics::toString() const
+{
+  std::stringstream ss;
+  ss << "interval error [us]: " << intervalError.toString();
+  if(schedulingDelay.total() > 0) {
+    ss << "; scheduling delay [us]: " << schedulingDelay.toString();
+  }
+  if(cameraDelay.total() > 0) {
+    ss << "; camera delay [us]: " << cameraDelay.toString();
+  }
+  return ss.str();
+}
+
+}  // namespace frame_collector
+}  // namespace server
+}  // namespace irsol
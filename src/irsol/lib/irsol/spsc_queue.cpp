@@ -0,0 +1,67 @@
+#include "irsol/spsc_queue.hpp"
+
+#include "irsol/macros.hpp"
+
+#include <chrono>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace irsol {
+namespace utils {
+namespace internal {
+
+#ifdef __linux__
+// The futex system call operates on the 32-bit value stored in the atomic.
+static_assert(
+  sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+  "std::atomic<uint32_t> can't be used as a futex word");
+
+void
+waitOn(std::atomic<uint32_t>& word, uint32_t expected)
+{
+  // Returns at once if the word no longer holds `expected`, e.g. if it was woken up meanwhile.
+  syscall(
+    SYS_futex,
+    reinterpret_cast<uint32_t*>(&word),
+    FUTEX_WAIT_PRIVATE,
+    expected,
+    nullptr,
+    nullptr,
+    0);
+}
+
+void
+wakeAll(std::atomic<uint32_t>& word)
+{
+  syscall(
+    SYS_futex,
+    reinterpret_cast<uint32_t*>(&word),
+    FUTEX_WAKE_PRIVATE,
+    INT32_MAX,
+    nullptr,
+    nullptr,
+    0);
+}
+#else
+void
+waitOn(std::atomic<uint32_t>& word, uint32_t expected)
+{
+  // No portable way to sleep on an address before C++20: poll the word at a low rate.
+  while(word.load(std::memory_order_acquire) == expected) {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+}
+
+void
+wakeAll(IRSOL_MAYBE_UNUSED std::atomic<uint32_t>& word)
+{}
+#endif
+
+}  // namespace internal
+}  // namespace utils
+}  // namespace irsol
@@ -3,6 +3,8 @@
 #include "irsol/assert.hpp"
 #include "irsol/logging.hpp"
 
+#include <cctype>
+#include <ctime>
 #include <iomanip>
 #include <neoapi/neoapi.hpp>
 #include <random>
@@ -129,6 +131,46 @@ timestampToString(irsol::types::timepoint_t tp)
   return ss.str();
 }
 
+std::optional<irsol::types::timepoint_t>
+timestampFromString(const std::string& s)
+{
+  std::stringstream ss(s);
+  std::tm           tm{};
+  ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+  if(ss.fail()) {
+    return std::nullopt;
+  }
+
+  // Optional fractional seconds, as printed by `timestampToString`.
+  std::chrono::microseconds fraction{0};
+  if(ss.peek() == '.') {
+    ss.get();
+    std::string digits;
+    while(std::isdigit(ss.peek())) {
+      digits.push_back(static_cast<char>(ss.get()));
+    }
+    if(digits.empty()) {
+      return std::nullopt;
+    }
+    digits.resize(6, '0');
+    fraction = std::chrono::microseconds(std::stoll(digits));
+  }
+  if(ss.peek() != std::char_traits<char>::eof()) {
+    return std::nullopt;
+  }
+
+  // The string is local time: let mktime figure out whether daylight saving time applies.
+  tm.tm_isdst          = -1;
+  const std::time_t tc = std::mktime(&tm);
+  if(tc == -1) {
+    return std::nullopt;
+  }
+  using system_clock_t = std::chrono::system_clock;
+  const auto systemTp  = system_clock_t::from_time_t(tc) + fraction;
+  return irsol::types::clock_t::now() +
+         std::chrono::duration_cast<irsol::types::duration_t>(systemTp - system_clock_t::now());
+}
+
 std::string
 durationToString(irsol::types::duration_t dr)
 {
@@ -196,12 +238,17 @@ NeoAPI::Cam
 loadDefaultCamera()
 {
   IRSOL_LOG_DEBUG("Loading default camera");
+  return loadCamera(internal::defaultCameraSerialNumber());
+}
+
+NeoAPI::Cam
+loadCamera(const std::string& cameraSerialNumber)
+{
   NeoAPI::Cam cam = NeoAPI::Cam();
 
-  const auto cameraSerialNumber = internal::defaultCameraSerialNumber();
-  IRSOL_LOG_TRACE("Trying to connect to default camera with SN '{0:s}'.", cameraSerialNumber);
+  IRSOL_LOG_TRACE("Trying to connect to camera with SN '{0:s}'.", cameraSerialNumber);
   try {
-    cam.Connect(cameraSerialNumber);
+    cam.Connect(cameraSerialNumber.c_str());
   } catch(NeoAPI::NotConnectedException& e) {
     IRSOL_ASSERT_FATAL(false, "Camera connection failed: %s", e.GetDescription());
     throw e;
@@ -0,0 +1,108 @@
+#include "irsol/queue.hpp"
+#include "irsol/spsc_queue.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <memory>
+#include <thread>
+
+namespace {
+
+// Items transferred per measurement.
+constexpr int NUM_ITEMS = 100000;
+
+// Capacity of the bounded queues.
+constexpr size_t CAPACITY = 64;
+
+/// Transfers NUM_ITEMS items from a producer thread to the calling thread.
+template<typename Queue>
+int64_t
+transfer(Queue& queue)
+{
+  std::thread producer([&queue]() {
+    for(int i = 0; i < NUM_ITEMS; ++i) {
+      queue.push(std::move(i));
+    }
+    queue.producerFinished();
+  });
+  int64_t sum = 0;
+  int     value;
+  while(queue.pop(value)) {
+    sum += value;
+  }
+  producer.join();
+  return sum;
+}
+
+/// Bounces an item between two threads, through a pair of queues, NUM_ITEMS / 100 times.
+template<typename Queue>
+int
+pingPong(Queue& ping, Queue& pong)
+{
+  constexpr int numRoundTrips = NUM_ITEMS / 100;
+  std::thread   echo([&ping, &pong]() {
+    int value;
+    while(ping.pop(value)) {
+      pong.push(std::move(value));
+    }
+    pong.producerFinished();
+  });
+  int value = 0;
+  for(int i = 0; i < numRoundTrips; ++i) {
+    ping.push(std::move(value));
+    pong.pop(value);
+    ++value;
+  }
+  ping.producerFinished();
+  int ignored;
+  while(pong.pop(ignored)) {
+  }
+  echo.join();
+  return value;
+}
+}
+
+TEST_CASE("Queue throughput", "[SpscQueue][benchmark]")
+{
+  BENCHMARK_ADVANCED("SafeQueue, " + std::to_string(NUM_ITEMS) + " items")
+  (Catch::Benchmark::Chronometer meter)
+  {
+    std::vector<std::unique_ptr<irsol::utils::SafeQueue<int>>> queues;
+    for(int i = 0; i < meter.runs(); ++i) {
+      queues.push_back(std::make_unique<irsol::utils::SafeQueue<int>>(CAPACITY));
+    }
+    meter.measure([&queues](int i) { return transfer(*queues[i]); });
+  };
+
+  BENCHMARK_ADVANCED("SpscQueue, " + std::to_string(NUM_ITEMS) + " items")
+  (Catch::Benchmark::Chronometer meter)
+  {
+    std::vector<std::unique_ptr<irsol::utils::SpscQueue<int>>> queues;
+    for(int i = 0; i < meter.runs(); ++i) {
+      queues.push_back(std::make_unique<irsol::utils::SpscQueue<int>>(CAPACITY));
+    }
+    meter.measure([&queues](int i) { return transfer(*queues[i]); });
+  };
+}
+
+TEST_CASE("Queue round-trip latency", "[SpscQueue][benchmark]")
+{
+  BENCHMARK_ADVANCED("SafeQueue, " + std::to_string(NUM_ITEMS / 100) + " round trips")
+  (Catch::Benchmark::Chronometer meter)
+  {
+    std::vector<std::unique_ptr<irsol::utils::SafeQueue<int>>> queues;
+    for(int i = 0; i < 2 * meter.runs(); ++i) {
+      queues.push_back(std::make_unique<irsol::utils::SafeQueue<int>>(CAPACITY));
+    }
+    meter.measure([&queues](int i) { return pingPong(*queues[2 * i], *queues[2 * i + 1]); });
+  };
+
+  BENCHMARK_ADVANCED("SpscQueue, " + std::to_string(NUM_ITEMS / 100) + " round trips")
+  (Catch::Benchmark::Chronometer meter)
+  {
+    std::vector<std::unique_ptr<irsol::utils::SpscQueue<int>>> queues;
+    for(int i = 0; i < 2 * meter.runs(); ++i) {
+      queues.push_back(std::make_unique<irsol::utils::SpscQueue<int>>(CAPACITY));
+    }
+    meter.measure([&queues](int i) { return pingPong(*queues[2 * i], *queues[2 * i + 1]); });
+  };
+}
@@ -0,0 +1,76 @@
+#include "irsol/camera/feature_cache.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <string>
+
+namespace {
+
+using irsol::camera::FeatureCache;
+using irsol::camera::FeatureId;
+using irsol::camera::SimulatedFeatureTree;
+
+// Number of features of the stand-in tree, in the order of the ones of a real camera.
+constexpr int NUM_FEATURES = 400;
+
+// Simulated frames per measurement.
+constexpr int NUM_FRAMES = 10000;
+
+SimulatedFeatureTree
+makeTree()
+{
+  SimulatedFeatureTree tree;
+  for(int i = 0; i < NUM_FEATURES; ++i) {
+    tree.addFeature("Feature" + std::to_string(i));
+  }
+  tree.addFeature("AcquisitionStart");
+  tree.addFeature("TriggerSoftware");
+  tree.addFeature("AcquisitionStop");
+  return tree;
+}
+}
+
+TEST_CASE("Feature access of a capture", "[FeatureCache][benchmark]")
+{
+  // Each capture accesses the features 'AcquisitionStart', 'TriggerSoftware' and
+  // 'AcquisitionStop'.
+  auto tree = makeTree();
+
+  BENCHMARK("Lookup by name, " + std::to_string(NUM_FRAMES) + " frames")
+  {
+    int64_t sum = 0;
+    for(int i = 0; i < NUM_FRAMES; ++i) {
+      for(const char* name : {"AcquisitionStart", "TriggerSoftware", "AcquisitionStop"}) {
+        sum += tree.GetFeature(NeoAPI::NeoString(std::string(name).c_str())).GetInt();
+      }
+    }
+    return sum;
+  };
+
+  const FeatureId                    acquisitionStart("AcquisitionStart");
+  const FeatureId                    triggerSoftware("TriggerSoftware");
+  const FeatureId                    acquisitionStop("AcquisitionStop");
+  FeatureCache<SimulatedFeatureTree> cache;
+
+  BENCHMARK("Cached handles, " + std::to_string(NUM_FRAMES) + " frames")
+  {
+    int64_t sum = 0;
+    for(int i = 0; i < NUM_FRAMES; ++i) {
+      sum += cache.get(tree, acquisitionStart).GetInt();
+      sum += cache.get(tree, triggerSoftware).GetInt();
+      sum += cache.get(tree, acquisitionStop).GetInt();
+    }
+    return sum;
+  };
+
+  // The accessors taking a name intern it on each call.
+  BENCHMARK("Cached handles by name, " + std::to_string(NUM_FRAMES) + " frames")
+  {
+    int64_t sum = 0;
+    for(int i = 0; i < NUM_FRAMES; ++i) {
+      for(const char* name : {"AcquisitionStart", "TriggerSoftware", "AcquisitionStop"}) {
+        sum += cache.get(tree, FeatureId(name)).GetInt();
+      }
+    }
+    return sum;
+  };
+}
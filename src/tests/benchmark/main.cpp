@@ -0,0 +1,12 @@
+#define CATCH_CONFIG_RUNNER
+#include "irsol/logging.hpp"
+
+#include <catch2/catch_all.hpp>
+
+int
+main(int argc, char** argv)
+{
+  // Logging would dominate the measured timings, keep it disabled.
+  irsol::initLogging("logs/benchmarks.log", spdlog::level::off);
+  return Catch::Session().run(argc, argv);
+}
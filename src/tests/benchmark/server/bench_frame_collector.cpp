@@ -0,0 +1,81 @@
+#include "irsol/server/image_collector.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Half-resolution Mono12 frame, as served by the default server application.
+constexpr uint64_t FRAME_HEIGHT = 1080;
+constexpr uint64_t FRAME_WIDTH  = 1440;
+
+irsol::server::frame_collector::FrameMetadata
+makeMetadata(uint64_t frameId)
+{
+  return {irsol::types::clock_t::now(), frameId, FRAME_HEIGHT, FRAME_WIDTH};
+}
+
+std::vector<irsol::types::byte_t>
+makeRawBuffer()
+{
+  return std::vector<irsol::types::byte_t>(
+    FRAME_HEIGHT * FRAME_WIDTH * irsol::protocol::ImageBinaryData::BYTES_PER_ELEMENT,
+    irsol::types::byte_t{0x2a});
+}
+
+std::vector<std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t>>
+makeQueues(size_t numClients)
+{
+  std::vector<std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t>>
+    queues;
+  for(size_t i = 0; i < numClients; ++i) {
+    queues.push_back(irsol::server::frame_collector::FrameCollector::makeQueuePtr());
+  }
+  return queues;
+}
+
+void
+drain(
+  std::vector<std::shared_ptr<irsol::server::frame_collector::FrameCollector::frame_queue_t>>&
+    queues)
+{
+  std::shared_ptr<const irsol::server::frame_collector::Frame> frame;
+  for(auto& queue : queues) {
+    while(!queue->empty()) {
+      queue->pop(frame);
+    }
+  }
+}
+}
+
+TEST_CASE("FrameCollector fan-out cost per capture", "[FrameCollector][benchmark]")
+{
+  const size_t numClients = GENERATE(1, 2, 4, 8, 16, 32);
+  const auto   rawBuffer  = makeRawBuffer();
+  auto         queues     = makeQueues(numClients);
+  uint64_t     frameId    = 0;
+
+  BENCHMARK("shared frame, " + std::to_string(numClients) + " clients")
+  {
+    // The captured buffer is copied once out of the camera, as done by the collector.
+    auto frame = irsol::server::frame_collector::FrameCollector::makeFrame(
+      makeMetadata(frameId++), {rawBuffer.begin(), rawBuffer.end()});
+    for(auto& queue : queues) {
+      queue->push(std::shared_ptr<const irsol::server::frame_collector::Frame>(frame));
+    }
+    drain(queues);
+  };
+
+  BENCHMARK("copied frame per client, " + std::to_string(numClients) + " clients")
+  {
+    auto captured = std::vector<irsol::types::byte_t>(rawBuffer.begin(), rawBuffer.end());
+    auto metadata = makeMetadata(frameId++);
+    for(auto& queue : queues) {
+      queue->push(irsol::server::frame_collector::FrameCollector::makeFrame(
+        metadata, {captured.begin(), captured.end()}));
+    }
+    drain(queues);
+  };
+}
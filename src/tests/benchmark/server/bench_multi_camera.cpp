@@ -0,0 +1,78 @@
+#include "irsol/server/device.hpp"
+
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using irsol::server::Device;
+using irsol::server::frame_collector::Frame;
+using irsol::server::frame_collector::FrameCollector;
+using irsol::server::frame_collector::SimulatedFrameSource;
+
+// Half-resolution Mono12 frame, as served by the default server application.
+constexpr uint64_t FRAME_HEIGHT = 1080;
+constexpr uint64_t FRAME_WIDTH  = 1440;
+
+// Frames requested from each device per measurement.
+constexpr uint64_t FRAMES_PER_DEVICE = 8;
+
+std::vector<std::unique_ptr<Device>>
+makeDevices(size_t numDevices, bool pinned)
+{
+  std::vector<std::unique_ptr<Device>> devices;
+  const auto                           numCpus = std::max(1u, std::thread::hardware_concurrency());
+  for(size_t i = 0; i < numDevices; ++i) {
+    devices.push_back(Device::simulated(
+      "sim" + std::to_string(i),
+      std::make_unique<SimulatedFrameSource>(FRAME_HEIGHT, FRAME_WIDTH, 1000.0)));
+    if(pinned) {
+      devices.back()->pinToCpu(i % numCpus);
+    }
+  }
+  return devices;
+}
+
+// Streams frames from all the devices at once, as many clients of different cameras would do.
+uint64_t
+acquire(std::vector<std::unique_ptr<Device>>& devices)
+{
+  std::vector<std::future<uint64_t>> consumers;
+  for(auto& device : devices) {
+    auto queue = FrameCollector::makeQueuePtr();
+    consumers.push_back(std::async(std::launch::async, [queue]() {
+      std::shared_ptr<const Frame> frame;
+      uint64_t                     numFrames = 0;
+      while(queue->pop(frame)) {
+        ++numFrames;
+      }
+      return numFrames;
+    }));
+    device->frameCollector().registerClient("client", 1000.0, queue, FRAMES_PER_DEVICE);
+  }
+  uint64_t numFrames = 0;
+  for(auto& consumer : consumers) {
+    numFrames += consumer.get();
+  }
+  return numFrames;
+}
+}
+
+TEST_CASE("Multi-camera aggregate acquisition", "[Device][benchmark]")
+{
+  const size_t numDevices = GENERATE(1, 2, 4);
+  const bool   pinned     = GENERATE(false, true);
+  auto         devices    = makeDevices(numDevices, pinned);
+
+  BENCHMARK(
+    std::to_string(numDevices) + " devices, " + (pinned ? "pinned" : "unpinned") + ", " +
+    std::to_string(FRAMES_PER_DEVICE) + " frames each")
+  {
+    return acquire(devices);
+  };
+}
@@ -0,0 +1,161 @@
+#include "irsol/server/image_collector.hpp"
+
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using irsol::server::frame_collector::client_handle_t;
+using irsol::server::frame_collector::Scheduler;
+
+// Mixed frame rates of the registered clients: mostly low-rate monitoring clients, and a few
+// live viewers.
+const std::vector<double> CLIENT_RATES = {0.125, 0.25, 0.5, 1.0, 0.3, 2.0, 4.0, 1.5, 8.0, 16.0};
+
+// Fixed batching window of the simulated distributor loops.
+constexpr irsol::types::duration_t SLACK = std::chrono::milliseconds(50);
+
+irsol::types::duration_t
+intervalOf(size_t client)
+{
+  return std::chrono::duration_cast<irsol::types::duration_t>(
+    std::chrono::duration<double>(1.0 / CLIENT_RATES[client % CLIENT_RATES.size()]));
+}
+
+/// Distributor loop of the collector, without capture, driven by a virtual clock.
+class HeapScheduleSimulation
+{
+public:
+  explicit HeapScheduleSimulation(size_t numClients): m_intervals(numClients)
+  {
+    m_scheduler.reserve(numClients);
+    m_ready.reserve(numClients);
+    const auto t0 = irsol::types::timepoint_t{};
+    for(size_t client = 0; client < numClients; ++client) {
+      m_intervals[client] = intervalOf(client);
+      // Spread the registrations over one second.
+      m_scheduler.schedule(
+        static_cast<client_handle_t>(client),
+        t0 + std::chrono::microseconds((client * 7919) % 1000000));
+    }
+  }
+
+  /// Runs one wake-up of the distributor loop, returns the time of the wake-up.
+  irsol::types::timepoint_t tick()
+  {
+    const auto now = m_scheduler.nextDue();
+    m_ready.clear();
+    m_scheduler.popDue(now + SLACK, m_ready);
+    for(const auto& entry : m_ready) {
+      m_scheduler.schedule(entry.handle, entry.due + m_intervals[entry.handle]);
+    }
+    return now;
+  }
+
+private:
+  Scheduler                             m_scheduler;
+  std::vector<Scheduler::Entry>         m_ready;
+  std::vector<irsol::types::duration_t> m_intervals;
+};
+
+/// Previous implementation of the distributor loop, based on an ordered map of client IDs.
+class MapScheduleSimulation
+{
+public:
+  explicit MapScheduleSimulation(size_t numClients)
+  {
+    const auto t0 = irsol::types::timepoint_t{};
+    for(size_t client = 0; client < numClients; ++client) {
+      auto clientId       = irsol::utils::uuid();
+      auto due            = t0 + std::chrono::microseconds((client * 7919) % 1000000);
+      m_clients[clientId] = {intervalOf(client), due};
+      m_scheduleMap[due].push_back(clientId);
+    }
+  }
+
+  irsol::types::timepoint_t tick()
+  {
+    const auto now = m_scheduleMap.begin()->first;
+    std::vector<irsol::types::client_id_t> readyClients;
+    std::vector<irsol::types::timepoint_t> clientsSchedules;
+    for(const auto& [scheduleTime, clients] : m_scheduleMap) {
+      if(scheduleTime > now + SLACK) {
+        break;
+      }
+      for(const auto& client : clients) {
+        readyClients.push_back(client);
+        clientsSchedules.push_back(scheduleTime);
+      }
+    }
+    auto uniqueSchedules = std::set<irsol::types::timepoint_t>(
+      clientsSchedules.begin(), clientsSchedules.end());
+    for(auto uniqueSchedule : uniqueSchedules) {
+      m_numSlackClients += std::count_if(
+        clientsSchedules.begin(), clientsSchedules.end(), [&uniqueSchedule](const auto& schedule) {
+          return schedule == uniqueSchedule;
+        });
+    }
+    for(auto schedule : clientsSchedules) {
+      m_scheduleMap.erase(schedule);
+    }
+    for(const auto& clientId : readyClients) {
+      auto& [interval, nextDue] = m_clients.at(clientId);
+      nextDue += interval;
+      m_scheduleMap[nextDue].push_back(clientId);
+    }
+    return now;
+  }
+
+private:
+  std::unordered_map<
+    irsol::types::client_id_t,
+    std::pair<irsol::types::duration_t, irsol::types::timepoint_t>>
+    m_clients;
+  std::map<irsol::types::timepoint_t, std::vector<irsol::types::client_id_t>> m_scheduleMap;
+  int64_t m_numSlackClients{0};
+};
+
+/// Number of wake-ups of the distributor loop per (virtual) second.
+template<typename Simulation>
+double
+wakeupsPerSecond(Simulation& simulation)
+{
+  constexpr auto simulatedDuration = std::chrono::seconds(60);
+  const auto     start             = simulation.tick();
+  uint64_t       numTicks          = 1;
+  while(simulation.tick() - start < simulatedDuration) {
+    ++numTicks;
+  }
+  return static_cast<double>(numTicks) / static_cast<double>(simulatedDuration.count());
+}
+}
+
+TEST_CASE("FrameCollector scheduler cost per tick", "[FrameCollector][Scheduler][benchmark]")
+{
+  const size_t numClients = GENERATE(1, 100, 10000);
+
+  {
+    HeapScheduleSimulation simulation(numClients);
+    std::cout << numClients << " clients: " << wakeupsPerSecond(simulation)
+              << " wakeups/s (heap scheduler)\n";
+  }
+
+  HeapScheduleSimulation heap(numClients);
+  BENCHMARK("heap scheduler tick, " + std::to_string(numClients) + " clients")
+  {
+    return heap.tick();
+  };
+
+  MapScheduleSimulation map(numClients);
+  BENCHMARK("map scheduler tick, " + std::to_string(numClients) + " clients")
+  {
+    return map.tick();
+  };
+}
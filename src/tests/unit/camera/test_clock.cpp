@@ -0,0 +1,125 @@
+#include "irsol/camera/clock.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+// Adds a sample whose device counter was read at `host`, within a round-trip of `roundTrip`.
+void
+addSample(
+  irsol::camera::DeviceClock& clock,
+  uint64_t                    deviceTicks,
+  irsol::types::timepoint_t   host,
+  irsol::types::duration_t    roundTrip = std::chrono::microseconds(100))
+{
+  clock.addSample(deviceTicks, host - roundTrip / 2, host + roundTrip / 2);
+}
+
+// Error of a mapped time point, in microseconds.
+double
+errorInMicroseconds(irsol::types::timepoint_t actual, irsol::types::timepoint_t expected)
+{
+  return std::abs(std::chrono::duration<double, std::micro>(actual - expected).count());
+}
+}
+
+TEST_CASE("DeviceClock::toHost()", "[DeviceClock]")
+{
+  irsol::camera::DeviceClock clock;
+  CHECK(clock.numSamples() == 0);
+  CHECK_FALSE(clock.toHost(1000).has_value());
+  CHECK_FALSE(clock.lastSampleTime().has_value());
+
+  const auto host0 = irsol::types::clock_t::now();
+
+  SECTION("single sample")
+  {
+    // Device counter started 1 hour before the host time `host0`.
+    const uint64_t device0 = 3600ull * 1000000000ull;
+    addSample(clock, device0, host0);
+    CHECK(clock.numSamples() == 1);
+    CHECK(clock.drift() == 0.0);
+
+    auto mapped = clock.toHost(device0 + 20000000);  // 20ms later
+    REQUIRE(mapped.has_value());
+    CHECK(errorInMicroseconds(*mapped, host0 + std::chrono::milliseconds(20)) < 1.0);
+
+    mapped = clock.toHost(device0 - 20000000);  // 20ms earlier
+    REQUIRE(mapped.has_value());
+    CHECK(errorInMicroseconds(*mapped, host0 - std::chrono::milliseconds(20)) < 1.0);
+  }
+
+  SECTION("drift correction")
+  {
+    // The device clock runs 50 ppm faster than the host clock.
+    constexpr double drift    = 50e-6;
+    const uint64_t   device0  = 123456789;
+    const auto       deviceAt = [&](std::chrono::nanoseconds sinceHost0) {
+      return device0 +
+             static_cast<uint64_t>(static_cast<double>(sinceHost0.count()) * (1.0 + drift));
+    };
+
+    // One sample per second for 30 seconds, with round-trips of varying length.
+    for(int i = 0; i < 30; ++i) {
+      const auto sinceHost0 = std::chrono::seconds(i);
+      addSample(
+        clock,
+        deviceAt(sinceHost0),
+        host0 + sinceHost0,
+        std::chrono::microseconds(100 + 200 * (i % 3)));
+    }
+    CHECK(clock.numSamples() == 30);
+    CHECK(clock.drift() == Catch::Approx(drift).margin(1e-7));
+
+    // Without drift correction, the error after 40 seconds would be 2ms.
+    const auto later  = std::chrono::seconds(40);
+    auto       mapped = clock.toHost(deviceAt(later));
+    REQUIRE(mapped.has_value());
+    CHECK(errorInMicroseconds(*mapped, host0 + later) < 10.0);
+  }
+
+  SECTION("samples with long round-trips barely affect the mapping")
+  {
+    const uint64_t device0 = 1000;
+    addSample(clock, device0, host0, std::chrono::microseconds(20));
+    // Disturbed sample: the latch happened at the very beginning of a 20ms round-trip.
+    addSample(
+      clock,
+      device0 + 1000000,
+      host0 + std::chrono::milliseconds(11),
+      std::chrono::milliseconds(20));
+    addSample(
+      clock,
+      device0 + 2000000,
+      host0 + std::chrono::milliseconds(2),
+      std::chrono::microseconds(20));
+
+    auto mapped = clock.toHost(device0 + 2000000);
+    REQUIRE(mapped.has_value());
+    CHECK(errorInMicroseconds(*mapped, host0 + std::chrono::milliseconds(2)) < 5.0);
+  }
+
+  SECTION("a counter going backwards resets the mapping")
+  {
+    addSample(clock, 1000000000, host0);
+    addSample(clock, 1001000000, host0 + std::chrono::milliseconds(1));
+    CHECK(clock.numSamples() == 2);
+
+    addSample(clock, 5000, host0 + std::chrono::seconds(1));
+    CHECK(clock.numSamples() == 1);
+    auto mapped = clock.toHost(5000);
+    REQUIRE(mapped.has_value());
+    CHECK(errorInMicroseconds(*mapped, host0 + std::chrono::seconds(1)) < 1.0);
+  }
+
+  SECTION("reset()")
+  {
+    addSample(clock, 1000, host0);
+    clock.reset();
+    CHECK(clock.numSamples() == 0);
+    CHECK_FALSE(clock.toHost(1000).has_value());
+  }
+}
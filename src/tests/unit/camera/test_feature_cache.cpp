@@ -0,0 +1,85 @@
+#include "irsol/camera/feature_cache.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <stdexcept>
+#include <string>
+
+using irsol::camera::FeatureCache;
+using irsol::camera::FeatureId;
+using irsol::camera::SimulatedFeatureTree;
+
+TEST_CASE("FeatureId::FeatureId()", "[FeatureCache]")
+{
+  FeatureId width("Width");
+  FeatureId height("Height");
+  FeatureId widthAgain("Width");
+
+  CHECK(width.name() == "Width");
+  CHECK(width.index() == widthAgain.index());
+  CHECK(width.index() != height.index());
+
+  const auto numInterned = FeatureId::numInterned();
+  FeatureId  heightAgain("Height");
+  CHECK(FeatureId::numInterned() == numInterned);
+}
+
+TEST_CASE("FeatureCache::get()", "[FeatureCache]")
+{
+  SimulatedFeatureTree tree;
+  tree.addFeature("ExposureTime", 2000);
+  tree.addFeature("Width", 1024);
+
+  FeatureCache<SimulatedFeatureTree> cache;
+  const FeatureId                    exposureTime("ExposureTime");
+  const FeatureId                    width("Width");
+
+  SECTION("features are resolved once")
+  {
+    CHECK(cache.get(tree, exposureTime).GetInt() == 2000);
+    CHECK(cache.get(tree, width).GetInt() == 1024);
+    cache.get(tree, exposureTime).SetInt(4000);
+    CHECK(cache.get(tree, exposureTime).GetInt() == 4000);
+    CHECK(tree.numLookups() == 2);
+    CHECK(cache.numResolved() == 2);
+  }
+
+  SECTION("cached features don't alias each other")
+  {
+    // The tree re-uses the handle it returns: the cache must keep its own handles.
+    auto& exposureFeature = cache.get(tree, exposureTime);
+    auto& widthFeature    = cache.get(tree, width);
+    CHECK(exposureFeature.GetName() == "ExposureTime");
+    CHECK(widthFeature.GetName() == "Width");
+
+    exposureFeature.SetInt(4000);
+    CHECK(widthFeature.GetInt() == 1024);
+    CHECK(tree.GetFeature(NeoAPI::NeoString("ExposureTime")).GetInt() == 4000);
+    CHECK(tree.GetFeature(NeoAPI::NeoString("Width")).GetInt() == 1024);
+
+    // Resolving more features keeps the previous handles valid.
+    for(int i = 0; i < 64; ++i) {
+      const auto name = "Feature" + std::to_string(i);
+      tree.addFeature(name, i);
+      CHECK(cache.get(tree, FeatureId(name)).GetInt() == i);
+    }
+    CHECK(exposureFeature.GetName() == "ExposureTime");
+    CHECK(exposureFeature.GetInt() == 4000);
+  }
+
+  SECTION("invalidated features are resolved again")
+  {
+    cache.get(tree, exposureTime);
+    cache.invalidate();
+    CHECK(cache.get(tree, exposureTime).GetInt() == 2000);
+    CHECK(tree.numLookups() == 2);
+    CHECK(cache.numResolved() == 2);
+  }
+
+  SECTION("unknown features are not cached")
+  {
+    const FeatureId unknown("NoSuchFeature");
+    CHECK_THROWS_AS(cache.get(tree, unknown), std::out_of_range);
+    tree.addFeature("NoSuchFeature", 1);
+    CHECK(cache.get(tree, unknown).GetInt() == 1);
+  }
+}
@@ -0,0 +1,36 @@
+#include "irsol/camera/interface.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <string>
+#include <vector>
+
+using irsol::camera::Interface;
+
+TEST_CASE("Interface::dependencyOrder()", "[Interface]")
+{
+  SECTION("binning is applied before the region of interest")
+  {
+    const auto order = Interface::dependencyOrder(
+      {"Height", "Width", "OffsetY", "BinningVertical", "OffsetX", "BinningHorizontal"});
+    CHECK(
+      order == std::vector<std::string>{
+                 "BinningHorizontal", "BinningVertical", "OffsetX", "Width", "OffsetY", "Height"});
+  }
+
+  SECTION("the frame rate is applied after the exposure")
+  {
+    const auto order = Interface::dependencyOrder(
+      {"AcquisitionFrameRate", "ExposureTime", "AcquisitionFrameRateEnable", "ExposureAuto"});
+    CHECK(
+      order == std::vector<std::string>{"ExposureAuto",
+                                        "ExposureTime",
+                                        "AcquisitionFrameRateEnable",
+                                        "AcquisitionFrameRate"});
+  }
+
+  SECTION("other features follow, sorted by name")
+  {
+    const auto order = Interface::dependencyOrder({"ReverseY", "Width", "ReverseX"});
+    CHECK(order == std::vector<std::string>{"Width", "ReverseX", "ReverseY"});
+  }
+}
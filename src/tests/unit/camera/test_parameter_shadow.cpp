@@ -0,0 +1,76 @@
+#include "irsol/camera/parameter_shadow.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <string>
+
+using irsol::camera::FeatureId;
+using irsol::camera::ParameterShadow;
+
+namespace {
+const auto T0 = irsol::types::clock_t::now();
+}
+
+TEST_CASE("ParameterShadow::get()", "[ParameterShadow]")
+{
+  const FeatureId width("Width");
+  const FeatureId pixelFormat("PixelFormat");
+  ParameterShadow shadow;
+
+  CHECK_FALSE(shadow.get<int>(width, T0).has_value());
+  shadow.store(width, int64_t{1024}, T0);
+  shadow.store(pixelFormat, std::string("Mono12"), T0);
+
+  SECTION("values are served in the representation they were read as")
+  {
+    CHECK(shadow.get<int>(width, T0) == 1024);
+    CHECK(shadow.get<int64_t>(width, T0 + std::chrono::hours(1)) == 1024);
+    CHECK_FALSE(shadow.get<std::string>(width, T0).has_value());
+    CHECK(shadow.get<std::string>(pixelFormat, T0) == "Mono12");
+
+    shadow.store(width, std::string("1024"), T0);
+    CHECK(shadow.get<std::string>(width, T0) == "1024");
+    CHECK(shadow.numHits() == 4);
+    CHECK(shadow.numMisses() == 2);
+  }
+
+  SECTION("invalidation forgets all the values")
+  {
+    shadow.invalidate();
+    CHECK_FALSE(shadow.get<int>(width, T0).has_value());
+    CHECK_FALSE(shadow.get<std::string>(pixelFormat, T0).has_value());
+  }
+
+  SECTION("invalidation can keep some values")
+  {
+    shadow.invalidateAllBut({pixelFormat});
+    CHECK_FALSE(shadow.get<int>(width, T0).has_value());
+    CHECK(shadow.get<std::string>(pixelFormat, T0) == "Mono12");
+  }
+}
+
+TEST_CASE("ParameterShadow::setRefreshPeriod()", "[ParameterShadow]")
+{
+  const FeatureId temperature("DeviceTemperature");
+  ParameterShadow shadow({{temperature, std::chrono::seconds(1)}});
+
+  shadow.store(temperature, 41.5, T0);
+  CHECK(shadow.get<double>(temperature, T0 + std::chrono::milliseconds(500)) == 41.5);
+  CHECK_FALSE(shadow.get<double>(temperature, T0 + std::chrono::seconds(2)).has_value());
+
+  SECTION("expired values are replaced by the refreshed ones")
+  {
+    const auto t1 = T0 + std::chrono::seconds(2);
+    shadow.store(temperature, std::string("42.0"), t1);
+    CHECK(shadow.get<std::string>(temperature, t1) == "42.0");
+    // The value read as a number is older than the refresh.
+    CHECK_FALSE(shadow.get<double>(temperature, t1).has_value());
+  }
+
+  SECTION("non-volatile features never expire")
+  {
+    shadow.setRefreshPeriod(temperature, std::nullopt);
+    shadow.store(temperature, 41.5, T0);
+    CHECK(shadow.get<double>(temperature, T0 + std::chrono::hours(24)) == 41.5);
+  }
+}
@@ -0,0 +1,99 @@
+#include "irsol/camera/recording.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+using irsol::camera::RecordingHeader;
+using irsol::camera::RecordingReader;
+using irsol::camera::RecordingWriter;
+
+std::string
+recordingPath(const std::string& name)
+{
+  return (std::filesystem::temp_directory_path() / ("irsol-test-" + name + ".irsolrec")).string();
+}
+
+std::vector<irsol::types::byte_t>
+makeImage(uint64_t width, uint64_t height, uint16_t value)
+{
+  std::vector<uint16_t>             pixels(width * height, value);
+  std::vector<irsol::types::byte_t> image(pixels.size() * sizeof(uint16_t));
+  std::memcpy(image.data(), pixels.data(), image.size());
+  return image;
+}
+}
+
+TEST_CASE("RecordingReader::next()", "[Recording]")
+{
+  const auto path  = recordingPath("roundtrip");
+  const auto start = irsol::types::clock_t::now();
+  {
+    RecordingWriter writer(path, {"SN-1234", std::chrono::milliseconds(3)});
+    for(uint16_t i = 0; i < 3; ++i) {
+      const auto image = makeImage(4, 2, i);
+      writer.write(10 + i, start + std::chrono::milliseconds(20 * i), 4, 2, image.data(), 16);
+    }
+    CHECK(writer.numFrames() == 3);
+  }
+
+  RecordingReader reader(path);
+  CHECK(reader.header().serialNumber == "SN-1234");
+  CHECK(reader.header().exposure == std::chrono::milliseconds(3));
+  for(uint16_t i = 0; i < 3; ++i) {
+    auto frame = reader.next();
+    REQUIRE(frame.has_value());
+    CHECK(frame->frameId == 10u + i);
+    CHECK(frame->timestamp == start + std::chrono::milliseconds(20 * i));
+    CHECK(frame->width == 4);
+    CHECK(frame->height == 2);
+    CHECK(*frame->data == makeImage(4, 2, i));
+  }
+  CHECK_FALSE(reader.next().has_value());
+
+  reader.rewind();
+  auto frame = reader.next();
+  REQUIRE(frame.has_value());
+  CHECK(frame->frameId == 10);
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("RecordingReader::RecordingReader()", "[Recording]")
+{
+  SECTION("missing files are rejected")
+  {
+    CHECK_THROWS_AS(RecordingReader(recordingPath("missing")), std::runtime_error);
+  }
+
+  SECTION("files that are not recordings are rejected")
+  {
+    const auto path = recordingPath("not-a-recording");
+    std::ofstream(path) << "not a recording";
+    CHECK_THROWS_AS(RecordingReader(path), std::runtime_error);
+    std::filesystem::remove(path);
+  }
+}
+
+TEST_CASE("RecordingReader::next() on a truncated recording", "[Recording]")
+{
+  const auto path = recordingPath("truncated");
+  {
+    RecordingWriter writer(path, {"SN-1234", std::chrono::milliseconds(3)});
+    const auto      image = makeImage(4, 2, 1);
+    writer.write(0, irsol::types::clock_t::now(), 4, 2, image.data(), image.size());
+    writer.write(1, irsol::types::clock_t::now(), 4, 2, image.data(), image.size());
+  }
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+  RecordingReader reader(path);
+  CHECK(reader.next().has_value());
+  CHECK_THROWS_AS(reader.next(), std::runtime_error);
+
+  std::filesystem::remove(path);
+}
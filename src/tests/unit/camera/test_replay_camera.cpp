@@ -0,0 +1,151 @@
+#include "irsol/camera/replay_camera.hpp"
+#include "irsol/server/image_collector.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+namespace {
+
+using irsol::camera::RecordingWriter;
+using irsol::camera::ReplayCamera;
+using irsol::server::frame_collector::ReplayFrameSource;
+
+/// Writes a recording of @p numFrames 4x2 frames, with IDs from @p firstId, every @p interval.
+void
+writeRecording(
+  const std::filesystem::path& path,
+  uint64_t                     firstId,
+  size_t                       numFrames,
+  irsol::types::duration_t     interval)
+{
+  RecordingWriter writer(path.string(), {"SN-1234", std::chrono::milliseconds(2)});
+  std::vector<irsol::types::byte_t> image(4 * 2 * 2);
+  // Recorded on another host, with an unrelated clock.
+  const irsol::types::timepoint_t start{std::chrono::hours(1)};
+  for(size_t i = 0; i < numFrames; ++i) {
+    writer.write(firstId + i, start + interval * i, 4, 2, image.data(), image.size());
+  }
+}
+
+std::filesystem::path
+replayDirectory(const std::string& name)
+{
+  const auto path = std::filesystem::temp_directory_path() / ("irsol-test-replay-" + name);
+  std::filesystem::remove_all(path);
+  std::filesystem::create_directories(path);
+  return path;
+}
+}
+
+TEST_CASE("ReplayCamera::ReplayCamera()", "[ReplayCamera]")
+{
+  const auto directory = replayDirectory("params");
+  writeRecording(directory / "a.irsolrec", 5, 2, std::chrono::milliseconds(1));
+
+  SECTION("the recording describes the camera")
+  {
+    ReplayCamera camera((directory / "a.irsolrec").string());
+    CHECK(camera.serialNumber() == "SN-1234");
+    CHECK(camera.getExposure() == std::chrono::milliseconds(2));
+    CHECK(camera.getIntParam("ExposureTime") == 2000);
+    camera.next();
+    CHECK(camera.getIntParam("Width") == 4);
+    CHECK(camera.getIntParam("Height") == 2);
+    CHECK(camera.getIntParam("FrameCounter") == 1);
+  }
+
+  SECTION("the parameters can't be changed")
+  {
+    ReplayCamera camera(directory.string());
+    CHECK(camera.setExposure(std::chrono::milliseconds(5)) == std::chrono::milliseconds(2));
+    CHECK(camera.setIntParam("ExposureTime", 5000) == 2000);
+  }
+
+  SECTION("missing recordings are rejected")
+  {
+    CHECK_THROWS_AS(ReplayCamera((directory / "missing").string()), std::runtime_error);
+    const auto empty = replayDirectory("empty");
+    CHECK_THROWS_AS(ReplayCamera(empty.string()), std::runtime_error);
+    std::filesystem::remove_all(empty);
+  }
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("ReplayCamera::next()", "[ReplayCamera]")
+{
+  const auto directory = replayDirectory("next");
+
+  SECTION("frame IDs are preserved, and keep increasing over the passes")
+  {
+    writeRecording(directory / "a.irsolrec", 5, 3, std::chrono::milliseconds(1));
+    ReplayCamera          camera(directory.string(), ReplayCamera::Pacing::AS_FAST_AS_POSSIBLE);
+    std::vector<uint64_t> ids;
+    for(size_t i = 0; i < 7; ++i) {
+      ids.push_back(camera.next().frameId);
+    }
+    CHECK(ids == std::vector<uint64_t>{5, 6, 7, 8, 9, 10, 11});
+    CHECK(camera.numPasses() == 2);
+    CHECK(camera.numReplayedFrames() == 7);
+  }
+
+  SECTION("the recordings of a directory are replayed in order")
+  {
+    writeRecording(directory / "b.irsolrec", 100, 2, std::chrono::milliseconds(1));
+    writeRecording(directory / "a.irsolrec", 0, 2, std::chrono::milliseconds(1));
+    ReplayCamera camera(directory.string(), ReplayCamera::Pacing::AS_FAST_AS_POSSIBLE);
+    REQUIRE(camera.recordings().size() == 2);
+    CHECK(std::filesystem::path(camera.recordings()[0]).filename() == "a.irsolrec");
+    std::vector<uint64_t> ids;
+    for(size_t i = 0; i < 5; ++i) {
+      ids.push_back(camera.next().frameId);
+    }
+    CHECK(ids == std::vector<uint64_t>{0, 1, 100, 101, 102});
+  }
+
+  SECTION("the original pace preserves the recorded intervals, on the host clock")
+  {
+    writeRecording(directory / "a.irsolrec", 0, 3, std::chrono::milliseconds(10));
+    ReplayCamera camera(directory.string(), ReplayCamera::Pacing::ORIGINAL);
+    const auto   start  = irsol::types::clock_t::now();
+    const auto   first  = camera.next();
+    const auto   second = camera.next();
+    const auto   third  = camera.next();
+    CHECK(first.timestamp >= start);
+    CHECK(second.timestamp - first.timestamp == std::chrono::milliseconds(10));
+    CHECK(third.timestamp - first.timestamp == std::chrono::milliseconds(20));
+    CHECK(irsol::types::clock_t::now() >= third.timestamp);
+
+    // The next pass follows the last frame by the mean interval of the recording.
+    CHECK(camera.next().timestamp - third.timestamp == std::chrono::milliseconds(10));
+  }
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("ReplayFrameSource::captureSingle()", "[ReplayCamera]")
+{
+  const auto directory = replayDirectory("source");
+  writeRecording(directory / "a.irsolrec", 7, 1, std::chrono::milliseconds(1));
+  ReplayCamera      camera(directory.string(), ReplayCamera::Pacing::AS_FAST_AS_POSSIBLE);
+  ReplayFrameSource source(camera);
+  CHECK(source.exposure() == std::chrono::milliseconds(2));
+
+  auto captured = source.captureSingle();
+  REQUIRE(captured.has_value());
+  const auto& [metadata, storage] = *captured;
+  CHECK(metadata.frameId == 7);
+  CHECK(metadata.width == 4);
+  CHECK(metadata.height == 2);
+  CHECK(storage->size() == 4 * 2 * 2);
+
+  source.startContinuous(1000.0);
+  captured = source.nextContinuous();
+  REQUIRE(captured.has_value());
+  CHECK(captured->first.frameId == 8);
+  source.stopContinuous();
+
+  std::filesystem::remove_all(directory);
+}
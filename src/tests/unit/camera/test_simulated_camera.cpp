@@ -0,0 +1,310 @@
+#include "irsol/camera/simulated_camera.hpp"
+#include "irsol/server/image_collector.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using irsol::camera::SimulatedCamera;
+using irsol::server::frame_collector::SimulatedCameraFrameSource;
+
+SimulatedCamera::Config
+smallSensor()
+{
+  SimulatedCamera::Config config;
+  config.serialNumber = "SIM-TEST";
+  config.sensorWidth  = 64;
+  config.sensorHeight = 32;
+  config.lineTime     = std::chrono::microseconds(100);
+  return config;
+}
+
+// Collects the frames of a triggered acquisition, as read out by the camera.
+class FrameSink
+{
+public:
+  SimulatedCamera::frame_callback_t callback()
+  {
+    return [this](const SimulatedCamera::Frame& frame) {
+      std::scoped_lock<std::mutex> lock(m_mutex);
+      m_frames.push_back(frame);
+      m_condition.notify_all();
+    };
+  }
+
+  std::vector<SimulatedCamera::Frame> waitFor(size_t numFrames)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait_for(
+      lock, std::chrono::seconds(1), [&]() { return m_frames.size() >= numFrames; });
+    return m_frames;
+  }
+
+private:
+  std::mutex                          m_mutex;
+  std::condition_variable             m_condition;
+  std::vector<SimulatedCamera::Frame> m_frames;
+};
+}
+
+TEST_CASE("SimulatedCamera::SimulatedCamera()", "[SimulatedCamera]")
+{
+  SimulatedCamera camera(smallSensor());
+  CHECK(camera.serialNumber() == "SIM-TEST");
+  CHECK(camera.getIntParam("Width") == 64);
+  CHECK(camera.getIntParam("Height") == 32);
+  CHECK(camera.getIntParam("WidthMax") == 64);
+  CHECK(camera.getIntParam("OffsetX") == 0);
+  CHECK(camera.getIntParam("BinningHorizontal") == 1);
+  CHECK(camera.getExposure() == SimulatedCamera::DEFAULT_EXPOSURE_TIME);
+  CHECK(camera.getIntParam("NoSuchFeature") == 0);
+}
+
+TEST_CASE("SimulatedCamera::setIntParam()", "[SimulatedCamera]")
+{
+  SimulatedCamera camera(smallSensor());
+
+  SECTION("sizes and offsets are rounded to the increment and kept within the sensor")
+  {
+    CHECK(camera.setIntParam("Width", 30) == 28);
+    CHECK(camera.setIntParam("OffsetX", 50) == 36);
+    CHECK(camera.setIntParam("OffsetX", -4) == 0);
+    CHECK(camera.setIntParam("Width", 0) == 4);
+    CHECK(camera.setIntParam("Height", 1000) == 32);
+  }
+
+  SECTION("a larger size moves the offset back within the sensor")
+  {
+    camera.setIntParam("Width", 16);
+    camera.setIntParam("OffsetX", 40);
+    CHECK(camera.setIntParam("Width", 32) == 32);
+    CHECK(camera.getIntParam("OffsetX") == 32);
+  }
+
+  SECTION("the binning rescales the region of interest")
+  {
+    camera.setIntParam("Width", 32);
+    camera.setIntParam("OffsetX", 16);
+    CHECK(camera.setIntParam("BinningHorizontal", 2) == 2);
+    CHECK(camera.getIntParam("WidthMax") == 32);
+    CHECK(camera.getIntParam("Width") == 16);
+    CHECK(camera.getIntParam("OffsetX") == 8);
+    CHECK(camera.getIntParam("HeightMax") == 32);
+
+    CHECK(camera.setIntParam("BinningHorizontal", 8) == 4);
+    CHECK(camera.getIntParam("WidthMax") == 16);
+  }
+
+  SECTION("read-only and unknown features are not written")
+  {
+    CHECK(camera.setIntParam("WidthMax", 8) == 64);
+    CHECK(camera.setIntParam("NoSuchFeature", 8) == 0);
+  }
+
+  SECTION("the exposure is clamped to the range of the camera")
+  {
+    CHECK(camera.setExposure(std::chrono::microseconds(1)) == std::chrono::microseconds(20));
+    CHECK(camera.setExposure(std::chrono::milliseconds(3)) == std::chrono::milliseconds(3));
+    CHECK(camera.getIntParam("ExposureTime") == 3000);
+  }
+}
+
+TEST_CASE("SimulatedCamera::captureSingle()", "[SimulatedCamera]")
+{
+  SimulatedCamera camera(smallSensor());
+  camera.setExposure(std::chrono::milliseconds(5));
+  camera.setIntParam("Height", 20);
+  camera.setIntParam("OffsetY", 8);
+  camera.setIntParam("BinningHorizontal", 2);
+  // Exposure, plus the readout of 20 rows.
+  CHECK(camera.readoutTime() == std::chrono::milliseconds(2));
+  CHECK(camera.captureTime() == std::chrono::milliseconds(7));
+
+  const auto start = irsol::types::clock_t::now();
+  const auto first = camera.captureSingle();
+  CHECK(irsol::types::clock_t::now() - start >= camera.captureTime());
+  CHECK(first.timestamp >= start);
+  CHECK(first.frameId == 0);
+  CHECK(first.width == 32);
+  CHECK(first.height == 20);
+  CHECK(first.offsetY == 8);
+  CHECK(first.binningHorizontal == 2);
+  CHECK(first.numBytes() == 32 * 20 * 2);
+
+  const auto second = camera.captureSingle();
+  CHECK(second.frameId == 1);
+  CHECK(camera.getIntParam("FrameCounter") == 2);
+}
+
+TEST_CASE("SimulatedCamera::render()", "[SimulatedCamera]")
+{
+  SimulatedCamera::Frame frame{4095, {}, 4, 2, 1, 3, 2, 1};
+  std::vector<irsol::types::byte_t> data(frame.numBytes());
+  SimulatedCamera::render(frame, data.data());
+
+  std::vector<uint16_t> pixels(frame.width * frame.height);
+  std::memcpy(pixels.data(), data.data(), data.size());
+  // Pixels depend on the sensor coordinates, shifted by the frame id, on 12 bits.
+  CHECK(pixels[0] == ((4095 + 1 * 2 + 3) & 0x0fff));
+  CHECK(pixels[1] == ((4095 + 2 * 2 + 3) & 0x0fff));
+  CHECK(pixels[4] == ((4095 + 1 * 2 + 4) & 0x0fff));
+  for(uint64_t y = 0; y < frame.height; ++y) {
+    for(uint64_t x = 0; x < frame.width; ++x) {
+      CHECK(pixels[y * frame.width + x] == SimulatedCamera::pixelValue(frame, x, y));
+      CHECK(pixels[y * frame.width + x] <= 0x0fff);
+    }
+  }
+}
+
+TEST_CASE("SimulatedCamera::nextContinuous()", "[SimulatedCamera]")
+{
+  SimulatedCamera camera(smallSensor());
+  camera.setExposure(std::chrono::milliseconds(1));
+
+  SECTION("frames are produced at the requested rate")
+  {
+    camera.startContinuous(100.0);
+    const auto first  = camera.nextContinuous();
+    const auto second = camera.nextContinuous();
+    CHECK(second.frameId == first.frameId + 1);
+    CHECK(second.timestamp - first.timestamp == std::chrono::milliseconds(10));
+    camera.stopContinuous();
+  }
+
+  SECTION("the rate is bounded by the duration of a capture")
+  {
+    camera.startContinuous(10000.0);
+    const auto first  = camera.nextContinuous();
+    const auto second = camera.nextContinuous();
+    CHECK(second.timestamp - first.timestamp == camera.captureTime());
+    camera.stopContinuous();
+  }
+
+  SECTION("frames missed by the consumer are dropped, and their ids skipped")
+  {
+    camera.startContinuous(100.0);
+    const auto first = camera.nextContinuous();
+    std::this_thread::sleep_for(std::chrono::milliseconds(35));
+    const auto next = camera.nextContinuous();
+    CHECK(next.frameId >= first.frameId + 3);
+    CHECK(camera.numDroppedFrames() == next.frameId - first.frameId - 1);
+    camera.stopContinuous();
+  }
+}
+
+TEST_CASE("SimulatedCamera::submitTrigger()", "[SimulatedCamera]")
+{
+  SimulatedCamera camera(smallSensor());
+  // Exposure and readout of 2ms each.
+  camera.setExposure(std::chrono::milliseconds(2));
+  camera.setIntParam("Height", 20);
+  REQUIRE(camera.readoutTime() == std::chrono::milliseconds(2));
+
+  FrameSink sink;
+  camera.startTriggered(sink.callback());
+
+  SECTION("without overlap, a trigger during the readout is skipped")
+  {
+    CHECK(camera.triggerTiming().triggerInterval() == std::chrono::milliseconds(4));
+    REQUIRE(camera.submitTrigger());
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    CHECK_FALSE(camera.submitTrigger());
+    CHECK(camera.numSkippedTriggers() == 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    REQUIRE(camera.submitTrigger());
+    const auto frames = sink.waitFor(2);
+    REQUIRE(frames.size() == 2);
+    CHECK(frames[1].frameId == frames[0].frameId + 1);
+    CHECK(frames[1].timestamp - frames[0].timestamp >= std::chrono::milliseconds(4));
+  }
+
+  SECTION("with overlap, the next exposure runs during the readout")
+  {
+    camera.setTriggerOverlap(true);
+    CHECK(camera.triggerTiming().triggerInterval() == std::chrono::milliseconds(2));
+    CHECK(camera.triggerTiming().maxPendingTriggers() == 2);
+
+    REQUIRE(camera.submitTrigger());
+    // Still exposing the first frame.
+    CHECK_FALSE(camera.submitTrigger());
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    CHECK(camera.submitTrigger());
+    CHECK(camera.numSkippedTriggers() == 1);
+
+    const auto frames = sink.waitFor(2);
+    REQUIRE(frames.size() == 2);
+    CHECK(frames[1].frameId == frames[0].frameId + 1);
+    CHECK(frames[1].timestamp - frames[0].timestamp < camera.captureTime());
+  }
+
+  camera.stopTriggered();
+}
+
+TEST_CASE("SimulatedCameraFrameSource::captureSingle()", "[SimulatedCamera]")
+{
+  SimulatedCamera camera(smallSensor());
+  camera.setIntParam("Width", 16);
+  camera.setIntParam("OffsetX", 8);
+  SimulatedCameraFrameSource source(camera);
+  CHECK(source.exposure() == camera.getExposure());
+
+  auto captured = source.captureSingle();
+  REQUIRE(captured.has_value());
+  const auto& [metadata, storage] = *captured;
+  CHECK(metadata.frameId == 0);
+  CHECK(metadata.width == 16);
+  CHECK(metadata.height == 32);
+  REQUIRE(storage->size() == 16 * 32 * 2);
+
+  uint16_t firstPixel;
+  std::memcpy(&firstPixel, storage->data(), sizeof(firstPixel));
+  CHECK(firstPixel == 8);
+}
+
+TEST_CASE("SimulatedCameraFrameSource::submitCapture()", "[SimulatedCamera]")
+{
+  SimulatedCamera camera(smallSensor());
+  camera.setExposure(std::chrono::milliseconds(2));
+  camera.setIntParam("Height", 20);
+  camera.setTriggerOverlap(true);
+  SimulatedCameraFrameSource source(camera);
+  CHECK(source.maxPendingCaptures() == 2);
+  CHECK(source.triggerInterval() == std::chrono::milliseconds(2));
+
+  SECTION("captures submitted on the trigger cadence overlap")
+  {
+    auto first = source.submitCapture();
+    std::this_thread::sleep_for(source.triggerInterval());
+    auto second = source.submitCapture();
+
+    auto firstFrame  = first.get();
+    auto secondFrame = second.get();
+    REQUIRE(firstFrame.has_value());
+    REQUIRE(secondFrame.has_value());
+    CHECK(secondFrame->first.frameId == firstFrame->first.frameId + 1);
+    CHECK(camera.numSkippedTriggers() == 0);
+  }
+
+  SECTION("a capture submitted too early fails at once")
+  {
+    auto first  = source.submitCapture();
+    auto second = source.submitCapture();
+    CHECK_FALSE(second.get().has_value());
+    CHECK(first.get().has_value());
+    CHECK(camera.numSkippedTriggers() == 1);
+  }
+
+  SECTION("stopping the captures fails the pending ones")
+  {
+    auto pending = source.submitCapture();
+    source.stopCaptures();
+    CHECK_FALSE(pending.get().has_value());
+  }
+}
@@ -0,0 +1,41 @@
+#include "irsol/camera/trigger_timing.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+
+using irsol::camera::TriggerTiming;
+using namespace std::chrono_literals;
+
+TEST_CASE("TriggerTiming::triggerInterval()", "[TriggerTiming]")
+{
+  SECTION("without overlap, a trigger waits for the readout of the previous frame")
+  {
+    TriggerTiming timing{5ms, 3ms, false};
+    CHECK(timing.triggerInterval() == 8ms);
+    CHECK(timing.captureTime() == 8ms);
+    CHECK(timing.maxPendingTriggers() == 1);
+    CHECK(timing.maxFrameRate() == Catch::Approx(125.0));
+  }
+
+  SECTION("with overlap, the exposure runs during the readout of the previous frame")
+  {
+    TriggerTiming timing{5ms, 3ms, true};
+    CHECK(timing.triggerInterval() == 5ms);
+    CHECK(timing.captureTime() == 8ms);
+    CHECK(timing.maxPendingTriggers() == 2);
+    CHECK(timing.maxFrameRate() == Catch::Approx(200.0));
+  }
+
+  SECTION("with overlap, a short exposure is bound by the readout")
+  {
+    TriggerTiming timing{1ms, 4ms, true};
+    CHECK(timing.triggerInterval() == 4ms);
+  }
+
+  SECTION("overlap doubles the rate when exposure and readout are equal")
+  {
+    TriggerTiming sequential{2ms, 2ms, false};
+    TriggerTiming overlapped{2ms, 2ms, true};
+    CHECK(overlapped.maxFrameRate() == Catch::Approx(2 * sequential.maxFrameRate()));
+  }
+}
@@ -0,0 +1,170 @@
+#include "irsol/camera/user_buffers.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <memory>
+#include <vector>
+
+TEST_CASE("UserBufferRing::UserBufferRing()", "[UserBuffers]")
+{
+  irsol::camera::SimulatedUserBufferDriver driver;
+  CHECK_FALSE(driver.enabled());
+
+  {
+    irsol::camera::UserBufferRing ring(driver, 4, 1000);
+    CHECK(ring.numBuffers() == 4);
+    CHECK(ring.bufferSize() == 1000);
+    CHECK(driver.enabled());
+    CHECK(driver.numQueued() == 4);
+  }
+
+  // All the buffers are revoked, and the driver is back to its own buffers.
+  CHECK_FALSE(driver.enabled());
+  CHECK(driver.numQueued() == 0);
+  CHECK_FALSE(driver.acquire().has_value());
+}
+
+TEST_CASE("UserBufferRing::wrap()", "[UserBuffers]")
+{
+  irsol::camera::SimulatedUserBufferDriver driver;
+  irsol::camera::UserBufferRing            ring(driver, 2, 1000);
+
+  SECTION("buffers are shared without copy")
+  {
+    auto acquisition = driver.acquire();
+    REQUIRE(acquisition.has_value());
+    acquisition->buffer->data()[0] = irsol::types::byte_t{42};
+
+    auto storage = ring.wrap(acquisition->buffer, std::move(acquisition->lease));
+    REQUIRE(storage != nullptr);
+    CHECK(storage->data() == acquisition->buffer->data());
+    CHECK(storage->size() == 1000);
+    CHECK(storage->at(0) == irsol::types::byte_t{42});
+  }
+
+  SECTION("buffers are re-queued once the last holder releases them")
+  {
+    auto acquisition = driver.acquire();
+    REQUIRE(acquisition.has_value());
+    auto storage = ring.wrap(acquisition->buffer, std::move(acquisition->lease));
+    CHECK(driver.numQueued() == 1);
+
+    auto copy = storage;
+    storage.reset();
+    CHECK(driver.numQueued() == 1);
+    CHECK(driver.numRequeued() == 0);
+
+    copy.reset();
+    CHECK(driver.numQueued() == 2);
+    CHECK(driver.numRequeued() == 1);
+  }
+
+  SECTION("buffers are acquired in a ring")
+  {
+    std::vector<const irsol::types::byte_t*> order;
+    for(size_t i = 0; i < 6; ++i) {
+      auto acquisition = driver.acquire();
+      REQUIRE(acquisition.has_value());
+      order.push_back(acquisition->buffer->data());
+      ring.wrap(acquisition->buffer, std::move(acquisition->lease));
+    }
+    CHECK(order[0] != order[1]);
+    CHECK(order[0] == order[2]);
+    CHECK(order[1] == order[3]);
+    CHECK(driver.numRequeued() == 6);
+  }
+
+  SECTION("frames are dropped when all buffers are held")
+  {
+    std::vector<irsol::camera::UserBufferRing::storage_t> held;
+    for(size_t i = 0; i < 2; ++i) {
+      auto acquisition = driver.acquire();
+      REQUIRE(acquisition.has_value());
+      held.push_back(ring.wrap(acquisition->buffer, std::move(acquisition->lease)));
+    }
+    CHECK_FALSE(driver.acquire().has_value());
+    CHECK(driver.numStarved() == 1);
+
+    held.pop_back();
+    CHECK(driver.acquire().has_value());
+  }
+
+  SECTION("foreign buffers are not wrapped")
+  {
+    irsol::camera::UserBuffer foreign(0, 1000);
+    CHECK(ring.wrap(&foreign, nullptr) == nullptr);
+    CHECK(ring.wrap(nullptr, nullptr) == nullptr);
+  }
+}
+
+TEST_CASE("UserBufferRing::~UserBufferRing()", "[UserBuffers]")
+{
+  irsol::camera::SimulatedUserBufferDriver driver;
+  irsol::camera::UserBufferRing::storage_t storage;
+  {
+    irsol::camera::UserBufferRing ring(driver, 2, 1000);
+    auto                          acquisition = driver.acquire();
+    REQUIRE(acquisition.has_value());
+    acquisition->buffer->data()[999] = irsol::types::byte_t{7};
+    storage = ring.wrap(acquisition->buffer, std::move(acquisition->lease));
+  }
+
+  // The frame outlives the ring: its buffer is still valid, but no longer given to the driver.
+  REQUIRE(storage != nullptr);
+  CHECK(storage->at(999) == irsol::types::byte_t{7});
+  storage.reset();
+  CHECK(driver.numQueued() == 0);
+  CHECK(driver.numRequeued() == 0);
+}
+
+TEST_CASE("UserBufferRing::refit()", "[UserBuffers]")
+{
+  irsol::camera::SimulatedUserBufferDriver driver;
+  auto ring = std::make_unique<irsol::camera::UserBufferRing>(driver, 2, 1000);
+  driver.setPayloadSize(1000);
+
+  // A frame acquired before the change of the region of interest is still held by a client.
+  auto before = driver.acquire();
+  REQUIRE(before.has_value());
+  before->buffer->data()[999] = irsol::types::byte_t{7};
+  auto held = ring->wrap(before->buffer, std::move(before->lease));
+
+  SECTION("a larger region of interest can't be acquired into the previous buffers")
+  {
+    driver.setPayloadSize(2000);
+    CHECK_FALSE(driver.acquire().has_value());
+    CHECK(driver.numUndersized() == 1);
+  }
+
+  SECTION("a larger region of interest is acquired once the ring is refitted")
+  {
+    CHECK(irsol::camera::affectsPayloadSize("Width"));
+    driver.setPayloadSize(2000);
+    REQUIRE(irsol::camera::UserBufferRing::refit(ring, 2000));
+    REQUIRE(ring != nullptr);
+    CHECK(ring->numBuffers() == 2);
+    CHECK(ring->bufferSize() == 2000);
+    CHECK(driver.enabled());
+    CHECK(driver.numQueued() == 2);
+
+    auto after = driver.acquire();
+    REQUIRE(after.has_value());
+    auto storage = ring->wrap(after->buffer, std::move(after->lease));
+    REQUIRE(storage != nullptr);
+    CHECK(storage->size() == 2000);
+    CHECK(driver.numUndersized() == 0);
+
+    // The frame of the previous ring is still valid, but its buffer is not queued again.
+    CHECK(held->at(999) == irsol::types::byte_t{7});
+    held.reset();
+    CHECK(driver.numQueued() == 1);
+  }
+
+  SECTION("a ring already fitting the payload is kept")
+  {
+    const auto* previous = ring.get();
+    CHECK_FALSE(irsol::camera::UserBufferRing::refit(ring, 1000));
+    CHECK(ring.get() == previous);
+    CHECK_FALSE(irsol::camera::affectsPayloadSize("OffsetX"));
+    CHECK_FALSE(irsol::camera::affectsPayloadSize("ExposureTime"));
+  }
+}
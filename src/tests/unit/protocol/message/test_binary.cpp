@@ -62,3 +62,80 @@ TEST_CASE("ColorImageBinaryData::ColorImageBinaryData()", "[Protocol][Protocol::
     CHECK(m.numBytes == sizeData.first * irsol::protocol::BinaryDataBuffer::BYTES_PER_ELEMENT);
   }
 }
+
+TEST_CASE("ImageBinaryData::share()", "[Protocol][Protocol::Message]")
+{
+  std::vector<irsol::types::byte_t> data(
+    160 * irsol::protocol::ImageBinaryData::BYTES_PER_ELEMENT, irsol::types::byte_t{0x2a});
+  irsol::protocol::ImageBinaryData original{
+    std::move(data), {10, 16}, {irsol::protocol::BinaryDataAttribute("imageId", 3)}};
+  CHECK(original.useCount() == 1);
+
+  auto shared = original.share();
+  CHECK(original.useCount() == 2);
+  CHECK(shared.useCount() == 2);
+  CHECK(shared.data == original.data);
+  CHECK(shared.shape == original.shape);
+  CHECK(shared.numBytes == original.numBytes);
+  REQUIRE(shared.attributes.size() == 1);
+  CHECK(shared.attributes[0].identifier == "imageId");
+
+  SECTION("moving a shared object does not copy the data")
+  {
+    auto moved = std::move(shared);
+    CHECK(moved.data == original.data);
+    CHECK(original.useCount() == 2);
+  }
+
+  SECTION("mutating a shared object copies the data first")
+  {
+    auto& bytes = shared.mutableData();
+    bytes[0]    = irsol::types::byte_t{0x00};
+    CHECK(shared.data != original.data);
+    CHECK(original.useCount() == 1);
+    CHECK(shared.useCount() == 1);
+    CHECK((*original.data)[0] == irsol::types::byte_t{0x2a});
+    CHECK((*shared.data)[0] == irsol::types::byte_t{0x00});
+  }
+
+  SECTION("mutating an exclusively owned object does not copy the data")
+  {
+    auto storage = original.data.get();
+    {
+      auto discarded = std::move(shared);
+    }
+    CHECK(original.useCount() == 1);
+    original.mutableData()[1] = irsol::types::byte_t{0x01};
+    CHECK(original.data.get() == storage);
+  }
+}
+
+TEST_CASE("ImageBinaryData::fromSharedData()", "[Protocol][Protocol::Message]")
+{
+  auto storage = std::make_shared<const std::vector<irsol::types::byte_t>>(
+    160 * irsol::protocol::ImageBinaryData::BYTES_PER_ELEMENT);
+  auto first  = irsol::protocol::ImageBinaryData::fromSharedData(storage, {10, 16});
+  auto second = irsol::protocol::ImageBinaryData::fromSharedData(storage, {16, 10});
+  CHECK(first.data == storage);
+  CHECK(second.data == storage);
+  CHECK(storage.use_count() == 3);
+  CHECK(first.numElements == 160);
+  CHECK(second.numElements == 160);
+
+  SECTION("mutating an object adopting external storage always copies the data")
+  {
+    auto adopted = irsol::protocol::ImageBinaryData::fromSharedData(
+      std::make_shared<const std::vector<irsol::types::byte_t>>(
+        160 * irsol::protocol::ImageBinaryData::BYTES_PER_ELEMENT),
+      {10, 16});
+    auto adoptedStorage = adopted.data.get();
+    CHECK(adopted.useCount() == 1);
+    adopted.mutableData()[0] = irsol::types::byte_t{0x01};
+    CHECK(adopted.data.get() != adoptedStorage);
+
+    // The copy is owned by the object, so further mutations happen in place.
+    auto ownedStorage        = adopted.data.get();
+    adopted.mutableData()[1] = irsol::types::byte_t{0x02};
+    CHECK(adopted.data.get() == ownedStorage);
+  }
+}
@@ -1,8 +1,11 @@
 #include "irsol/protocol/message.hpp"
 #include "irsol/protocol/serialization/serializer.hpp"
+#include "irsol/utils.hpp"
 
 #include <catch2/catch_all.hpp>
+#include <string>
 #include <utility>
+#include <vector>
 
 TEST_CASE("Serializer::message_termination", "[Protocol][Protocol::Serialization]")
 {
@@ -284,3 +287,31 @@ TEST_CASE("Serializer::serialize<variant>(Error)", "[Protocol][Protocol::Seriali
     CHECK(serialized.payloadSize() == 0);
   }
 }
+
+TEST_CASE("Serializer::serialize<direct>(ImageBinaryData)", "[Protocol][Protocol::Serialization]")
+{
+  std::vector<irsol::types::byte_t> data{
+    irsol::types::byte_t{0x01},
+    irsol::types::byte_t{0x02},
+    irsol::types::byte_t{0x03},
+    irsol::types::byte_t{0x04}};
+  auto image = irsol::protocol::ImageBinaryData(
+    std::move(data), {1, 2}, {irsol::protocol::BinaryDataAttribute("imageId", 7)});
+
+  auto serialized = irsol::protocol::Serializer::serialize(std::move(image));
+  CHECK_FALSE(serialized.hasHeader());
+  REQUIRE(serialized.hasPayload());
+
+  const std::string expectedHeader = "img=\x01u16[1,2] imageId=7\x02";
+  REQUIRE(serialized.payloadSize() == expectedHeader.size() + 4 + 1);
+  const auto& payload = *serialized.payload;
+  CHECK(
+    irsol::utils::bytesToString({payload.begin(), payload.begin() + expectedHeader.size()}) ==
+    expectedHeader);
+  // Pixels are sent big-endian.
+  CHECK(payload[expectedHeader.size()] == irsol::types::byte_t{0x02});
+  CHECK(payload[expectedHeader.size() + 1] == irsol::types::byte_t{0x01});
+  CHECK(payload[expectedHeader.size() + 2] == irsol::types::byte_t{0x04});
+  CHECK(payload[expectedHeader.size() + 3] == irsol::types::byte_t{0x03});
+  CHECK(payload.back() == irsol::protocol::Serializer::SpecialBytes::ETX);
+}
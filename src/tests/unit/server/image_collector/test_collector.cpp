@@ -0,0 +1,599 @@
+#include "irsol/camera/simulated_camera.hpp"
+#include "irsol/server/image_collector.hpp"
+
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using irsol::server::frame_collector::CollectionMode;
+using irsol::server::frame_collector::Frame;
+using irsol::server::frame_collector::FrameCollector;
+using irsol::server::frame_collector::SimulatedFrameSource;
+
+// Consumes the frames of a queue in the background, as a client session would do.
+std::future<std::vector<std::shared_ptr<const Frame>>>
+consume(std::shared_ptr<FrameCollector::frame_queue_t> queue)
+{
+  return std::async(std::launch::async, [queue]() {
+    std::vector<std::shared_ptr<const Frame>> frames;
+    std::shared_ptr<const Frame>              frame;
+    while(queue->pop(frame)) {
+      frames.push_back(frame);
+    }
+    return frames;
+  });
+}
+}
+
+TEST_CASE("FrameCollector::FrameCollector(just-in-time)", "[FrameCollector]")
+{
+  auto  source    = std::make_unique<SimulatedFrameSource>(4, 8, 100.0);
+  auto* sourcePtr = source.get();
+
+  FrameCollector collector(std::move(source), CollectionMode::JUST_IN_TIME);
+  CHECK(collector.mode() == CollectionMode::JUST_IN_TIME);
+
+  auto queue    = FrameCollector::makeQueuePtr();
+  auto consumer = consume(queue);
+  collector.registerClient("client", 20.0, queue, 3);
+  auto frames = consumer.get();
+
+  REQUIRE(frames.size() == 3);
+  for(const auto& frame : frames) {
+    CHECK(frame->metadata.height == 4);
+    CHECK(frame->metadata.width == 8);
+    CHECK(frame->image.numBytes == 4 * 8 * 2);
+  }
+  CHECK(sourcePtr->numSingleCaptures() == 3);
+  CHECK(sourcePtr->numContinuousStarts() == 0);
+  CHECK_FALSE(collector.isBusy());
+}
+
+TEST_CASE("FrameCollector::FrameCollector(continuous)", "[FrameCollector]")
+{
+  auto  source    = std::make_unique<SimulatedFrameSource>(4, 8, 200.0);
+  auto* sourcePtr = source.get();
+
+  FrameCollector collector(std::move(source), CollectionMode::CONTINUOUS);
+  CHECK(collector.mode() == CollectionMode::CONTINUOUS);
+
+  SECTION("single client receives frames at its own rate")
+  {
+    auto queue    = FrameCollector::makeQueuePtr();
+    auto consumer = consume(queue);
+    collector.registerClient("client", 20.0, queue, 4);
+    auto frames = consumer.get();
+
+    REQUIRE(frames.size() == 4);
+    for(size_t i = 1; i < frames.size(); ++i) {
+      CHECK(frames[i]->metadata.frameId > frames[i - 1]->metadata.frameId);
+      // Frames are delivered every 50ms, selected among frames produced every 50ms.
+      auto delta = frames[i]->metadata.timestamp - frames[i - 1]->metadata.timestamp;
+      CHECK(delta > std::chrono::milliseconds(30));
+    }
+    // The source ran freely, without triggered captures.
+    CHECK(sourcePtr->numSingleCaptures() == 0);
+    CHECK(sourcePtr->numContinuousStarts() >= 1);
+  }
+
+  SECTION("source runs at the highest rate requested by the clients")
+  {
+    auto fastQueue    = FrameCollector::makeQueuePtr();
+    auto slowQueue    = FrameCollector::makeQueuePtr();
+    auto fastConsumer = consume(fastQueue);
+    auto slowConsumer = consume(slowQueue);
+    collector.registerClient("fast", 50.0, fastQueue, 20);
+    collector.registerClient("slow", 10.0, slowQueue, 3);
+
+    auto slowFrames = slowConsumer.get();
+    auto fastFrames = fastConsumer.get();
+
+    REQUIRE(slowFrames.size() == 3);
+    REQUIRE(fastFrames.size() == 20);
+    for(size_t i = 1; i < slowFrames.size(); ++i) {
+      // The slow client skips the frames produced for the fast client.
+      CHECK(slowFrames[i]->metadata.frameId - slowFrames[i - 1]->metadata.frameId > 1);
+    }
+    CHECK(sourcePtr->numSingleCaptures() == 0);
+  }
+
+  SECTION("single-frame client is served by the next produced frame")
+  {
+    auto queue    = FrameCollector::makeQueuePtr();
+    auto consumer = consume(queue);
+    auto t0       = irsol::types::clock_t::now();
+    collector.registerClient("client", -1.0, queue, 1);
+    auto frames = consumer.get();
+
+    REQUIRE(frames.size() == 1);
+    CHECK(frames[0]->metadata.timestamp - t0 < std::chrono::milliseconds(40));
+    CHECK(sourcePtr->numSingleCaptures() == 0);
+  }
+}
+
+TEST_CASE("FrameCollector::makeQueuePtr(policy)", "[FrameCollector]")
+{
+  auto mode = GENERATE(CollectionMode::JUST_IN_TIME, CollectionMode::CONTINUOUS);
+
+  FrameCollector collector(std::make_unique<SimulatedFrameSource>(4, 8, 200.0), mode);
+
+  // A live viewer that never consumes its frames must not slow down the other clients.
+  auto stalledQueue = FrameCollector::makeQueuePtr(0, irsol::utils::OverflowPolicy::LATEST_ONLY);
+  collector.registerClient("stalled", 50.0, stalledQueue);
+
+  auto queue    = FrameCollector::makeQueuePtr(2, irsol::utils::OverflowPolicy::BLOCK);
+  auto consumer = consume(queue);
+  auto t0       = irsol::types::clock_t::now();
+  collector.registerClient("client", 50.0, queue, 10);
+  auto frames = consumer.get();
+
+  CHECK(frames.size() == 10);
+  CHECK(irsol::types::clock_t::now() - t0 < std::chrono::seconds(1));
+  CHECK(stalledQueue->size() == 1);
+  auto stalledDropped = collector.droppedFrames("stalled");
+  REQUIRE(stalledDropped.has_value());
+  CHECK(*stalledDropped >= 8);
+  CHECK_FALSE(collector.droppedFrames("client").has_value());
+  collector.deregisterClient("stalled");
+}
+
+TEST_CASE("FrameCollector::registerClient(slow consumer)", "[FrameCollector]")
+{
+  FrameCollector collector(
+    std::make_unique<SimulatedFrameSource>(4, 8, 200.0), CollectionMode::CONTINUOUS);
+
+  // With the BLOCK policy, a slow client still receives all the requested frames, at the pace
+  // it can sustain.
+  auto queue = FrameCollector::makeQueuePtr(1, irsol::utils::OverflowPolicy::BLOCK);
+  collector.registerClient("client", 100.0, queue, 5);
+  std::vector<std::shared_ptr<const Frame>> frames;
+  std::shared_ptr<const Frame>              frame;
+  while(queue->pop(frame)) {
+    frames.push_back(frame);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  }
+  CHECK(frames.size() == 5);
+  // The deliveries were postponed, but no frame was dropped.
+  CHECK(queue->rejected() > 0);
+  CHECK(queue->dropped() == 0);
+}
+
+TEST_CASE("FrameCollector::registerClient(during capture)", "[FrameCollector]")
+{
+  auto mode = GENERATE(CollectionMode::JUST_IN_TIME, CollectionMode::CONTINUOUS);
+
+  // Each frame takes 500ms to be produced (i.e. a long exposure).
+  FrameCollector collector(std::make_unique<SimulatedFrameSource>(4, 8, 2.0), mode);
+
+  auto queue    = FrameCollector::makeQueuePtr();
+  auto consumer = consume(queue);
+  collector.registerClient("slow", 2.0, queue, 2);
+
+  // Wait for the acquisition to be in progress.
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+  // (De)registrations don't wait for the acquisition to complete.
+  auto otherQueue    = FrameCollector::makeQueuePtr();
+  auto otherConsumer = consume(otherQueue);
+  auto t0            = irsol::types::clock_t::now();
+  collector.registerClient("other", 2.0, otherQueue);
+  collector.deregisterClient("other");
+  CHECK(irsol::types::clock_t::now() - t0 < std::chrono::milliseconds(100));
+  CHECK(otherConsumer.get().empty());
+
+  CHECK(consumer.get().size() == 2);
+}
+
+TEST_CASE("SimulatedFrameSource::submitCapture()", "[FrameCollector]")
+{
+  // Each capture takes 20ms.
+  SimulatedFrameSource source(4, 8, 50.0);
+  source.setMaxPendingCaptures(2);
+  CHECK(source.maxPendingCaptures() == 2);
+
+  SECTION("the pending captures complete back-to-back, in submission order")
+  {
+    const auto start  = irsol::types::clock_t::now();
+    auto       first  = source.submitCapture();
+    auto       second = source.submitCapture();
+    // Submitting doesn't wait for the capture.
+    CHECK(irsol::types::clock_t::now() - start < std::chrono::milliseconds(10));
+
+    auto firstFrame  = first.get();
+    auto secondFrame = second.get();
+    REQUIRE(firstFrame.has_value());
+    REQUIRE(secondFrame.has_value());
+    CHECK(secondFrame->first.frameId == firstFrame->first.frameId + 1);
+    CHECK(secondFrame->first.timestamp - start >= std::chrono::milliseconds(40));
+    CHECK(source.numSingleCaptures() == 2);
+  }
+
+  SECTION("stopping the captures fails the pending ones")
+  {
+    auto pending = source.submitCapture();
+    source.stopCaptures();
+    CHECK_FALSE(pending.get().has_value());
+
+    // The next capture restarts the source.
+    CHECK(source.submitCapture().get().has_value());
+  }
+}
+
+TEST_CASE("FrameCollector::FrameCollector(pending captures)", "[FrameCollector]")
+{
+  // Each capture takes 10ms, and the next one can be triggered during the current one.
+  auto  source    = std::make_unique<SimulatedFrameSource>(4, 8, 100.0);
+  auto* sourcePtr = source.get();
+  source->setMaxPendingCaptures(2);
+  FrameCollector collector(std::move(source), CollectionMode::JUST_IN_TIME);
+
+  // A client faster than the source is served at the full rate of the source.
+  auto       queue    = FrameCollector::makeQueuePtr();
+  auto       consumer = consume(queue);
+  const auto start    = irsol::types::clock_t::now();
+  collector.registerClient("fast", 1000.0, queue, 20);
+  auto frames = consumer.get();
+
+  REQUIRE(frames.size() == 20);
+  for(size_t i = 1; i < frames.size(); ++i) {
+    CHECK(frames[i]->metadata.frameId == frames[i - 1]->metadata.frameId + 1);
+  }
+  CHECK(sourcePtr->numSingleCaptures() == 20);
+  CHECK(collector.numCaptures() == 20);
+  // Registration delay, then 20 captures without idle time in between.
+  CHECK(
+    irsol::types::clock_t::now() - start <
+    FrameCollector::REGISTRATION_DELAY + std::chrono::milliseconds(20 * 10 + 100));
+}
+
+TEST_CASE("FrameCollector::FrameCollector(trigger overlap)", "[FrameCollector]")
+{
+  // Exposure and readout of 4ms each: 8ms per capture, but a trigger every 4ms with overlap.
+  irsol::camera::SimulatedCamera::Config config;
+  config.sensorWidth    = 16;
+  config.sensorHeight   = 40;
+  config.lineTime       = std::chrono::microseconds(100);
+  config.triggerOverlap = true;
+  irsol::camera::SimulatedCamera camera(config);
+  camera.setExposure(std::chrono::milliseconds(4));
+  REQUIRE(camera.triggerTiming().triggerInterval() == std::chrono::milliseconds(4));
+
+  FrameCollector collector(
+    std::make_unique<irsol::server::frame_collector::SimulatedCameraFrameSource>(camera),
+    CollectionMode::JUST_IN_TIME);
+
+  // A client faster than the camera is served on the trigger cadence, without skipped triggers:
+  // its next frame is exposed while the previous one is read out.
+  auto       queue    = FrameCollector::makeQueuePtr();
+  auto       consumer = consume(queue);
+  const auto start    = irsol::types::clock_t::now();
+  collector.registerClient("fast", 1000.0, queue, 20);
+  auto       frames  = consumer.get();
+  const auto elapsed = irsol::types::clock_t::now() - start;
+
+  REQUIRE(frames.size() == 20);
+  for(size_t i = 1; i < frames.size(); ++i) {
+    CHECK(frames[i]->metadata.frameId == frames[i - 1]->metadata.frameId + 1);
+  }
+  CHECK(camera.numSkippedTriggers() == 0);
+  CHECK(collector.numCaptures() == 20);
+  // Faster than 20 sequential captures of 8ms.
+  CHECK(elapsed < FrameCollector::REGISTRATION_DELAY + 20 * camera.captureTime());
+}
+
+TEST_CASE("FrameCollector::FrameCollector(buffer pool)", "[FrameCollector]")
+{
+  auto mode = GENERATE(CollectionMode::JUST_IN_TIME, CollectionMode::CONTINUOUS);
+
+  irsol::utils::BufferPool pool;
+  FrameCollector collector(std::make_unique<SimulatedFrameSource>(4, 8, 200.0, pool), mode);
+
+  // Frames are consumed as they arrive, so only a handful of buffers is ever in use: in steady
+  // state, the frame buffers are recycled without any allocation.
+  auto queue    = FrameCollector::makeQueuePtr(1, irsol::utils::OverflowPolicy::BLOCK);
+  auto consumer = consume(queue);
+  collector.registerClient("client", 50.0, queue, 20);
+  auto frames = consumer.get();
+  REQUIRE(frames.size() == 20);
+  // Frames still referenced keep their buffer.
+  CHECK(pool.numAllocations() >= 20);
+
+  frames.clear();
+  const auto numAllocations = pool.numAllocations();
+
+  // Consume the frames without keeping them.
+  queue        = FrameCollector::makeQueuePtr(1, irsol::utils::OverflowPolicy::BLOCK);
+  auto counter = std::async(std::launch::async, [queue]() {
+    size_t                       numFrames = 0;
+    std::shared_ptr<const Frame> frame;
+    while(queue->pop(frame)) {
+      ++numFrames;
+    }
+    return numFrames;
+  });
+  collector.registerClient("client", 50.0, queue, 20);
+  CHECK(counter.get() == 20);
+  CHECK(pool.numAllocations() == numAllocations);
+}
+
+TEST_CASE("FrameCollector::FrameCollector(user buffers)", "[FrameCollector]")
+{
+  auto mode = GENERATE(CollectionMode::JUST_IN_TIME, CollectionMode::CONTINUOUS);
+
+  irsol::utils::BufferPool pool;
+  auto                     source = std::make_unique<SimulatedFrameSource>(4, 8, 200.0, pool);
+  // The frames kept in the history hold their buffer.
+  source->useUserBuffers(4 + FrameCollector::DEFAULT_HISTORY_CAPACITY);
+  const auto*    driver = source->userBufferDriver();
+  FrameCollector collector(std::move(source), mode);
+
+  // Frames are written in the user buffers and handed as-is to the clients: no buffer is taken
+  // from the pool, and each buffer goes back to the driver once the frame is released.
+  auto queue   = FrameCollector::makeQueuePtr(1, irsol::utils::OverflowPolicy::BLOCK);
+  auto counter = std::async(std::launch::async, [queue]() {
+    size_t                       numFrames = 0;
+    std::shared_ptr<const Frame> frame;
+    while(queue->pop(frame)) {
+      ++numFrames;
+    }
+    return numFrames;
+  });
+  collector.registerClient("client", 50.0, queue, 20);
+  CHECK(counter.get() == 20);
+  CHECK(pool.numAllocations() == 0);
+  CHECK(driver->numRequeued() >= 20 - 4 - FrameCollector::DEFAULT_HISTORY_CAPACITY);
+}
+
+TEST_CASE("FrameCollector::registerClient(mixed rates)", "[FrameCollector]")
+{
+  auto           source    = std::make_unique<SimulatedFrameSource>(4, 8, 200.0);
+  auto*          sourcePtr = source.get();
+  FrameCollector collector(std::move(source), CollectionMode::JUST_IN_TIME);
+
+  // The slow client is due 30ms after the fast one: within its own slack (a tenth of its 500ms
+  // interval), so it is served by the captures of the fast client instead of triggering its own.
+  auto fastQueue    = FrameCollector::makeQueuePtr();
+  auto slowQueue    = FrameCollector::makeQueuePtr();
+  auto fastConsumer = consume(fastQueue);
+  auto slowConsumer = consume(slowQueue);
+  collector.registerClient("fast", 10.0, fastQueue, 10);
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  collector.registerClient("slow", 2.0, slowQueue, 2);
+
+  CHECK(fastConsumer.get().size() == 10);
+  CHECK(slowConsumer.get().size() == 2);
+  CHECK(collector.numSavedCaptures() >= 1);
+  CHECK(collector.numCaptures() + collector.numSavedCaptures() == 12);
+  CHECK(sourcePtr->numSingleCaptures() < 12);
+}
+
+TEST_CASE("FrameCollector::snapToHarmonicGrid()", "[FrameCollector]")
+{
+  CHECK(FrameCollector::snapToHarmonicGrid(1.0) == 1.0);
+  CHECK(FrameCollector::snapToHarmonicGrid(5.0) == 4.0);
+  CHECK(FrameCollector::snapToHarmonicGrid(6.0) == 8.0);
+  CHECK(FrameCollector::snapToHarmonicGrid(0.3) == 0.25);
+  CHECK(FrameCollector::snapToHarmonicGrid(100.0) == FrameCollector::HARMONIC_MAX_FPS);
+  CHECK(FrameCollector::snapToHarmonicGrid(0.01) == FrameCollector::HARMONIC_MIN_FPS);
+  CHECK(FrameCollector::snapToHarmonicGrid(0.0) == FrameCollector::HARMONIC_MIN_FPS);
+}
+
+TEST_CASE("FrameCollector::FrameCollector(harmonic)", "[FrameCollector]")
+{
+  auto           source    = std::make_unique<SimulatedFrameSource>(4, 8, 200.0);
+  auto*          sourcePtr = source.get();
+  FrameCollector collector(std::move(source), CollectionMode::HARMONIC);
+  CHECK(collector.mode() == CollectionMode::HARMONIC);
+
+  // The slow client (5 fps, snapped to 4 fps) is due on every 4th tick of the fast one: all its
+  // frames are served by the captures of the fast client.
+  auto fastQueue    = FrameCollector::makeQueuePtr();
+  auto slowQueue    = FrameCollector::makeQueuePtr();
+  auto fastConsumer = consume(fastQueue);
+  auto slowConsumer = consume(slowQueue);
+  collector.registerClient("fast", 16.0, fastQueue, 8);
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  collector.registerClient("slow", 5.0, slowQueue, 2);
+
+  auto fastFrames = fastConsumer.get();
+  auto slowFrames = slowConsumer.get();
+  REQUIRE(fastFrames.size() == 8);
+  REQUIRE(slowFrames.size() == 2);
+  CHECK(slowFrames[0] == fastFrames[0]);
+  CHECK(slowFrames[1] == fastFrames[4]);
+  CHECK(collector.numCaptures() == 8);
+  CHECK(collector.numSavedCaptures() == 2);
+  CHECK(sourcePtr->numSingleCaptures() == 8);
+}
+
+TEST_CASE("FrameCollector::timingStatistics()", "[FrameCollector]")
+{
+  FrameCollector collector(std::make_unique<SimulatedFrameSource>(4, 8, 200.0));
+  CHECK_FALSE(collector.timingStatistics("client").has_value());
+
+  auto queue    = FrameCollector::makeQueuePtr();
+  auto consumer = consume(queue);
+  collector.registerClient("client", 20.0, queue);
+  std::this_thread::sleep_for(std::chrono::milliseconds(400));
+
+  auto timing = collector.timingStatistics("client");
+  collector.deregisterClient("client");
+  auto frames = consumer.get();
+
+  REQUIRE(timing.has_value());
+  REQUIRE(timing->schedulingDelay.total() >= 2);
+  CHECK(timing->intervalError.total() == timing->schedulingDelay.total() - 1);
+  CHECK(timing->cameraDelay.total() == timing->schedulingDelay.total());
+  // A simulated capture lasts a full frame period (5ms), and is stamped at its end.
+  CHECK(timing->cameraDelay.min() >= 5000.0);
+  // The frames are stamped at the requested rate, give or take the scheduling noise.
+  CHECK(std::abs(timing->intervalError.mean()) < 20000.0);
+  CHECK(frames.size() >= timing->schedulingDelay.total());
+}
+
+TEST_CASE("FrameCollector::history()", "[FrameCollector]")
+{
+  auto mode = GENERATE(CollectionMode::JUST_IN_TIME, CollectionMode::CONTINUOUS);
+
+  auto           source    = std::make_unique<SimulatedFrameSource>(4, 8, 200.0);
+  auto*          sourcePtr = source.get();
+  FrameCollector collector(std::move(source), mode, 16);
+  CHECK(collector.history().capacity() == 16);
+  CHECK(collector.history().size() == 0);
+
+  auto queue    = FrameCollector::makeQueuePtr();
+  auto consumer = consume(queue);
+  collector.registerClient("client", 50.0, queue, 6);
+  auto frames = consumer.get();
+  REQUIRE(frames.size() == 6);
+
+  // The delivered frames (and, in continuous mode, the skipped ones) are kept in the history, and
+  // retrieving them doesn't trigger captures.
+  const auto  numCaptures = sourcePtr->numSingleCaptures();
+  const auto& history     = collector.history();
+  CHECK(history.size() >= frames.size());
+  auto latest = history.latest(std::chrono::seconds(1));
+  REQUIRE(latest != nullptr);
+  CHECK(latest->metadata.frameId >= frames.back()->metadata.frameId);
+  auto missed = history.since(frames[1]->metadata.frameId);
+  REQUIRE_FALSE(missed.empty());
+  CHECK(missed.back() == latest);
+  CHECK(history.nearest(frames.back()->metadata.timestamp) == frames.back());
+  CHECK(sourcePtr->numSingleCaptures() == numCaptures);
+}
+
+TEST_CASE("FrameCollector::registerClient(single frame)", "[FrameCollector]")
+{
+  SECTION("a capture is triggered at once")
+  {
+    // Captures last 5ms.
+    auto           source    = std::make_unique<SimulatedFrameSource>(4, 8, 200.0);
+    auto*          sourcePtr = source.get();
+    FrameCollector collector(std::move(source));
+
+    auto       queue = FrameCollector::makeQueuePtr(1);
+    const auto start = irsol::types::clock_t::now();
+    collector.registerClient("single", -1.0, queue, 1);
+    std::shared_ptr<const Frame> frame;
+    REQUIRE(queue->pop(frame));
+    CHECK(sourcePtr->numSingleCaptures() == 1);
+    CHECK(collector.numSavedCaptures() == 0);
+
+    // The frame is timestamped at the end of its capture: a capture waiting for the scheduler
+    // (i.e. started after the registration delay) could not complete before this bound.
+    CHECK(
+      frame->metadata.timestamp <
+      start + FrameCollector::REGISTRATION_DELAY + std::chrono::milliseconds(5));
+  }
+
+  SECTION("the capture in flight is joined")
+  {
+    // Captures last 100ms.
+    auto           source    = std::make_unique<SimulatedFrameSource>(4, 8, 10.0);
+    auto*          sourcePtr = source.get();
+    FrameCollector collector(std::move(source), CollectionMode::JUST_IN_TIME);
+
+    auto streamQueue    = FrameCollector::makeQueuePtr();
+    auto streamConsumer = consume(streamQueue);
+    collector.registerClient("stream", 5.0, streamQueue);
+    std::this_thread::sleep_for(FrameCollector::REGISTRATION_DELAY + std::chrono::milliseconds(40));
+    CHECK(sourcePtr->numSingleCaptures() == 0);
+
+    // The single-frame client gets the frame of the stream's capture, without its own capture.
+    auto queue = FrameCollector::makeQueuePtr(1);
+    collector.registerClient("single", -1.0, queue, 1);
+    std::shared_ptr<const Frame> frame;
+    REQUIRE(queue->pop(frame));
+    CHECK(sourcePtr->numSingleCaptures() == 1);
+    CHECK(collector.numSavedCaptures() == 1);
+
+    collector.deregisterClient("stream");
+    auto streamFrames = streamConsumer.get();
+    REQUIRE_FALSE(streamFrames.empty());
+    CHECK(streamFrames.front() == frame);
+  }
+}
+
+TEST_CASE("FrameCollector::registerBurst()", "[FrameCollector]")
+{
+  auto mode = GENERATE(CollectionMode::JUST_IN_TIME, CollectionMode::CONTINUOUS);
+
+  // Captures last 2ms, and the source only has 2 user buffers to acquire into. Without history,
+  // the frames are only referenced by the clients.
+  irsol::utils::BufferPool pool;
+  auto                     source    = std::make_unique<SimulatedFrameSource>(4, 8, 500.0, pool);
+  auto*                    sourcePtr = source.get();
+  source->useUserBuffers(2);
+  FrameCollector collector(std::move(source), mode, 0);
+
+  SECTION("the frames are captured back-to-back")
+  {
+    // Nobody consumes the frames while the burst is acquired: they are all kept in the queue, and
+    // copied out of the user buffers so that the acquisition never waits for a buffer to come
+    // back.
+    auto queue = FrameCollector::makeQueuePtr(20);
+    collector.registerBurst("burst", queue, 20);
+    REQUIRE(queue->waitDone() == irsol::utils::PopResult::DONE);
+    CHECK(queue->dropped() == 0);
+    CHECK(sourcePtr->userBufferDriver()->numStarved() == 0);
+    if(mode == CollectionMode::JUST_IN_TIME) {
+      CHECK(sourcePtr->numSingleCaptures() == 20);
+    } else {
+      CHECK(sourcePtr->numContinuousStarts() == 1);
+    }
+    // The frames are written into the buffers reserved for the burst, not into the pool of the
+    // source, which never frees its buffers.
+    CHECK(pool.numAllocations() == 0);
+
+    std::vector<std::shared_ptr<const Frame>> frames;
+    std::shared_ptr<const Frame>              frame;
+    while(queue->pop(frame)) {
+      frames.push_back(frame);
+    }
+    REQUIRE(frames.size() == 20);
+    for(size_t i = 1; i < frames.size(); ++i) {
+      CHECK(frames[i]->metadata.frameId > frames[i - 1]->metadata.frameId);
+      CHECK(frames[i]->metadata.timestamp > frames[i - 1]->metadata.timestamp);
+    }
+    CHECK_FALSE(collector.isBusy());
+
+    // The reserved buffers are freed once the frames are delivered (the collector is stopped
+    // first, so that its threads no longer reference the last frame).
+    std::vector<std::weak_ptr<const std::vector<irsol::types::byte_t>>> buffers;
+    for(const auto& burstFrame : frames) {
+      buffers.push_back(burstFrame->image.data);
+    }
+    collector.stop();
+    frame.reset();
+    frames.clear();
+    CHECK(std::all_of(buffers.begin(), buffers.end(), [](const auto& buffer) {
+      return buffer.expired();
+    }));
+  }
+
+  SECTION("the reservation ends with an aborted burst")
+  {
+    auto queue = FrameCollector::makeQueuePtr(100);
+    collector.registerBurst("burst", queue, 100);
+    std::shared_ptr<const Frame> frame;
+    REQUIRE(queue->pop(frame));
+    collector.deregisterClient("burst");
+    while(queue->pop(frame)) {
+    }
+    frame.reset();
+
+    // The next frames are shared with the user buffers again: the frame holds one of them.
+    auto single = FrameCollector::makeQueuePtr(1);
+    collector.registerClient("single", -1.0, single, 1);
+    REQUIRE(single->pop(frame));
+    CHECK(sourcePtr->userBufferDriver()->numQueued() < 2);
+    CHECK(pool.numAllocations() == 0);
+  }
+}
@@ -0,0 +1,152 @@
+#include "irsol/server/image_collector.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using irsol::server::frame_collector::CollectionMode;
+using irsol::server::frame_collector::ControlQueue;
+using irsol::server::frame_collector::FrameCollector;
+using irsol::server::frame_collector::SimulatedFrameSource;
+
+bool
+isReady(const std::future<int>& future)
+{
+  return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+}
+
+TEST_CASE("ControlQueue::runPending()", "[FrameCollector]")
+{
+  ControlQueue     queue;
+  std::vector<int> executed;
+
+  auto first  = queue.submit("Width", [&executed]() {
+    executed.push_back(1);
+    return 1;
+  });
+  auto second = queue.submit("Height", [&executed]() {
+    executed.push_back(2);
+    return 2;
+  });
+  CHECK(queue.size() == 2);
+  CHECK_FALSE(isReady(first));
+
+  CHECK(queue.runPending() == 2);
+  CHECK(queue.empty());
+  CHECK(executed == std::vector<int>{1, 2});
+  CHECK(first.get() == 1);
+  CHECK(second.get() == 2);
+  CHECK(queue.runPending() == 0);
+}
+
+TEST_CASE("ControlQueue::submit(coalescing)", "[FrameCollector]")
+{
+  ControlQueue queue;
+  int          numExecuted = 0;
+  auto         write       = [&numExecuted](int value) {
+    return [&numExecuted, value]() {
+      ++numExecuted;
+      return value;
+    };
+  };
+
+  SECTION("consecutive writes to the same feature are coalesced")
+  {
+    auto first  = queue.submit("ExposureTime", write(10));
+    auto second = queue.submit("ExposureTime", write(20));
+    auto third  = queue.submit("ExposureTime", write(30));
+    CHECK(queue.size() == 1);
+    CHECK(queue.numCoalesced() == 2);
+
+    queue.runPending();
+    CHECK(numExecuted == 1);
+    CHECK(first.get() == 30);
+    CHECK(second.get() == 30);
+    CHECK(third.get() == 30);
+  }
+
+  SECTION("writes to the same feature are not reordered around other features")
+  {
+    auto first  = queue.submit("Width", write(10));
+    auto other  = queue.submit("OffsetX", write(1));
+    auto second = queue.submit("Width", write(20));
+    CHECK(queue.size() == 3);
+    CHECK(queue.numCoalesced() == 0);
+
+    queue.runPending();
+    CHECK(numExecuted == 3);
+    CHECK(first.get() == 10);
+    CHECK(other.get() == 1);
+    CHECK(second.get() == 20);
+  }
+}
+
+TEST_CASE("ControlQueue::submit(exception)", "[FrameCollector]")
+{
+  ControlQueue queue;
+  auto         failing = queue.submit("Width", []() -> int { throw std::runtime_error("busy"); });
+  auto         next    = queue.submit("Height", []() { return 4; });
+
+  queue.runPending();
+  CHECK_THROWS_AS(failing.get(), std::runtime_error);
+  CHECK(next.get() == 4);
+}
+
+TEST_CASE("FrameCollector::control()", "[FrameCollector]")
+{
+  SECTION("an idle collector executes the operation at once")
+  {
+    auto mode = GENERATE(CollectionMode::JUST_IN_TIME, CollectionMode::CONTINUOUS);
+    FrameCollector collector(std::make_unique<SimulatedFrameSource>(4, 8, 200.0), mode);
+
+    auto future = collector.control("Width", []() { return std::this_thread::get_id(); });
+    REQUIRE(future.wait_for(std::chrono::milliseconds(200)) == std::future_status::ready);
+    // Executed by the acquisition thread.
+    CHECK(future.get() != std::this_thread::get_id());
+  }
+
+  SECTION("a stopped collector executes the operation on the calling thread")
+  {
+    FrameCollector collector(std::make_unique<SimulatedFrameSource>(4, 8, 200.0));
+    collector.stop();
+
+    auto future = collector.control("Width", []() { return std::this_thread::get_id(); });
+    CHECK(future.get() == std::this_thread::get_id());
+  }
+
+  SECTION("operations wait for the capture in progress")
+  {
+    // Each frame takes 500ms to be produced (i.e. a long exposure).
+    FrameCollector collector(std::make_unique<SimulatedFrameSource>(4, 8, 2.0));
+    auto           queue = FrameCollector::makeQueuePtr();
+    collector.registerClient("slow", 2.0, queue, 1);
+
+    // Wait for the acquisition to be in progress.
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+    int  numExecuted = 0;
+    auto first       = collector.control("ExposureTime", [&numExecuted]() {
+      ++numExecuted;
+      return 1;
+    });
+    auto second      = collector.control("ExposureTime", [&numExecuted]() {
+      ++numExecuted;
+      return 2;
+    });
+    CHECK(first.wait_for(std::chrono::milliseconds(100)) == std::future_status::timeout);
+
+    // Applied once the frame is captured, as a single camera access.
+    CHECK(first.get() == 2);
+    CHECK(second.get() == 2);
+    CHECK(numExecuted == 1);
+    CHECK(collector.numCoalescedControls() == 1);
+  }
+}
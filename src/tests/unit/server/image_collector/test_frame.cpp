@@ -0,0 +1,61 @@
+#include "irsol/server/image_collector.hpp"
+
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using irsol::server::frame_collector::FrameCollector;
+using irsol::server::frame_collector::FrameMetadata;
+
+std::shared_ptr<const irsol::server::frame_collector::Frame>
+makeTestFrame()
+{
+  std::vector<irsol::types::byte_t> data(4 * 8 * 2);
+  for(size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<irsol::types::byte_t>(i);
+  }
+  return FrameCollector::makeFrame(
+    FrameMetadata{irsol::types::clock_t::now(), 42, 4, 8}, std::move(data));
+}
+}
+
+TEST_CASE("Frame::serialized()", "[FrameCollector]")
+{
+  auto frame = makeTestFrame();
+
+  SECTION("matches the serialization of the image")
+  {
+    auto expected =
+      irsol::protocol::Serializer::serialize(irsol::protocol::OutMessage(frame->image.share()));
+    auto serialized = frame->serialized();
+    REQUIRE(serialized != nullptr);
+    CHECK(serialized->header == expected.header);
+    REQUIRE(serialized->payloadSize() == expected.payloadSize());
+    CHECK(std::equal(
+      serialized->payloadData(),
+      serialized->payloadData() + serialized->payloadSize(),
+      expected.payloadData()));
+  }
+
+  SECTION("is computed once and shared by all the clients")
+  {
+    std::vector<std::shared_ptr<const irsol::protocol::internal::SerializedMessage>> results(8);
+    std::vector<std::thread>                                                          threads;
+    for(size_t i = 0; i < results.size(); ++i) {
+      threads.emplace_back([&frame, &results, i]() { results[i] = frame->serialized(); });
+    }
+    for(auto& thread : threads) {
+      thread.join();
+    }
+    for(const auto& result : results) {
+      CHECK(result == results[0]);
+    }
+    // The image itself is left untouched by the serialization.
+    CHECK(frame->image.data->at(0) == irsol::types::byte_t{0});
+    CHECK(frame->image.data->at(1) == irsol::types::byte_t{1});
+  }
+}
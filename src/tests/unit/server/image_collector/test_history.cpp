@@ -0,0 +1,111 @@
+#include "irsol/server/image_collector.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using irsol::server::frame_collector::FrameCollector;
+using irsol::server::frame_collector::FrameHistory;
+using irsol::server::frame_collector::FrameMetadata;
+
+const auto T0 = irsol::types::clock_t::now();
+
+FrameHistory::frame_ptr_t
+makeTestFrame(uint64_t frameId)
+{
+  // Frames are 10ms apart.
+  return FrameCollector::makeFrame(
+    FrameMetadata{T0 + std::chrono::milliseconds(10 * frameId), frameId, 1, 1},
+    std::vector<irsol::types::byte_t>(2));
+}
+
+std::vector<uint64_t>
+idsOf(const std::vector<FrameHistory::frame_ptr_t>& frames)
+{
+  std::vector<uint64_t> ids;
+  for(const auto& frame : frames) {
+    ids.push_back(frame->metadata.frameId);
+  }
+  return ids;
+}
+}
+
+TEST_CASE("FrameHistory::add()", "[FrameCollector]")
+{
+  FrameHistory history(3);
+  CHECK(history.capacity() == 3);
+  CHECK(history.size() == 0);
+
+  SECTION("the oldest frames are released")
+  {
+    auto first = makeTestFrame(1);
+    history.add(first);
+    CHECK(first.use_count() == 2);
+    for(uint64_t id = 2; id <= 4; ++id) {
+      history.add(makeTestFrame(id));
+    }
+    CHECK(history.size() == 3);
+    CHECK(first.use_count() == 1);
+    CHECK(idsOf(history.since(0)) == std::vector<uint64_t>{2, 3, 4});
+  }
+
+  SECTION("restarting the frame IDs discards the history")
+  {
+    history.add(makeTestFrame(5));
+    history.add(makeTestFrame(6));
+    history.add(makeTestFrame(2));
+    CHECK(idsOf(history.since(0)) == std::vector<uint64_t>{2});
+  }
+
+  SECTION("a null capacity disables the history")
+  {
+    FrameHistory disabled(0);
+    disabled.add(makeTestFrame(1));
+    CHECK(disabled.size() == 0);
+    CHECK(disabled.nearest(T0) == nullptr);
+  }
+}
+
+TEST_CASE("FrameHistory::latest()", "[FrameCollector]")
+{
+  FrameHistory history(4);
+  CHECK(history.latest(std::chrono::hours(1)) == nullptr);
+
+  history.add(makeTestFrame(1));
+  history.add(makeTestFrame(2));
+  const auto now = T0 + std::chrono::milliseconds(50);
+
+  auto latest = history.latest(std::chrono::milliseconds(30), now);
+  REQUIRE(latest != nullptr);
+  CHECK(latest->metadata.frameId == 2);
+  CHECK(history.latest(std::chrono::milliseconds(29), now) == nullptr);
+}
+
+TEST_CASE("FrameHistory::since()", "[FrameCollector]")
+{
+  FrameHistory history(4);
+  for(uint64_t id = 1; id <= 6; ++id) {
+    history.add(makeTestFrame(id));
+  }
+
+  CHECK(idsOf(history.since(4)) == std::vector<uint64_t>{5, 6});
+  CHECK(idsOf(history.since(0)) == std::vector<uint64_t>{3, 4, 5, 6});
+  CHECK(history.since(6).empty());
+}
+
+TEST_CASE("FrameHistory::nearest()", "[FrameCollector]")
+{
+  FrameHistory history(4);
+  CHECK(history.nearest(T0) == nullptr);
+  for(uint64_t id = 1; id <= 4; ++id) {
+    history.add(makeTestFrame(id));
+  }
+
+  CHECK(history.nearest(T0)->metadata.frameId == 1);
+  CHECK(history.nearest(T0 + std::chrono::milliseconds(24))->metadata.frameId == 2);
+  CHECK(history.nearest(T0 + std::chrono::milliseconds(26))->metadata.frameId == 3);
+  CHECK(history.nearest(T0 + std::chrono::hours(1))->metadata.frameId == 4);
+}
@@ -0,0 +1,80 @@
+#include "irsol/server/image_collector/scheduler.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <vector>
+
+namespace {
+using irsol::server::frame_collector::Scheduler;
+
+const irsol::types::timepoint_t T0 = irsol::types::clock_t::now();
+
+irsol::types::timepoint_t
+at(int ms)
+{
+  return T0 + std::chrono::milliseconds(ms);
+}
+}
+
+TEST_CASE("Scheduler::schedule()", "[FrameCollector][Scheduler]")
+{
+  Scheduler scheduler;
+  CHECK(scheduler.empty());
+
+  scheduler.schedule(3, at(30));
+  scheduler.schedule(1, at(10));
+  scheduler.schedule(2, at(20));
+  CHECK(scheduler.size() == 3);
+  CHECK(scheduler.contains(1));
+  CHECK_FALSE(scheduler.contains(0));
+  CHECK_FALSE(scheduler.contains(100));
+  CHECK(scheduler.nextDue() == at(10));
+
+  SECTION("re-scheduling a client updates its due time")
+  {
+    scheduler.schedule(1, at(40));
+    CHECK(scheduler.size() == 3);
+    CHECK(scheduler.nextDue() == at(20));
+    scheduler.schedule(3, at(5));
+    CHECK(scheduler.nextDue() == at(5));
+  }
+
+  SECTION("removing a client")
+  {
+    CHECK(scheduler.remove(1));
+    CHECK_FALSE(scheduler.remove(1));
+    CHECK_FALSE(scheduler.contains(1));
+    CHECK(scheduler.size() == 2);
+    CHECK(scheduler.nextDue() == at(20));
+  }
+}
+
+TEST_CASE("Scheduler::popDue()", "[FrameCollector][Scheduler]")
+{
+  Scheduler scheduler;
+  for(uint32_t handle = 0; handle < 100; ++handle) {
+    // Scramble the insertion order.
+    scheduler.schedule(handle, at(static_cast<int>((handle * 37) % 100)));
+  }
+
+  std::vector<Scheduler::Entry> ready;
+  CHECK(scheduler.popDue(at(9), ready) == 10);
+  REQUIRE(ready.size() == 10);
+  for(size_t i = 0; i < ready.size(); ++i) {
+    CHECK(ready[i].due == at(static_cast<int>(i)));
+    CHECK_FALSE(scheduler.contains(ready[i].handle));
+  }
+  CHECK(scheduler.size() == 90);
+  CHECK(scheduler.nextDue() == at(10));
+
+  // Nothing is due before the next due time.
+  CHECK(scheduler.popDue(at(9), ready) == 0);
+  CHECK(ready.size() == 10);
+
+  ready.clear();
+  CHECK(scheduler.popDue(at(1000), ready) == 90);
+  CHECK(scheduler.empty());
+  for(size_t i = 1; i < ready.size(); ++i) {
+    CHECK(ready[i - 1].due <= ready[i].due);
+  }
+}
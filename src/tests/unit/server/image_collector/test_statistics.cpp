@@ -0,0 +1,38 @@
+#include "irsol/server/image_collector/statistics.hpp"
+
+#include <catch2/catch_all.hpp>
+
+using irsol::server::frame_collector::RollingStatistics;
+
+TEST_CASE("RollingStatistics::add()", "[FrameCollector]")
+{
+  RollingStatistics stats(4);
+  CHECK(stats.count() == 0);
+  CHECK(stats.mean() == 0.0);
+  CHECK(stats.stddev() == 0.0);
+
+  SECTION("statistics of the values in the window")
+  {
+    stats.add(1.0);
+    stats.add(2.0);
+    stats.add(3.0);
+    CHECK(stats.count() == 3);
+    CHECK(stats.total() == 3);
+    CHECK(stats.mean() == Catch::Approx(2.0));
+    CHECK(stats.stddev() == Catch::Approx(1.0));
+    CHECK(stats.min() == 1.0);
+    CHECK(stats.max() == 3.0);
+  }
+
+  SECTION("only the last values are kept")
+  {
+    for(int i = 0; i < 10; ++i) {
+      stats.add(static_cast<double>(i));
+    }
+    CHECK(stats.count() == 4);
+    CHECK(stats.total() == 10);
+    CHECK(stats.mean() == Catch::Approx(7.5));
+    CHECK(stats.min() == 6.0);
+    CHECK(stats.max() == 9.0);
+  }
+}
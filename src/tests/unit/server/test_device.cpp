@@ -0,0 +1,92 @@
+#include "irsol/assert.hpp"
+#include "irsol/server/device.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using irsol::camera::SimulatedCamera;
+using irsol::server::Device;
+using irsol::server::frame_collector::Frame;
+using irsol::server::frame_collector::FrameCollector;
+using irsol::server::frame_collector::SimulatedFrameSource;
+
+std::unique_ptr<Device>
+makeSimulatedDevice(const std::string& name)
+{
+  return Device::simulated(name, std::make_unique<SimulatedFrameSource>(4, 8, 200.0));
+}
+}
+
+TEST_CASE("Device::simulated()", "[Device]")
+{
+  auto device = makeSimulatedDevice("sim0");
+  CHECK(device->name() == "sim0");
+  CHECK(device->serialNumber() == "sim0");
+  CHECK(device->matches("sim0"));
+  CHECK_FALSE(device->matches("sim1"));
+  CHECK_FALSE(device->hasCamera());
+  CHECK_THROWS_AS(device->camera(), irsol::AssertionException);
+  CHECK_FALSE(device->cpu().has_value());
+}
+
+TEST_CASE("Device::simulated(camera)", "[Device]")
+{
+  SimulatedCamera::Config config;
+  config.serialNumber = "SIM-1234";
+  config.sensorWidth  = 64;
+  config.sensorHeight = 32;
+  auto device = Device::simulated("sim0", std::make_unique<SimulatedCamera>(config));
+  CHECK(device->serialNumber() == "SIM-1234");
+  CHECK(device->matches("SIM-1234"));
+  REQUIRE(device->hasCamera());
+
+  // The frames follow the parameters of the camera, as changed by the clients.
+  auto& camera   = device->camera();
+  auto  setWidth = [&camera]() { return camera.setIntParam("Width", 16); };
+  CHECK(device->frameCollector().control("Width", setWidth).get() == 16);
+  CHECK(camera.getIntParam("Width") == 16);
+  camera.setExposure(std::chrono::milliseconds(1));
+
+  auto queue = FrameCollector::makeQueuePtr();
+  device->frameCollector().registerClient("client", 50.0, queue, 1);
+  std::shared_ptr<const Frame> frame;
+  REQUIRE(queue->pop(frame));
+  CHECK(frame->metadata.width == 16);
+  CHECK(frame->metadata.height == 32);
+}
+
+TEST_CASE("Device::frameCollector()", "[Device]")
+{
+  // Each device acquires from its own source, with its own frame collector.
+  std::vector<std::unique_ptr<Device>> devices;
+  devices.push_back(makeSimulatedDevice("sim0"));
+  devices.push_back(makeSimulatedDevice("sim1"));
+  CHECK(&devices[0]->frameCollector() != &devices[1]->frameCollector());
+
+  std::vector<std::shared_ptr<FrameCollector::frame_queue_t>> queues;
+  for(auto& device : devices) {
+    queues.push_back(FrameCollector::makeQueuePtr());
+    device->frameCollector().registerClient("client", 50.0, queues.back(), 2);
+  }
+  for(auto& queue : queues) {
+    std::shared_ptr<const Frame> frame;
+    size_t                       numFrames = 0;
+    while(queue->pop(frame)) {
+      ++numFrames;
+    }
+    CHECK(numFrames == 2);
+  }
+}
+
+#ifdef __linux__
+TEST_CASE("Device::pinToCpu()", "[Device]")
+{
+  auto device = makeSimulatedDevice("sim0");
+  REQUIRE(device->pinToCpu(0));
+  CHECK(device->cpu() == 0);
+}
+#endif
@@ -0,0 +1,124 @@
+#include "irsol/buffer_pool.hpp"
+
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <thread>
+#include <vector>
+
+TEST_CASE("BufferPool::classSize()", "[BufferPool]")
+{
+  CHECK(irsol::utils::BufferPool::classSize(0) == irsol::utils::BufferPool::MIN_CLASS_SIZE);
+  CHECK(irsol::utils::BufferPool::classSize(1) == irsol::utils::BufferPool::MIN_CLASS_SIZE);
+  CHECK(irsol::utils::BufferPool::classSize(4096) == 4096);
+  CHECK(irsol::utils::BufferPool::classSize(4097) == 8192);
+  CHECK(irsol::utils::BufferPool::classSize(1080 * 1440 * 2) == 4 * 1024 * 1024);
+}
+
+TEST_CASE("BufferPool::acquire()", "[BufferPool]")
+{
+  irsol::utils::BufferPool pool;
+  CHECK(pool.numBuffers() == 0);
+
+  SECTION("buffers have the requested size")
+  {
+    auto numBytes = GENERATE(1, 100, 4096, 10000, 1 << 20);
+    auto buffer   = pool.acquire(numBytes);
+    CHECK(buffer->size() == static_cast<size_t>(numBytes));
+    CHECK(buffer->capacity() >= irsol::utils::BufferPool::classSize(numBytes));
+    CHECK(pool.numAllocations() == 1);
+  }
+
+  SECTION("released buffers are re-used")
+  {
+    const irsol::types::byte_t* data;
+    {
+      auto buffer = pool.acquire(10000);
+      data        = buffer->data();
+      CHECK(pool.numAvailable() == 0);
+    }
+    CHECK(pool.numAvailable() == 1);
+
+    // Same size class, same buffer.
+    for(size_t i = 0; i < 100; ++i) {
+      auto buffer = pool.acquire(9000 + i);
+      CHECK(buffer->data() == data);
+      CHECK(buffer->size() == 9000 + i);
+    }
+    CHECK(pool.numAllocations() == 1);
+  }
+
+  SECTION("buffers in use are never handed out twice")
+  {
+    std::vector<irsol::utils::BufferPool::buffer_t> buffers;
+    for(size_t i = 0; i < 4; ++i) {
+      buffers.push_back(pool.acquire(10000));
+    }
+    for(size_t i = 1; i < buffers.size(); ++i) {
+      CHECK(buffers[i]->data() != buffers[i - 1]->data());
+    }
+    CHECK(pool.numAllocations() == 4);
+
+    // A buffer is only available once its last copy is released.
+    auto copy = buffers.front();
+    buffers.clear();
+    CHECK(pool.numAvailable() == 3);
+    copy.reset();
+    CHECK(pool.numAvailable() == 4);
+  }
+
+  SECTION("different size classes don't share buffers")
+  {
+    {
+      auto small = pool.acquire(100);
+    }
+    auto large = pool.acquire(100000);
+    CHECK(pool.numAllocations() == 2);
+    CHECK(pool.numBuffers() == 2);
+  }
+}
+
+TEST_CASE("BufferPool::reserve()", "[BufferPool]")
+{
+  irsol::utils::BufferPool pool(true);
+  pool.reserve(1080 * 1440 * 2, 3);
+  CHECK(pool.numAllocations() == 3);
+  CHECK(pool.numAvailable() == 3);
+
+  // Reserved buffers are used without further allocations.
+  {
+    std::vector<irsol::utils::BufferPool::buffer_t> buffers;
+    for(size_t i = 0; i < 3; ++i) {
+      buffers.push_back(pool.acquire(1080 * 1440 * 2));
+    }
+    CHECK(pool.numAvailable() == 0);
+  }
+  CHECK(pool.numAllocations() == 3);
+
+  // Reserving less than the existing buffers is a no-op.
+  pool.reserve(1080 * 1440 * 2, 2);
+  CHECK(pool.numAllocations() == 3);
+}
+
+TEST_CASE("BufferPool::acquire(multi-threaded)", "[BufferPool]")
+{
+  irsol::utils::BufferPool pool;
+
+  // Buffers are acquired and released from many threads: each buffer is written by a single
+  // owner at a time.
+  std::vector<std::thread> threads;
+  for(uint8_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&pool, t]() {
+      for(size_t i = 0; i < 1000; ++i) {
+        auto buffer = pool.acquire(8192);
+        std::fill(buffer->begin(), buffer->end(), irsol::types::byte_t{t});
+        REQUIRE(std::all_of(buffer->begin(), buffer->end(), [t](auto byte) {
+          return byte == irsol::types::byte_t{t};
+        }));
+      }
+    });
+  }
+  for(auto& thread : threads) {
+    thread.join();
+  }
+  CHECK(pool.numAllocations() <= 4);
+}
@@ -1,6 +1,11 @@
 #include "irsol/queue.hpp"
 
+#include <atomic>
 #include <catch2/catch_all.hpp>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
 
 TEST_CASE("SafeQueue<T>::done())", "[SafeQueue]")
 {
@@ -10,6 +15,22 @@ TEST_CASE("SafeQueue<T>::done())", "[SafeQueue]")
   CHECK(queue.done());
 }
 
+TEST_CASE("SafeQueue<T>::pop(after done)", "[SafeQueue]")
+{
+  auto queue = irsol::utils::SafeQueue<int>(3);
+  queue.push(1);
+  queue.push(2);
+  queue.producerFinished();
+
+  // Items pushed before the producer finished can still be drained.
+  int value;
+  CHECK(queue.pop(value));
+  CHECK(value == 1);
+  CHECK(queue.pop(value));
+  CHECK(value == 2);
+  CHECK_FALSE(queue.pop(value));
+}
+
 TEST_CASE("SafeQueue<T>::sizes", "[SafeQueue]")
 {
   auto queue = irsol::utils::SafeQueue<int>(3);
@@ -33,3 +54,197 @@ TEST_CASE("SafeQueue<T>::sizes", "[SafeQueue]")
   CHECK(queue.empty());
   CHECK_FALSE(queue.full());
 }
+
+TEST_CASE("SafeQueue<T>::OverflowPolicy", "[SafeQueue]")
+{
+  int value;
+
+  SECTION("BLOCK rejects items on tryPush when full")
+  {
+    auto queue = irsol::utils::SafeQueue<int>(2, irsol::utils::OverflowPolicy::BLOCK);
+    CHECK(queue.tryPush(1));
+    CHECK(queue.tryPush(2));
+    CHECK_FALSE(queue.tryPush(3));
+    CHECK(queue.size() == 2);
+    // The rejected item is left to the producer: it's not dropped.
+    CHECK(queue.rejected() == 1);
+    CHECK(queue.dropped() == 0);
+    CHECK(queue.pop(value));
+    CHECK(value == 1);
+    CHECK(queue.tryPush(4));
+    CHECK(queue.rejected() == 1);
+  }
+
+  SECTION("DROP_OLDEST discards the front of the queue")
+  {
+    auto queue = irsol::utils::SafeQueue<int>(2, irsol::utils::OverflowPolicy::DROP_OLDEST);
+    for(int i = 0; i < 5; ++i) {
+      CHECK(queue.push(std::move(i)));
+    }
+    CHECK(queue.size() == 2);
+    CHECK(queue.dropped() == 3);
+    CHECK(queue.pop(value));
+    CHECK(value == 3);
+    CHECK(queue.pop(value));
+    CHECK(value == 4);
+  }
+
+  SECTION("DROP_NEWEST discards the pushed item")
+  {
+    auto queue = irsol::utils::SafeQueue<int>(2, irsol::utils::OverflowPolicy::DROP_NEWEST);
+    for(int i = 0; i < 5; ++i) {
+      CHECK(queue.tryPush(std::move(i)) == (i < 2));
+    }
+    CHECK(queue.size() == 2);
+    CHECK(queue.dropped() == 3);
+    CHECK(queue.pop(value));
+    CHECK(value == 0);
+    CHECK(queue.pop(value));
+    CHECK(value == 1);
+  }
+
+  SECTION("LATEST_ONLY keeps only the most recent item")
+  {
+    auto queue = irsol::utils::SafeQueue<int>(0, irsol::utils::OverflowPolicy::LATEST_ONLY);
+    for(int i = 0; i < 5; ++i) {
+      CHECK(queue.push(std::move(i)));
+      CHECK(queue.size() == 1);
+    }
+    CHECK(queue.full());
+    CHECK(queue.dropped() == 4);
+    CHECK(queue.pop(value));
+    CHECK(value == 4);
+  }
+}
+
+TEST_CASE("OverflowPolicy names", "[SafeQueue]")
+{
+  for(auto policy : {irsol::utils::OverflowPolicy::BLOCK,
+                     irsol::utils::OverflowPolicy::DROP_OLDEST,
+                     irsol::utils::OverflowPolicy::DROP_NEWEST,
+                     irsol::utils::OverflowPolicy::LATEST_ONLY}) {
+    auto parsed =
+      irsol::utils::overflowPolicyFromString(irsol::utils::overflowPolicyToString(policy));
+    REQUIRE(parsed.has_value());
+    CHECK(*parsed == policy);
+  }
+  CHECK(std::string(irsol::utils::overflowPolicyToString(
+          irsol::utils::OverflowPolicy::LATEST_ONLY)) == "latest_only");
+  CHECK_FALSE(irsol::utils::overflowPolicyFromString("DROP_OLDEST").has_value());
+  CHECK_FALSE(irsol::utils::overflowPolicyFromString("").has_value());
+}
+
+TEST_CASE("overflowPolicyRequiresBound()", "[SafeQueue]")
+{
+  CHECK_FALSE(irsol::utils::overflowPolicyRequiresBound(irsol::utils::OverflowPolicy::BLOCK));
+  CHECK(irsol::utils::overflowPolicyRequiresBound(irsol::utils::OverflowPolicy::DROP_OLDEST));
+  CHECK(irsol::utils::overflowPolicyRequiresBound(irsol::utils::OverflowPolicy::DROP_NEWEST));
+  // A LATEST_ONLY queue always holds at most one item.
+  CHECK_FALSE(
+    irsol::utils::overflowPolicyRequiresBound(irsol::utils::OverflowPolicy::LATEST_ONLY));
+}
+
+TEST_CASE("SafeQueue<T>::popFor()", "[SafeQueue]")
+{
+  auto queue = irsol::utils::SafeQueue<int>(3);
+  int  value = 0;
+
+  SECTION("times out on an empty queue")
+  {
+    const auto t0 = std::chrono::steady_clock::now();
+    CHECK(queue.popFor(value, std::chrono::milliseconds(20)) == irsol::utils::PopResult::TIMEOUT);
+    CHECK(std::chrono::steady_clock::now() - t0 >= std::chrono::milliseconds(20));
+  }
+
+  SECTION("pops an available item")
+  {
+    queue.push(7);
+    CHECK(queue.popFor(value, std::chrono::seconds(1)) == irsol::utils::PopResult::POPPED);
+    CHECK(value == 7);
+  }
+
+  SECTION("reports a done queue")
+  {
+    queue.producerFinished();
+    CHECK(queue.popFor(value, std::chrono::seconds(1)) == irsol::utils::PopResult::DONE);
+  }
+
+  SECTION("is woken up by the stop flag")
+  {
+    std::atomic<bool> stopRequested{false};
+    auto              consumer = std::async(std::launch::async, [&]() {
+      return queue.popFor(value, std::chrono::seconds(10), &stopRequested);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const auto t0 = std::chrono::steady_clock::now();
+    stopRequested = true;
+    queue.interrupt();
+    CHECK(consumer.get() == irsol::utils::PopResult::STOPPED);
+    CHECK(std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(100));
+  }
+}
+
+TEST_CASE("SafeQueue<T>::popMany()", "[SafeQueue]")
+{
+  auto             queue = irsol::utils::SafeQueue<int>(8);
+  std::vector<int> values;
+
+  SECTION("drains the ready items, up to the maximum")
+  {
+    for(int i = 0; i < 5; ++i) {
+      queue.push(std::move(i));
+    }
+    CHECK(queue.popMany(values, 3) == irsol::utils::PopResult::POPPED);
+    CHECK(values == std::vector<int>{0, 1, 2});
+    CHECK(queue.popMany(values, 3) == irsol::utils::PopResult::POPPED);
+    CHECK(values == std::vector<int>{0, 1, 2, 3, 4});
+    CHECK(queue.empty());
+  }
+
+  SECTION("waits for the first item")
+  {
+    auto consumer = std::async(std::launch::async, [&]() { return queue.popMany(values, 3); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.push(1);
+    CHECK(consumer.get() == irsol::utils::PopResult::POPPED);
+    CHECK(values == std::vector<int>{1});
+  }
+
+  SECTION("stops on the stop flag, or when done")
+  {
+    std::atomic<bool> stopRequested{true};
+    queue.push(1);
+    CHECK(queue.popMany(values, 3, &stopRequested) == irsol::utils::PopResult::STOPPED);
+    CHECK(values.empty());
+    stopRequested = false;
+    queue.producerFinished();
+    CHECK(queue.popMany(values, 3, &stopRequested) == irsol::utils::PopResult::POPPED);
+    CHECK(queue.popMany(values, 3, &stopRequested) == irsol::utils::PopResult::DONE);
+  }
+}
+
+TEST_CASE("SafeQueue<T>::waitDone()", "[SafeQueue]")
+{
+  auto queue = irsol::utils::SafeQueue<int>(8);
+
+  SECTION("waits for the producer to finish, and keeps the items")
+  {
+    auto consumer = std::async(std::launch::async, [&]() { return queue.waitDone(); });
+    queue.push(1);
+    queue.push(2);
+    CHECK(consumer.wait_for(std::chrono::milliseconds(20)) == std::future_status::timeout);
+    queue.producerFinished();
+    CHECK(consumer.get() == irsol::utils::PopResult::DONE);
+    CHECK(queue.size() == 2);
+  }
+
+  SECTION("stops on the stop flag")
+  {
+    std::atomic<bool> stopRequested{false};
+    auto              consumer =
+      std::async(std::launch::async, [&]() { return queue.waitDone(&stopRequested); });
+    stopRequested = true;
+    queue.interrupt();
+    CHECK(consumer.get() == irsol::utils::PopResult::STOPPED);
+  }
+}
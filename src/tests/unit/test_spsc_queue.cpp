@@ -0,0 +1,168 @@
+#include "irsol/spsc_queue.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+
+TEST_CASE("SpscQueue<T>::done())", "[SpscQueue]")
+{
+  auto queue = irsol::utils::SpscQueue<int>(3);
+  CHECK_FALSE(queue.done());
+  queue.producerFinished();
+  CHECK(queue.done());
+  CHECK_THROWS_AS(queue.push(1), irsol::AssertionException);
+}
+
+TEST_CASE("SpscQueue<T>::pop(after done)", "[SpscQueue]")
+{
+  auto queue = irsol::utils::SpscQueue<int>(3);
+  queue.push(1);
+  queue.push(2);
+  queue.producerFinished();
+
+  // Items pushed before the producer finished can still be drained.
+  int value;
+  CHECK(queue.pop(value));
+  CHECK(value == 1);
+  CHECK(queue.pop(value));
+  CHECK(value == 2);
+  CHECK_FALSE(queue.pop(value));
+}
+
+TEST_CASE("SpscQueue<T>::sizes", "[SpscQueue]")
+{
+  // The capacity is not a power of two, and the ring wraps around several times.
+  auto queue = irsol::utils::SpscQueue<int>(3);
+  CHECK(queue.capacity() == 3);
+  int value;
+  for(int round = 0; round < 4; ++round) {
+    CHECK(queue.empty());
+    for(size_t i = 0; i < 3; ++i) {
+      CHECK_FALSE(queue.full());
+      CHECK(queue.size() == i);
+      queue.push(static_cast<int>(i));
+      CHECK(queue.size() == i + 1);
+    }
+    CHECK(queue.full());
+    CHECK_FALSE(queue.empty());
+
+    for(size_t i = 0; i < 3; ++i) {
+      CHECK(queue.pop(value));
+      CHECK(value == static_cast<int>(i));
+      CHECK(queue.size() == 2 - i);
+    }
+    CHECK_FALSE(queue.tryPop(value));
+  }
+}
+
+TEST_CASE("SpscQueue<T>::OverflowPolicy", "[SpscQueue]")
+{
+  int value;
+
+  SECTION("BLOCK rejects items on tryPush when full")
+  {
+    auto queue = irsol::utils::SpscQueue<int>(2, irsol::utils::OverflowPolicy::BLOCK);
+    CHECK(queue.tryPush(1));
+    CHECK(queue.tryPush(2));
+    CHECK_FALSE(queue.tryPush(3));
+    CHECK(queue.size() == 2);
+    CHECK(queue.rejected() == 1);
+    CHECK(queue.dropped() == 0);
+    CHECK(queue.pop(value));
+    CHECK(value == 1);
+    CHECK(queue.tryPush(4));
+    CHECK(queue.rejected() == 1);
+  }
+
+  SECTION("DROP_NEWEST discards the pushed item")
+  {
+    auto queue = irsol::utils::SpscQueue<int>(2, irsol::utils::OverflowPolicy::DROP_NEWEST);
+    for(int i = 0; i < 5; ++i) {
+      CHECK(queue.push(std::move(i)) == (i < 2));
+    }
+    CHECK(queue.size() == 2);
+    CHECK(queue.dropped() == 3);
+    CHECK(queue.pop(value));
+    CHECK(value == 0);
+    CHECK(queue.pop(value));
+    CHECK(value == 1);
+  }
+
+  SECTION("policies discarding queued items are not supported")
+  {
+    CHECK_THROWS_AS(
+      irsol::utils::SpscQueue<int>(2, irsol::utils::OverflowPolicy::DROP_OLDEST),
+      irsol::AssertionException);
+    CHECK_THROWS_AS(
+      irsol::utils::SpscQueue<int>(2, irsol::utils::OverflowPolicy::LATEST_ONLY),
+      irsol::AssertionException);
+    CHECK_THROWS_AS(irsol::utils::SpscQueue<int>(0), irsol::AssertionException);
+  }
+}
+
+TEST_CASE("SpscQueue<T>::pop(blocking)", "[SpscQueue]")
+{
+  auto queue = irsol::utils::SpscQueue<int>(4);
+
+  SECTION("the consumer is woken up by an item")
+  {
+    auto consumer = std::async(std::launch::async, [&queue]() {
+      int value = 0;
+      return queue.pop(value) ? value : -1;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.push(42);
+    CHECK(consumer.get() == 42);
+  }
+
+  SECTION("the consumer is woken up by the end of the producer")
+  {
+    auto consumer = std::async(std::launch::async, [&queue]() {
+      int value = 0;
+      return queue.pop(value);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.producerFinished();
+    CHECK_FALSE(consumer.get());
+  }
+}
+
+TEST_CASE("SpscQueue<T>::push(blocking)", "[SpscQueue]")
+{
+  // A small queue makes both sides block repeatedly: all the items are received, in order.
+  constexpr int numItems = 100000;
+  auto          queue    = irsol::utils::SpscQueue<int>(2);
+  auto          producer = std::async(std::launch::async, [&queue]() {
+    for(int i = 0; i < numItems; ++i) {
+      queue.push(std::move(i));
+    }
+    queue.producerFinished();
+  });
+
+  int  expected = 0;
+  int  value;
+  bool ordered = true;
+  while(queue.pop(value)) {
+    ordered = ordered && value == expected;
+    ++expected;
+  }
+  producer.get();
+  CHECK(ordered);
+  CHECK(expected == numItems);
+  CHECK(queue.dropped() == 0);
+}
+
+TEST_CASE("SpscQueue<T>::pop(releases items)", "[SpscQueue]")
+{
+  auto queue = irsol::utils::SpscQueue<std::shared_ptr<int>>(2);
+  auto item  = std::make_shared<int>(1);
+  queue.push(std::shared_ptr<int>(item));
+  CHECK(item.use_count() == 2);
+
+  std::shared_ptr<int> out;
+  CHECK(queue.pop(out));
+  out.reset();
+  CHECK(item.use_count() == 1);
+}
@@ -137,6 +137,34 @@ TEST_CASE("stripString()", "[Utils]")
     }
   }
 }
+TEST_CASE("timestampFromString()", "[Utils]")
+{
+  {
+    const auto timestamp = irsol::types::clock_t::now() - std::chrono::seconds(3);
+    const auto parsed =
+      irsol::utils::timestampFromString(irsol::utils::timestampToString(timestamp));
+    REQUIRE(parsed.has_value());
+    // Both conversions go through the system clock, which is read at slightly different times.
+    CHECK(*parsed - timestamp < std::chrono::milliseconds(1));
+    CHECK(timestamp - *parsed < std::chrono::milliseconds(1));
+  }
+  {
+    const auto withFraction    = irsol::utils::timestampFromString("2025-06-01 12:34:56.5");
+    const auto withoutFraction = irsol::utils::timestampFromString("2025-06-01 12:34:56");
+    REQUIRE(withFraction.has_value());
+    REQUIRE(withoutFraction.has_value());
+    const auto difference = *withFraction - *withoutFraction;
+    CHECK(difference > std::chrono::milliseconds(499));
+    CHECK(difference < std::chrono::milliseconds(501));
+  }
+  {
+    CHECK_FALSE(irsol::utils::timestampFromString("").has_value());
+    CHECK_FALSE(irsol::utils::timestampFromString("12:34:56").has_value());
+    CHECK_FALSE(irsol::utils::timestampFromString("2025-06-01 12:34:56.").has_value());
+    CHECK_FALSE(irsol::utils::timestampFromString("2025-06-01 12:34:56 UTC").has_value());
+  }
+}
+
 TEST_CASE("durationToString()", "[Utils]")
 {
   {